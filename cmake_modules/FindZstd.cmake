@@ -0,0 +1,30 @@
+# - Find Zstandard (zstd.h, libzstd.a)
+# This module defines
+#  ZSTD_INCLUDE_DIR, directory containing headers
+#  ZSTD_STATIC_LIB, path to libzstd's static library
+#  ZSTD_FOUND, whether zstd has been found
+
+#
+# Copyright (c) YugaByte, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+# in compliance with the License.  You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software distributed under the License
+# is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+# or implied.  See the License for the specific language governing permissions and limitations
+# under the License.
+#
+find_path(ZSTD_INCLUDE_DIR zstd.h
+  # make sure we don't accidentally pick up a different version
+  NO_CMAKE_SYSTEM_PATH
+  NO_SYSTEM_ENVIRONMENT_PATH)
+find_library(ZSTD_STATIC_LIB libzstd.a
+  NO_CMAKE_SYSTEM_PATH
+  NO_SYSTEM_ENVIRONMENT_PATH)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(ZSTD REQUIRED_VARS
+  ZSTD_STATIC_LIB ZSTD_INCLUDE_DIR)
@@ -153,6 +153,18 @@ find_package(Lz4 REQUIRED)
 include_directories(SYSTEM ${LZ4_INCLUDE_DIR})
 ADD_THIRDPARTY_LIB(lz4 STATIC_LIB "${LZ4_STATIC_LIB}")
 
+## Zstandard
+# Optional: ZSTD compression is only supported when zstd is present in the third-party dependencies.
+find_package(Zstd)
+if(ZSTD_FOUND)
+  include_directories(SYSTEM ${ZSTD_INCLUDE_DIR})
+  ADD_THIRDPARTY_LIB(zstd STATIC_LIB "${ZSTD_STATIC_LIB}")
+  ADD_CXX_FLAGS("-DZSTD")
+  set(ZSTD_LIBS zstd)
+else()
+  set(ZSTD_LIBS "")
+endif()
+
 ## ZLib
 find_package(Zlib REQUIRED)
 include_directories(SYSTEM ${ZLIB_INCLUDE_DIR})
@@ -2280,6 +2280,7 @@ Status CatalogManager::HandlePlacementUsingReplicationInfo(
   RETURN_NOT_OK(super::HandlePlacementUsingPlacementInfo(replication_info.live_replicas(),
                                                       ts_descs,
                                                       consensus::PeerMemberType::VOTER, config));
+  RETURN_NOT_OK(super::HandleWitnessPlacement(replication_info, ts_descs, config));
   for (int i = 0; i < replication_info.read_replicas_size(); i++) {
     GetTsDescsFromPlacementInfo(replication_info.read_replicas(i), all_ts_descs, &ts_descs);
     RETURN_NOT_OK(super::HandlePlacementUsingPlacementInfo(replication_info.read_replicas(i),
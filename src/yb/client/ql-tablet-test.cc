@@ -54,6 +54,7 @@
 
 #include "yb/server/skewed_clock.h"
 
+#include "yb/tablet/mvcc.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet_metadata.h"
@@ -104,6 +105,7 @@ DECLARE_double(leader_failure_max_missed_heartbeat_periods);
 DECLARE_int32(TEST_backfill_sabotage_frequency);
 DECLARE_string(regular_tablets_data_block_key_value_encoding);
 DECLARE_string(compression_type);
+DECLARE_int32(closed_timestamp_publish_interval_ms);
 
 namespace yb {
 namespace client {
@@ -1328,6 +1330,40 @@ TEST_F(QLTabletTest, HistoryCutoff) {
   ASSERT_NO_FATALS(VerifyHistoryCutoff(cluster_.get(), &committed_history_cutoff, "Final"));
 }
 
+class QLTabletClosedTimestampTest : public QLTabletTest {
+ public:
+  void SetUp() override {
+    FLAGS_closed_timestamp_publish_interval_ms = 50;
+    // Make Raft heartbeats rare, so safe time on followers is advanced by closed timestamps.
+    FLAGS_raft_heartbeat_interval_ms = 2000;
+    QLTabletTest::SetUp();
+  }
+};
+
+TEST_F_EX(QLTabletTest, ClosedTimestamp, QLTabletClosedTimestampTest) {
+  CreateTable(kTable1Name, &table1_, /* num_tablets= */ 1);
+  FillTable(0, 10, table1_);
+
+  auto leaders = ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders);
+  ASSERT_EQ(leaders.size(), 1);
+  auto followers = ListTabletPeers(cluster_.get(), ListPeersFilter::kNonLeaders);
+  ASSERT_EQ(followers.size(), 2);
+
+  for (int i = 0; i != 3; ++i) {
+    auto now = leaders[0]->clock_ptr()->Now();
+    for (const auto& follower : followers) {
+      ASSERT_OK(WaitFor(
+          [follower, now] {
+            return follower->tablet()->mvcc_manager()->SafeTimeForFollower(
+                HybridTime::kMin, CoarseTimePoint::min()) >= now;
+          },
+          FLAGS_raft_heartbeat_interval_ms / 4 * 1ms,
+          Format("Wait safe time of $0 to reach $1", follower->permanent_uuid(), now)));
+    }
+    FillTable(i * 10, (i + 1) * 10, table1_);
+  }
+}
+
 class QLTabletRf1Test : public QLTabletTest {
  public:
   void SetUp() override {
@@ -0,0 +1,188 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/session.h"
+#include "yb/client/transaction.h"
+#include "yb/client/txn-test-base.h"
+
+#include "yb/util/atomic.h"
+#include "yb/util/test_thread_holder.h"
+#include "yb/util/tsan_util.h"
+
+using namespace std::literals;
+
+DECLARE_bool(enable_single_shard_commit);
+
+namespace yb {
+namespace client {
+
+class SingleShardTxnTest : public TransactionTestBase<MiniCluster> {
+ protected:
+  void SetUp() override {
+    SetNumTablets(1);
+    TransactionTestBase<MiniCluster>::SetUp();
+  }
+
+  // Writes kRowsPerTransaction rows starting from key in a single transaction.
+  Status WriteTransaction(int32_t key, int32_t value, bool flush_and_commit) {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    for (int32_t i = 0; i != kRowsPerTransaction; ++i) {
+      RETURN_NOT_OK(WriteRow(session, key + i, value, WriteOpType::INSERT, Flush::kFalse));
+    }
+    if (flush_and_commit) {
+      return txn->FlushAndCommitFuture(session).get();
+    }
+    RETURN_NOT_OK(session->Flush());
+    return txn->CommitFuture().get();
+  }
+
+  struct RunStats {
+    bool flush_and_commit = false;
+    int64_t transactions = 0;
+    MonoDelta total_latency;
+
+    std::string ToString() const {
+      return Format(
+          "{ flush_and_commit: $0 transactions: $1 avg_latency: $2 }",
+          flush_and_commit, transactions, total_latency / std::max<int64_t>(transactions, 1));
+    }
+  };
+
+  RunStats RunWorkload(bool flush_and_commit, int32_t key_base);
+
+  static constexpr int32_t kRowsPerTransaction = 3;
+};
+
+SingleShardTxnTest::RunStats SingleShardTxnTest::RunWorkload(
+    bool flush_and_commit, int32_t key_base) {
+  constexpr int kThreads = 4;
+  constexpr int32_t kKeysPerThread = 1000000;
+
+  TestThreadHolder thread_holder;
+  std::atomic<int64_t> transactions{0};
+  std::atomic<int64_t> total_latency_us{0};
+  for (int i = 0; i != kThreads; ++i) {
+    thread_holder.AddThreadFunctor(
+        [this, &stop = thread_holder.stop_flag(), &transactions, &total_latency_us,
+         flush_and_commit, key = key_base + i * kKeysPerThread] () mutable {
+      while (!stop.load(std::memory_order_acquire)) {
+        auto start = MonoTime::Now();
+        ASSERT_OK(WriteTransaction(key, key, flush_and_commit));
+        total_latency_us += (MonoTime::Now() - start).ToMicroseconds();
+        ++transactions;
+        key += kRowsPerTransaction;
+      }
+    });
+  }
+  thread_holder.WaitAndStop(RegularBuildVsSanitizers(10s, 30s));
+
+  RunStats result;
+  result.flush_and_commit = flush_and_commit;
+  result.transactions = transactions.load();
+  result.total_latency = MonoDelta::FromMicroseconds(total_latency_us.load());
+  return result;
+}
+
+TEST_F(SingleShardTxnTest, WriteSingleShard) {
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kValue = 10;
+
+  ASSERT_OK(WriteTransaction(kKey, kValue, /* flush_and_commit= */ true));
+  // Operations were applied directly to the regular DB, so there are no intents to resolve.
+  ASSERT_EQ(CountRunningTransactions(), 0U);
+
+  auto session = CreateSession();
+  for (int32_t i = 0; i != kRowsPerTransaction; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(SelectRow(session, kKey + i)), kValue);
+  }
+}
+
+// Read time could be picked when transaction starts, as YSQL does, without reading anything.
+// Such transaction still could be committed as a single-shard write.
+TEST_F(SingleShardTxnTest, WriteSingleShardWithReadTime) {
+  constexpr int32_t kKey = 1;
+  constexpr int32_t kValue = 10;
+
+  auto txn = CreateTransaction(SetReadTime::kTrue);
+  auto session = CreateSession(txn);
+  for (int32_t i = 0; i != kRowsPerTransaction; ++i) {
+    ASSERT_OK(WriteRow(session, kKey + i, kValue, WriteOpType::INSERT, Flush::kFalse));
+  }
+  txn->RequestSingleShardFlush();
+  ASSERT_OK(session->Flush());
+  ASSERT_EQ(CountRunningTransactions(), 0U);
+  ASSERT_OK(txn->CommitFuture().get());
+
+  session = CreateSession();
+  for (int32_t i = 0; i != kRowsPerTransaction; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(SelectRow(session, kKey + i)), kValue);
+  }
+}
+
+// Transaction that has read something should use regular commit, so conflicts with writes
+// after its read time are detected.
+TEST_F(SingleShardTxnTest, FallbackAfterRead) {
+  constexpr int32_t kKey = 1;
+
+  ASSERT_OK(WriteRow(CreateSession(), kKey, 1));
+
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  ASSERT_EQ(ASSERT_RESULT(SelectRow(session, kKey)), 1);
+  ASSERT_OK(WriteRow(CreateSession(), kKey, 2));
+  ASSERT_OK(WriteRow(session, kKey, 3, WriteOpType::INSERT, Flush::kFalse));
+  ASSERT_NOK(txn->FlushAndCommitFuture(session).get());
+
+  ASSERT_EQ(ASSERT_RESULT(SelectRow(CreateSession(), kKey)), 2);
+}
+
+// Single-shard write that conflicts with a pending transaction. Exactly one of them should
+// succeed.
+TEST_F(SingleShardTxnTest, ConflictWithPending) {
+  constexpr int32_t kKey = 1;
+
+  auto txn1 = CreateTransaction();
+  auto session1 = CreateSession(txn1);
+  ASSERT_OK(WriteRow(session1, kKey, 1));
+
+  auto txn2 = CreateTransaction();
+  auto session2 = CreateSession(txn2);
+  ASSERT_OK(WriteRow(session2, kKey, 2, WriteOpType::INSERT, Flush::kFalse));
+  auto status2 = txn2->FlushAndCommitFuture(session2).get();
+  auto status1 = txn1->CommitFuture().get();
+  LOG(INFO) << "Pending transaction: " << status1 << ", single-shard write: " << status2;
+
+  ASSERT_NE(status1.ok(), status2.ok());
+  ASSERT_EQ(ASSERT_RESULT(SelectRow(CreateSession(), kKey)), status1.ok() ? 1 : 2);
+}
+
+// Compares latency and throughput of single-tablet transactions, committed via intents and
+// status tablet, and written as single-shard operations.
+TEST_F(SingleShardTxnTest, YB_DISABLE_TEST_IN_TSAN(Benchmark)) {
+  auto regular = RunWorkload(/* flush_and_commit= */ false, 0);
+  LOG(INFO) << "Regular commit: " << regular.ToString();
+  auto single_shard = RunWorkload(/* flush_and_commit= */ true, 100000000);
+  LOG(INFO) << "Single-shard commit: " << single_shard.ToString();
+
+  ASSERT_GT(regular.transactions, 0);
+  ASSERT_GT(single_shard.transactions, 0);
+
+  SetAtomicFlag(false, &FLAGS_enable_single_shard_commit);
+  auto disabled = RunWorkload(/* flush_and_commit= */ true, 200000000);
+  LOG(INFO) << "Single-shard commit disabled: " << disabled.ToString();
+  ASSERT_GT(disabled.transactions, 0);
+}
+
+} // namespace client
+} // namespace yb
@@ -68,6 +68,8 @@ DECLARE_int32(TEST_inject_load_transaction_delay_ms);
 DECLARE_int32(TEST_inject_mvcc_delay_add_leader_pending_ms);
 DECLARE_int32(TEST_inject_status_resolver_delay_ms);
 DECLARE_int32(log_min_seconds_to_retain);
+DECLARE_int32(txn_apply_intents_chunk_records);
+DECLARE_int32(txn_apply_intents_parallelism);
 DECLARE_int32(txn_max_apply_batch_records);
 DECLARE_int64(transaction_rpc_timeout_ms);
 DECLARE_uint64(max_clock_skew_usec);
@@ -818,6 +820,13 @@ TEST_F(SnapshotTxnTest, MultiWriteWithRestartAndLongApply) {
   TestMultiWriteWithRestart();
 }
 
+TEST_F(SnapshotTxnTest, MultiWriteWithRestartAndParallelApply) {
+  FLAGS_txn_max_apply_batch_records = 12;
+  FLAGS_txn_apply_intents_chunk_records = 2;
+  FLAGS_txn_apply_intents_parallelism = 4;
+  TestMultiWriteWithRestart();
+}
+
 using RemoteBootstrapOnStartBase = TransactionCustomLogSegmentSizeTest<128, SnapshotTxnTest>;
 
 void SnapshotTxnTest::TestRemoteBootstrap() {
@@ -21,6 +21,7 @@
 #include "yb/client/client.h"
 #include "yb/client/in_flight_op.h"
 #include "yb/client/meta_cache.h"
+#include "yb/client/session.h"
 #include "yb/client/transaction_cleanup.h"
 #include "yb/client/transaction_manager.h"
 #include "yb/client/transaction_rpc.h"
@@ -37,6 +38,7 @@
 
 #include "yb/tserver/tserver_service.pb.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/format.h"
@@ -74,6 +76,13 @@ DECLARE_uint64(max_clock_skew_usec);
 DEFINE_test_flag(int32, transaction_inject_flushed_delay_ms, 0,
                  "Inject delay before processing flushed operations by transaction.");
 
+DEFINE_bool(enable_single_shard_commit, true,
+            "Whether YBTransaction::FlushAndCommit writes operations of a transaction that did not "
+            "write or read anything before, and touches a single tablet, as a single-shard "
+            "operation, bypassing intents and the transaction status tablet.");
+TAG_FLAG(enable_single_shard_commit, advanced);
+TAG_FLAG(enable_single_shard_commit, runtime);
+
 DEFINE_test_flag(bool, disable_proactive_txn_cleanup_on_abort, false,
                 "Disable cleanup of intents in abort path.");
 
@@ -324,8 +333,31 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
           }
           return false;
         }
+        if (single_shard_write_) {
+          auto status = STATUS(
+              IllegalState, "Transaction already flushed its operations as single-shard write");
+          lock.unlock();
+          if (waiter) {
+            waiter(status);
+          }
+          return false;
+        }
+        if (initial && single_shard_commit_requested_) {
+          single_shard_commit_requested_ = false;
+          if (CouldWriteSingleShardUnlocked(*ops_info)) {
+            // Operations are sent without transaction metadata, so the tablet applies them
+            // directly to the regular DB as a single Raft operation.
+            single_shard_write_ = true;
+            ops_info->metadata = {};
+            VLOG_WITH_PREFIX(2) << "Prepare, single-shard write: " << AsString(ops_info->groups);
+            return true;
+          }
+        }
         for (auto& group : ops_info->groups) {
           auto& first_op = *group.begin;
+          if (initial && first_op.yb_op->group() != OpGroup::kWrite) {
+            has_reads_ = true;
+          }
           const auto should_add_intents = first_op.yb_op->should_add_intents(metadata_.isolation);
           const auto& tablet = first_op.tablet;
           const auto& tablet_id = tablet->tablet_id();
@@ -396,7 +428,13 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
       std::lock_guard<std::mutex> lock(mutex_);
       running_requests_ -= ops.size();
 
-      if (status.ok()) {
+      if (single_shard_write_) {
+        // Nothing was written to intents, so there is nothing to abort on failure, and
+        // read time used by the single-shard write is not related to the transaction.
+        if (!status.ok()) {
+          SetErrorUnlocked(status, "Single-shard flush");
+        }
+      } else if (status.ok()) {
         if (used_read_time && metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
           const bool read_point_already_set = static_cast<bool>(read_point_.GetReadTime());
 #ifndef NDEBUG
@@ -493,6 +531,32 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
     DoCommit(deadline, seal_only, Status::OK(), transaction);
   }
 
+  void RequestSingleShardFlush() EXCLUDES(mutex_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    single_shard_commit_requested_ = GetAtomicFlag(&FLAGS_enable_single_shard_commit);
+  }
+
+  void FlushAndCommit(
+      const YBSessionPtr& session, CoarseTimePoint deadline, CommitCallback callback)
+      EXCLUDES(mutex_) {
+    auto transaction = transaction_->shared_from_this();
+    RequestSingleShardFlush();
+    session->FlushAsync(
+        [this, transaction, session, deadline, callback = std::move(callback)](
+            FlushStatus* flush_status) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        single_shard_commit_requested_ = false;
+      }
+      if (!flush_status->status.ok()) {
+        callback(flush_status->status);
+        return;
+      }
+      // After single-shard write transaction has no intents, so commit completes without RPCs.
+      Commit(deadline, SealOnly::kFalse, callback);
+    });
+  }
+
   void Abort(CoarseTimePoint deadline) EXCLUDES(mutex_) {
     auto transaction = transaction_->shared_from_this();
 
@@ -1181,6 +1245,31 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
     callback(child_txn_data_pb);
   }
 
+  // Operations could be written as a single-shard operation, when it is the only write of this
+  // transaction, i.e. there are no intents and operations in flight, all operations are sent
+  // to a single tablet in one RPC, and transaction did not read anything. So there is nothing
+  // that could require read restart or conflict with writes of other transactions after the
+  // read time. Note that read time could be picked without reading, e.g. YSQL assigns it when
+  // transaction starts.
+  bool CouldWriteSingleShardUnlocked(const internal::InFlightOpsGroupsWithMetadata& ops_info)
+      REQUIRES(mutex_) {
+    if (child_ || !tablets_.empty() || has_reads_ ||
+        ops_info.groups.size() != 1 || IsRestartRequired() ||
+        state_.load(std::memory_order_acquire) != TransactionState::kRunning) {
+      return false;
+    }
+    const auto& group = ops_info.groups.front();
+    if (running_requests_ != static_cast<size_t>(std::distance(group.begin, group.end))) {
+      return false;
+    }
+    for (auto it = group.begin; it != group.end; ++it) {
+      if (it->yb_op->group() != OpGroup::kWrite) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   CHECKED_STATUS CheckCouldCommitUnlocked(SealOnly seal_only) REQUIRES(mutex_) {
     RETURN_NOT_OK(CheckRunningUnlocked());
     if (child_) {
@@ -1260,6 +1349,12 @@ class YBTransaction::Impl final : public internal::TxnBatcherIf {
   size_t running_requests_ GUARDED_BY(mutex_) = 0;
   // Set to true after commit record is replicated. Used only during transaction sealing.
   bool commit_replicated_ = false;
+  // Next flush could be written as single-shard operation, see RequestSingleShardFlush.
+  bool single_shard_commit_requested_ GUARDED_BY(mutex_) = false;
+  // Transaction sent read operations.
+  bool has_reads_ GUARDED_BY(mutex_) = false;
+  // Operations of this transaction were written as single-shard operation.
+  bool single_shard_write_ GUARDED_BY(mutex_) = false;
 };
 
 CoarseTimePoint AdjustDeadline(CoarseTimePoint deadline) {
@@ -1336,6 +1431,22 @@ ConsistentReadPoint& YBTransaction::read_point() {
   return impl_->read_point();
 }
 
+void YBTransaction::RequestSingleShardFlush() {
+  impl_->RequestSingleShardFlush();
+}
+
+void YBTransaction::FlushAndCommit(
+    const YBSessionPtr& session, CoarseTimePoint deadline, CommitCallback callback) {
+  impl_->FlushAndCommit(session, AdjustDeadline(deadline), std::move(callback));
+}
+
+std::future<Status> YBTransaction::FlushAndCommitFuture(
+    const YBSessionPtr& session, CoarseTimePoint deadline) {
+  return MakeFuture<Status>([this, session, deadline](auto callback) {
+    impl_->FlushAndCommit(session, AdjustDeadline(deadline), std::move(callback));
+  });
+}
+
 std::future<Status> YBTransaction::CommitFuture(
     CoarseTimePoint deadline, SealOnly seal_only) {
   return MakeFuture<Status>([this, deadline, seal_only](auto callback) {
@@ -99,6 +99,26 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
 
   void Commit(CommitCallback callback);
 
+  // Requests the next flush of this transaction to be written as a single-shard operation.
+  // Caller should commit the transaction right after this flush.
+  //
+  // When this flush is the only write of the transaction, all its operations go to a single
+  // tablet, and the transaction did not read anything before, operations are written as
+  // a single-shard operation. I.e. they are applied directly to the regular DB in a single Raft
+  // operation, so neither intents nor the status tablet are involved, and commit completes
+  // without RPCs. Otherwise operations are flushed and transaction is committed as usual.
+  // Reads performed outside of this transaction at its read point are not visible to it, so
+  // caller should not request single-shard flush after such reads.
+  void RequestSingleShardFlush();
+
+  // Flushes operations of the session, that should be bound to this transaction, and commits
+  // this transaction, using single-shard flush when possible. See RequestSingleShardFlush.
+  void FlushAndCommit(
+      const YBSessionPtr& session, CoarseTimePoint deadline, CommitCallback callback);
+
+  std::future<Status> FlushAndCommitFuture(
+      const YBSessionPtr& session, CoarseTimePoint deadline = CoarseTimePoint());
+
   // Utility function for Commit.
   std::future<Status> CommitFuture(
       CoarseTimePoint deadline = CoarseTimePoint(), SealOnly seal_only = SealOnly::kFalse);
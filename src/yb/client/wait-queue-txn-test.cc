@@ -0,0 +1,176 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/session.h"
+#include "yb/client/transaction.h"
+#include "yb/client/txn-test-base.h"
+
+#include "yb/common/transaction_error.h"
+
+#include "yb/integration-tests/mini_cluster.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_thread_holder.h"
+#include "yb/util/tsan_util.h"
+
+using namespace std::literals;
+
+METRIC_DECLARE_histogram(wait_queue_wait_time);
+METRIC_DECLARE_counter(wait_queue_deadlocks);
+
+DECLARE_bool(enable_wait_queues);
+
+namespace yb {
+namespace client {
+
+class WaitQueueTxnTest : public TransactionTestBase<MiniCluster> {
+ protected:
+  struct RunStats {
+    bool wait_queues = false;
+    int64_t committed = 0;
+    int64_t failed = 0;
+    int64_t waits = 0;
+
+    std::string ToString() const {
+      return YB_STRUCT_TO_STRING(wait_queues, committed, failed, waits);
+    }
+  };
+
+  int64_t TotalWaits() {
+    int64_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+      auto entity = peer->tablet()->GetTabletMetricsEntity();
+      result += METRIC_wait_queue_wait_time.Instantiate(entity)->TotalCount();
+    }
+    return result;
+  }
+
+  int64_t TotalDeadlocks() {
+    int64_t result = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+      auto entity = peer->tablet()->GetTabletMetricsEntity();
+      result += METRIC_wait_queue_deadlocks.Instantiate(entity)->value();
+    }
+    return result;
+  }
+
+  // Runs transactions that write to a few hot keys from many threads.
+  RunStats RunContention(bool wait_queues);
+};
+
+WaitQueueTxnTest::RunStats WaitQueueTxnTest::RunContention(bool wait_queues) {
+  constexpr int kThreads = 16;
+  constexpr int kKeys = 4;
+
+  FLAGS_enable_wait_queues = wait_queues;
+  auto waits_before = TotalWaits();
+
+  TestThreadHolder thread_holder;
+  std::atomic<int64_t> committed{0};
+  std::atomic<int64_t> failed{0};
+  for (int i = 0; i != kThreads; ++i) {
+    thread_holder.AddThreadFunctor(
+        [this, &stop = thread_holder.stop_flag(), &committed, &failed] {
+      while (!stop.load(std::memory_order_acquire)) {
+        auto txn = CreateTransaction();
+        auto session = CreateSession(txn);
+        auto key = RandomUniformInt(0, kKeys - 1);
+        auto status = ResultToStatus(WriteRow(session, key, key));
+        if (status.ok()) {
+          status = txn->CommitFuture().get();
+        }
+        if (status.ok()) {
+          ++committed;
+        } else {
+          ++failed;
+        }
+      }
+    });
+  }
+  thread_holder.WaitAndStop(RegularBuildVsSanitizers(10s, 30s));
+
+  RunStats result;
+  result.wait_queues = wait_queues;
+  result.committed = committed.load();
+  result.failed = failed.load();
+  result.waits = TotalWaits() - waits_before;
+  return result;
+}
+
+// Compares throughput of contended transactions, that fail on conflict, and that wait for
+// conflicting transactions in wait queues.
+TEST_F(WaitQueueTxnTest, YB_DISABLE_TEST_IN_TSAN(Contention)) {
+  auto fail_on_conflict = RunContention(/* wait_queues= */ false);
+  LOG(INFO) << "Fail on conflict: " << fail_on_conflict.ToString();
+  auto wait_on_conflict = RunContention(/* wait_queues= */ true);
+  LOG(INFO) << "Wait on conflict: " << wait_on_conflict.ToString();
+
+  ASSERT_GT(fail_on_conflict.committed, 0);
+  ASSERT_GT(wait_on_conflict.committed, 0);
+  ASSERT_EQ(fail_on_conflict.waits, 0);
+  ASSERT_GT(wait_on_conflict.waits, 0);
+  // Waiting for conflicting transactions should commit more and fail less than failing on
+  // conflict and retrying.
+  ASSERT_GT(wait_on_conflict.committed, fail_on_conflict.committed);
+  ASSERT_LT(wait_on_conflict.failed, fail_on_conflict.failed);
+}
+
+// Two transactions lock keys in opposite order, one of them should be chosen as deadlock victim,
+// while the other one should complete.
+TEST_F(WaitQueueTxnTest, Deadlock) {
+  constexpr int kKey1 = 1;
+  constexpr int kKey2 = 2;
+
+  FLAGS_enable_wait_queues = true;
+
+  auto txn1 = CreateTransaction();
+  auto session1 = CreateSession(txn1);
+  ASSERT_OK(WriteRow(session1, kKey1, 1));
+  auto txn2 = CreateTransaction();
+  auto session2 = CreateSession(txn2);
+  ASSERT_OK(WriteRow(session2, kKey2, 2));
+
+  ASSERT_OK(WriteRow(session1, kKey2, 1, WriteOpType::INSERT, Flush::kFalse));
+  auto flush1 = session1->FlushFuture();
+  ASSERT_OK(WriteRow(session2, kKey1, 2, WriteOpType::INSERT, Flush::kFalse));
+  auto flush2 = session2->FlushFuture();
+
+  std::future<FlushStatus>* victim_flush = nullptr;
+  ASSERT_OK(WaitFor([&] {
+    if (IsReady(flush1)) {
+      victim_flush = &flush1;
+    } else if (IsReady(flush2)) {
+      victim_flush = &flush2;
+    }
+    return victim_flush != nullptr;
+  }, 30s, "Deadlock detected"));
+
+  auto victim_status = victim_flush->get().status;
+  ASSERT_EQ(TransactionError(victim_status).value(), TransactionErrorCode::kDeadlock)
+      << victim_status;
+  ASSERT_EQ(TotalDeadlocks(), 1);
+
+  auto victim = victim_flush == &flush1 ? txn1 : txn2;
+  auto survivor = victim_flush == &flush1 ? txn2 : txn1;
+  auto& survivor_flush = victim_flush == &flush1 ? flush2 : flush1;
+  victim->Abort();
+  ASSERT_OK(survivor_flush.get().status);
+  ASSERT_OK(survivor->CommitFuture().get());
+}
+
+} // namespace client
+} // namespace yb
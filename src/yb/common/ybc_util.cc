@@ -188,6 +188,9 @@ uint32_t YBCStatusPgsqlError(YBCStatus s) {
         case TransactionErrorCode::kSnapshotTooOld:
           result = YBPgErrorCode::YB_PG_SNAPSHOT_TOO_OLD;
           break;
+        case TransactionErrorCode::kDeadlock:
+          result = YBPgErrorCode::YB_PG_T_R_DEADLOCK_DETECTED;
+          break;
         case TransactionErrorCode::kNone: FALLTHROUGH_INTENDED;
         default:
           result = YBPgErrorCode::YB_PG_INTERNAL_ERROR;
@@ -52,6 +52,10 @@ class ConsensusContext {
   // Returns the current safe time, so we can send it from leaders to followers.
   virtual Result<HybridTime> PreparePeerRequest() = 0;
 
+  // Returns the hybrid time, such that this leader would not replicate operations with lower or
+  // equal hybrid time. Returns invalid hybrid time when safe time propagation is disabled.
+  virtual Result<HybridTime> LeaderClosedTimestamp() = 0;
+
   // This is called every time majority-replicated watermarks (OpId / leader leases) change. This is
   // used for updating the "propagated safe time" value in MvccManager and unblocking readers
   // waiting for it to advance.
@@ -83,9 +83,17 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_bool(consensus_send_encoded_ops, false,
+            "Send operations to followers using their encoding cached in the log cache, so each "
+            "operation is serialized once for all peers instead of once per peer.");
+TAG_FLAG(consensus_send_encoded_ops, advanced);
+TAG_FLAG(consensus_send_encoded_ops, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
+DECLARE_int32(consensus_max_inflight_requests_per_peer);
 
 DECLARE_bool(enable_multi_raft_heartbeat_batcher);
+DECLARE_bool(enable_multi_raft_update_batching);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
                  "Fraction of the time when the leader will crash just before sending an "
@@ -261,10 +269,11 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
     return;
   }
 
-  // If the peer doesn't need remote bootstrap, but it is a PRE_VOTER or PRE_OBSERVER in the config,
-  // we need to promote it.
+  // If the peer doesn't need remote bootstrap, but it is a PRE_VOTER, PRE_OBSERVER or PRE_WITNESS
+  // in the config, we need to promote it.
   if (last_exchange_successful &&
-      (member_type == PeerMemberType::PRE_VOTER || member_type == PeerMemberType::PRE_OBSERVER)) {
+      (member_type == PeerMemberType::PRE_VOTER || member_type == PeerMemberType::PRE_OBSERVER ||
+       member_type == PeerMemberType::PRE_WITNESS)) {
     if (PREDICT_TRUE(consensus_)) {
       auto uuid = peer_pb_.permanent_uuid();
       // Remove these here, before we drop the locks.
@@ -360,9 +369,90 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   minimum_viable_heartbeat_ = cur_heartbeat_id_ + 1;
   processing_lock.unlock();
   performing_update_lock.release();
+  if (multi_raft_batcher_ && FLAGS_enable_multi_raft_update_batching) {
+    // Ops are not owned by the request, so msgs_holder keeps them until the batch is complete.
+    multi_raft_batcher_->AddRequestToBatch(&update_request_, &update_response_,
+                                           std::bind(&Peer::ProcessUpdateResponse,
+                                                     retain_self, _1),
+                                           std::move(msgs_holder));
+    return;
+  }
   controller_.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  // Should be checked before ops are moved to the request tail below.
+  const bool pipeline = update_request_.ops_size() != 0 &&
+                        GetAtomicFlag(&FLAGS_consensus_max_inflight_requests_per_peer) > 1;
+  if (FLAGS_consensus_send_encoded_ops && update_request_.ops_size() != 0) {
+    // Encoded ops are appended after the rest of the request, that is parsed by the follower
+    // exactly as if they were present in the request itself.
+    controller_.set_request_tail(queue_->EncodeOps(update_request_.ops()));
+    CleanRequestOps(&update_request_);
+  }
   proxy_->UpdateAsync(&update_request_, trigger_mode, &update_response_, &controller_,
                       std::bind(&Peer::ProcessResponse, retain_self));
+  if (pipeline) {
+    SendPipelinedRequests();
+  }
+}
+
+void Peer::SendPipelinedRequests() {
+  auto retain_self = shared_from_this();
+  for (;;) {
+    auto call = std::make_shared<PipelinedCall>();
+    {
+      auto processing_lock = StartProcessingUnlocked();
+      if (!processing_lock.owns_lock()) {
+        return;
+      }
+      bool needs_remote_bootstrap = false;
+      bool pipelined = true;
+      auto status = queue_->RequestForPeer(
+          peer_pb_.permanent_uuid(), &call->request, &call->msgs_holder, &needs_remote_bootstrap,
+          nullptr /* member_type */, nullptr /* last_exchange_successful */, &pipelined);
+      if (!status.ok() || !pipelined) {
+        VLOG_IF_WITH_PREFIX(1, !status.ok())
+            << "Could not obtain pipelined request from queue: " << status;
+        return;
+      }
+    }
+
+    call->request.set_tablet_id(tablet_id_);
+    call->request.set_caller_uuid(leader_uuid_);
+    call->request.set_dest_uuid(peer_pb_.permanent_uuid());
+    call->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+    if (FLAGS_consensus_send_encoded_ops) {
+      call->controller.set_request_tail(queue_->EncodeOps(call->request.ops()));
+      CleanRequestOps(&call->request);
+    }
+    heartbeater_->Snooze();
+    proxy_->UpdateAsync(&call->request, RequestTriggerMode::kNonEmptyOnly, &call->response,
+                        &call->controller,
+                        std::bind(&Peer::ProcessPipelinedResponse, retain_self, call));
+  }
+}
+
+void Peer::ProcessPipelinedResponse(const std::shared_ptr<PipelinedCall>& call) {
+  auto status = call->controller.status();
+  if (status.ok()) {
+    status = call->controller.thread_pool_failure();
+  }
+  call->msgs_holder.Reset();
+
+  bool more_pending;
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return;
+    }
+    more_pending = ProcessResponseWithStatus(status, &call->response, /* pipelined= */ true);
+  }
+
+  if (more_pending) {
+    // Keep the window full while the regular request is in flight, otherwise send the next
+    // regular request.
+    SendPipelinedRequests();
+    WARN_NOT_OK(SignalRequest(RequestTriggerMode::kNonEmptyOnly),
+                "Failed to signal request after pipelined response");
+  }
 }
 
 std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
@@ -376,7 +466,16 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
 }
 
 bool Peer::ProcessResponseWithStatus(const Status& status,
-                                     ConsensusResponsePB* response) {
+                                     ConsensusResponsePB* response,
+                                     bool pipelined) {
+  // Most errors are not passed to the queue, so it should be notified that operations sent after
+  // the failed pipelined request could be missing at the peer.
+  bool passed_to_queue = false;
+  auto se = ScopeExit([this, pipelined, &passed_to_queue] {
+    if (pipelined && !passed_to_queue) {
+      queue_->PipelinedRequestFailed(peer_pb_.permanent_uuid());
+    }
+  });
   if (!status.ok()) {
     if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
@@ -440,7 +539,8 @@ bool Peer::ProcessResponseWithStatus(const Status& status,
   }
 
   failed_attempts_ = 0;
-  return queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), *response);
+  passed_to_queue = true;
+  return queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), *response, pipelined);
 }
 
 void Peer::ProcessResponse() {
@@ -452,6 +552,11 @@ void Peer::ProcessResponse() {
   controller_.Reset();
   CleanRequestOps(&update_request_);
 
+  ProcessUpdateResponse(status);
+}
+
+void Peer::ProcessUpdateResponse(const Status& status) {
+  DCHECK(performing_update_mutex_.is_locked()) << "Got a response when nothing was pending.";
   auto performing_update_lock = LockPerformingUpdate(std::adopt_lock);
   auto processing_lock = StartProcessingUnlocked();
   if (!processing_lock.owns_lock()) {
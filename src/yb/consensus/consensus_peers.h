@@ -50,6 +50,7 @@
 #include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/metadata.pb.h"
+#include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/integral_types.h"
 
@@ -186,12 +187,32 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // requires IO or may block.
   void ProcessResponse();
 
+  // Processes the response to update_request_ with the status of the RPC that carried it.
+  void ProcessUpdateResponse(const Status& status);
+
   // Signals that a heartbeat response was received from the peer.
   void ProcessHeartbeatResponse(const Status& status);
 
+  // State of a pipelined request, i.e. the one sent while update_request_ is in flight.
+  struct PipelinedCall {
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    rpc::RpcController controller;
+    // Declared after request, so ops are extracted from it before the request is destroyed.
+    ReplicateMsgsHolder msgs_holder;
+  };
+
+  // Sends pipelined requests with operations following the ones in flight, until the window of
+  // in-flight requests is full or there are no more operations to send.
+  void SendPipelinedRequests();
+
+  // Handles the response to a pipelined request.
+  void ProcessPipelinedResponse(const std::shared_ptr<PipelinedCall>& call);
+
   // Returns true if there are more pending ops to process, false otherwise.
   bool ProcessResponseWithStatus(const Status& status,
-                                 ConsensusResponsePB* response);
+                                 ConsensusResponsePB* response,
+                                 bool pipelined = false);
 
   // Fetch the desired remote bootstrap request from the queue and send it to the peer. The callback
   // goes to ProcessRemoteBootstrapResponse().
@@ -55,6 +55,7 @@
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_uint64(consensus_max_batch_size_bytes);
+DECLARE_int32(consensus_max_inflight_requests_per_peer);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -215,6 +216,52 @@ class ConsensusQueueTest : public YBTest {
     SetLastReceivedAndLastCommitted(response, last_received, last_received.index);
   }
 
+  // Asks the queue for a pipelined request to the peer, returns whether it was assembled.
+  Result<bool> PipelinedRequestForPeer(ConsensusRequestPB* request, ReplicateMsgsHolder* refs) {
+    bool needs_remote_bootstrap = false;
+    bool pipelined = true;
+    RETURN_NOT_OK(queue_->RequestForPeer(
+        kPeerUuid, request, refs, &needs_remote_bootstrap, nullptr /* member_type */,
+        nullptr /* last_exchange_successful */, &pipelined));
+    return pipelined;
+  }
+
+  // Acks all operations of the request on behalf of the peer.
+  bool AckRequest(const ConsensusRequestPB& request, bool pipelined) {
+    ConsensusResponsePB response;
+    response.set_responder_uuid(kPeerUuid);
+    SetLastReceivedAndLastCommitted(
+        &response, OpId::FromPB(request.ops(request.ops_size() - 1).id()));
+    return queue_->ResponseFromPeer(kPeerUuid, response, pipelined);
+  }
+
+  // Prepares the queue for the pipelining tests. Operations are split between several requests,
+  // and the last exchange with the peer is successful.
+  void SetupPipelining() {
+    FLAGS_consensus_max_inflight_requests_per_peer = 3;
+    FLAGS_consensus_max_batch_size_bytes = 1024;
+
+    queue_->Init(OpId::Min());
+    queue_->SetLeaderMode(
+        OpId::Min(), OpId::Min().term, OpId::Min(), BuildRaftConfigPBForTests(2));
+
+    ConsensusRequestPB request;
+    ConsensusResponsePB response;
+    response.set_responder_uuid(kPeerUuid);
+    ASSERT_TRUE(UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId()));
+    AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, kNumMessages);
+
+    // Pipelining requires a successful exchange with the peer.
+    ReplicateMsgsHolder refs;
+    ASSERT_FALSE(ASSERT_RESULT(PipelinedRequestForPeer(&request, &refs)));
+
+    bool needs_remote_bootstrap;
+    ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+    ASSERT_GT(request.ops_size(), 0);
+    ASSERT_LT(request.ops_size(), kNumMessages / 4);
+    ASSERT_TRUE(AckRequest(request, /* pipelined= */ false));
+  }
+
  protected:
   std::unique_ptr<TestRaftConsensusQueueIface> consensus_;
   const Schema schema_;
@@ -926,5 +973,95 @@ TEST_F(ConsensusQueueTest, TestReadReplicatedMessagesForCDC) {
   ASSERT_EQ(last_committed_index - start, read_result.messages.size());
 }
 
+// Tests that pipelined requests carry operations following the ones in flight, that the window of
+// in-flight requests is respected, and that responses arriving out of order don't move the peer's
+// watermark back.
+TEST_F(ConsensusQueueTest, TestPipelinedRequests) {
+  google::FlagSaver saver;
+  ASSERT_NO_FATALS(SetupPipelining());
+
+  ConsensusRequestPB request, pipelined_request1, pipelined_request2, pipelined_request3;
+  ReplicateMsgsHolder refs, pipelined_refs1, pipelined_refs2, pipelined_refs3;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_GT(request.ops_size(), 0);
+  ASSERT_FALSE(request.pipelined());
+
+  ASSERT_TRUE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request1, &pipelined_refs1)));
+  ASSERT_TRUE(pipelined_request1.pipelined());
+  ASSERT_EQ(OpId::FromPB(pipelined_request1.preceding_id()),
+            OpId::FromPB(request.ops(request.ops_size() - 1).id()));
+
+  ASSERT_TRUE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request2, &pipelined_refs2)));
+  ASSERT_EQ(OpId::FromPB(pipelined_request2.preceding_id()),
+            OpId::FromPB(pipelined_request1.ops(pipelined_request1.ops_size() - 1).id()));
+
+  // The window is full: the regular request and two pipelined ones are in flight.
+  ASSERT_FALSE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request3, &pipelined_refs3)));
+
+  // Responses arrive in reverse order.
+  const auto last_sent = OpId::FromPB(
+      pipelined_request2.ops(pipelined_request2.ops_size() - 1).id());
+  AckRequest(pipelined_request2, /* pipelined= */ true);
+  AckRequest(pipelined_request1, /* pipelined= */ true);
+  AckRequest(request, /* pipelined= */ false);
+
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(peer.last_received, last_sent);
+  ASSERT_EQ(peer.next_index, last_sent.index + 1);
+  ASSERT_EQ(peer.num_pipelined_requests, 0);
+
+  // The next request continues after the acked operations.
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_EQ(OpId::FromPB(request.preceding_id()), last_sent);
+}
+
+// Tests that after a failed pipelined request the operations that follow the last acked one are
+// sent again.
+TEST_F(ConsensusQueueTest, TestPipelinedRequestFailure) {
+  google::FlagSaver saver;
+  ASSERT_NO_FATALS(SetupPipelining());
+
+  ConsensusRequestPB request, pipelined_request1, pipelined_request2;
+  ReplicateMsgsHolder refs, pipelined_refs1, pipelined_refs2;
+  bool needs_remote_bootstrap;
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_TRUE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request1, &pipelined_refs1)));
+  ASSERT_TRUE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request2, &pipelined_refs2)));
+
+  const auto last_acked = OpId::FromPB(request.ops(request.ops_size() - 1).id());
+  AckRequest(request, /* pipelined= */ false);
+  queue_->PipelinedRequestFailed(kPeerUuid);
+
+  // No pipelining until the next successful exchange.
+  {
+    ConsensusRequestPB pipelined_request;
+    ReplicateMsgsHolder pipelined_refs;
+    ASSERT_FALSE(ASSERT_RESULT(PipelinedRequestForPeer(&pipelined_request, &pipelined_refs)));
+  }
+
+  // The peer waited for operations of the failed request, and refused the last pipelined one.
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  RefuseWithLogPropertyMismatch(&response, last_acked.ToPB<OpIdPB>(),
+                                last_acked.ToPB<OpIdPB>());
+  response.mutable_status()->set_last_committed_idx(last_acked.index);
+  ASSERT_TRUE(queue_->ResponseFromPeer(kPeerUuid, response, /* pipelined= */ true));
+
+  auto peer = queue_->GetTrackedPeerForTests(kPeerUuid);
+  ASSERT_EQ(peer.last_received, last_acked);
+  ASSERT_EQ(peer.num_pipelined_requests, 0);
+
+  // Operations of the failed request are sent again.
+  refs.Reset();
+  request.Clear();
+  ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+  ASSERT_FALSE(request.pipelined());
+  ASSERT_EQ(OpId::FromPB(request.preceding_id()), last_acked);
+  ASSERT_EQ(request.ops(0).id().index(), pipelined_request1.ops(0).id().index());
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -113,6 +113,13 @@ DEFINE_int32(consensus_lagging_follower_threshold, 10,
 TAG_FLAG(consensus_lagging_follower_threshold, advanced);
 TAG_FLAG(consensus_lagging_follower_threshold, runtime);
 
+DEFINE_int32(consensus_max_inflight_requests_per_peer, 1,
+             "Maximum number of requests carrying operations that the leader keeps in flight to "
+             "a single peer. Values greater than 1 pipeline replication, so the peer is not "
+             "limited to one batch of operations per round trip.");
+TAG_FLAG(consensus_max_inflight_requests_per_peer, advanced);
+TAG_FLAG(consensus_max_inflight_requests_per_peer, runtime);
+
 DEFINE_test_flag(bool, disallow_lmp_failures, false,
                  "Whether we disallow PRECEDING_ENTRY_DIDNT_MATCH failures for non new peers.");
 
@@ -167,10 +174,12 @@ std::string PeerMessageQueue::TrackedPeer::ToString() const {
   return Format(
       "{ peer: $0 is_new: $1 last_received: $2 next_index: $3 last_known_committed_idx: $4 "
       "is_last_exchange_successful: $5 needs_remote_bootstrap: $6 member_type: $7 "
-      "num_sst_files: $8 last_applied: $9 }",
+      "num_sst_files: $8 last_applied: $9 ",
       uuid, is_new, last_received, next_index, last_known_committed_idx,
       is_last_exchange_successful, needs_remote_bootstrap, PeerMemberType_Name(member_type),
-      num_sst_files, last_applied);
+      num_sst_files, last_applied) +
+      Format("num_pipelined_requests: $0 pipelined_next_index: $1 }",
+             num_pipelined_requests, pipelined_next_index);
 }
 
 void PeerMessageQueue::TrackedPeer::ResetLeaderLeases() {
@@ -200,13 +209,15 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
                                    const string& tablet_id,
                                    const server::ClockPtr& clock,
                                    ConsensusContext* context,
-                                   unique_ptr<ThreadPoolToken> raft_pool_token)
+                                   unique_ptr<ThreadPoolToken> raft_pool_token,
+                                   unique_ptr<ThreadPoolToken> log_cache_prefetch_token)
     : raft_pool_observers_token_(std::move(raft_pool_token)),
       local_peer_pb_(local_peer_pb),
       local_peer_uuid_(local_peer_pb_.has_permanent_uuid() ? local_peer_pb_.permanent_uuid()
                                                            : string()),
       tablet_id_(tablet_id),
-      log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id),
+      log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id,
+                 std::move(log_cache_prefetch_token)),
       operations_mem_tracker_(
           MemTracker::FindOrCreateTracker("OperationsFromDisk", parent_tracker)),
       metrics_(metric_entity),
@@ -264,6 +275,7 @@ void PeerMessageQueue::SetNonLeaderMode() {
   queue_state_.active_config.reset();
   queue_state_.mode = Mode::NON_LEADER;
   queue_state_.majority_size_ = -1;
+  log_cache_.SetReplicatedToAllIndex(std::numeric_limits<int64_t>::max());
   LOG_WITH_PREFIX_UNLOCKED(INFO) << "Queue going to NON_LEADER mode. State: "
       << queue_state_.ToString();
 }
@@ -428,11 +440,18 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgsHolder* msgs_holder,
                                         bool* needs_remote_bootstrap,
                                         PeerMemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        bool* pipelined) {
   static constexpr uint64_t kSendUnboundedLogOps = std::numeric_limits<uint64_t>::max();
   DCHECK(request->ops().empty()) << request->ShortDebugString();
 
+  const bool want_pipelined = pipelined && *pipelined;
+  const int64_t max_inflight_requests =
+      GetAtomicFlag(&FLAGS_consensus_max_inflight_requests_per_peer);
   OpId preceding_id;
+  // Set when operations are already in flight to the peer and this request continues after them.
+  bool send_after_in_flight = false;
+  OpId last_acked_op_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
   bool is_voter = false;
   bool is_new;
@@ -455,6 +474,14 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       return STATUS(NotFound, "Peer not tracked or queue not in leader mode.");
     }
 
+    if (want_pipelined &&
+        (peer->is_new || !peer->is_last_exchange_successful || peer->needs_remote_bootstrap ||
+         peer->num_pipelined_requests + 1 >= max_inflight_requests ||
+         !log_cache_.HasOpBeenWritten(peer->pipelined_next_index))) {
+      *pipelined = false;
+      return Status::OK();
+    }
+
     HybridTime now_ht;
 
     is_new = peer->is_new;
@@ -478,9 +505,14 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
       // Because of coarse clocks we subtract 2ms, to be sure that our local version of lease
       // does not expire after it expires at follower.
-      peer->leader_lease_expiration.last_sent =
-          CoarseMonoClock::Now() + leader_lease_duration_ms * 1ms - kCoarseClockPrecision * 2;
-      peer->leader_ht_lease_expiration.last_sent = ht_lease_expiration_micros;
+      //
+      // Responses to pipelined requests could arrive out of order, so the leases are only
+      // accounted for the regular request. It keeps our local version of lease conservative.
+      if (!want_pipelined) {
+        peer->leader_lease_expiration.last_sent =
+            CoarseMonoClock::Now() + leader_lease_duration_ms * 1ms - kCoarseClockPrecision * 2;
+        peer->leader_ht_lease_expiration.last_sent = ht_lease_expiration_micros;
+      }
     } else {
       now_ht = clock_->Now();
       request->clear_leader_lease_duration_ms();
@@ -520,6 +552,12 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       queue_state_.committed_op_id.ToPB(request->mutable_committed_op_id());
     }
 
+    if (IsWitnessMemberType(peer->member_type) && !queue_state_.majority_applied_op_id.empty()) {
+      queue_state_.majority_applied_op_id.ToPB(request->mutable_majority_applied_op_id());
+    } else {
+      request->clear_majority_applied_op_id();
+    }
+
     request->set_caller_term(queue_state_.current_term);
     unreachable_time =
         MonoTime::Now().GetDeltaSince(peer->last_successful_communication_time);
@@ -528,7 +566,18 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
 
     previously_sent_index = peer->next_index - 1;
-    if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0) {
+    if (want_pipelined) {
+      previously_sent_index = peer->pipelined_next_index - 1;
+      num_log_ops_to_send = kSendUnboundedLogOps;
+    } else if (peer->num_pipelined_requests > 0 && peer->last_num_messages_sent < 0 &&
+               peer->pipelined_next_index > peer->next_index) {
+      // Pipelined requests are in flight, so continue after the operations they carry instead of
+      // sending them again.
+      previously_sent_index = peer->pipelined_next_index - 1;
+      num_log_ops_to_send = kSendUnboundedLogOps;
+      send_after_in_flight = true;
+      last_acked_op_id = peer->last_received;
+    } else if (FLAGS_enable_consensus_exponential_backoff && peer->last_num_messages_sent >= 0) {
       // Previous request to peer has not been acked. Reduce number of entries to be sent
       // in this attempt using exponential backoff. Note that to_index is inclusive.
       num_log_ops_to_send = GetNumMessagesToSendWithBackoff(peer->last_num_messages_sent);
@@ -538,9 +587,11 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       num_log_ops_to_send = kSendUnboundedLogOps;
     }
 
-    peer->current_retransmissions++;
+    if (!want_pipelined) {
+      peer->current_retransmissions++;
+    }
 
-    if (peer->member_type == PeerMemberType::VOTER) {
+    if (IsVoterMemberType(peer->member_type)) {
       is_voter = true;
     }
   }
@@ -549,7 +600,8 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (!is_voter || CountVoters(*queue_state_.active_config) > 2) {
       // We never drop from 2 voters to 1 voter automatically, at least for now (12/4/18). We may
       // want to revisit this later, we're just being cautious with this.
-      // We remove unconditionally any failed non-voter replica (PRE_VOTER, PRE_OBSERVER, OBSERVER).
+      // We remove unconditionally any failed non-voter replica (PRE_VOTER, PRE_OBSERVER, OBSERVER,
+      // PRE_WITNESS).
       string msg = Substitute("Leader has been unable to successfully communicate "
                               "with Peer $0 for more than $1 seconds ($2)",
                               uuid,
@@ -567,6 +619,7 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   *needs_remote_bootstrap = false;
 
   request->clear_propagated_safe_time();
+  request->clear_pipelined();
 
   // If we've never communicated with the peer, we don't know what messages to send, so we'll send a
   // status-only request. If the peer has not responded to the point that our to_index == next_index
@@ -589,6 +642,32 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       return result.status();
     }
 
+    {
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (PREDICT_FALSE(peer == nullptr)) {
+        return STATUS(NotFound, "Peer not tracked.");
+      }
+
+      if (want_pipelined) {
+        // Another pipelined request could have taken the same operations while we were reading
+        // them, or the window could have been filled.
+        if (result->messages.empty() ||
+            peer->pipelined_next_index != previously_sent_index + 1 ||
+            peer->num_pipelined_requests + 1 >= max_inflight_requests) {
+          *pipelined = false;
+          return Status::OK();
+        }
+        ++peer->num_pipelined_requests;
+      } else {
+        peer->last_num_messages_sent = result->messages.size();
+      }
+      if (!result->messages.empty()) {
+        peer->pipelined_next_index = std::max(
+            peer->pipelined_next_index, result->messages.back()->id().index() + 1);
+      }
+    }
+
     preceding_id = result->preceding_op;
     // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
     // point. At some point we may want to allow partially loading (and not pinning) earlier
@@ -597,19 +676,22 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
       request->mutable_ops()->AddAllocated(msg.get());
     }
 
-    {
-      LockGuard lock(queue_lock_);
-      auto peer = FindPtrOrNull(peers_map_, uuid);
-      if (PREDICT_FALSE(peer == nullptr)) {
-        return STATUS(NotFound, "Peer not tracked.");
-      }
+    // The peer could receive this request before the ones carrying the preceding operations, so
+    // let it know that it should wait for them.
+    if (!result->messages.empty() && (want_pipelined || send_after_in_flight)) {
+      request->set_pipelined(true);
+    }
 
-      peer->last_num_messages_sent = result->messages.size();
+    // The peer is behind the operations kept in memory, so read ahead the ones it will
+    // request next.
+    auto read_size = result->read_from_disk_size + result->read_from_compressed_size;
+    if (read_size && result->have_more_messages) {
+      log_cache_.Prefetch(result->messages.back()->id().index());
     }
 
     ScopedTrackedConsumption consumption;
-    if (result->read_from_disk_size) {
-      consumption = ScopedTrackedConsumption(operations_mem_tracker_, result->read_from_disk_size);
+    if (read_size) {
+      consumption = ScopedTrackedConsumption(operations_mem_tracker_, read_size);
     }
     *msgs_holder = ReplicateMsgsHolder(
         request->mutable_ops(), std::move(result->messages), std::move(consumption));
@@ -622,6 +704,12 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
   }
 
+  if (send_after_in_flight && request->ops().empty()) {
+    // Status only request while operations are in flight. Refer to the operation that the peer
+    // has already acked, so it would not fail the log matching property check.
+    preceding_id = last_acked_op_id;
+  }
+
   preceding_id.ToPB(request->mutable_preceding_id());
 
   // All entries committed at leader may not be available at lagging follower.
@@ -753,7 +841,7 @@ Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
     return STATUS(IllegalState, "Peer does not need to remotely bootstrap", uuid);
   }
 
-  if (peer->member_type == PeerMemberType::VOTER || peer->member_type == PeerMemberType::OBSERVER) {
+  if (IsVoterMemberType(peer->member_type) || peer->member_type == PeerMemberType::OBSERVER) {
     LOG(INFO) << "Remote bootstrapping peer " << uuid << " with type "
               << PeerMemberType_Name(peer->member_type);
   }
@@ -1048,6 +1136,64 @@ OpId PeerMessageQueue::OpIdWatermark() {
     }
   };
 
+  auto watermark = GetWatermark<Policy>();
+  if (watermark == OpId::Min()) {
+    return watermark;
+  }
+  // Witness could not become leader, so an operation replicated only to the leader and witnesses
+  // would be lost with the leader. Such operation is not considered majority replicated until at
+  // least one regular follower receives it.
+  auto regular_follower_watermark = RegularFollowerOpIdWatermark();
+  return regular_follower_watermark.index < watermark.index ? regular_follower_watermark
+                                                            : watermark;
+}
+
+OpId PeerMessageQueue::RegularFollowerOpIdWatermark() {
+  const auto& config = *queue_state_.active_config;
+  if (CountMemberType(config, PeerMemberType::WITNESS) == 0) {
+    return OpId::Max();
+  }
+  bool has_regular_follower = false;
+  OpId result = OpId::Min();
+  for (const auto& peer_pb : config.peers()) {
+    if (peer_pb.member_type() != PeerMemberType::VOTER ||
+        peer_pb.permanent_uuid() == local_peer_uuid_) {
+      continue;
+    }
+    has_regular_follower = true;
+    auto* peer = FindPtrOrNull(peers_map_, peer_pb.permanent_uuid());
+    if (peer && peer->is_last_exchange_successful && peer->last_received.index > result.index) {
+      result = peer->last_received;
+    }
+  }
+  // When the leader is the only regular voter, there is no other replica to protect the data.
+  return has_regular_follower ? result : OpId::Max();
+}
+
+OpId PeerMessageQueue::MajorityAppliedOpIdWatermark() {
+  struct Policy {
+    typedef OpId result_type;
+
+    static result_type NotEnoughPeersValue() {
+      return OpId::Min();
+    }
+
+    static result_type ExtractValue(const TrackedPeer& peer) {
+      // Witnesses do not apply operations, so they could not provide data for them.
+      return IsWitnessMemberType(peer.member_type) ? OpId::Min() : peer.last_applied;
+    }
+
+    struct Comparator {
+      bool operator()(const OpId& lhs, const OpId& rhs) {
+        return lhs.index < rhs.index;
+      }
+    };
+
+    static const char* Name() {
+      return "Majority applied OpId";
+    }
+  };
+
   return GetWatermark<Policy>();
 }
 
@@ -1071,9 +1217,28 @@ void PeerMessageQueue::RequestWasNotSent(const std::string& peer_uuid) {
   peer->ResetLastRequest();
 }
 
+void PeerMessageQueue::PipelinedRequestFailed(const std::string& peer_uuid) {
+  LockGuard scoped_lock(queue_lock_);
+  DCHECK_NE(State::kQueueConstructed, queue_state_.state);
+
+  TrackedPeer* peer = FindPtrOrNull(peers_map_, peer_uuid);
+  if (PREDICT_FALSE(queue_state_.state != State::kQueueOpen || peer == nullptr)) {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Queue is closed or peer was untracked.";
+    return;
+  }
+
+  if (peer->num_pipelined_requests > 0) {
+    --peer->num_pipelined_requests;
+  }
+  // Operations sent after the failed request could not be appended by the peer, so stop
+  // pipelining until the next successful exchange and resend them.
+  peer->pipelined_next_index = peer->next_index;
+  peer->is_last_exchange_successful = false;
+}
 
 bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
-                                        const ConsensusResponsePB& response) {
+                                        const ConsensusResponsePB& response,
+                                        bool pipelined) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -1091,6 +1256,13 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       return false;
     }
 
+    // Whether responses to other requests to this peer could arrive out of order with this one.
+    const bool pipelining = peer->num_pipelined_requests > 0 ||
+                            GetAtomicFlag(&FLAGS_consensus_max_inflight_requests_per_peer) > 1;
+    if (pipelined && peer->num_pipelined_requests > 0) {
+      --peer->num_pipelined_requests;
+    }
+
     // Remotely bootstrap the peer if the tablet is not found or deleted.
     if (response.has_error()) {
       // We only let special types of errors through to this point from the peer.
@@ -1128,7 +1300,9 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     peer->is_new = false;
     peer->last_successful_communication_time = MonoTime::Now();
 
-    peer->ResetLastRequest();
+    if (!pipelined) {
+      peer->ResetLastRequest();
+    }
 
     if (response.has_status()) {
       const auto& status = response.status();
@@ -1171,6 +1345,21 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
         peer->next_index = peer->last_known_committed_idx + 1;
       }
 
+      if (PREDICT_FALSE(status.has_error())) {
+        peer->pipelined_next_index = peer->next_index;
+      } else if (pipelining) {
+        // A response could be overtaken by a response to the later request, that was sent
+        // while the earlier one was still in flight. Don't let it move the watermark back.
+        if (previous.last_received.term == peer->last_received.term &&
+            previous.last_received.index > peer->last_received.index) {
+          peer->last_received = previous.last_received;
+          peer->next_index = peer->last_received.index + 1;
+        }
+        peer->pipelined_next_index = std::max(peer->pipelined_next_index, peer->next_index);
+      } else {
+        peer->pipelined_next_index = peer->next_index;
+      }
+
       if (PREDICT_FALSE(status.has_error())) {
         peer->is_last_exchange_successful = false;
         switch (status.error().code()) {
@@ -1221,8 +1410,11 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     }
 
     // If our log has the next request for the peer or if the peer's committed index is lower than
-    // our own, set 'more_pending' to true.
-    result = log_cache_.HasOpBeenWritten(peer->next_index) ||
+    // our own, set 'more_pending' to true. Operations carried by pipelined requests in flight are
+    // not pending.
+    const auto next_index_to_send = peer->num_pipelined_requests > 0
+        ? std::max(peer->next_index, peer->pipelined_next_index) : peer->next_index;
+    result = log_cache_.HasOpBeenWritten(next_index_to_send) ||
         (peer->last_known_committed_idx < queue_state_.committed_op_id.index);
 
     mode_copy = queue_state_.mode;
@@ -1243,6 +1435,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
       majority_replicated.ht_lease_expiration = HybridTimeLeaseExpirationWatermark();
       majority_replicated.num_sst_files = NumSSTFilesWatermark();
+      queue_state_.majority_applied_op_id.MakeAtLeast(MajorityAppliedOpIdWatermark());
       if (peer->last_received == queue_state_.last_applied_op_id) {
         majority_replicated.peer_got_all_ops = peer->uuid;
       }
@@ -1261,6 +1454,7 @@ bool PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       evict_index = std::min(evict_index, queue_state_.all_replicated_op_id.index);
     }
 
+    log_cache_.SetReplicatedToAllIndex(queue_state_.all_replicated_op_id.index);
     log_cache_.EvictThroughOp(evict_index);
 
     UpdateMetrics();
@@ -1475,6 +1669,9 @@ void PeerMessageQueue::NotifyObserversOfMajorityReplOpChangeTask(
     queue_state_.last_applied_op_id.MakeAtLeast(last_applied_op_id);
     local_peer_->last_applied = queue_state_.last_applied_op_id;
     UpdateAllAppliedOpId(&queue_state_.all_applied_op_id);
+    if (queue_state_.mode == Mode::LEADER) {
+      queue_state_.majority_applied_op_id.MakeAtLeast(MajorityAppliedOpIdWatermark());
+    }
   }
 }
 
@@ -1610,6 +1807,11 @@ void PeerMessageQueue::TrackOperationsMemory(const OpIds& op_ids) {
   log_cache_.TrackOperationsMemory(op_ids);
 }
 
+std::vector<RefCntBuffer> PeerMessageQueue::EncodeOps(
+    const google::protobuf::RepeatedPtrField<ReplicateMsg>& ops) {
+  return log_cache_.EncodeOps(ops);
+}
+
 Result<OpId> PeerMessageQueue::TEST_GetLastOpIdWithType(
     int64_t max_allowed_index, OperationType op_type) {
   return log_cache_.TEST_GetLastOpIdWithType(max_allowed_index, op_type);
@@ -105,8 +105,10 @@ struct FollowerWatermark {
 // This also takes care of pushing requests to peers as new operations are added, and notifying
 // RaftConsensus when the commit index advances.
 //
-// TODO Currently this class is able to track one outstanding operation per peer. If we want to have
-// more than one outstanding RPC we need to modify it.
+// Besides the regular request, up to FLAGS_consensus_max_inflight_requests_per_peer - 1 pipelined
+// requests could be in flight to each peer. Pipelined requests carry operations that follow the
+// ones already sent, and the peer's watermarks are only moved by its acks, so the majority
+// replicated op id does not depend on the order in which responses arrive.
 class PeerMessageQueue {
  public:
   struct TrackedPeer {
@@ -178,6 +180,13 @@ class PeerMessageQueue {
 
     uint64_t num_sst_files = 0;
 
+    // Number of pipelined requests to this peer that are in flight.
+    int64_t num_pipelined_requests = 0;
+
+    // Index of the operation following the last one sent to this peer. Pipelined requests start
+    // from it, while next_index is only moved by the peer's responses.
+    int64_t pipelined_next_index = kInvalidOpIdIndex;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -193,7 +202,8 @@ class PeerMessageQueue {
                    const std::string& tablet_id,
                    const server::ClockPtr& clock,
                    ConsensusContext* context,
-                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token);
+                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token,
+                   std::unique_ptr<ThreadPoolToken> log_cache_prefetch_token = nullptr);
 
   // Initialize the queue.
   virtual void Init(const OpId& last_locally_replicated);
@@ -264,13 +274,19 @@ class PeerMessageQueue {
   // not delete the entries. The simplest way is to pass the same instance of ConsensusRequestPB to
   // RequestForPeer(): the buffer will replace the old entries with new ones without de-allocating
   // the old ones if they are still required.
+  //
+  // If 'pipelined' points to true, the request is assembled only if it could be sent while
+  // previous requests to the peer are still in flight, i.e. the last exchange with the peer was
+  // successful, the window of in-flight requests is not full and there are operations following
+  // the ones already sent. Otherwise *pipelined is set to false and the request must not be sent.
   virtual CHECKED_STATUS RequestForPeer(
       const std::string& uuid,
       ConsensusRequestPB* request,
       ReplicateMsgsHolder* msgs_holder,
       bool* needs_remote_bootstrap,
       PeerMemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      bool* pipelined = nullptr);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
@@ -285,12 +301,18 @@ class PeerMessageQueue {
   void NotifyPeerIsResponsiveDespiteError(const std::string& peer_uuid);
 
   // Updates the request queue with the latest response of a peer, returns whether this peer has
-  // more requests pending.
+  // more requests pending. 'pipelined' should be true if the response is for a request assembled
+  // as pipelined by RequestForPeer.
   virtual bool ResponseFromPeer(const std::string& peer_uuid,
-                                const ConsensusResponsePB& response);
+                                const ConsensusResponsePB& response,
+                                bool pipelined = false);
 
   void RequestWasNotSent(const std::string& peer_uuid);
 
+  // Should be called when a pipelined request failed, or its response could not be passed to
+  // ResponseFromPeer. Subsequent requests to the peer resume from the last operation it acked.
+  void PipelinedRequestFailed(const std::string& peer_uuid);
+
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
   virtual void Close();
@@ -371,6 +393,10 @@ class PeerMessageQueue {
   // Start memory tracking of following operations in case they are still present in our caches.
   void TrackOperationsMemory(const OpIds& op_ids);
 
+  // Returns encoded ops, sharing encodings of ops that are present in the log cache.
+  // See LogCache::EncodeOps.
+  std::vector<RefCntBuffer> EncodeOps(const google::protobuf::RepeatedPtrField<ReplicateMsg>& ops);
+
   const server::ClockPtr& clock() const {
     return clock_;
   }
@@ -418,6 +444,10 @@ class PeerMessageQueue {
     // The last operation that has been applied by all currently tracked peers.
     OpId all_applied_op_id = OpId::Min();
 
+    // The last operation that has been applied by a majority of voters. Witnesses never count as
+    // having applied an operation.
+    OpId majority_applied_op_id = OpId::Min();
+
     // The index of the last operation replicated to a majority.  This is usually the same as
     // 'committed_op_id' but might not be if the terms changed.
     OpId majority_replicated_op_id = OpId::Min();
@@ -514,7 +544,11 @@ class PeerMessageQueue {
   CoarseTimePoint LeaderLeaseExpirationWatermark();
   MicrosTime HybridTimeLeaseExpirationWatermark();
   OpId OpIdWatermark();
+  // The highest op id received by a regular (non-witness) follower voter. OpId::Max() when the
+  // config does not have witnesses or there are no regular followers.
+  OpId RegularFollowerOpIdWatermark();
   uint64_t NumSSTFilesWatermark();
+  OpId MajorityAppliedOpIdWatermark();
 
   // Reads operations from the log cache in the range (after_index, to_index].
   //
@@ -40,6 +40,7 @@
 #include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus_peers.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/consensus/metadata.pb.h"
 
 #include "yb/gutil/map-util.h"
@@ -159,8 +160,8 @@ LeaderElection::LeaderElection(const RaftConfigPB& config,
       decision_callback_(std::move(decision_callback)) {
   for (const RaftPeerPB& peer : config.peers()) {
     if (request.candidate_uuid() == peer.permanent_uuid()) continue;
-    // Only peers with member_type == VOTER are allowed to vote.
-    if (peer.member_type() != PeerMemberType::VOTER) {
+    // Only VOTER and WITNESS peers are allowed to vote.
+    if (!IsVoterMemberType(peer.member_type())) {
       LOG(INFO) << "Ignoring peer " << peer.permanent_uuid() << " vote because its member type is "
                 << PeerMemberType_Name(peer.member_type());
       continue;
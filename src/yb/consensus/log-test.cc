@@ -56,6 +56,7 @@
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_bool(log_background_periodic_sync);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
@@ -250,6 +251,27 @@ TEST_F(LogTest, TestFsyncInterval) {
   ASSERT_OK(log_->Close());
 }
 
+// Tests that log is closed and rolled over, while periodic syncs run in background.
+TEST_F(LogTest, TestFsyncIntervalInBackground) {
+  FLAGS_log_background_periodic_sync = true;
+  options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
+  BuildLog();
+
+  OpIdPB opid;
+  opid.set_term(0);
+  opid.set_index(1);
+
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(AppendNoOp(&opid));
+    SleepFor(MonoDelta::FromMilliseconds(2));
+  }
+  ASSERT_OK(log_->AllocateSegmentAndRollOver());
+  ASSERT_OK(AppendNoOp(&opid));
+  // Periodic sync is due, so Close should sync it in foreground after the background sync.
+  SleepFor(MonoDelta::FromMilliseconds(2));
+  ASSERT_OK(log_->Close());
+}
+
 // Tests interval for durable wal write physically
 TEST_F(LogTest, TestFsyncIntervalPhysical) {
   int interval = 1;
@@ -51,6 +51,7 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 
 #include "yb/fs/fs_manager.h"
@@ -166,6 +167,19 @@ DEFINE_int32(taskstream_queue_max_wait_ms, 1000,
 DEFINE_int32(wait_for_safe_op_id_to_apply_default_timeout_ms, 15000 * yb::kTimeMultiplier,
              "Timeout used by WaitForSafeOpIdToApply when it was not specified by caller.");
 
+DEFINE_bool(log_compress_entry_batches, false,
+            "Whether entry batches written to new WAL segments should be compressed with ZSTD. "
+            "Ignored if ZSTD compression is not supported by this build.");
+TAG_FLAG(log_compress_entry_batches, runtime);
+TAG_FLAG(log_compress_entry_batches, advanced);
+
+DEFINE_bool(log_background_periodic_sync, false,
+            "When durable_wal_write is off, run the periodic syncs triggered by "
+            "interval_durable_wal_write_ms and bytes_durable_wal_write_mb in background, so "
+            "appends to the log don't wait for fsync.");
+TAG_FLAG(log_background_periodic_sync, runtime);
+TAG_FLAG(log_background_periodic_sync, advanced);
+
 DEFINE_test_flag(int64, log_fault_after_segment_allocation_min_replicate_index, 0,
                  "Fault of segment allocation when min replicate index is at least specified. "
                  "0 to disable.");
@@ -555,6 +569,8 @@ Log::Log(
       cur_max_segment_size_((options.initial_segment_size_bytes + 1) / 2),
       appender_(new Appender(this, append_thread_pool)),
       allocation_token_(allocation_thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
+      background_sync_token_(
+          allocation_thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)),
       durable_wal_write_(options_.durable_wal_write),
       interval_durable_wal_write_(options_.interval_durable_wal_write),
       bytes_durable_wal_write_mb_(options_.bytes_durable_wal_write_mb),
@@ -668,6 +684,7 @@ Status Log::RollOver() {
         last_appended_entry_op_id_.ToString());
 
     RETURN_NOT_OK(Sync());
+    RETURN_NOT_OK(FinishSyncs());
     RETURN_NOT_OK(CloseCurrentSegment());
 
     RETURN_NOT_OK(SwitchToAllocatedSegment());
@@ -933,11 +950,13 @@ Status Log::Sync() {
       }
     }
 
-    if (durable_wal_write_ || timed_or_data_limit_sync) {
+    if (timed_or_data_limit_sync && GetAtomicFlag(&FLAGS_log_background_periodic_sync)) {
+      RETURN_NOT_OK(ScheduleBackgroundSync());
+    } else if (durable_wal_write_ || timed_or_data_limit_sync) {
       periodic_sync_needed_.store(false);
       periodic_sync_unsynced_bytes_ = 0;
       LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
-        RETURN_NOT_OK(active_segment_->Sync());
+        RETURN_NOT_OK(SyncActiveSegment());
       }
     }
   }
@@ -954,6 +973,65 @@ Status Log::Sync() {
   return Status::OK();
 }
 
+Status Log::SyncActiveSegment() {
+  if (options_.sync_group) {
+    return options_.sync_group->Sync(wal_dir_, active_segment_.get());
+  }
+  return active_segment_->Sync();
+}
+
+Status Log::ScheduleBackgroundSync() {
+  RETURN_NOT_OK(TakeBackgroundSyncStatus());
+  bool expected = false;
+  if (!background_sync_running_.compare_exchange_strong(
+          expected, true, std::memory_order_acq_rel)) {
+    // Previous sync is still running, the next Sync will try again.
+    return Status::OK();
+  }
+  periodic_sync_needed_.store(false);
+  periodic_sync_unsynced_bytes_ = 0;
+  auto status = background_sync_token_->SubmitFunc(std::bind(&Log::BackgroundSyncTask, this));
+  if (!status.ok()) {
+    background_sync_running_.store(false, std::memory_order_release);
+  }
+  return status;
+}
+
+void Log::BackgroundSyncTask() {
+  // Active segment is not switched while this task is running, see FinishSyncs.
+  Status status;
+  LOG_SLOW_EXECUTION(WARNING, 50, "Background fsync log took a long time") {
+    status = SyncActiveSegment();
+  }
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Background sync failed: " << status;
+    std::lock_guard<std::mutex> lock(background_sync_mutex_);
+    background_sync_status_ = status;
+  }
+  background_sync_running_.store(false, std::memory_order_release);
+}
+
+Status Log::TakeBackgroundSyncStatus() {
+  std::lock_guard<std::mutex> lock(background_sync_mutex_);
+  auto result = background_sync_status_;
+  background_sync_status_ = Status::OK();
+  return result;
+}
+
+Status Log::FinishSyncs() {
+  if (background_sync_token_) {
+    background_sync_token_->Wait();
+  }
+  RETURN_NOT_OK(TakeBackgroundSyncStatus());
+  // Data appended after the last background sync was scheduled is synced here, because the
+  // segment is about to be closed.
+  if (!sync_disabled_ && periodic_sync_needed_.exchange(false)) {
+    periodic_sync_unsynced_bytes_ = 0;
+    RETURN_NOT_OK(SyncActiveSegment());
+  }
+  return Status::OK();
+}
+
 Status Log::GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const {
   // For the lifetime of a Log::CopyTo call, log_copy_min_index_ may be set to something
   // other than std::numeric_limits<int64_t>::max(). This value will correspond to the
@@ -1236,6 +1314,9 @@ Status Log::Close() {
   switch (log_state_) {
     case kLogWriting:
       RETURN_NOT_OK(Sync());
+      // Sync could schedule background sync, so the token is reset only after it is finished.
+      RETURN_NOT_OK(FinishSyncs());
+      background_sync_token_.reset();
       RETURN_NOT_OK(CloseCurrentSegment());
       RETURN_NOT_OK(ReplaceSegmentInReaderUnlocked());
       log_state_ = kLogClosed;
@@ -1437,6 +1518,9 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_unused_tablet_id(tablet_id_);
+  if (FLAGS_log_compress_entry_batches && IsLogCompressionSupported(LOG_ZSTD_COMPRESSION)) {
+    header.set_compression(LOG_ZSTD_COMPRESSION);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
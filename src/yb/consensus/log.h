@@ -393,6 +393,22 @@ class Log : public RefCountedThreadSafe<Log> {
 
   CHECKED_STATUS Sync();
 
+  // Syncs the active segment, through options_.sync_group if it is set.
+  CHECKED_STATUS SyncActiveSegment();
+
+  // Submits periodic sync of the active segment to background_sync_token_, unless the previous
+  // one is still running. Returns the error of the previous background sync, if any.
+  CHECKED_STATUS ScheduleBackgroundSync();
+
+  void BackgroundSyncTask();
+
+  // Returns the error of the most recent background sync, and clears it, so it is reported once.
+  CHECKED_STATUS TakeBackgroundSyncStatus();
+
+  // Waits for the running background sync to complete and syncs the rest of the active segment
+  // in foreground, so the active segment could be closed.
+  CHECKED_STATUS FinishSyncs();
+
   // Helper method to get the segment sequence to GC based on the provided min_op_idx.
   CHECKED_STATUS GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const;
 
@@ -481,6 +497,18 @@ class Log : public RefCountedThreadSafe<Log> {
   // A thread pool for asynchronously pre-allocating new log segments.
   std::unique_ptr<ThreadPoolToken> allocation_token_;
 
+  // Protects background_sync_status_.
+  std::mutex background_sync_mutex_;
+
+  // The error of the most recent background sync, reported by the next Sync.
+  Status background_sync_status_;
+
+  std::atomic<bool> background_sync_running_{false};
+
+  // Runs periodic syncs of the active segment off the append thread, when
+  // --log_background_periodic_sync is set.
+  std::unique_ptr<ThreadPoolToken> background_sync_token_;
+
   // If true, sync on all appends.
   bool durable_wal_write_;
 
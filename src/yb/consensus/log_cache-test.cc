@@ -66,6 +66,8 @@ using std::thread;
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_percentage);
+DECLARE_int32(log_cache_compressed_size_limit_mb);
+DECLARE_int32(log_cache_prefetch_size_kb);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -124,12 +126,14 @@ class LogCacheTest : public YBTest {
     ASSERT_OK(log_->WaitUntilAllFlushed());
   }
 
-  void CloseAndReopenCache(const OpIdPB& preceding_id) {
+  void CloseAndReopenCache(
+      const OpIdPB& preceding_id, std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr) {
     // Blow away the memtrackers before creating the new cache.
     cache_.reset();
 
     cache_.reset(new LogCache(
-        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet));
+        metric_entity_, log_.get(), nullptr /* mem_tracker */, kPeerUuid, kTestTablet,
+        std::move(prefetch_token)));
     cache_->Init(preceding_id);
   }
 
@@ -157,6 +161,7 @@ class LogCacheTest : public YBTest {
   scoped_refptr<MetricEntity> metric_entity_;
   std::unique_ptr<FsManager> fs_manager_;
   std::unique_ptr<ThreadPool> log_thread_pool_;
+  std::unique_ptr<ThreadPool> prefetch_thread_pool_;
   std::unique_ptr<LogCache> cache_;
   scoped_refptr<log::Log> log_;
   scoped_refptr<server::Clock> clock_;
@@ -373,6 +378,131 @@ TEST_F(LogCacheTest, TestReplaceMessages) {
             cache_->ToString());
 }
 
+TEST_F(LogCacheTest, EncodeOps) {
+  constexpr int kNumMessages = 4;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumMessages, 1_KB));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumMessages, read_result.messages.size());
+  google::protobuf::RepeatedPtrField<ReplicateMsg> ops;
+  for (const auto& msg : read_result.messages) {
+    ops.AddAllocated(msg.get());
+  }
+  auto se = ScopeExit([&ops] {
+    ops.ExtractSubrange(0, ops.size(), nullptr /* elements */);
+  });
+
+  auto size_before = cache_->metrics_.size->value();
+  auto encoded = cache_->EncodeOps(ops);
+  ASSERT_EQ(kNumMessages, encoded.size());
+
+  // Concatenated encodings are parsed as the ops field of the request.
+  std::string buffer;
+  size_t encoded_size = 0;
+  for (const auto& op : encoded) {
+    buffer += op.AsSlice().ToBuffer();
+    encoded_size += op.size();
+  }
+  ConsensusRequestPB request;
+  ASSERT_TRUE(request.ParseFromString(buffer));
+  ASSERT_EQ(kNumMessages, request.ops_size());
+  for (int i = 0; i != kNumMessages; ++i) {
+    ASSERT_EQ(ops.Get(i).ShortDebugString(), request.ops(i).ShortDebugString());
+  }
+  ASSERT_EQ(size_before + encoded_size, cache_->metrics_.size->value());
+
+  // Encoding is stored in the cache and shared by subsequent calls.
+  auto encoded_again = cache_->EncodeOps(ops);
+  ASSERT_EQ(kNumMessages, encoded_again.size());
+  for (int i = 0; i != kNumMessages; ++i) {
+    ASSERT_EQ(encoded[i].data(), encoded_again[i].data());
+  }
+  ASSERT_EQ(size_before + encoded_size, cache_->metrics_.size->value());
+
+  // Encoding of evicted op is released with it.
+  cache_->EvictThroughOp(kNumMessages);
+  ASSERT_EQ(0, cache_->metrics_.size->value());
+}
+
+TEST_F(LogCacheTest, CompressedTier) {
+  FLAGS_log_cache_compressed_size_limit_mb = 1;
+  CloseAndReopenCache(MinimumOpId());
+
+  constexpr int kNumOps = 10;
+  constexpr int kReplicatedToAll = 5;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumOps, 1_KB));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  // Operations that are not replicated to all followers are compressed when evicted.
+  cache_->SetReplicatedToAllIndex(kReplicatedToAll);
+  cache_->EvictThroughOp(kNumOps);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_EQ(kNumOps - kReplicatedToAll, cache_->metrics_.compressed_num_ops->value());
+  ASSERT_GT(cache_->metrics_.compressed_size->value(), 0);
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(kReplicatedToAll, 8_MB));
+  ASSERT_EQ(kNumOps - kReplicatedToAll, read_result.messages.size());
+  int64_t index = kReplicatedToAll;
+  for (const auto& msg : read_result.messages) {
+    ASSERT_EQ(++index, msg->id().index());
+  }
+  ASSERT_GT(read_result.read_from_compressed_size, 0);
+  ASSERT_EQ(0, read_result.read_from_disk_size);
+  ASSERT_EQ(kNumOps - kReplicatedToAll, cache_->metrics_.compressed_reads->value());
+  ASSERT_EQ(0, cache_->metrics_.disk_reads->value());
+
+  // Operations before the compressed ones are read from disk.
+  read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumOps, read_result.messages.size());
+  index = 0;
+  for (const auto& msg : read_result.messages) {
+    ASSERT_EQ(++index, msg->id().index());
+  }
+  ASSERT_EQ(kReplicatedToAll, cache_->metrics_.disk_reads->value());
+
+  // Replicated operations are dropped from the compressed tier.
+  cache_->SetReplicatedToAllIndex(kNumOps);
+  ASSERT_EQ(0, cache_->metrics_.compressed_num_ops->value());
+  ASSERT_EQ(0, cache_->metrics_.compressed_size->value());
+  ASSERT_EQ(0, cache_->compressed_tracker_->consumption());
+}
+
+TEST_F(LogCacheTest, Prefetch) {
+  FLAGS_log_cache_compressed_size_limit_mb = 1;
+  FLAGS_log_cache_prefetch_size_kb = 4;
+  ASSERT_OK(ThreadPoolBuilder("prefetch").Build(&prefetch_thread_pool_));
+  CloseAndReopenCache(
+      MinimumOpId(), prefetch_thread_pool_->NewToken(ThreadPool::ExecutionMode::SERIAL));
+
+  constexpr int kNumOps = 20;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, kNumOps, 1_KB));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  cache_->SetReplicatedToAllIndex(kNumOps);
+  cache_->EvictThroughOp(kNumOps);
+  ASSERT_EQ(0, cache_->num_cached_ops());
+  ASSERT_EQ(0, cache_->metrics_.compressed_num_ops->value());
+
+  // Follower lags from the start of the log.
+  cache_->SetReplicatedToAllIndex(0);
+  cache_->Prefetch(0);
+  cache_->prefetch_token_->Wait();
+  auto prefetched = cache_->metrics_.prefetched_ops->value();
+  ASSERT_GT(prefetched, 0);
+  ASSERT_LT(prefetched, kNumOps);
+  ASSERT_EQ(prefetched, cache_->metrics_.compressed_num_ops->value());
+
+  auto read_result = ASSERT_RESULT(cache_->ReadOps(0, 8_MB));
+  ASSERT_EQ(kNumOps, read_result.messages.size());
+  ASSERT_EQ(prefetched, cache_->metrics_.compressed_reads->value());
+  ASSERT_EQ(kNumOps - prefetched, cache_->metrics_.disk_reads->value());
+
+  // Next prefetch continues after the operations that are already prefetched.
+  cache_->Prefetch(0);
+  cache_->prefetch_token_->Wait();
+  ASSERT_GT(cache_->metrics_.compressed_num_ops->value(), prefetched);
+}
+
 TEST_F(LogCacheTest, TestMTReadAndWrite) {
   atomic<bool> stop { false };
   bool stopped = false;
@@ -37,15 +37,22 @@
 #include <mutex>
 #include <vector>
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <lz4.h>
+
+#include "yb/consensus/consensus.pb.h"
 #include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/opid_util.h"
 
 #include "yb/gutil/bind.h"
+#include "yb/gutil/casts.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 
+#include "yb/util/cast.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/format.h"
 #include "yb/util/locks.h"
@@ -56,6 +63,7 @@
 #include "yb/util/result.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status_format.h"
+#include "yb/util/threadpool.h"
 
 using namespace std::literals;
 
@@ -76,6 +84,19 @@ DEFINE_int32(global_log_cache_size_limit_percentage, 5,
              "entries across all tablets. Default is 5.");
 TAG_FLAG(global_log_cache_size_limit_percentage, advanced);
 
+DEFINE_int32(log_cache_compressed_size_limit_mb, 0,
+             "The per-tablet size of the second tier of the log cache, that keeps LZ4 compressed "
+             "operations evicted from memory while some follower still needs them. Also used "
+             "for operations read ahead from disk for lagging followers. 0 disables the tier.");
+TAG_FLAG(log_cache_compressed_size_limit_mb, advanced);
+
+DEFINE_int32(log_cache_prefetch_size_kb, 4096,
+             "Amount of operations read ahead from disk into the compressed tier of the log "
+             "cache, when a lagging follower is caught up from outside of memory. 0 disables "
+             "read ahead.");
+TAG_FLAG(log_cache_prefetch_size_kb, advanced);
+TAG_FLAG(log_cache_prefetch_size_kb, runtime);
+
 DEFINE_test_flag(bool, log_cache_skip_eviction, false,
                  "Don't evict log entries in tests.");
 
@@ -90,6 +111,26 @@ METRIC_DEFINE_gauge_int64(tablet, log_cache_size, "Log Cache Memory Usage",
 METRIC_DEFINE_counter(tablet, log_cache_disk_reads, "Log Cache Disk Reads",
                       yb::MetricUnit::kEntries,
                       "Amount of operations read from disk.");
+METRIC_DEFINE_counter(tablet, log_cache_memory_reads, "Log Cache Memory Reads",
+                      yb::MetricUnit::kEntries,
+                      "Amount of operations read from the in-memory tier of the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_compressed_reads, "Log Cache Compressed Reads",
+                      yb::MetricUnit::kEntries,
+                      "Amount of operations read from the compressed tier of the log cache.");
+METRIC_DEFINE_gauge_int64(tablet, log_cache_compressed_num_ops,
+                          "Log Cache Compressed Operation Count",
+                          yb::MetricUnit::kOperations,
+                          "Number of operations in the compressed tier of the log cache.");
+METRIC_DEFINE_gauge_int64(tablet, log_cache_compressed_size, "Log Cache Compressed Memory Usage",
+                          yb::MetricUnit::kBytes,
+                          "Amount of memory in use by the compressed tier of the log cache.");
+METRIC_DEFINE_counter(tablet, log_cache_prefetched_ops, "Log Cache Prefetched Operations",
+                      yb::MetricUnit::kEntries,
+                      "Amount of operations read ahead from disk into the compressed tier.");
+METRIC_DEFINE_counter(tablet, log_cache_catch_up_bytes, "Log Cache Catch Up Bytes",
+                      yb::MetricUnit::kBytes,
+                      "Amount of operation bytes read from the compressed tier or disk, i.e. "
+                      "sent to followers lagging behind the in-memory tier.");
 
 DECLARE_bool(get_changes_honor_deadline);
 
@@ -108,12 +149,14 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
                    const log::LogPtr& log,
                    const MemTrackerPtr& server_tracker,
                    const string& local_uuid,
-                   const string& tablet_id)
+                   const string& tablet_id,
+                   std::unique_ptr<ThreadPoolToken> prefetch_token)
   : log_(log),
     local_uuid_(local_uuid),
     tablet_id_(tablet_id),
     next_sequential_op_index_(0),
     min_pinned_op_index_(0),
+    prefetch_token_(std::move(prefetch_token)),
     metrics_(metric_entity) {
 
   const int64_t max_ops_size_bytes = FLAGS_log_cache_size_limit_mb * 1_MB;
@@ -128,6 +171,13 @@ LogCache::LogCache(const scoped_refptr<MetricEntity>& metric_entity,
       AddToParent::kTrue, CreateMetrics::kFalse);
   tracker_->SetMetricEntity(metric_entity, kParentMemTrackerId);
 
+  if (FLAGS_log_cache_compressed_size_limit_mb > 0) {
+    compressed_tracker_ = MemTracker::CreateTracker(
+        FLAGS_log_cache_compressed_size_limit_mb * 1_MB,
+        Format("$0-compressed-$1", kParentMemTrackerId, tablet_id), parent_tracker_,
+        AddToParent::kTrue, CreateMetrics::kFalse);
+  }
+
   // Put a fake message at index 0, since this simplifies a lot of our code paths elsewhere.
   auto zero_op = std::make_shared<ReplicateMsg>();
   *zero_op->mutable_id() = MinimumOpId();
@@ -151,10 +201,19 @@ MemTrackerPtr LogCache::GetServerMemTracker(const MemTrackerPtr& server_tracker)
 }
 
 LogCache::~LogCache() {
+  // Wait for the running prefetch, that uses this instance.
+  prefetch_token_.reset();
+
   tracker_->Release(tracker_->consumption());
   cache_.clear();
 
   tracker_->UnregisterFromParent();
+
+  if (compressed_tracker_) {
+    compressed_tracker_->Release(compressed_tracker_->consumption());
+    compressed_cache_.clear();
+    compressed_tracker_->UnregisterFromParent();
+  }
 }
 
 void LogCache::Init(const OpIdPB& preceding_op) {
@@ -194,6 +253,9 @@ LogCache::PrepareAppendResult LogCache::PrepareAppendOperations(const ReplicateM
         cache_.erase(it);
       }
     }
+    EraseCompressedUnlocked(
+        compressed_cache_.lower_bound(first_idx_in_batch), compressed_cache_.end());
+    ++num_overwrites_;
   }
 
   for (auto& e : entries_to_insert) {
@@ -281,13 +343,47 @@ namespace {
 
 // Calculate the total byte size that will be used on the wire to replicate this message as part of
 // a consensus update request. This accounts for the length delimiting and tagging of the message.
-int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+int64_t TotalByteSizeForMessage(size_t serialized_size) {
   auto msg_size = google::protobuf::internal::WireFormatLite::LengthDelimitedSize(
-    msg.ByteSize());
+    serialized_size);
   msg_size += 1; // for the type tag
   return msg_size;
 }
 
+int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
+  return TotalByteSizeForMessage(msg.ByteSize());
+}
+
+// Serializes and compresses the message, 'buffer' is used as a scratch space.
+RefCntBuffer CompressOp(const ReplicateMsg& msg, size_t serialized_size, std::string* buffer) {
+  auto bound = LZ4_compressBound(narrow_cast<int>(serialized_size));
+  buffer->resize(serialized_size + bound);
+  auto* serialized = &(*buffer)[0];
+  msg.SerializeWithCachedSizesToArray(pointer_cast<uint8_t*>(serialized));
+  auto* compressed = serialized + serialized_size;
+  int compressed_size = LZ4_compress_limitedOutput(
+      serialized, compressed, narrow_cast<int>(serialized_size), bound);
+  CHECK_GT(compressed_size, 0) << "Failed to compress " << msg.id().ShortDebugString();
+  return RefCntBuffer(compressed, compressed_size);
+}
+
+Result<ReplicateMsgPtr> DecompressOp(const RefCntBuffer& data, uint32_t uncompressed_size) {
+  std::string buffer;
+  buffer.resize(uncompressed_size);
+  int size = LZ4_decompress_safe(
+      data.data(), &buffer[0], narrow_cast<int>(data.size()), uncompressed_size);
+  if (size != static_cast<int>(uncompressed_size)) {
+    return STATUS_FORMAT(
+        Corruption, "Failed to decompress operation, expected $0 bytes, got $1",
+        uncompressed_size, size);
+  }
+  auto result = std::make_shared<ReplicateMsg>();
+  if (!result->ParseFromString(buffer)) {
+    return STATUS(Corruption, "Failed to parse decompressed operation");
+  }
+  return result;
+}
+
 } // anonymous namespace
 
 Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index, size_t max_size_bytes) {
@@ -328,6 +424,39 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
     // If the messages the peer needs haven't been loaded into the queue yet, load them.
     MessageCache::const_iterator iter = cache_.lower_bound(next_index);
     if (iter == cache_.end() || iter->first != next_index) {
+      // Take contiguous messages from the compressed tier, they are decompressed without lock.
+      std::vector<CompressedEntry> compressed;
+      auto compressed_iter = compressed_cache_.lower_bound(next_index);
+      for (; compressed_iter != compressed_cache_.end() &&
+                 compressed_iter->first == next_index + static_cast<int64_t>(compressed.size()) &&
+                 compressed_iter->first < to_index;
+           ++compressed_iter) {
+        remaining_space -= TotalByteSizeForMessage(compressed_iter->second.uncompressed_size);
+        if (remaining_space < 0 && (!result.messages.empty() || !compressed.empty())) {
+          break;
+        }
+        compressed.push_back(compressed_iter->second);
+      }
+      if (!compressed.empty()) {
+        l.unlock();
+        int64_t read_size = 0;
+        for (const auto& entry : compressed) {
+          auto msg = VERIFY_RESULT(DecompressOp(entry.data, entry.uncompressed_size));
+          CHECK_EQ(next_index, msg->id().index());
+          read_size += TotalByteSizeForMessage(*msg);
+          result.messages.push_back(std::move(msg));
+          next_index++;
+        }
+        result.read_from_compressed_size += read_size;
+        metrics_.compressed_reads->IncrementBy(compressed.size());
+        metrics_.catch_up_bytes->IncrementBy(read_size);
+        l.lock();
+        continue;
+      }
+      if (remaining_space < 0) {
+        break;
+      }
+
       int64_t up_to;
       if (iter == cache_.end()) {
         // Read all the way to the current op.
@@ -336,6 +465,10 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
         // Read up to the next entry that's in the cache or to_index whichever is lesser.
         up_to = std::min(iter->first - 1, to_index - 1);
       }
+      if (compressed_iter != compressed_cache_.end()) {
+        // Or up to the next entry in the compressed tier.
+        up_to = std::min(compressed_iter->first - 1, up_to);
+      }
 
       l.unlock();
 
@@ -359,9 +492,11 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
         }
         result.messages.push_back(msg);
         result.read_from_disk_size += current_message_size;
+        metrics_.catch_up_bytes->IncrementBy(current_message_size);
         next_index++;
       }
     } else {
+      int64_t num_read = 0;
       // Pull contiguous messages from the cache until the size limit is achieved.
       for (; iter != cache_.end(); ++iter) {
         if (to_op_index > 0 && next_index > to_op_index) {
@@ -381,7 +516,9 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
 
         result.messages.push_back(msg);
         next_index++;
+        num_read++;
       }
+      metrics_.memory_reads->IncrementBy(num_read);
     }
   }
   result.have_more_messages = remaining_space < 0;
@@ -389,11 +526,148 @@ Result<ReadOpsResult> LogCache::ReadOps(int64_t after_op_index,
 }
 
 size_t LogCache::EvictThroughOp(int64_t index, int64_t bytes_to_evict) {
+  ReplicateMsgs to_compress;
+  uint64_t num_overwrites;
+  size_t result;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    result = EvictSomeUnlocked(index, bytes_to_evict, &to_compress);
+    num_overwrites = num_overwrites_;
+  }
+  AddToCompressedTier(to_compress, num_overwrites);
+  return result;
+}
+
+void LogCache::SetReplicatedToAllIndex(int64_t index) {
   std::lock_guard<simple_spinlock> lock(lock_);
-  return EvictSomeUnlocked(index, bytes_to_evict);
+  replicated_to_all_index_ = index;
+  if (!compressed_cache_.empty()) {
+    EraseCompressedUnlocked(compressed_cache_.begin(), compressed_cache_.upper_bound(index));
+  }
+}
+
+void LogCache::AddToCompressedTier(const ReplicateMsgs& msgs, uint64_t num_overwrites) {
+  if (msgs.empty() || !compressed_tracker_) {
+    return;
+  }
+
+  std::vector<CompressedEntry> entries;
+  entries.reserve(msgs.size());
+  std::string buffer;
+  for (const auto& msg : msgs) {
+    auto size = msg->ByteSizeLong();
+    entries.push_back({CompressOp(*msg, size, &buffer), narrow_cast<uint32_t>(size)});
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  if (num_overwrites != num_overwrites_) {
+    // Operations could be replaced while they were compressed.
+    return;
+  }
+  for (size_t i = 0; i != msgs.size(); ++i) {
+    auto index = msgs[i]->id().index();
+    if (index <= replicated_to_all_index_ || index >= min_pinned_op_index_ ||
+        cache_.count(index) || compressed_cache_.count(index)) {
+      continue;
+    }
+    auto& entry = entries[i];
+    auto mem_usage = entry.data.DynamicMemoryUsage();
+    // Drop the oldest compressed operations to fit the new one.
+    while (!compressed_tracker_->TryConsume(mem_usage)) {
+      if (compressed_cache_.empty() || compressed_cache_.begin()->first > index) {
+        return;
+      }
+      EraseCompressedUnlocked(compressed_cache_.begin(), std::next(compressed_cache_.begin()));
+    }
+    metrics_.compressed_num_ops->Increment();
+    metrics_.compressed_size->IncrementBy(mem_usage);
+    compressed_cache_.emplace(index, std::move(entry));
+  }
 }
 
-size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict) {
+void LogCache::EraseCompressedUnlocked(CompressedCache::iterator begin,
+                                       CompressedCache::iterator end) {
+  int64_t num_ops = 0;
+  int64_t mem_usage = 0;
+  for (auto it = begin; it != end; ++it) {
+    ++num_ops;
+    mem_usage += it->second.data.DynamicMemoryUsage();
+  }
+  if (num_ops == 0) {
+    return;
+  }
+  compressed_tracker_->Release(mem_usage);
+  metrics_.compressed_num_ops->DecrementBy(num_ops);
+  metrics_.compressed_size->DecrementBy(mem_usage);
+  compressed_cache_.erase(begin, end);
+}
+
+void LogCache::Prefetch(int64_t after_op_index) {
+  if (!prefetch_token_ || !compressed_tracker_ ||
+      ANNOTATE_UNPROTECTED_READ(FLAGS_log_cache_prefetch_size_kb) <= 0) {
+    return;
+  }
+  bool expected = false;
+  if (!prefetch_running_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  int64_t from_index = after_op_index + 1;
+  int64_t to_index;
+  uint64_t num_overwrites;
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    // Skip operations that are already in the compressed tier.
+    auto compressed_iter = compressed_cache_.lower_bound(from_index);
+    for (; compressed_iter != compressed_cache_.end() && compressed_iter->first == from_index;
+         ++compressed_iter) {
+      ++from_index;
+    }
+    // Read up to the next operation that is in memory, in the compressed tier, or not written yet.
+    to_index = min_pinned_op_index_ - 1;
+    auto iter = cache_.lower_bound(from_index);
+    if (iter != cache_.end()) {
+      to_index = std::min(iter->first - 1, to_index);
+    }
+    if (compressed_iter != compressed_cache_.end()) {
+      to_index = std::min(compressed_iter->first - 1, to_index);
+    }
+    if (to_index <= replicated_to_all_index_) {
+      // Operations are not needed, or the tier is not used by this peer.
+      to_index = -1;
+    }
+    num_overwrites = num_overwrites_;
+  }
+
+  if (from_index > to_index) {
+    prefetch_running_ = false;
+    return;
+  }
+  auto status = prefetch_token_->SubmitFunc(
+      std::bind(&LogCache::PrefetchTask, this, from_index, to_index, num_overwrites));
+  if (!status.ok()) {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING) << "Failed to submit log cache prefetch: " << status;
+    prefetch_running_ = false;
+  }
+}
+
+void LogCache::PrefetchTask(int64_t from_index, int64_t to_index, uint64_t num_overwrites) {
+  ReplicateMsgs msgs;
+  auto status = log_->GetLogReader()->ReadReplicatesInRange(
+      from_index, to_index, FLAGS_log_cache_prefetch_size_kb * 1_KB, &msgs);
+  if (status.ok()) {
+    VLOG_WITH_PREFIX_UNLOCKED(2) << "Prefetched " << msgs.size() << " ops from " << from_index;
+    metrics_.prefetched_ops->IncrementBy(msgs.size());
+    AddToCompressedTier(msgs, num_overwrites);
+  } else {
+    LOG_WITH_PREFIX_UNLOCKED(WARNING)
+        << "Failed to prefetch ops " << from_index << ".." << to_index << ": " << status;
+  }
+  prefetch_running_ = false;
+}
+
+size_t LogCache::EvictSomeUnlocked(
+    int64_t stop_after_index, int64_t bytes_to_evict, ReplicateMsgs* to_compress) {
   DCHECK(lock_.is_locked());
   VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting log cache index <= "
                       << stop_after_index
@@ -421,6 +695,9 @@ size_t LogCache::EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_ev
     }
 
     VLOG_WITH_PREFIX_UNLOCKED(2) << "Evicting cache. Removing: " << msg->id();
+    if (compressed_tracker_ && msg_index > replicated_to_all_index_) {
+      to_compress->push_back(msg);
+    }
     AccountForMessageRemovalUnlocked(entry);
     bytes_evicted += entry.mem_usage;
     cache_.erase(iter++);
@@ -536,12 +813,80 @@ void LogCache::DumpToHtml(std::ostream& out) const {
   out << "</table>";
 }
 
+namespace {
+
+RefCntBuffer EncodeOp(const ReplicateMsg& msg) {
+  using google::protobuf::internal::WireFormatLite;
+  using google::protobuf::io::CodedOutputStream;
+
+  const uint32_t kTag = WireFormatLite::MakeTag(
+      ConsensusRequestPB::kOpsFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  auto msg_size = narrow_cast<uint32_t>(msg.ByteSizeLong());
+  RefCntBuffer result(
+      CodedOutputStream::VarintSize32(kTag) + CodedOutputStream::VarintSize32(msg_size) +
+      msg_size);
+  auto* dst = CodedOutputStream::WriteTagToArray(kTag, result.udata());
+  dst = CodedOutputStream::WriteVarint32ToArray(msg_size, dst);
+  dst = msg.SerializeWithCachedSizesToArray(dst);
+  DCHECK_EQ(dst, result.udata() + result.size());
+  return result;
+}
+
+} // namespace
+
+std::vector<RefCntBuffer> LogCache::EncodeOps(
+    const google::protobuf::RepeatedPtrField<ReplicateMsg>& ops) {
+  std::vector<RefCntBuffer> result(ops.size());
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    for (int i = 0; i != ops.size(); ++i) {
+      auto it = cache_.find(ops.Get(i).id().index());
+      if (it != cache_.end() && it->second.msg.get() == &ops.Get(i)) {
+        result[i] = it->second.encoded;
+      }
+    }
+  }
+
+  // Serialize outside of the lock, ops are immutable while they are in the cache.
+  std::vector<int> newly_encoded;
+  for (int i = 0; i != ops.size(); ++i) {
+    if (!result[i]) {
+      result[i] = EncodeOp(ops.Get(i));
+      newly_encoded.push_back(i);
+    }
+  }
+  if (newly_encoded.empty()) {
+    return result;
+  }
+
+  std::lock_guard<simple_spinlock> lock(lock_);
+  int64_t mem_required = 0;
+  for (auto i : newly_encoded) {
+    auto it = cache_.find(ops.Get(i).id().index());
+    // Op could be evicted or replaced meanwhile, or encoded by another peer.
+    if (it == cache_.end() || it->second.msg.get() != &ops.Get(i) || it->second.encoded) {
+      continue;
+    }
+    auto& entry = it->second;
+    entry.encoded = result[i];
+    entry.mem_usage += entry.encoded.size();
+    metrics_.size->IncrementBy(entry.encoded.size());
+    if (entry.tracked) {
+      mem_required += entry.encoded.size();
+    }
+  }
+  if (mem_required) {
+    tracker_->Consume(mem_required);
+  }
+  return result;
+}
+
 void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
   if (op_ids.empty()) {
     return;
   }
 
-  std::lock_guard<simple_spinlock> lock(lock_);
+  std::unique_lock<simple_spinlock> lock(lock_);
 
   size_t mem_required = 0;
   for (const auto& op_id : op_ids) {
@@ -571,7 +916,11 @@ void LogCache::TrackOperationsMemory(const OpIds& op_ids) {
 
     // TODO: we should also try to evict from other tablets - probably better to evict really old
     // ops from another tablet than evict recent ops from this one.
-    EvictSomeUnlocked(min_pinned_op_index_, need_to_free);
+    ReplicateMsgs to_compress;
+    EvictSomeUnlocked(min_pinned_op_index_, need_to_free, &to_compress);
+    auto num_overwrites = num_overwrites_;
+    lock.unlock();
+    AddToCompressedTier(to_compress, num_overwrites);
   }
 }
 
@@ -584,7 +933,13 @@ int64_t LogCache::num_cached_ops() const {
 LogCache::Metrics::Metrics(const scoped_refptr<MetricEntity>& metric_entity)
   : INSTANTIATE_METRIC(num_ops, 0),
     INSTANTIATE_METRIC(size, 0),
-    INSTANTIATE_METRIC(disk_reads) {
+    INSTANTIATE_METRIC(disk_reads),
+    INSTANTIATE_METRIC(memory_reads),
+    INSTANTIATE_METRIC(compressed_reads),
+    INSTANTIATE_METRIC(compressed_num_ops, 0),
+    INSTANTIATE_METRIC(compressed_size, 0),
+    INSTANTIATE_METRIC(prefetched_ops),
+    INSTANTIATE_METRIC(catch_up_bytes) {
 }
 #undef INSTANTIATE_METRIC
 
@@ -44,6 +44,7 @@
 #include <vector>
 
 #include <glog/logging.h>
+#include <google/protobuf/repeated_field.h>
 #include <gtest/gtest_prod.h>
 
 #include "yb/consensus/consensus_fwd.h"
@@ -57,6 +58,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/mutex.h"
 #include "yb/util/opid.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/restart_safe_clock.h"
 #include "yb/util/status_callback.h"
 
@@ -65,6 +67,7 @@ namespace yb {
 class MetricEntity;
 class MemTracker;
 class OpIdPB;
+class ThreadPoolToken;
 
 namespace consensus {
 
@@ -75,6 +78,8 @@ struct ReadOpsResult {
   yb::OpId preceding_op;
   bool have_more_messages = false;
   int64_t read_from_disk_size = 0;
+  // Size of messages decompressed from the compressed tier, they are not shared with the cache.
+  int64_t read_from_compressed_size = 0;
 };
 
 // Write-through cache for the log.
@@ -82,13 +87,19 @@ struct ReadOpsResult {
 // This stores a set of log messages by their index. New operations can be appended to the end as
 // they are written to the log. Readers fetch entries that were explicitly appended, or they can
 // fetch older entries which are asynchronously fetched from the disk.
+//
+// When --log_cache_compressed_size_limit_mb is set, operations that are evicted from memory while
+// some follower still needs them are kept LZ4 compressed in the second tier of the cache. Reads
+// that miss both tiers go to disk, and could be followed by a read ahead into the second tier
+// using prefetch_token.
 class LogCache {
  public:
   LogCache(const scoped_refptr<MetricEntity>& metric_entity,
            const log::LogPtr& log,
            const std::shared_ptr<MemTracker>& server_tracker,
            const std::string& local_uuid,
-           const std::string& tablet_id);
+           const std::string& tablet_id,
+           std::unique_ptr<ThreadPoolToken> prefetch_token = nullptr);
   ~LogCache();
 
   static std::shared_ptr<MemTracker> GetServerMemTracker(
@@ -144,6 +155,14 @@ class LogCache {
   size_t EvictThroughOp(
       int64_t index, int64_t bytes_to_evict = std::numeric_limits<int64_t>::max());
 
+  // Operations after 'index' are still needed by some follower, so they are moved to the
+  // compressed tier when evicted. Compressed operations through 'index' are dropped.
+  void SetReplicatedToAllIndex(int64_t index);
+
+  // Asynchronously reads operations following 'after_op_index' from disk into the compressed tier,
+  // so they are available when a lagging follower requests them.
+  void Prefetch(int64_t after_op_index);
+
   // Return the number of bytes of memory currently in use by the cache.
   int64_t BytesUsed() const;
 
@@ -174,6 +193,12 @@ class LogCache {
   // Start memory tracking of following operations in case they are still present in cache.
   void TrackOperationsMemory(const OpIds& op_ids);
 
+  // Returns ops encoded as the ops field of ConsensusRequestPB, one buffer per op. Encoding of an
+  // op that is present in the cache is stored along with it, so each op is serialized once for
+  // all peers.
+  std::vector<RefCntBuffer> EncodeOps(
+      const google::protobuf::RepeatedPtrField<ReplicateMsg>& ops);
+
   CHECKED_STATUS FlushIndex();
 
   Result<OpId> TEST_GetLastOpIdWithType(int64_t max_allowed_index, OperationType op_type);
@@ -183,6 +208,8 @@ class LogCache {
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimitMB);
   FRIEND_TEST(LogCacheTest, TestGlobalMemoryLimitPercentage);
   FRIEND_TEST(LogCacheTest, TestReplaceMessages);
+  FRIEND_TEST(LogCacheTest, CompressedTier);
+  FRIEND_TEST(LogCacheTest, Prefetch);
   friend class LogCacheTest;
 
   // An entry in the cache.
@@ -194,12 +221,34 @@ class LogCache {
 
     // Did we start memory tracking for this entry.
     bool tracked = false;
+
+    // msg encoded by EncodeOps, its size is included in mem_usage.
+    RefCntBuffer encoded;
+  };
+
+  // An operation in the compressed tier.
+  struct CompressedEntry {
+    // LZ4 compressed serialized ReplicateMsg.
+    RefCntBuffer data;
+    uint32_t uncompressed_size = 0;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
   // 'bytes_to_evict' bytes have been evicted, or the op with index
   // 'stop_after_index' has been evicted, whichever comes first.
-  size_t EvictSomeUnlocked(int64_t stop_after_index, int64_t bytes_to_evict);
+  // Evicted operations that should be moved to the compressed tier are added to 'to_compress'.
+  size_t EvictSomeUnlocked(
+      int64_t stop_after_index, int64_t bytes_to_evict, ReplicateMsgs* to_compress);
+
+  // Compresses 'msgs' and adds them to the compressed tier, unless operations were overwritten
+  // since num_overwrites_ was equal to 'num_overwrites'. Should be called without lock_ held.
+  void AddToCompressedTier(const ReplicateMsgs& msgs, uint64_t num_overwrites);
+
+  void EraseCompressedUnlocked(
+      std::map<int64_t, CompressedEntry>::iterator begin,
+      std::map<int64_t, CompressedEntry>::iterator end);
+
+  void PrefetchTask(int64_t from_index, int64_t to_index, uint64_t num_overwrites);
 
   // Update metrics and MemTracker to account for the removal of the
   // given message.
@@ -242,6 +291,16 @@ class LogCache {
   typedef std::map<int64_t, CacheEntry> MessageCache;
   MessageCache cache_;
 
+  // The compressed tier, maps from log index -> CompressedEntry. Protected by lock_.
+  typedef std::map<int64_t, CompressedEntry> CompressedCache;
+  CompressedCache compressed_cache_;
+
+  // See SetReplicatedToAllIndex. Protected by lock_.
+  int64_t replicated_to_all_index_ = std::numeric_limits<int64_t>::max();
+
+  // Incremented when appended operations replace existing ones. Protected by lock_.
+  uint64_t num_overwrites_ = 0;
+
   // The next log index to append. Each append operation must either start with this log index, or
   // go backward (but never skip forward).
   int64_t next_sequential_op_index_;
@@ -261,6 +320,12 @@ class LogCache {
   // A MemTracker for this instance.
   std::shared_ptr<MemTracker> tracker_;
 
+  // A MemTracker for the compressed tier of this instance, null if the tier is disabled.
+  std::shared_ptr<MemTracker> compressed_tracker_;
+
+  std::unique_ptr<ThreadPoolToken> prefetch_token_;
+  std::atomic<bool> prefetch_running_{false};
+
   struct Metrics {
     explicit Metrics(const scoped_refptr<MetricEntity>& metric_entity);
 
@@ -271,6 +336,18 @@ class LogCache {
     scoped_refptr<AtomicGauge<int64_t>> size;
 
     scoped_refptr<Counter> disk_reads;
+
+    // Number of operations read from the memory and compressed tiers.
+    scoped_refptr<Counter> memory_reads;
+    scoped_refptr<Counter> compressed_reads;
+
+    scoped_refptr<AtomicGauge<int64_t>> compressed_num_ops;
+    scoped_refptr<AtomicGauge<int64_t>> compressed_size;
+
+    scoped_refptr<Counter> prefetched_ops;
+
+    // Bytes of operations read from the compressed tier or disk.
+    scoped_refptr<Counter> catch_up_bytes;
   };
   Metrics metrics_;
 
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/consensus/log_sync_group.h"
+#include "yb/consensus/log_util.h"
+
+#include "yb/util/env.h"
+#include "yb/util/format.h"
+#include "yb/util/path_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_thread_holder.h"
+#include "yb/util/test_util.h"
+
+DECLARE_bool(never_fsync);
+
+namespace yb {
+namespace log {
+
+class LogSyncGroupTest : public YBTest {
+};
+
+// Logs of different tablets sync concurrently. Each log would fsync its segment separately
+// without the group, while with the group the number of file system syncs is lower.
+TEST_F(LogSyncGroupTest, ConcurrentSyncs) {
+  if (!LogSyncGroup::IsSupported()) {
+    LOG(INFO) << "syncfs does not report writeback errors on this system, skipping test";
+    return;
+  }
+
+  constexpr int kNumLogs = 16;
+  constexpr int kSyncsPerLog = 100;
+
+  FLAGS_never_fsync = false;
+  LogSyncGroup sync_group;
+
+  std::vector<std::string> dirs;
+  std::vector<std::shared_ptr<WritableFile>> files;
+  std::vector<std::unique_ptr<WritableLogSegment>> segments;
+  for (int i = 0; i != kNumLogs; ++i) {
+    dirs.push_back(GetTestPath(Format("wal-$0", i)));
+    ASSERT_OK(env_->CreateDir(dirs.back()));
+    auto path = JoinPathSegments(dirs.back(), "segment");
+    std::unique_ptr<WritableFile> file;
+    ASSERT_OK(env_->NewWritableFile(path, &file));
+    files.emplace_back(std::move(file));
+    segments.push_back(std::make_unique<WritableLogSegment>(path, files.back()));
+  }
+
+  std::atomic<size_t> num_syncs{0};
+  TestThreadHolder thread_holder;
+  for (int i = 0; i != kNumLogs; ++i) {
+    thread_holder.AddThreadFunctor([&, i] {
+      for (int j = 0; j != kSyncsPerLog; ++j) {
+        ASSERT_OK(files[i]->Append(Slice(Format("entry-$0", j))));
+        ASSERT_OK(sync_group.Sync(dirs[i], segments[i].get()));
+        ++num_syncs;
+      }
+    });
+  }
+  thread_holder.JoinAll();
+
+  LOG(INFO) << "Synced " << num_syncs.load() << " segments in " << sync_group.num_groups()
+            << " groups with " << sync_group.num_fs_syncs() << " file system syncs";
+  ASSERT_EQ(num_syncs.load(), kNumLogs * kSyncsPerLog);
+  ASSERT_LE(sync_group.num_groups(), num_syncs.load());
+  // All directories are on the same file system, so there is at most one syncfs per group.
+  ASSERT_LE(sync_group.num_fs_syncs(), sync_group.num_groups());
+  ASSERT_LT(sync_group.num_fs_syncs(), num_syncs.load());
+
+  for (int i = 0; i != kNumLogs; ++i) {
+    ASSERT_OK(files[i]->Close());
+    ASSERT_GT(ASSERT_RESULT(env_->GetFileSize(JoinPathSegments(dirs[i], "segment"))), 0);
+  }
+}
+
+} // namespace log
+} // namespace yb
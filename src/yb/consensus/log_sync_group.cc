@@ -0,0 +1,167 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include <gflags/gflags.h>
+
+#include "yb/consensus/log_util.h"
+
+#include "yb/util/errno.h"
+#include "yb/util/result.h"
+#include "yb/util/status_log.h"
+
+DECLARE_bool(never_fsync);
+
+namespace yb {
+namespace log {
+
+struct LogSyncGroup::Request {
+  const std::string& wal_dir;
+  WritableLogSegment* segment;
+  Status status;
+  // Protected by mutex_.
+  bool done = false;
+};
+
+namespace {
+
+// Before Linux 5.8 syncfs always returns success, even when writeback of some data failed.
+bool SyncfsReportsErrors() {
+#if defined(__linux__)
+  struct utsname name;
+  int major = 0;
+  int minor = 0;
+  if (uname(&name) != 0 || sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+    return false;
+  }
+  return major > 5 || (major == 5 && minor >= 8);
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+LogSyncGroup::LogSyncGroup() {
+  DCHECK(IsSupported());
+}
+
+LogSyncGroup::~LogSyncGroup() {
+  for (const auto& p : fs_fds_) {
+    if (close(p.second) != 0) {
+      LOG(WARNING) << "Failed to close WAL directory descriptor: " << ErrnoToString(errno);
+    }
+  }
+}
+
+bool LogSyncGroup::IsSupported() {
+  static const bool result = SyncfsReportsErrors();
+  return result;
+}
+
+Status LogSyncGroup::Sync(const std::string& wal_dir, WritableLogSegment* segment) {
+  Request request{wal_dir, segment};
+  std::unique_lock<std::mutex> lock(mutex_);
+  queue_.push_back(&request);
+  while (!request.done) {
+    if (leader_active_) {
+      cond_.wait(lock);
+      continue;
+    }
+    // Our request is in the queue, so it will be synced in this group.
+    leader_active_ = true;
+    std::vector<Request*> group;
+    group.swap(queue_);
+    lock.unlock();
+    SyncGroup(group);
+    lock.lock();
+    leader_active_ = false;
+    ++num_groups_;
+    for (auto* group_request : group) {
+      group_request->done = true;
+    }
+    cond_.notify_all();
+  }
+  return request.status;
+}
+
+size_t LogSyncGroup::num_groups() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_groups_;
+}
+
+size_t LogSyncGroup::num_fs_syncs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_fs_syncs_;
+}
+
+void LogSyncGroup::SyncGroup(const std::vector<Request*>& group) {
+  VLOG(2) << "Syncing " << group.size() << " log segments";
+  // Start writeback of all segments first, so it proceeds in parallel, then wait for it with
+  // a single syncfs per file system.
+  std::unordered_map<int, std::vector<Request*>> fs_groups;
+  for (auto* request : group) {
+    request->status = request->segment->Flush();
+    if (!request->status.ok()) {
+      continue;
+    }
+    auto fd = FileSystemFd(request->wal_dir);
+    if (!fd.ok()) {
+      request->status = fd.status();
+      continue;
+    }
+    fs_groups[*fd].push_back(request);
+  }
+  for (const auto& p : fs_groups) {
+    Status status;
+#if defined(__linux__)
+    if (!FLAGS_never_fsync && syncfs(p.first) != 0) {
+      status = STATUS_FROM_ERRNO(p.second.front()->wal_dir, errno);
+    }
+#else
+    status = STATUS(NotSupported, "syncfs is not supported on this platform");
+#endif
+    for (auto* request : p.second) {
+      request->status = status;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  num_fs_syncs_ += fs_groups.size();
+}
+
+Result<int> LogSyncGroup::FileSystemFd(const std::string& dir) {
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return STATUS_FROM_ERRNO(dir, errno);
+  }
+  auto it = fs_fds_.find(st.st_dev);
+  if (it != fs_fds_.end()) {
+    return it->second;
+  }
+  int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return STATUS_FROM_ERRNO(dir, errno);
+  }
+  fs_fds_.emplace(st.st_dev, fd);
+  return fd;
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <sys/types.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/gutil/macros.h"
+
+#include "yb/util/status_fwd.h"
+
+namespace yb {
+
+namespace log {
+
+class WritableLogSegment;
+
+// Combines WAL syncs of all tablets on the node. A log that needs to sync its active segment
+// queues it and waits. The first waiting log becomes the leader: it starts writeback of all queued
+// segments and then waits for it with a single syncfs per file system, instead of a separate fsync
+// per segment. Segments queued in the meantime form the next group.
+//
+// syncfs flushes all dirty data of the file system, so grouping pays off only when WAL directories
+// are placed on devices that don't hold anything else. syncfs reports writeback errors only since
+// Linux 5.8, so the group should be used only when IsSupported returns true. Otherwise each log
+// should fsync its own segment, there is no benefit in grouping separate fsyncs.
+class LogSyncGroup {
+ public:
+  LogSyncGroup();
+  ~LogSyncGroup();
+
+  // Whether syncfs is available and reports writeback errors on this system.
+  static bool IsSupported();
+
+  // Syncs segment located in wal_dir, possibly together with segments of other logs.
+  // Blocks until the segment is synced.
+  CHECKED_STATUS Sync(const std::string& wal_dir, WritableLogSegment* segment);
+
+  // Returns the number of groups synced so far.
+  size_t num_groups() const;
+
+  // Returns the number of file system syncs performed so far.
+  size_t num_fs_syncs() const;
+
+ private:
+  struct Request;
+
+  void SyncGroup(const std::vector<Request*>& group);
+
+  // Returns descriptor of the directory that could be used for syncfs of the file system
+  // containing dir.
+  Result<int> FileSystemFd(const std::string& dir);
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  bool leader_active_ = false;
+  std::vector<Request*> queue_;
+  size_t num_groups_ = 0;
+  size_t num_fs_syncs_ = 0;
+
+  // Opened directories by device id. Accessed only by the current leader.
+  std::unordered_map<dev_t, int> fs_fds_;
+
+  DISALLOW_COPY_AND_ASSIGN(LogSyncGroup);
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNC_GROUP_H
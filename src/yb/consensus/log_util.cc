@@ -39,6 +39,10 @@
 
 #include <glog/logging.h>
 
+#ifdef ZSTD
+#include <zstd.h>
+#endif
+
 #include "yb/common/hybrid_time.h"
 
 #include "yb/consensus/opid_util.h"
@@ -133,6 +137,79 @@ const size_t kEntryHeaderSize = 12;
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
+namespace {
+
+// WAL is written on the write path, so fast compression level is used.
+constexpr int kLogZstdCompressionLevel = 1;
+
+Status CompressEntryBatch(LogCompressionPB compression, const Slice& data, faststring* output) {
+  switch (compression) {
+    case LOG_NO_COMPRESSION:
+      break;
+    case LOG_ZSTD_COMPRESSION: {
+#ifdef ZSTD
+      output->resize(ZSTD_compressBound(data.size()));
+      const size_t size = ZSTD_compress(
+          output->data(), output->size(), data.data(), data.size(), kLogZstdCompressionLevel);
+      if (ZSTD_isError(size)) {
+        return STATUS_FORMAT(RuntimeError, "Failed to compress entry batch: $0",
+                             ZSTD_getErrorName(size));
+      }
+      output->resize(size);
+      return Status::OK();
+#else
+      break;
+#endif
+    }
+  }
+  return STATUS_FORMAT(NotSupported, "Log compression not supported: $0",
+                       LogCompressionPB_Name(compression));
+}
+
+Status UncompressEntryBatch(LogCompressionPB compression, const Slice& data, faststring* output) {
+  switch (compression) {
+    case LOG_NO_COMPRESSION:
+      break;
+    case LOG_ZSTD_COMPRESSION: {
+#ifdef ZSTD
+      const auto content_size = ZSTD_getFrameContentSize(data.data(), data.size());
+      if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+          content_size > std::numeric_limits<uint32_t>::max()) {
+        return STATUS(Corruption, "Invalid compressed entry batch header");
+      }
+      output->resize(content_size);
+      const size_t size = ZSTD_decompress(
+          output->data(), output->size(), data.data(), data.size());
+      if (ZSTD_isError(size) || size != content_size) {
+        return STATUS_FORMAT(Corruption, "Failed to uncompress entry batch: $0",
+                             ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch");
+      }
+      return Status::OK();
+#else
+      break;
+#endif
+    }
+  }
+  return STATUS_FORMAT(NotSupported, "Log compression not supported: $0",
+                       LogCompressionPB_Name(compression));
+}
+
+} // namespace
+
+bool IsLogCompressionSupported(LogCompressionPB compression) {
+  switch (compression) {
+    case LOG_NO_COMPRESSION:
+      return true;
+    case LOG_ZSTD_COMPRESSION:
+#ifdef ZSTD
+      return true;
+#else
+      return false;
+#endif
+  }
+  return false;
+}
+
 // Maximum log segment header/footer size, in bytes (8 MB).
 const uint32_t kLogSegmentMaxHeaderOrFooterSize = 8 * 1024 * 1024;
 
@@ -788,10 +865,21 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice entry_batch_data = entry_batch_slice;
+  faststring uncompressed_buf;
+  if (header_.compression() != LOG_NO_COMPRESSION) {
+    s = UncompressEntryBatch(header_.compression(), entry_batch_slice, &uncompressed_buf);
+    if (!s.ok()) {
+      return STATUS_FORMAT(Corruption, "Could not uncompress entry in byte range $0-$1: $2",
+                           *offset, *offset + header.msg_length, s);
+    }
+    entry_batch_data = Slice(uncompressed_buf);
+  }
+
   LogEntryBatchPB read_entry_batch;
   s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+                              entry_batch_data.data(),
+                              entry_batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -863,11 +951,17 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
   uint8_t header_buf[kEntryHeaderSize];
 
+  Slice data = entry_batch_data;
+  if (header_.compression() != LOG_NO_COMPRESSION) {
+    RETURN_NOT_OK(CompressEntryBatch(header_.compression(), entry_batch_data, &compressed_buffer_));
+    data = Slice(compressed_buffer_);
+  }
+
   // First encode the length of the message.
   auto len = data.size();
   InlineEncodeFixed32(&header_buf[0], narrow_cast<uint32_t>(len));
@@ -896,6 +990,10 @@ Status WritableLogSegment::Sync() {
   return writable_file_->Sync();
 }
 
+Status WritableLogSegment::Flush() {
+  return writable_file_->Flush(WritableFile::FLUSH_ASYNC);
+}
+
 // Creates a LogEntryBatchPB from pre-allocated ReplicateMsgs managed using shared pointers. The
 // caller has to ensure these messages are not deleted twice, both by LogEntryBatchPB and by
 // the shared pointers.
@@ -52,6 +52,7 @@
 #include "yb/util/atomic.h"
 #include "yb/util/compare_util.h"
 #include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
@@ -77,6 +78,9 @@ extern const size_t kEntryHeaderSize;
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
+// Returns true if entry batches could be written with the specified compression.
+bool IsLogCompressionSupported(LogCompressionPB compression);
+
 // Options for the Write Ahead Log. The LogOptions constructor initializes default field values
 // based on flags. See log_util.cc for details.
 struct LogOptions {
@@ -111,6 +115,9 @@ struct LogOptions {
 
   uint64_t initial_active_segment_sequence_number = 0;
 
+  // If set, syncs of the active segment are combined with syncs of other logs on the node.
+  LogSyncGroup* sync_group = nullptr;
+
   LogOptions();
 };
 
@@ -402,6 +409,9 @@ class WritableLogSegment {
   // Makes sure the I/O buffers in the underlying writable file are flushed.
   CHECKED_STATUS Sync();
 
+  // Starts writeback of the data written so far, without waiting for it to complete.
+  CHECKED_STATUS Flush();
+
   // Returns true if the segment header has already been written to disk.
   bool IsHeaderWritten() const {
     return is_header_written_;
@@ -454,6 +464,9 @@ class WritableLogSegment {
 
   LogSegmentFooterPB footer_;
 
+  // Buffer for entry batches compressed as specified in header_.
+  faststring compressed_buffer_;
+
   // the offset of the first entry in the log
   int64_t first_entry_offset_;
 
@@ -55,6 +55,11 @@ DEFINE_int32(num_writer_threads, 1, "Number of threads writing to the log");
 DEFINE_int32(num_batches_per_thread, 2000, "Number of batches per thread");
 DEFINE_int32(num_ops_per_batch_avg, 5, "Target average number of ops per batch");
 
+DECLARE_bool(log_background_periodic_sync);
+
+METRIC_DECLARE_histogram(log_sync_latency);
+METRIC_DECLARE_histogram(log_group_commit_latency);
+
 namespace yb {
 namespace log {
 
@@ -146,6 +151,8 @@ class MultiThreadedLogTest : public LogTestBase {
     ASSERT_EQ(0, errors.size());
   }
 
+  void TestAppends();
+
   void Run() {
     for (int i = 0; i < FLAGS_num_writer_threads; i++) {
       scoped_refptr<yb::Thread> new_thread;
@@ -163,15 +170,25 @@ class MultiThreadedLogTest : public LogTestBase {
   vector<scoped_refptr<yb::Thread> > threads_;
 };
 
-TEST_F(MultiThreadedLogTest, TestAppends) {
+void MultiThreadedLogTest::TestAppends() {
   BuildLog();
   auto start_current_id = current_index_;
+  MonoTime start = MonoTime::Now();
   LOG_TIMING(INFO, strings::Substitute("inserting $0 batches($1 threads, $2 per-thread)",
                                       FLAGS_num_writer_threads * FLAGS_num_batches_per_thread,
                                       FLAGS_num_batches_per_thread, FLAGS_num_writer_threads)) {
     ASSERT_NO_FATALS(Run());
   }
+  auto elapsed = MonoTime::Now() - start;
   ASSERT_OK(log_->Close());
+  LOG(INFO) << "Append throughput: "
+            << (current_index_ - start_current_id) / elapsed.ToSeconds() << " ops/s";
+  for (auto* prototype : {&METRIC_log_sync_latency, &METRIC_log_group_commit_latency}) {
+    const auto* histogram = prototype->Instantiate(table_metric_entity_)->histogram();
+    LOG(INFO) << prototype->name() << ": count: " << histogram->TotalCount()
+              << ", mean: " << histogram->MeanValue()
+              << "us, p99: " << histogram->ValueAtPercentile(99) << "us";
+  }
 
   std::unique_ptr<LogReader> reader;
   ASSERT_OK(LogReader::Open(fs_manager_->env(), nullptr, "Log reader: ",
@@ -195,5 +212,16 @@ TEST_F(MultiThreadedLogTest, TestAppends) {
   ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
 }
 
+TEST_F(MultiThreadedLogTest, TestAppends) {
+  TestAppends();
+}
+
+TEST_F(MultiThreadedLogTest, TestAppendsWithBackgroundSync) {
+  FLAGS_log_background_periodic_sync = true;
+  options_.durable_wal_write = false;
+  options_.interval_durable_wal_write = MonoDelta::FromMilliseconds(1);
+  TestAppends();
+}
+
 } // namespace log
 } // namespace yb
@@ -18,7 +18,9 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus.proxy.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/periodic.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/util/flag_tags.h"
 
@@ -43,7 +45,20 @@ DEFINE_uint64(multi_raft_batch_size, 1,
 TAG_FLAG(multi_raft_batch_size, experimental);
 TAG_FLAG(multi_raft_batch_size, hidden);
 
+DEFINE_bool(enable_multi_raft_update_batching, false,
+            "Whether to also batch raft requests carrying operations, when batching of raft "
+            "heartbeats is enabled.");
+TAG_FLAG(enable_multi_raft_update_batching, experimental);
+TAG_FLAG(enable_multi_raft_update_batching, hidden);
+
+DEFINE_int32(multi_raft_update_batch_window_us, 200,
+             "Maximum time a raft request carrying operations waits in a batch, for requests to "
+             "other tablets on the same server.");
+TAG_FLAG(multi_raft_update_batch_window_us, experimental);
+TAG_FLAG(multi_raft_update_batch_window_us, hidden);
+
 DECLARE_int32(consensus_rpc_timeout_ms);
+DECLARE_uint64(consensus_max_batch_size_bytes);
 
 namespace yb {
 namespace consensus {
@@ -55,6 +70,11 @@ struct MultiRaftHeartbeatBatcher::MultiRaftConsensusData {
   MultiRaftConsensusResponsePB batch_res;
   rpc::RpcController controller;
   std::vector<ResponseCallbackData> response_callback_data;
+  // Keep operations of batched requests, declared after batch_req, so operations are released
+  // from it first.
+  std::vector<ReplicateMsgsHolder> msgs_holders;
+  // Size of batched requests carrying operations.
+  size_t ops_requests_size = 0;
 };
 
 MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(const yb::HostPort& hostport,
@@ -81,26 +101,72 @@ MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() = default;
 
 void MultiRaftHeartbeatBatcher::AddRequestToBatch(ConsensusRequestPB* request,
                                                   ConsensusResponsePB* response,
-                                                  HeartbeatResponseCallback callback) {
-  std::shared_ptr<MultiRaftConsensusData> data = nullptr;
+                                                  HeartbeatResponseCallback callback,
+                                                  ReplicateMsgsHolder msgs_holder) {
+  const bool has_ops = request->ops_size() != 0;
+  const size_t request_size = has_ops ? request->ByteSizeLong() : 0;
+  std::shared_ptr<MultiRaftConsensusData> full_batch;
+  std::shared_ptr<MultiRaftConsensusData> data;
+  bool schedule_send = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    if (has_ops && current_batch_->ops_requests_size != 0 &&
+        current_batch_->ops_requests_size + request_size > FLAGS_consensus_max_batch_size_bytes) {
+      // Keep the batch under the size limit, that is respected by a single request.
+      full_batch = PrepareNextBatchRequest();
+    }
     current_batch_->response_callback_data.push_back({
       response,
       std::move(callback)
     });
     // Add a ConsensusRequestPB to the batch
-    current_batch_->batch_req.add_consensus_request()->Swap(request);
+    auto* batched_request = current_batch_->batch_req.add_consensus_request();
+    batched_request->Swap(request);
+    if (has_ops) {
+      msgs_holder.SetOps(batched_request->mutable_ops());
+      current_batch_->msgs_holders.push_back(std::move(msgs_holder));
+      // The first request with operations starts the batch window.
+      schedule_send = current_batch_->ops_requests_size == 0;
+      current_batch_->ops_requests_size += request_size;
+    }
     if (FLAGS_multi_raft_batch_size > 0
         && current_batch_->response_callback_data.size() >= FLAGS_multi_raft_batch_size) {
       data = PrepareNextBatchRequest();
+      schedule_send = false;
+    } else if (schedule_send) {
+      data = current_batch_;
     }
   }
-  if (data) {
+  SendBatchRequest(full_batch);
+  if (schedule_send) {
+    std::weak_ptr<MultiRaftHeartbeatBatcher> weak_batcher = shared_from_this();
+    messenger_->scheduler().Schedule(
+        [weak_batcher, data](const Status& status) {
+          auto batcher = weak_batcher.lock();
+          if (batcher && status.ok()) {
+            batcher->SendBatchIfCurrent(data);
+          }
+        },
+        std::chrono::microseconds(FLAGS_multi_raft_update_batch_window_us));
+  } else {
     SendBatchRequest(data);
   }
 }
 
+void MultiRaftHeartbeatBatcher::SendBatchIfCurrent(
+    const std::shared_ptr<MultiRaftConsensusData>& batch) {
+  std::shared_ptr<MultiRaftConsensusData> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (current_batch_ != batch) {
+      // Already sent.
+      return;
+    }
+    data = PrepareNextBatchRequest();
+  }
+  SendBatchRequest(data);
+}
+
 void MultiRaftHeartbeatBatcher::PrepareAndSendBatchRequest() {
   std::shared_ptr<MultiRaftConsensusData> data;
   {
@@ -127,6 +193,10 @@ void MultiRaftHeartbeatBatcher::SendBatchRequest(std::shared_ptr<MultiRaftConsen
   }
 
   data->controller.Reset();
+  if (!data->msgs_holders.empty()) {
+    // Same as for the requests with operations sent by Peer.
+    data->controller.set_invoke_callback_mode(rpc::InvokeCallbackMode::kThreadPoolHigh);
+  }
   data->controller.set_timeout(MonoDelta::FromMilliseconds(
     FLAGS_consensus_rpc_timeout_ms * data->batch_req.consensus_request_size()));
   consensus_proxy_->MultiRaftUpdateConsensusAsync(
@@ -18,6 +18,7 @@
 #include "yb/common/common_net.pb.h"
 
 #include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/rpc/rpc_controller.h"
 
@@ -44,6 +45,10 @@ using HeartbeatResponseCallback = std::function<void(const Status&)>;
 //   FLAGS_multi_raft_batch_size
 // - To improve efficency multiple batches may be processed concurrently
 //   but only a single batch is being built at any given time
+// - When FLAGS_enable_multi_raft_update_batching is set, requests carrying operations are batched
+//   as well. A batch containing such a request is sent at most
+//   FLAGS_multi_raft_update_batch_window_us after it was added, or once the batch reaches
+//   FLAGS_consensus_max_batch_size_bytes
 class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
  public:
   MultiRaftHeartbeatBatcher(const yb::HostPort& hostport,
@@ -59,9 +64,13 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
   // If the batch executes sucessfully then the response is populated and the callback is executed.
   // If the batch rpc call fails the response will NOT be populated and the callback will be
   // executed with an error status.
+  //
+  // Operations of the request are not owned by it, msgs_holder keeps them alive until the batch
+  // is complete.
   void AddRequestToBatch(ConsensusRequestPB* request,
                          ConsensusResponsePB* response,
-                         HeartbeatResponseCallback callback);
+                         HeartbeatResponseCallback callback,
+                         ReplicateMsgsHolder msgs_holder = ReplicateMsgsHolder());
 
  private:
   // Tracks a single peers ConsensusResponsePB as well as its ProcessResponse callback.
@@ -76,6 +85,10 @@ class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftH
 
   void PrepareAndSendBatchRequest();
 
+  // Sends the batch if it is still being built, used to limit the time that requests carrying
+  // operations spend in the batch.
+  void SendBatchIfCurrent(const std::shared_ptr<MultiRaftConsensusData>& batch);
+
   // This method will return a nullptr if the current batch is empty.
   std::shared_ptr<MultiRaftConsensusData> PrepareNextBatchRequest() REQUIRES(mutex_);
 
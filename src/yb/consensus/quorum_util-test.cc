@@ -74,5 +74,38 @@ TEST(QuorumUtilTest, TestMemberExtraction) {
   ASSERT_EQ("B", peer_pb.permanent_uuid());
 }
 
+TEST(QuorumUtilTest, TestWitnessMembers) {
+  RaftConfigPB config;
+  SetPeerInfo("A", PeerMemberType::VOTER, config.add_peers());
+  SetPeerInfo("B", PeerMemberType::WITNESS, config.add_peers());
+  SetPeerInfo("C", PeerMemberType::PRE_WITNESS, config.add_peers());
+
+  // Witnesses vote and count towards majorities, pre-witnesses are in transition.
+  ASSERT_TRUE(IsRaftConfigVoter("B", config));
+  ASSERT_TRUE(IsRaftConfigWitness("B", config));
+  ASSERT_FALSE(IsRaftConfigVoter("C", config));
+  ASSERT_TRUE(IsRaftConfigWitness("C", config));
+  ASSERT_FALSE(IsRaftConfigWitness("A", config));
+  ASSERT_EQ(2U, CountVoters(config));
+  ASSERT_EQ(1U, CountServersInTransition(config));
+
+  ConsensusStatePB cstate;
+  cstate.set_current_term(1);
+  *cstate.mutable_config() = config;
+  cstate.set_leader_uuid("A");
+  ASSERT_EQ(PeerRole::LEADER, GetConsensusRole("A", cstate));
+  ASSERT_EQ(PeerRole::WITNESS, GetConsensusRole("B", cstate));
+  ASSERT_EQ(PeerRole::LEARNER, GetConsensusRole("C", cstate));
+
+  // A witness cannot be the leader.
+  cstate.set_leader_uuid("B");
+  ASSERT_EQ(PeerRole::NON_PARTICIPANT, GetConsensusRole("B", cstate));
+
+  // A config cannot consist of witnesses only.
+  RaftConfigPB witnesses_only;
+  SetPeerInfo("A", PeerMemberType::WITNESS, witnesses_only.add_peers());
+  ASSERT_NOK(VerifyRaftConfig(witnesses_only, UNCOMMITTED_QUORUM));
+}
+
 } // namespace consensus
 } // namespace yb
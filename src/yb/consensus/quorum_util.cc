@@ -52,6 +52,14 @@ using google::protobuf::RepeatedPtrField;
 using std::string;
 using strings::Substitute;
 
+bool IsVoterMemberType(PeerMemberType member_type) {
+  return member_type == PeerMemberType::VOTER || member_type == PeerMemberType::WITNESS;
+}
+
+bool IsWitnessMemberType(PeerMemberType member_type) {
+  return member_type == PeerMemberType::WITNESS || member_type == PeerMemberType::PRE_WITNESS;
+}
+
 bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config) {
   for (const RaftPeerPB& peer : config.peers()) {
     if (peer.permanent_uuid() == uuid) {
@@ -64,7 +72,16 @@ bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config) {
 bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config) {
   for (const RaftPeerPB& peer : config.peers()) {
     if (peer.permanent_uuid() == uuid) {
-      return peer.member_type() == PeerMemberType::VOTER;
+      return IsVoterMemberType(peer.member_type());
+    }
+  }
+  return false;
+}
+
+bool IsRaftConfigWitness(const std::string& uuid, const RaftConfigPB& config) {
+  for (const RaftPeerPB& peer : config.peers()) {
+    if (peer.permanent_uuid() == uuid) {
+      return IsWitnessMemberType(peer.member_type());
     }
   }
   return false;
@@ -152,7 +169,8 @@ bool RemoveFromRaftConfig(RaftConfigPB* config, const ChangeConfigRequestPB& req
 }
 
 size_t CountVoters(const RaftConfigPB& config) {
-  return CountMemberType(config, PeerMemberType::VOTER);
+  return CountMemberType(config, PeerMemberType::VOTER) +
+         CountMemberType(config, PeerMemberType::WITNESS);
 }
 
 size_t CountVotersInTransition(const RaftConfigPB& config) {
@@ -161,7 +179,8 @@ size_t CountVotersInTransition(const RaftConfigPB& config) {
 
 size_t CountServersInTransition(const RaftConfigPB& config, const string& ignore_uuid) {
   return CountMemberType(config, PeerMemberType::PRE_VOTER, ignore_uuid) +
-         CountMemberType(config, PeerMemberType::PRE_OBSERVER, ignore_uuid);
+         CountMemberType(config, PeerMemberType::PRE_OBSERVER, ignore_uuid) +
+         CountMemberType(config, PeerMemberType::PRE_WITNESS, ignore_uuid);
 }
 
 size_t CountMemberType(const RaftConfigPB& config, const PeerMemberType member_type,
@@ -192,7 +211,9 @@ PeerMemberType GetConsensusMemberType(const std::string& permanent_uuid,
 
 PeerRole GetConsensusRole(const std::string& permanent_uuid, const ConsensusStatePB& cstate) {
   if (cstate.leader_uuid() == permanent_uuid) {
-    if (IsRaftConfigVoter(permanent_uuid, cstate.config())) {
+    // Witnesses never become leaders.
+    if (IsRaftConfigVoter(permanent_uuid, cstate.config()) &&
+        !IsRaftConfigWitness(permanent_uuid, cstate.config())) {
       return PeerRole::LEADER;
     }
     return PeerRole::NON_PARTICIPANT;
@@ -204,9 +225,13 @@ PeerRole GetConsensusRole(const std::string& permanent_uuid, const ConsensusStat
         case PeerMemberType::VOTER:
           return PeerRole::FOLLOWER;
 
-        // PRE_VOTER, PRE_OBSERVER peers are considered LEARNERs.
+        case PeerMemberType::WITNESS:
+          return PeerRole::WITNESS;
+
+        // PRE_VOTER, PRE_OBSERVER and PRE_WITNESS peers are considered LEARNERs.
         case PeerMemberType::PRE_VOTER:
         case PeerMemberType::PRE_OBSERVER:
+        case PeerMemberType::PRE_WITNESS:
           return PeerRole::LEARNER;
 
         case PeerMemberType::OBSERVER:
@@ -269,6 +294,14 @@ Status VerifyRaftConfig(const RaftConfigPB& config, RaftConfigState type) {
     }
   }
 
+  // Witnesses cannot be leaders, so a config with witnesses must have at least one regular voter.
+  if (CountMemberType(config, PeerMemberType::WITNESS) != 0 &&
+      CountMemberType(config, PeerMemberType::VOTER) == 0) {
+    return STATUS(IllegalState,
+        Substitute("RaftConfig with witnesses must have at least one voter. RaftConfig: $0",
+                   config.ShortDebugString()));
+  }
+
   return Status::OK();
 }
 
@@ -282,7 +315,8 @@ Status VerifyConsensusState(const ConsensusStatePB& cstate, RaftConfigState type
   RETURN_NOT_OK(VerifyRaftConfig(cstate.config(), type));
 
   if (cstate.has_leader_uuid() && !cstate.leader_uuid().empty()) {
-    if (!IsRaftConfigVoter(cstate.leader_uuid(), cstate.config())) {
+    if (!IsRaftConfigVoter(cstate.leader_uuid(), cstate.config()) ||
+        IsRaftConfigWitness(cstate.leader_uuid(), cstate.config())) {
       return STATUS(IllegalState,
           Substitute("Leader with UUID $0 is not a VOTER in the config! Consensus state: $1",
                      cstate.leader_uuid(), cstate.ShortDebugString()));
@@ -53,8 +53,19 @@ enum RaftConfigState {
   COMMITTED_QUORUM,
 };
 
+// Whether peers of the specified member type vote and count towards majorities, i.e. VOTER and
+// WITNESS. An operation is majority replicated only after at least one regular follower, besides
+// the leader, has received it, see PeerMessageQueue::OpIdWatermark.
+bool IsVoterMemberType(PeerMemberType member_type);
+
+// Whether peers of the specified member type keep only the log, i.e. WITNESS and PRE_WITNESS.
+bool IsWitnessMemberType(PeerMemberType member_type);
+
 bool IsRaftConfigMember(const std::string& uuid, const RaftConfigPB& config);
+// Returns true for VOTER and WITNESS peers.
 bool IsRaftConfigVoter(const std::string& uuid, const RaftConfigPB& config);
+// Returns true for WITNESS and PRE_WITNESS peers.
+bool IsRaftConfigWitness(const std::string& uuid, const RaftConfigPB& config);
 
 // Get the specified member of the config.
 // Returns Status::NotFound if a member with the specified uuid could not be
@@ -90,13 +101,13 @@ size_t CountMemberType(const RaftConfigPB& config,
                        const PeerMemberType member_type,
                        const std::string& ignore_uuid = "");
 
-// Counts the number of voters in the configuration.
+// Counts the number of voters (including witnesses) in the configuration.
 size_t CountVoters(const RaftConfigPB& config);
 
 // Counts the number of servers that are in transition (being bootstrapped) to become voters.
 size_t CountVotersInTransition(const RaftConfigPB& config);
 
-// Counts the number of servers that are in transition to become voters or observers.
+// Counts the number of servers that are in transition to become voters, witnesses or observers.
 size_t CountServersInTransition(const RaftConfigPB& config, const std::string& ignore_uuid = "");
 
 // Calculates size of a configuration majority based on # of voters.
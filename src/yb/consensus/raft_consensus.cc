@@ -134,6 +134,16 @@ DEFINE_test_flag(int32, follower_reject_update_consensus_requests_seconds, 0,
 DEFINE_test_flag(bool, follower_fail_all_prepare, false,
                  "Whether a follower will fail preparing all operations.");
 
+DEFINE_test_flag(int32, inject_follower_update_latency_ms, 0,
+                 "Delay applied by a follower to each UpdateConsensus() request before handling "
+                 "it. Used to emulate network round trip time between leader and followers.");
+
+DEFINE_int32(consensus_pipelined_request_wait_ms, 1000,
+             "How long a follower waits for the operations preceding the ones in a pipelined "
+             "UpdateConsensus() request, before failing it with a log matching property error.");
+TAG_FLAG(consensus_pipelined_request_wait_ms, advanced);
+TAG_FLAG(consensus_pipelined_request_wait_ms, runtime);
+
 DEFINE_int32(after_stepdown_delay_election_multiplier, 5,
              "After a peer steps down as a leader, the factor with which to multiply "
              "leader_failure_max_missed_heartbeat_periods to get the delay time before starting a "
@@ -343,6 +353,7 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
       options.tablet_id,
       clock,
       consensus_context,
+      raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL),
       raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL));
 
   DCHECK(local_peer_pb.has_permanent_uuid());
@@ -576,7 +587,8 @@ Status RaftConsensus::DoStartElection(const LeaderElectionData& data, PreElected
       LOG_WITH_PREFIX(INFO) << "Not starting " << election_name << " -- already leader";
       return Status::OK();
     }
-    if (active_role == PeerRole::LEARNER || active_role == PeerRole::READ_REPLICA) {
+    if (active_role == PeerRole::LEARNER || active_role == PeerRole::READ_REPLICA ||
+        active_role == PeerRole::WITNESS) {
       LOG_WITH_PREFIX(INFO) << "Not starting " << election_name << " -- role is " << active_role
                             << ", pending = " << state_->IsConfigChangePendingUnlocked()
                             << ", active_role=" << active_role;
@@ -1478,6 +1490,9 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
                                 "is set to true.");
   }
   TEST_PAUSE_IF_FLAG(TEST_follower_pause_update_consensus_requests);
+  if (PREDICT_FALSE(FLAGS_TEST_inject_follower_update_latency_ms > 0)) {
+    SleepFor(FLAGS_TEST_inject_follower_update_latency_ms * 1ms);
+  }
 
   auto reject_mode = reject_mode_.load(std::memory_order_acquire);
   if (reject_mode != RejectMode::kNone) {
@@ -1517,9 +1532,17 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
       return STATUS_FORMAT(TimedOut, "Unable to lock update mutex for $0", wait_duration);
     }
 
+    if (request->pipelined()) {
+      WaitForPrecedingOps(*request, deadline, &lock);
+    }
+
     LongOperationTracker operation_tracker("UpdateReplica", 1s);
     result = VERIFY_RESULT(UpdateReplica(request, response));
 
+    if (num_waiting_pipelined_requests_ != 0) {
+      received_ops_cond_.notify_all();
+    }
+
     auto delay = TEST_delay_update_.load(std::memory_order_acquire);
     if (delay != MonoDelta::kZero) {
       std::this_thread::sleep_for(delay.ToSteadyDuration());
@@ -1952,6 +1975,11 @@ Result<RaftConsensus::UpdateReplicaResult> RaftConsensus::UpdateReplica(
   // Also prohibit voting for anyone for the minimum election timeout.
   withhold_votes_until_.store(now + MinimumElectionTimeout(), std::memory_order_release);
 
+  if (request->has_majority_applied_op_id()) {
+    majority_applied_op_index_.store(
+        request->majority_applied_op_id().index(), std::memory_order_release);
+  }
+
   // 1 - Early commit pending (and committed) operations
   RETURN_NOT_OK(EarlyCommitUnlocked(*request, deduped_req));
 
@@ -2039,9 +2067,15 @@ Result<bool> RaftConsensus::EnqueuePreparesUnlocked(const ConsensusRequestPB& re
 
   HybridTime propagated_safe_time;
   if (request.has_propagated_safe_time()) {
-    propagated_safe_time = HybridTime(request.propagated_safe_time());
-    if (deduped_req.messages.empty()) {
-      state_->context()->SetPropagatedSafeTime(propagated_safe_time);
+    // Safe time could also be advanced by closed timestamps, or propagated by the previous
+    // leader, so only forward it to MVCC when it moves forward.
+    HybridTime request_safe_time(request.propagated_safe_time());
+    if (!follower_propagated_safe_time_ || request_safe_time > follower_propagated_safe_time_) {
+      propagated_safe_time = request_safe_time;
+      follower_propagated_safe_time_ = propagated_safe_time;
+      if (deduped_req.messages.empty()) {
+        state_->context()->SetPropagatedSafeTime(propagated_safe_time);
+      }
     }
   }
 
@@ -2482,9 +2516,11 @@ Status RaftConsensus::ChangeConfig(const ChangeConfigRequestPB& req,
                                    req.ShortDebugString()));
         }
         if (server.member_type() != PeerMemberType::PRE_VOTER &&
-            server.member_type() != PeerMemberType::PRE_OBSERVER) {
+            server.member_type() != PeerMemberType::PRE_OBSERVER &&
+            server.member_type() != PeerMemberType::PRE_WITNESS) {
           return STATUS(InvalidArgument,
-              Substitute("Server with UUID $0 must be of member_type PRE_VOTER or PRE_OBSERVER. "
+              Substitute("Server with UUID $0 must be of member_type PRE_VOTER, PRE_OBSERVER or "
+                         "PRE_WITNESS. "
                          "member_type received: $1", server_uuid,
                          PeerMemberType_Name(server.member_type())));
         }
@@ -2545,13 +2581,16 @@ Status RaftConsensus::ChangeConfig(const ChangeConfigRequestPB& req,
                        server_uuid, new_config.ShortDebugString()));
         }
         if (new_peer->member_type() != PeerMemberType::PRE_OBSERVER &&
-            new_peer->member_type() != PeerMemberType::PRE_VOTER) {
+            new_peer->member_type() != PeerMemberType::PRE_VOTER &&
+            new_peer->member_type() != PeerMemberType::PRE_WITNESS) {
           return STATUS(IllegalState, Substitute("Cannot change role of server with UUID $0 "
                                                  "because its member type is $1",
                                                  server_uuid, new_peer->member_type()));
         }
         if (new_peer->member_type() == PeerMemberType::PRE_OBSERVER) {
           new_peer->set_member_type(PeerMemberType::OBSERVER);
+        } else if (new_peer->member_type() == PeerMemberType::PRE_WITNESS) {
+          new_peer->set_member_type(PeerMemberType::WITNESS);
         } else {
           new_peer->set_member_type(PeerMemberType::VOTER);
         }
@@ -3168,6 +3207,77 @@ yb::OpId RaftConsensus::GetLastReceivedOpId() {
   return state_->GetLastReceivedOpIdUnlocked();
 }
 
+void RaftConsensus::WaitForPrecedingOps(
+    const ConsensusRequestPB& request, CoarseTimePoint deadline,
+    std::unique_lock<std::timed_mutex>* update_lock) {
+  const auto preceding_index = request.preceding_id().index();
+  if (GetLastReceivedOpId().index >= preceding_index) {
+    return;
+  }
+
+  // The request was sent by the leader while the ones carrying preceding operations were in
+  // flight, and overtook them. Wait for them instead of failing the log matching property check,
+  // which would make the leader resend all operations after the last acked one.
+  deadline = std::min(
+      deadline,
+      CoarseMonoClock::now() + GetAtomicFlag(&FLAGS_consensus_pipelined_request_wait_ms) * 1ms);
+  ++num_waiting_pipelined_requests_;
+  received_ops_cond_.wait_until(*update_lock, deadline, [this, preceding_index] {
+    return GetLastReceivedOpId().index >= preceding_index;
+  });
+  --num_waiting_pipelined_requests_;
+}
+
+Result<bool> RaftConsensus::GetClosedTimestamp(ClosedTimestampPB* closed_timestamp) {
+  auto leader_state = GetLeaderState();
+  if (!leader_state.ok()) {
+    return false;
+  }
+  auto closed_ht = VERIFY_RESULT(state_->context()->LeaderClosedTimestamp());
+  if (!closed_ht) {
+    return false;
+  }
+
+  // Operations with hybrid time not greater than closed_ht were already appended, so last
+  // received op id should be picked after safe time.
+  auto lock = state_->LockForRead();
+  if (state_->GetCurrentTermUnlocked() != leader_state.term) {
+    return false;
+  }
+  closed_timestamp->set_tablet_id(state_->GetOptions().tablet_id);
+  closed_timestamp->set_leader_term(leader_state.term);
+  state_->GetLastReceivedOpIdUnlocked().ToPB(closed_timestamp->mutable_op_id());
+  closed_timestamp->set_closed_ht(closed_ht.ToUint64());
+  return true;
+}
+
+Result<bool> RaftConsensus::ApplyClosedTimestamp(const ClosedTimestampPB& closed_timestamp) {
+  ReplicaState::UniqueLock lock;
+  RETURN_NOT_OK(state_->LockForUpdate(&lock));
+
+  if (state_->GetCurrentTermUnlocked() != closed_timestamp.leader_term() ||
+      state_->GetActiveRoleUnlocked() == PeerRole::LEADER) {
+    return false;
+  }
+
+  // All operations of the same term are appended by the same leader, so having received an
+  // operation of this term with index not less than op_id means that all operations preceding
+  // op_id match the leader log and were already submitted for prepare.
+  auto op_id = yb::OpId::FromPB(closed_timestamp.op_id());
+  auto last_received = state_->GetLastReceivedOpIdUnlocked();
+  if (last_received.term != op_id.term || last_received.index < op_id.index) {
+    return false;
+  }
+
+  HybridTime closed_ht(closed_timestamp.closed_ht());
+  if (follower_propagated_safe_time_ && closed_ht <= follower_propagated_safe_time_) {
+    return false;
+  }
+  follower_propagated_safe_time_ = closed_ht;
+  state_->context()->SetPropagatedSafeTime(closed_ht);
+  return true;
+}
+
 yb::OpId RaftConsensus::GetLastCommittedOpId() {
   auto lock = state_->LockForRead();
   return state_->GetCommittedOpIdUnlocked();
@@ -3331,6 +3441,10 @@ yb::OpId RaftConsensus::MinRetryableRequestOpId() {
   return state_->MinRetryableRequestOpId();
 }
 
+int64_t RaftConsensus::MajorityAppliedOpIndex() const {
+  return majority_applied_op_index_.load(std::memory_order_acquire);
+}
+
 size_t RaftConsensus::LogCacheSize() {
   return queue_->LogCacheSize();
 }
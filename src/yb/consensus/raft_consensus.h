@@ -34,6 +34,7 @@
 #define YB_CONSENSUS_RAFT_CONSENSUS_H_
 
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -220,6 +221,16 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
                              committed_index, last_committed_op_id);
   }
 
+  // Fills closed_timestamp with the hybrid time closed by this leader, so it could be published to
+  // followers. Returns false if this peer is not a ready leader or safe time propagation is
+  // disabled.
+  Result<bool> GetClosedTimestamp(ClosedTimestampPB* closed_timestamp);
+
+  // Applies closed timestamp published by the leader. Returns false if it was ignored, because
+  // this replica did not receive all operations preceding it yet, or it is not newer than the
+  // safe time propagated previously.
+  Result<bool> ApplyClosedTimestamp(const ClosedTimestampPB& closed_timestamp);
+
   yb::OpId GetLastReceivedOpId() override;
 
   yb::OpId GetLastCommittedOpId() override;
@@ -236,6 +247,14 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   yb::OpId MinRetryableRequestOpId();
 
+  // Index of the last operation that the leader reported as applied by a majority of non-witness
+  // voters. Only propagated to witness replicas, which use it to garbage collect their log.
+  int64_t MajorityAppliedOpIndex() const;
+
+  void TEST_SetMajorityAppliedOpIndex(int64_t index) {
+    majority_applied_op_index_.store(index, std::memory_order_release);
+  }
+
   CHECKED_STATUS StartElection(const LeaderElectionData& data) override {
     return DoStartElection(data, PreElected::kFalse);
   }
@@ -396,6 +415,13 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
       ConsensusRequestPB* request,
       ConsensusResponsePB* response);
 
+  // Waits until operations preceding the ones in the pipelined request are received, the deadline
+  // passes or FLAGS_consensus_pipelined_request_wait_ms expires. 'update_lock' should hold
+  // update_mutex_, it is released while waiting.
+  void WaitForPrecedingOps(
+      const ConsensusRequestPB& request, CoarseTimePoint deadline,
+      std::unique_lock<std::timed_mutex>* update_lock);
+
   // Deduplicates an RPC request making sure that we get only messages that we
   // haven't appended to our log yet.
   // On return 'deduplicated_req' is instantiated with only the new messages
@@ -700,6 +726,13 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
   // taken, this lock must be taken first.
   mutable std::timed_mutex update_mutex_;
 
+  // Notified when operations are received from the leader, while there are pipelined requests
+  // waiting for the operations preceding theirs. Used with update_mutex_.
+  std::condition_variable_any received_ops_cond_;
+
+  // Number of pipelined requests waiting on received_ops_cond_. Protected by update_mutex_.
+  size_t num_waiting_pipelined_requests_ = 0;
+
   std::atomic_flag outstanding_report_failure_task_ = ATOMIC_FLAG_INIT;
 
   AtomicBool shutdown_;
@@ -728,8 +761,14 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
 
   std::atomic<MonoDelta> TEST_delay_update_{MonoDelta::kZero};
 
+  // Last safe time propagated by the leader, that was passed to the context. Protected by the
+  // update lock of state_.
+  HybridTime follower_propagated_safe_time_;
+
   std::atomic<uint64_t> majority_num_sst_files_{0};
 
+  std::atomic<int64_t> majority_applied_op_index_{0};
+
   const TabletId split_parent_tablet_id_;
 
   DISALLOW_COPY_AND_ASSIGN(RaftConsensus);
@@ -46,6 +46,11 @@ class ReplicateMsgsHolder {
     ops_ = nullptr;
   }
 
+  // Used when operations are moved to another request.
+  void SetOps(google::protobuf::RepeatedPtrField<ReplicateMsg>* ops) {
+    ops_ = ops;
+  }
+
  private:
   google::protobuf::RepeatedPtrField<ReplicateMsg>* ops_;
 
@@ -29,6 +29,8 @@ class TestConsensusContext : public ConsensusContext {
 
   Result<HybridTime> PreparePeerRequest() override { return HybridTime(); }
 
+  Result<HybridTime> LeaderClosedTimestamp() override { return HybridTime(); }
+
   void MajorityReplicated() override {}
 
   void ChangeConfigReplicated(const RaftConfigPB&) override {}
@@ -24,8 +24,10 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/lock_batch.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/transaction_dump.h"
+#include "yb/docdb/wait_queue.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/scope_exit.h"
@@ -74,6 +76,17 @@ CHECKED_STATUS MakeConflictStatus(const TransactionId& our_id, const Transaction
                  Slice(), TransactionError(TransactionErrorCode::kConflict)));
 }
 
+// Returns kSkipLocking error if any of transactions was read with WAIT_SKIP policy.
+CHECKED_STATUS CheckSkipLocking(boost::iterator_range<TransactionData*> transactions) {
+  for (const auto& transaction : transactions) {
+    if (transaction.wait_policy == WAIT_SKIP) {
+      return STATUS(InternalError, "Skip locking since entity is already locked",
+                    TransactionError(TransactionErrorCode::kSkipLocking));
+    }
+  }
+  return Status::OK();
+}
+
 class ConflictResolver;
 
 class ConflictResolverContext {
@@ -97,6 +110,9 @@ class ConflictResolverContext {
 
   virtual TransactionId transaction_id() const = 0;
 
+  // Priority of the transaction, used to choose a victim when waiting transactions deadlock.
+  virtual uint64_t priority() const = 0;
+
   virtual std::string ToString() const = 0;
 
   std::string LogPrefix() const {
@@ -112,9 +128,13 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
                    TransactionStatusManager* status_manager,
                    PartialRangeKeyIntents partial_range_key_intents,
                    std::unique_ptr<ConflictResolverContext> context,
+                   WaitQueue* wait_queue,
+                   LockBatch* lock_batch,
+                   CoarseTimePoint deadline,
                    ResolutionCallback callback)
       : doc_db_(doc_db), status_manager_(*status_manager), request_scope_(status_manager),
         partial_range_key_intents_(partial_range_key_intents), context_(std::move(context)),
+        wait_queue_(wait_queue), lock_batch_(lock_batch), deadline_(deadline),
         callback_(std::move(callback)) {}
 
   PartialRangeKeyIntents partial_range_key_intents() {
@@ -320,12 +340,60 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
       return true;
     }
 
+    if (wait_queue_ && lock_batch_) {
+      RETURN_NOT_OK(CheckSkipLocking(RemainingTransactions()));
+      WaitForRemainingTransactions();
+      return false;
+    }
+
     RETURN_NOT_OK(context_->CheckPriority(this, RemainingTransactions()));
 
     AbortTransactions();
     return false;
   }
 
+  // Parks this resolution in the wait queue until one of the remaining transactions is resolved.
+  // Locks are released while waiting, so the transactions we are waiting for could proceed.
+  // Request scope is also released, otherwise the participant would not clean up the blockers,
+  // and would not signal their resolution.
+  void WaitForRemainingTransactions() {
+    std::vector<TransactionId> blockers;
+    blockers.reserve(remaining_transactions_);
+    for (const auto& transaction : RemainingTransactions()) {
+      blockers.push_back(transaction.id);
+    }
+    TRACE("Waiting for $0", AsString(blockers));
+    VLOG_WITH_PREFIX(3) << "Waiting for " << AsString(blockers);
+    intent_iter_.Reset();
+    lock_batch_->Unlock();
+    request_scope_ = RequestScope();
+    auto self = shared_from_this();
+    wait_queue_->WaitOn(
+        context_->transaction_id(), context_->priority(), blockers, deadline_,
+        [self](const Status& status) {
+          self->WaitDone(status);
+        });
+  }
+
+  void WaitDone(const Status& status) {
+    if (!status.ok()) {
+      InvokeCallback(status);
+      return;
+    }
+    // Invoked in the wait queue resume pool, so it is OK to block here.
+    auto lock_status = lock_batch_->Relock(deadline_);
+    if (!lock_status.ok()) {
+      InvokeCallback(lock_status);
+      return;
+    }
+    request_scope_ = RequestScope(&status_manager_);
+    // Intents could have been changed while we were waiting, so read conflicts from scratch.
+    conflicts_.clear();
+    transactions_.clear();
+    remaining_transactions_ = 0;
+    Resolve();
+  }
+
   // Returns true when there are no conflicts left.
   Result<bool> CheckLocalCommits() {
     return DoCleanup([this](auto* transaction) -> Result<bool> {
@@ -493,6 +561,9 @@ class ConflictResolver : public std::enable_shared_from_this<ConflictResolver> {
   RequestScope request_scope_;
   PartialRangeKeyIntents partial_range_key_intents_;
   std::unique_ptr<ConflictResolverContext> context_;
+  WaitQueue* const wait_queue_;
+  LockBatch* const lock_batch_;
+  const CoarseTimePoint deadline_;
   ResolutionCallback callback_;
 
   BoundedRocksDbIterator intent_iter_;
@@ -893,6 +964,10 @@ class TransactionConflictResolverContext : public ConflictResolverContextBase {
     return *transaction_id_;
   }
 
+  uint64_t priority() const override {
+    return metadata_.priority;
+  }
+
   std::string ToString() const override {
     return yb::ToString(transaction_id_);
   }
@@ -974,6 +1049,10 @@ class OperationConflictResolverContext : public ConflictResolverContextBase {
     return TransactionId::Nil();
   }
 
+  uint64_t priority() const override {
+    return kHighPriTxnLowerBound - 1;
+  }
+
   std::string ToString() const override {
     return "Operation Context";
   }
@@ -998,13 +1077,17 @@ void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  PartialRangeKeyIntents partial_range_key_intents,
                                  TransactionStatusManager* status_manager,
                                  Counter* conflicts_metric,
+                                 WaitQueue* wait_queue,
+                                 LockBatch* lock_batch,
+                                 CoarseTimePoint deadline,
                                  ResolutionCallback callback) {
   DCHECK(hybrid_time.is_valid());
   TRACE("ResolveTransactionConflicts");
   auto context = std::make_unique<TransactionConflictResolverContext>(
       doc_ops, write_batch, hybrid_time, read_time, conflicts_metric);
   auto resolver = std::make_shared<ConflictResolver>(
-      doc_db, status_manager, partial_range_key_intents, std::move(context), std::move(callback));
+      doc_db, status_manager, partial_range_key_intents, std::move(context), wait_queue,
+      lock_batch, deadline, std::move(callback));
   // Resolve takes a self reference to extend lifetime.
   resolver->Resolve();
   TRACE("resolver->Resolve done");
@@ -1021,7 +1104,9 @@ void ResolveOperationConflicts(const DocOperations& doc_ops,
   auto context = std::make_unique<OperationConflictResolverContext>(&doc_ops, resolution_ht,
                                                                     conflicts_metric);
   auto resolver = std::make_shared<ConflictResolver>(
-      doc_db, status_manager, partial_range_key_intents, std::move(context), std::move(callback));
+      doc_db, status_manager, partial_range_key_intents, std::move(context),
+      nullptr /* wait_queue */, nullptr /* lock_batch */, CoarseTimePoint() /* deadline */,
+      std::move(callback));
   // Resolve takes a self reference to extend lifetime.
   resolver->Resolve();
   TRACE("resolver->Resolve done");
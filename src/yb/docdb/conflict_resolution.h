@@ -43,11 +43,18 @@ using ResolutionCallback = boost::function<void(const Result<HybridTime>&)>;
 // Tries to abort transactions with lower priority.
 // If it conflicts with transaction with higher priority or committed one then error is returned.
 //
+// When wait_queue is specified, conflicting pending transactions are neither aborted nor cause
+// an error. Instead lock_batch is released and the transaction waits in wait_queue until they are
+// resolved, then locks are reacquired and conflicts are resolved again.
+//
 // write_batch - values that would be written as part of transaction.
 // hybrid_time - current hybrid time.
 // db - db that contains tablet data.
 // status_manager - status manager that should be used during this conflict resolution.
 // conflicts_metric - transaction_conflicts metric to update.
+// wait_queue - wait queue of the tablet, or nullptr if transaction should not wait.
+// lock_batch - locks held by the operation, released while waiting.
+// deadline - deadline for waiting and reacquiring locks.
 void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  const KeyValueWriteBatchPB& write_batch,
                                  HybridTime resolution_ht,
@@ -56,6 +63,9 @@ void ResolveTransactionConflicts(const DocOperations& doc_ops,
                                  PartialRangeKeyIntents partial_range_key_intents,
                                  TransactionStatusManager* status_manager,
                                  Counter* conflicts_metric,
+                                 WaitQueue* wait_queue,
+                                 LockBatch* lock_batch,
+                                 CoarseTimePoint deadline,
                                  ResolutionCallback callback);
 
 // Resolves conflicts for doc operations.
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gflags/gflags.h>
+
+#include "yb/docdb/deadlock_detector.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(deadlock_detector_report_timeout_ms);
+
+namespace yb {
+namespace docdb {
+
+class DeadlockDetectorTest : public YBTest {
+ protected:
+  WaitingTransactionData Wait(
+      const TransactionId& id, uint64_t priority, std::vector<TransactionId> blockers) {
+    return WaitingTransactionData {
+      .id = id,
+      .priority = priority,
+      .blockers = std::move(blockers),
+    };
+  }
+
+  DeadlockDetector detector_;
+  CoarseTimePoint now_ = CoarseMonoClock::now();
+};
+
+TEST_F(DeadlockDetectorTest, NoCycle) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  auto t3 = TransactionId::GenerateRandom();
+
+  ASSERT_TRUE(detector_.ProcessWaits("ts1", {Wait(t1, 1, {t2})}, now_).empty());
+  ASSERT_TRUE(detector_.ProcessWaits("ts2", {Wait(t2, 1, {t3})}, now_).empty());
+  ASSERT_EQ(detector_.num_deadlocks(), 0U);
+}
+
+// Transactions wait for each other at tablets of different servers.
+TEST_F(DeadlockDetectorTest, CycleAcrossServers) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  auto t3 = TransactionId::GenerateRandom();
+
+  ASSERT_TRUE(detector_.ProcessWaits("ts1", {Wait(t1, 10, {t2})}, now_).empty());
+  ASSERT_TRUE(detector_.ProcessWaits("ts2", {Wait(t2, 5, {t3})}, now_).empty());
+  // The cycle is closed by ts3, but the lowest priority waiter t2 is waiting at ts2.
+  ASSERT_TRUE(detector_.ProcessWaits("ts3", {Wait(t3, 20, {t1})}, now_).empty());
+  ASSERT_EQ(detector_.num_deadlocks(), 1U);
+
+  auto victims = detector_.ProcessWaits("ts2", {Wait(t2, 5, {t3})}, now_);
+  ASSERT_EQ(victims, std::vector<TransactionId>{t2});
+  // Cycle is not reported again while victim is still waiting.
+  ASSERT_TRUE(detector_.ProcessWaits("ts1", {Wait(t1, 10, {t2})}, now_).empty());
+  ASSERT_EQ(detector_.num_deadlocks(), 1U);
+
+  // Victim failed its wait, so it is not a victim when it waits again.
+  ASSERT_TRUE(detector_.ProcessWaits("ts2", {}, now_).empty());
+  ASSERT_TRUE(detector_.ProcessWaits("ts1", {Wait(t1, 10, {t2})}, now_).empty());
+  ASSERT_EQ(detector_.num_deadlocks(), 1U);
+}
+
+TEST_F(DeadlockDetectorTest, ExpiredSource) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+
+  ASSERT_TRUE(detector_.ProcessWaits("ts1", {Wait(t1, 1, {t2})}, now_).empty());
+  // Waits of ts1 are discarded, since ts1 did not report them for too long.
+  auto later = now_ + FLAGS_deadlock_detector_report_timeout_ms * 1ms + 1s;
+  ASSERT_TRUE(detector_.ProcessWaits("ts2", {Wait(t2, 1, {t1})}, later).empty());
+  ASSERT_EQ(detector_.num_deadlocks(), 0U);
+
+  auto victims = detector_.ProcessWaits("ts1", {Wait(t1, 1, {t2})}, later);
+  ASSERT_EQ(detector_.num_deadlocks(), 1U);
+  // Priorities are equal, so transaction with larger id is chosen as victim.
+  ASSERT_EQ(victims.empty(), t1 < t2);
+}
+
+} // namespace docdb
+} // namespace yb
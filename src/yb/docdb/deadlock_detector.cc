@@ -0,0 +1,194 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/deadlock_detector.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+
+using namespace std::literals;
+
+DEFINE_int32(deadlock_detector_report_timeout_ms, 10000,
+             "Waits reported by a tablet server are discarded by the deadlock detector, when the "
+             "tablet server did not report waits for this amount of time.");
+TAG_FLAG(deadlock_detector_report_timeout_ms, advanced);
+TAG_FLAG(deadlock_detector_report_timeout_ms, runtime);
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+struct WaitingNode {
+  uint64_t priority = 0;
+  std::vector<TransactionId> blockers;
+};
+
+using WaitGraph = std::unordered_map<TransactionId, WaitingNode, TransactionIdHash>;
+
+// Returns transactions that form a cycle in the graph, or empty vector if there are no cycles.
+std::vector<TransactionId> FindCycle(const WaitGraph& graph) {
+  enum class VisitState {
+    kInProgress,
+    kDone,
+  };
+
+  std::unordered_map<TransactionId, VisitState, TransactionIdHash> state;
+  // Transaction and index of the next blocker to visit.
+  std::vector<std::pair<const TransactionId*, size_t>> stack;
+  for (const auto& root : graph) {
+    if (state.count(root.first)) {
+      continue;
+    }
+    state.emplace(root.first, VisitState::kInProgress);
+    stack.emplace_back(&root.first, 0);
+    while (!stack.empty()) {
+      auto& top = stack.back();
+      const auto& blockers = graph.find(*top.first)->second.blockers;
+      if (top.second == blockers.size()) {
+        state[*top.first] = VisitState::kDone;
+        stack.pop_back();
+        continue;
+      }
+      const auto& next = blockers[top.second++];
+      auto next_it = graph.find(next);
+      if (next_it == graph.end()) {
+        // Blocker is not waiting for anything.
+        continue;
+      }
+      auto state_it = state.find(next);
+      if (state_it == state.end()) {
+        state.emplace(next, VisitState::kInProgress);
+        stack.emplace_back(&next_it->first, 0);
+      } else if (state_it->second == VisitState::kInProgress) {
+        std::vector<TransactionId> cycle;
+        auto it = stack.end();
+        do {
+          --it;
+          cycle.push_back(*it->first);
+        } while (*it->first != next);
+        return cycle;
+      }
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+DeadlockDetector::DeadlockDetector() = default;
+
+DeadlockDetector::~DeadlockDetector() = default;
+
+std::vector<TransactionId> DeadlockDetector::ProcessWaits(
+    const std::string& source, std::vector<WaitingTransactionData> waits, CoarseTimePoint now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CleanupExpiredSourcesUnlocked(now);
+  if (waits.empty()) {
+    if (sources_.erase(source)) {
+      CleanupVictimsUnlocked();
+    }
+    return {};
+  }
+
+  auto& data = sources_[source];
+  data.waits = std::move(waits);
+  data.update_time = now;
+  CleanupVictimsUnlocked();
+  DetectDeadlocksUnlocked();
+
+  std::vector<TransactionId> result;
+  for (const auto& wait : data.waits) {
+    if (victims_.count(wait.id) &&
+        std::find(result.begin(), result.end(), wait.id) == result.end()) {
+      result.push_back(wait.id);
+    }
+  }
+  return result;
+}
+
+size_t DeadlockDetector::num_deadlocks() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_deadlocks_;
+}
+
+void DeadlockDetector::CleanupExpiredSourcesUnlocked(CoarseTimePoint now) {
+  const auto timeout = FLAGS_deadlock_detector_report_timeout_ms * 1ms;
+  for (auto it = sources_.begin(); it != sources_.end();) {
+    if (it->second.update_time + timeout < now) {
+      LOG(INFO) << "Discarding expired waits reported by " << it->first;
+      it = sources_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void DeadlockDetector::CleanupVictimsUnlocked() {
+  TransactionIdSet waiting;
+  for (const auto& source : sources_) {
+    for (const auto& wait : source.second.waits) {
+      waiting.insert(wait.id);
+    }
+  }
+  for (auto it = victims_.begin(); it != victims_.end();) {
+    if (waiting.count(*it)) {
+      ++it;
+    } else {
+      it = victims_.erase(it);
+    }
+  }
+}
+
+void DeadlockDetector::DetectDeadlocksUnlocked() {
+  // Victims are excluded from the graph, since their waits are already being failed.
+  WaitGraph graph;
+  for (const auto& source : sources_) {
+    for (const auto& wait : source.second.waits) {
+      if (victims_.count(wait.id)) {
+        continue;
+      }
+      auto& node = graph[wait.id];
+      node.priority = wait.priority;
+      node.blockers.insert(node.blockers.end(), wait.blockers.begin(), wait.blockers.end());
+    }
+  }
+
+  for (;;) {
+    auto cycle = FindCycle(graph);
+    if (cycle.empty()) {
+      break;
+    }
+    auto victim = cycle.front();
+    auto victim_priority = graph[victim].priority;
+    for (const auto& id : cycle) {
+      auto priority = graph[id].priority;
+      if (priority < victim_priority || (priority == victim_priority && victim < id)) {
+        victim = id;
+        victim_priority = priority;
+      }
+    }
+    LOG(INFO) << "Deadlock detected: " << AsString(cycle) << ", victim: " << victim;
+    victims_.insert(victim);
+    graph.erase(victim);
+    ++num_deadlocks_;
+  }
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DEADLOCK_DETECTOR_H
+#define YB_DOCDB_DEADLOCK_DETECTOR_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/transaction.h"
+
+#include "yb/docdb/wait_queue.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace docdb {
+
+// Finds cycles in the graph of transactions waiting for each other.
+//
+// Waits are reported by multiple sources, i.e. tablet servers, each report replaces the previous
+// report of the same source. So the graph combines waits from all tablets of the cluster, and
+// cycles that span multiple tablets and servers are detected.
+//
+// For each cycle the waiter with the lowest priority is chosen as a victim. The victim is
+// returned to the sources that reported its waits, until it disappears from their reports.
+class DeadlockDetector {
+ public:
+  DeadlockDetector();
+  ~DeadlockDetector();
+
+  // Replaces waits reported by source, and detects deadlocks when the graph was changed.
+  // Returns victims that are waiting at source.
+  std::vector<TransactionId> ProcessWaits(
+      const std::string& source, std::vector<WaitingTransactionData> waits, CoarseTimePoint now);
+
+  // Returns the number of detected deadlocks.
+  size_t num_deadlocks() const;
+
+ private:
+  struct SourceData {
+    std::vector<WaitingTransactionData> waits;
+    CoarseTimePoint update_time;
+  };
+
+  void CleanupExpiredSourcesUnlocked(CoarseTimePoint now) REQUIRES(mutex_);
+  void DetectDeadlocksUnlocked() REQUIRES(mutex_);
+  void CleanupVictimsUnlocked() REQUIRES(mutex_);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, SourceData> sources_ GUARDED_BY(mutex_);
+  TransactionIdSet victims_ GUARDED_BY(mutex_);
+  size_t num_deadlocks_ GUARDED_BY(mutex_) = 0;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_DEADLOCK_DETECTOR_H
@@ -22,6 +22,7 @@
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/decimal.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/string_trim.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
@@ -731,5 +732,53 @@ TEST_F(DocKeyTest, TestEnumerateIntents) {
   }
 }
 
+#ifdef NDEBUG
+// Decoding of keys with long string components, whose time is dominated by scanning for the
+// terminator of zero encoded strings.
+TEST_F(DocKeyTest, BenchmarkDecodeStringComponents) {
+  constexpr size_t kNumKeys = 10000;
+  constexpr size_t kStringLength = 64;
+
+  RandomNumberGenerator rng;  // Use the default seed to keep it deterministic.
+  std::vector<KeyBytes> encoded_keys;
+  encoded_keys.reserve(kNumKeys);
+  for (size_t i = 0; i != kNumKeys; ++i) {
+    std::string str;
+    for (size_t j = 0; j != kStringLength; ++j) {
+      // No zero bytes, so strings do not contain escape sequences.
+      str.push_back(static_cast<char>(1 + rng() % 255));
+    }
+    SubDocKey key(
+        DocKey({
+            PrimitiveValue(str),
+            PrimitiveValue(static_cast<int64_t>(i)),
+            PrimitiveValue(str, SortOrder::kDescending)}),
+        PrimitiveValue(str),
+        HybridTime::FromMicros(1000));
+    encoded_keys.push_back(key.Encode());
+  }
+
+  size_t total_size = 0;
+  LOG_TIMING(INFO, "Skipping doc keys") {
+    for (int trial = 0; trial != 100; ++trial) {
+      for (const auto& encoded_key : encoded_keys) {
+        total_size += ASSERT_RESULT(
+            DocKey::EncodedSize(encoded_key.AsSlice(), DocKeyPart::kWholeDocKey));
+      }
+    }
+  }
+  ASSERT_GT(total_size, 0);
+
+  SubDocKey decoded_key;
+  LOG_TIMING(INFO, "Decoding sub doc keys") {
+    for (int trial = 0; trial != 100; ++trial) {
+      for (const auto& encoded_key : encoded_keys) {
+        ASSERT_OK(decoded_key.FullyDecodeFrom(encoded_key.AsSlice()));
+      }
+    }
+  }
+}
+#endif
+
 }  // namespace docdb
 }  // namespace yb
@@ -825,6 +825,10 @@ class DocDbAwareFilterPolicyBase : public rocksdb::FilterPolicy {
 
   FilterType GetFilterType() const override;
 
+ protected:
+  explicit DocDbAwareFilterPolicyBase(const rocksdb::FilterPolicy* builtin_policy)
+      : builtin_policy_(builtin_policy) {}
+
  private:
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
 };
@@ -869,6 +873,18 @@ class DocDbAwareV3FilterPolicy : public DocDbAwareFilterPolicyBase {
   const KeyTransformer* GetKeyTransformer() const override;
 };
 
+// The same key transformation as DocDbAwareV3FilterPolicy, but keys are stored in xor filters
+// instead of bloom filters, that gives lower false positive rate for the same filter block size.
+class DocDbAwareV3XorFilterPolicy : public DocDbAwareFilterPolicyBase {
+ public:
+  explicit DocDbAwareV3XorFilterPolicy(size_t filter_block_size_bits)
+      : DocDbAwareFilterPolicyBase(rocksdb::NewFixedSizeXorFilterPolicy(filter_block_size_bits)) {}
+
+  const char* Name() const override { return "DocKeyV3XorFilter"; }
+
+  const KeyTransformer* GetKeyTransformer() const override;
+};
+
 }  // namespace docdb
 }  // namespace yb
 
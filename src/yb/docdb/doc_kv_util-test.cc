@@ -118,6 +118,28 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make zero and 0xff bytes frequent, to cover escape sequences.
+      s.push_back(rng.OneIn(8) ? '\0' : rng.OneIn(8) ? '\xff' : static_cast<char>(rng.Next()));
+    }
+    KeyBuffer encoded;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded);
+    // Data after the terminator should not be consumed.
+    encoded.PushBack('x');
+    rocksdb::Slice slice = encoded.AsSlice();
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    ASSERT_EQ("x", slice.ToBuffer());
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
@@ -13,6 +13,8 @@
 
 #include "yb/docdb/doc_kv_util.h"
 
+#include <cstring>
+
 #include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/value_type.h"
@@ -114,6 +116,23 @@ void TerminateComplementZeroEncodedKeyStr(KeyBuffer *dest) {
   TerminateEncodedKeyStr<'\xff'>(dest);
 }
 
+namespace {
+
+// Appends [begin, end) to result, reverting the XOR with END_OF_STRING applied by encoding.
+template<char END_OF_STRING>
+void AppendDecodedChars(const char* begin, const char* end, string* result) {
+  const auto old_size = result->size();
+  result->append(begin, end);
+  if (END_OF_STRING != '\0') {
+    // Simple loop over the contiguous buffer, that is vectorized by the compiler.
+    for (auto it = result->begin() + old_size; it != result->end(); ++it) {
+      *it ^= END_OF_STRING;
+    }
+  }
+}
+
+} // namespace
+
 template<char END_OF_STRING>
 Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   static_assert(END_OF_STRING == '\0' || END_OF_STRING == '\xff',
@@ -123,34 +142,41 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* end = p + slice->size();
 
   while (p != end) {
+    // Regular characters are skipped or copied in bulk up to the next END_OF_STRING. memchr is
+    // implemented with SSE2/AVX2 instructions, selected at runtime according to the CPU.
+    const char* next = static_cast<const char*>(memchr(p, END_OF_STRING, end - p));
+    if (next == nullptr) {
+      next = end;
+    }
+    if (result != nullptr) {
+      AppendDecodedChars<END_OF_STRING>(p, next, result);
+    }
+    p = next;
+    if (p == end) {
+      break;
+    }
+
+    ++p;
+    if (p == end) {
+      return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
+                                             END_OF_STRING));
+    }
     if (*p == END_OF_STRING) {
+      // Found two END_OF_STRING characters, this is the end of the encoded string.
       ++p;
-      if (p == end) {
-        return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
-                                               END_OF_STRING));
-      }
-      if (*p == END_OF_STRING) {
-        // Found two END_OF_STRING characters, this is the end of the encoded string.
-        ++p;
-        break;
-      }
-      if (*p == END_OF_STRING_ESCAPE) {
-        // 0 is encoded as 00 01 in ascending encoding and FF FE in descending encoding.
-        if (result != nullptr) {
-          result->push_back(0);
-        }
-        ++p;
-      } else {
-        return STATUS(Corruption, StringPrintf(
-            "Invalid sequence in encoded string: "
-            R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
-            END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
-      }
-    } else {
+      break;
+    }
+    if (*p == END_OF_STRING_ESCAPE) {
+      // 0 is encoded as 00 01 in ascending encoding and FF FE in descending encoding.
       if (result != nullptr) {
-        result->push_back((*p) ^ END_OF_STRING);
+        result->push_back(0);
       }
       ++p;
+    } else {
+      return STATUS(Corruption, StringPrintf(
+          "Invalid sequence in encoded string: "
+          R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
+          END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
     }
   }
   if (result != nullptr) {
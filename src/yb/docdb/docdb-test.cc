@@ -11,7 +11,9 @@
 // under the License.
 //
 
+#include <limits>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "yb/common/doc_hybrid_time.h"
@@ -31,6 +33,7 @@
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value.h"
 
 #include "yb/gutil/casts.h"
@@ -39,6 +42,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/write_batch.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -74,7 +78,9 @@ using rocksdb::WriteOptions;
 using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
+DECLARE_bool(use_docdb_aware_xor_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_int32(docdb_memtable_hash_index_buckets);
 DECLARE_bool(TEST_docdb_sort_weak_intents);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
@@ -661,6 +667,112 @@ TEST_F(DocDBTestQl, LastProjectionIsNull) {
   )#", doc_from_rocksdb.ToString());
 }
 
+TEST_F(DocDBTestQl, PackedRow) {
+  const DocKey doc_key(PrimitiveValues("mydockey", 123456));
+  KeyBytes encoded_doc_key(doc_key.Encode());
+  const ColumnId kColumn1(10);
+  const ColumnId kColumn2(11);
+  const ColumnId kColumn3(12);
+
+  // Written before the row was packed, so should be overwritten by it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue(kColumn3)), PrimitiveValue("old"), 500_usec_ht));
+  {
+    RowPacker packer(/* schema_version= */ 1);
+    packer.AddValue(kColumn1, PrimitiveValue("value1"));
+    packer.AddValue(kColumn2, PrimitiveValue(2));
+    auto dwb = MakeDocWriteBatch();
+    auto& key_value = dwb.AddRaw();
+    key_value.first = encoded_doc_key.ToStringBuffer();
+    key_value.second = packer.Complete();
+    ASSERT_OK(WriteToRocksDB(dwb, 1000_usec_ht));
+  }
+  ASSERT_OK(SetPrimitive(
+      DocPath(encoded_doc_key, PrimitiveValue(kColumn1)), PrimitiveValue("value1_prime"),
+      2000_usec_ht));
+  ASSERT_OK(DeleteSubDoc(DocPath(encoded_doc_key, PrimitiveValue(kColumn2)), 3000_usec_ht));
+
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["mydockey", 123456]), [HT{ physical: 1000 }]) -> \
+          PACKED_ROW[1]{10: "value1", 11: 2}
+      SubDocKey(DocKey([], ["mydockey", 123456]), [ColumnId(10); HT{ physical: 2000 }]) -> \
+          "value1_prime"
+      SubDocKey(DocKey([], ["mydockey", 123456]), [ColumnId(11); HT{ physical: 3000 }]) -> DEL
+      SubDocKey(DocKey([], ["mydockey", 123456]), [ColumnId(12); HT{ physical: 500 }]) -> "old"
+      )#");
+
+  VerifySubDocument(SubDocKey(doc_key), 700_usec_ht, R"#(
+{
+  ColumnId(12): "old"
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 1500_usec_ht, R"#(
+{
+  ColumnId(10): "value1",
+  ColumnId(11): 2
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 2500_usec_ht, R"#(
+{
+  ColumnId(10): "value1_prime",
+  ColumnId(11): 2
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 4000_usec_ht, R"#(
+{
+  ColumnId(10): "value1_prime"
+}
+      )#");
+
+  const vector<PrimitiveValue> projection = {
+    PrimitiveValue(kColumn1),
+    PrimitiveValue(kColumn2),
+    PrimitiveValue(kColumn3),
+  };
+  auto encoded_subdoc_key = SubDocKey(doc_key).EncodeWithoutHt();
+  SubDocument doc_from_rocksdb;
+  bool subdoc_found_in_rocksdb = false;
+  GetSubDocQl(
+      doc_db(), encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb,
+      kNonTransactionalOperationContext, ReadHybridTime::SingleTime(1500_usec_ht), &projection);
+  EXPECT_TRUE(subdoc_found_in_rocksdb);
+  EXPECT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  ColumnId(10): "value1",
+  ColumnId(11): 2,
+  ColumnId(12): DEL
+}
+      )#", doc_from_rocksdb.ToString());
+
+  GetSubDocQl(
+      doc_db(), encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb,
+      kNonTransactionalOperationContext, ReadHybridTime::SingleTime(4000_usec_ht), &projection);
+  EXPECT_TRUE(subdoc_found_in_rocksdb);
+  EXPECT_STR_EQ_VERBOSE_TRIMMED(R"#(
+{
+  ColumnId(10): "value1_prime",
+  ColumnId(11): DEL,
+  ColumnId(12): DEL
+}
+      )#", doc_from_rocksdb.ToString());
+
+  // The tombstone of the packed column should survive major compaction, otherwise the packed
+  // value would become visible again.
+  FullyCompactHistoryBefore(3500_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+      SubDocKey(DocKey([], ["mydockey", 123456]), [HT{ physical: 1000 }]) -> \
+          PACKED_ROW[1]{10: "value1", 11: 2}
+      SubDocKey(DocKey([], ["mydockey", 123456]), [ColumnId(10); HT{ physical: 2000 }]) -> \
+          "value1_prime"
+      SubDocKey(DocKey([], ["mydockey", 123456]), [ColumnId(11); HT{ physical: 3000 }]) -> DEL
+      )#");
+  VerifySubDocument(SubDocKey(doc_key), 4000_usec_ht, R"#(
+{
+  ColumnId(10): "value1_prime"
+}
+      )#");
+}
+
 TEST_F(DocDBTestQl, ColocatedTableTombstoneTest) {
   constexpr PgTableOid pgtable_id(0x4001);
   DocKey doc_key_1(PrimitiveValues("mydockey", 123456));
@@ -3032,6 +3144,94 @@ TEST_P(DocDBTestWrapper, BloomFilterCorrectness) {
   }
 }
 
+// Reads DB that contains SST files written with both bloom and xor filters, each file should be
+// checked using the filter policy it was written with.
+TEST_P(DocDBTestWrapper, MixedFilterPolicies) {
+  if (!FLAGS_use_docdb_aware_bloom_filter) {
+    return;
+  }
+  // Turn off "next instead of seek" optimization, because this test rely on DocDB to do seeks.
+  FLAGS_max_nexts_to_avoid_seek = 0;
+  FLAGS_use_docdb_aware_xor_filter = false;
+  ASSERT_OK(ReinitDBOptions());
+
+  DocKey key1(0, PrimitiveValues("key1"), PrimitiveValues());
+  DocKey key2(0, PrimitiveValues("key2"), PrimitiveValues());
+  DocKey key3(0, PrimitiveValues("key3"), PrimitiveValues());
+
+  auto write_and_flush = [this](const DocKey& first, const DocKey& second, HybridTime ht) {
+    auto dwb = MakeDocWriteBatch();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(first.Encode()), PrimitiveValue("value")));
+    ASSERT_OK(dwb.SetPrimitive(DocPath(second.Encode()), PrimitiveValue("value")));
+    ASSERT_OK(WriteToRocksDB(dwb, ht));
+    ASSERT_OK(FlushRocksDbAndWait());
+  };
+
+  // file1 (bloom): k1, k3
+  // file2 (xor): k1, k2
+  ASSERT_NO_FATALS(write_and_flush(key1, key3, 1000_usec_ht));
+  FLAGS_use_docdb_aware_xor_filter = true;
+  ASSERT_OK(ReinitDBOptions());
+  ASSERT_NO_FATALS(write_and_flush(key1, key2, 2000_usec_ht));
+
+  rocksdb::TablePropertiesCollection props;
+  ASSERT_OK(rocksdb()->GetPropertiesOfAllTables(&props));
+  std::set<std::string> filter_policy_names;
+  for (const auto& prop : props) {
+    filter_policy_names.insert(prop.second->filter_policy_name);
+  }
+  ASSERT_EQ(filter_policy_names.size(), 2U) << yb::ToString(filter_policy_names);
+
+  // Both files should be readable after reopen with either policy configured for new files.
+  for (const auto use_xor_filter : { true, false }) {
+    FLAGS_use_docdb_aware_xor_filter = use_xor_filter;
+    ASSERT_OK(ReinitDBOptions());
+    for (const auto* key : { &key1, &key2, &key3 }) {
+      const auto bloom_useful =
+          regular_db_options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+      SubDocument doc_from_rocksdb;
+      bool subdoc_found_in_rocksdb = false;
+      GetSubDoc(SubDocKey(*key).EncodeWithoutHt(), &doc_from_rocksdb, &subdoc_found_in_rocksdb);
+      ASSERT_TRUE(subdoc_found_in_rocksdb) << key->ToString();
+      const auto bloom_useful_updated =
+          regular_db_options().statistics->getTickerCount(rocksdb::BLOOM_FILTER_USEFUL);
+      if (key == &key1) {
+        ASSERT_EQ(bloom_useful_updated, bloom_useful);
+      } else {
+        // k2 is filtered out from file1 by bloom filter, k3 from file2 by xor filter.
+        ASSERT_GT(bloom_useful_updated, bloom_useful) << key->ToString();
+      }
+    }
+  }
+}
+
+// Conflict resolution for table-level strong intent seeks regular DB to the key without hashed
+// components and expects to find records of all documents, including ones still in memtable.
+TEST_P(DocDBTestWrapper, TableLevelIntentSeekInHashIndexedMemTable) {
+  FLAGS_docdb_memtable_hash_index_buckets = 16;
+  ASSERT_OK(ReinitDBOptions());
+
+  DocKey key1(0, PrimitiveValues("key1"), PrimitiveValues());
+  DocKey key2(0xffff, PrimitiveValues("key2"), PrimitiveValues());
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key1.Encode()), PrimitiveValue("value1")));
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key2.Encode()), PrimitiveValue("value2")));
+  ASSERT_OK(WriteToRocksDB(dwb, 1000_usec_ht));
+
+  const char table_intent_key[] = { ValueTypeAsChar::kGroupEnd };
+  const Slice table_intent_key_slice(table_intent_key, sizeof(table_intent_key));
+  auto iter = CreateRocksDBIterator(
+      doc_db().regular, doc_db().key_bounds, BloomFilterMode::USE_BLOOM_FILTER,
+      table_intent_key_slice, rocksdb::kDefaultQueryId);
+  iter.Seek(table_intent_key_slice);
+  for (const auto* key : { &key1, &key2 }) {
+    ASSERT_TRUE(iter.Valid()) << key->ToString();
+    ASSERT_TRUE(iter.key().starts_with(key->Encode().AsSlice())) << key->ToString();
+    iter.Next();
+  }
+  ASSERT_FALSE(iter.Valid());
+}
+
 TEST_P(DocDBTestWrapper, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -3958,5 +4158,86 @@ TEST_P(DocDBTestWrapper, DISABLED_KeyBuffer) {
   TestKeyBytes<ByteBuffer<64>>("ByteBuffer<64>");
 }
 
+// Checks boundaries of chunks of transaction reverse index, returned by SplitApplyIntents, and that
+// chunks prepared by PrepareApplyIntentsChunk contain the same records as the sequential apply.
+TEST_P(DocDBTestWrapper, SplitApplyIntents) {
+  constexpr int kNumKeys = 5;
+  const auto kTxnHT = 5000_usec_ht;
+  const auto kCommitHT = 6000_usec_ht;
+
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+  const auto txn_id = TransactionId::GenerateRandom();
+  SetCurrentTransactionId(txn_id);
+  for (int i = 0; i != kNumKeys; ++i) {
+    const DocKey doc_key(PrimitiveValues(Format("key$0", i)));
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key.Encode(), PrimitiveValue("subkey")), PrimitiveValue(i), kTxnHT));
+  }
+  ResetCurrentTransactionId();
+
+  auto split = [this, &txn_id](size_t records_per_chunk, size_t max_chunks) {
+    return SplitApplyIntents(txn_id, Slice(), records_per_chunk, max_chunks, intents_db());
+  };
+
+  // With single record chunks, every record starts a chunk.
+  const auto all_records = ASSERT_RESULT(split(1, std::numeric_limits<size_t>::max()));
+  ASSERT_GE(all_records.size(), kNumKeys + 1U);
+  ASSERT_TRUE(all_records.back().empty());
+  const size_t num_records = all_records.size() - 1;
+
+  // Reverse index that consists of exactly one chunk.
+  auto bounds = ASSERT_RESULT(split(num_records, 10));
+  ASSERT_EQ(bounds, std::vector<std::string>({ all_records.front(), std::string() }));
+
+  // Exact multiple of chunk size, so the last full chunk is also returned.
+  bounds = ASSERT_RESULT(split(1, num_records));
+  ASSERT_EQ(bounds, all_records);
+
+  // One full chunk and the rest with a single record.
+  bounds = ASSERT_RESULT(split(num_records - 1, 10));
+  ASSERT_EQ(bounds, std::vector<std::string>({ all_records.front(), all_records[num_records - 1] }));
+
+  // Not enough records for a full chunk.
+  bounds = ASSERT_RESULT(split(num_records + 1, 10));
+  ASSERT_EQ(bounds, std::vector<std::string>({ all_records.front() }));
+
+  // Limited by the number of chunks.
+  bounds = ASSERT_RESULT(split(1, 2));
+  ASSERT_EQ(bounds, std::vector<std::string>(all_records.begin(), all_records.begin() + 3));
+
+  // Continue from the key of the rest.
+  bounds = ASSERT_RESULT(SplitApplyIntents(
+      txn_id, all_records[2], 1, std::numeric_limits<size_t>::max(), intents_db()));
+  ASSERT_EQ(bounds, std::vector<std::string>(all_records.begin() + 2, all_records.end()));
+
+  rocksdb::WriteBatch sequential_batch;
+  auto apply_state = ASSERT_RESULT(PrepareApplyIntentsBatch(
+      TabletId(), txn_id, AbortedSubTransactionSet(), kCommitHT, &KeyBounds::kNoBounds,
+      nullptr /* apply_state */, kCommitHT, &sequential_batch, intents_db(),
+      nullptr /* intents_batch */));
+  ASSERT_FALSE(apply_state.active());
+
+  const size_t records_per_chunk = (num_records + 1) / 2;
+  bounds = ASSERT_RESULT(split(records_per_chunk, 10));
+  ASSERT_GE(bounds.size(), 2U);
+  int chunks_count = 0;
+  for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+    rocksdb::WriteBatch chunk_batch;
+    ASSERT_RESULT(PrepareApplyIntentsChunk(
+        txn_id, AbortedSubTransactionSet(), kCommitHT, &KeyBounds::kNoBounds, bounds[i],
+        bounds[i + 1], intents_db(), &chunk_batch));
+    chunks_count += chunk_batch.Count();
+  }
+  if (!bounds.back().empty()) {
+    rocksdb::WriteBatch rest_batch;
+    ASSERT_RESULT(PrepareApplyIntentsChunk(
+        txn_id, AbortedSubTransactionSet(), kCommitHT, &KeyBounds::kNoBounds, bounds.back(),
+        Slice(), intents_db(), &rest_batch));
+    chunks_count += rest_batch.Count();
+  }
+  ASSERT_EQ(chunks_count, sequential_batch.Count());
+  ASSERT_GE(chunks_count, kNumKeys);
+}
+
 }  // namespace docdb
 }  // namespace yb
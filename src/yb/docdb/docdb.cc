@@ -1042,6 +1042,20 @@ void AppendTransactionKeyPrefix(const TransactionId& transaction_id, KeyBytes* o
   out->AppendRawBytes(transaction_id.AsSlice());
 }
 
+namespace {
+
+// Returns key of the intent record referenced by the value of a reverse index record.
+Result<Slice> ReverseIndexIntentKey(Slice reverse_index_value) {
+  if (!reverse_index_value.empty() && reverse_index_value[0] == ValueTypeAsChar::kBitSet) {
+    CHECK(!FLAGS_TEST_fail_on_replicated_batch_idx_set_in_txn_record);
+    reverse_index_value.remove_prefix(1);
+    RETURN_NOT_OK(OneWayBitmap::Skip(&reverse_index_value));
+  }
+  return reverse_index_value;
+}
+
+} // namespace
+
 CHECKED_STATUS IntentToWriteRequest(
     const Slice& transaction_id_slice,
     const AbortedSubTransactionSet& aborted,
@@ -1170,6 +1184,14 @@ ApplyTransactionState StoreApplyState(
   return result;
 }
 
+void RemoveApplyState(
+    const Slice& transaction_id_slice, HybridTime commit_ht, IntraTxnWriteId write_id,
+    rocksdb::WriteBatch* regular_batch) {
+  char tombstone_value_type = ValueTypeAsChar::kTombstone;
+  std::array<Slice, 1> value_parts = {{Slice(&tombstone_value_type, 1)}};
+  PutApplyState(transaction_id_slice, commit_ht, write_id, value_parts, regular_batch);
+}
+
 Result<ApplyTransactionState> PrepareApplyIntentsBatch(
     const TabletId& tablet_id,
     const TransactionId& transaction_id,
@@ -1236,8 +1258,10 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
     }
   }
 
+  // Write id could not be used to limit number of applied records, because it is taken from the
+  // applied intents, and apply could be started from a lower bound of it.
   const uint64_t max_records = FLAGS_txn_max_apply_batch_records;
-  const uint64_t write_id_limit = write_id + max_records;
+  uint64_t num_applied_records = 0;
   while (reverse_index_iter.Valid()) {
     const Slice key_slice(reverse_index_iter.key());
 
@@ -1253,18 +1277,13 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
     // txn_reverse_index_prefix in size, then they are identical, and we are seeked to transaction
     // metadata. Otherwise, we're seeked to an intent entry in the index which we may process.
     if (key_slice.size() > txn_reverse_index_prefix.size()) {
-      auto reverse_index_value = reverse_index_iter.value();
-      if (!reverse_index_value.empty() && reverse_index_value[0] == ValueTypeAsChar::kBitSet) {
-        CHECK(!FLAGS_TEST_fail_on_replicated_batch_idx_set_in_txn_record);
-        reverse_index_value.remove_prefix(1);
-        RETURN_NOT_OK(OneWayBitmap::Skip(&reverse_index_value));
-      }
+      auto reverse_index_value = VERIFY_RESULT(ReverseIndexIntentKey(reverse_index_iter.value()));
 
       // Value of reverse index is a key of original intent record, so seek it and check match.
       if (regular_batch && IsWithinBounds(key_bounds, reverse_index_value)) {
         // We store apply state only if there are some more intents left.
-        // So doing this check here, instead of right after write_id was incremented.
-        if (write_id >= write_id_limit) {
+        // So doing this check here, instead of right after the record was applied.
+        if (num_applied_records >= max_records) {
           return StoreApplyState(
               transaction_id_slice, key_slice, write_id, latest_aborted_set, commit_ht,
               regular_batch);
@@ -1272,6 +1291,7 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
         RETURN_NOT_OK(IntentToWriteRequest(
             transaction_id_slice, latest_aborted_set, commit_ht, key_slice, reverse_index_value,
             &intent_iter, regular_batch, &write_id));
+        ++num_applied_records;
       }
 
       if (intents_batch) {
@@ -1295,9 +1315,7 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
   }
 
   if (apply_state && regular_batch) {
-    char tombstone_value_type = ValueTypeAsChar::kTombstone;
-    std::array<Slice, 1> value_parts = {{Slice(&tombstone_value_type, 1)}};
-    PutApplyState(transaction_id_slice, commit_ht, write_id, value_parts, regular_batch);
+    RemoveApplyState(transaction_id_slice, commit_ht, write_id, regular_batch);
   }
 
   if (regular_batch) {
@@ -1307,6 +1325,87 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
   return ApplyTransactionState {};
 }
 
+Result<std::vector<std::string>> SplitApplyIntents(
+    const TransactionId& transaction_id,
+    const Slice& start_key,
+    size_t records_per_chunk,
+    size_t max_chunks,
+    rocksdb::DB* intents_db) {
+  SCHECK_GT(records_per_chunk, 0U, InvalidArgument, "Chunk should contain some records");
+
+  KeyBytes txn_reverse_index_prefix;
+  AppendTransactionKeyPrefix(transaction_id, &txn_reverse_index_prefix);
+  txn_reverse_index_prefix.AppendValueType(ValueType::kMaxByte);
+  Slice key_prefix = txn_reverse_index_prefix.AsSlice();
+  key_prefix.remove_suffix(1);
+  const Slice reverse_index_upperbound = txn_reverse_index_prefix.AsSlice();
+
+  auto reverse_index_iter = CreateRocksDBIterator(
+      intents_db, &KeyBounds::kNoBounds, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+      rocksdb::kDefaultQueryId, nullptr /* read_filter */, &reverse_index_upperbound);
+
+  std::vector<std::string> result;
+  size_t num_records = 0;
+  reverse_index_iter.Seek(start_key.empty() ? key_prefix : start_key);
+  while (reverse_index_iter.Valid() && reverse_index_iter.key().starts_with(key_prefix)) {
+    if (num_records % records_per_chunk == 0) {
+      result.push_back(reverse_index_iter.key().ToBuffer());
+      if (result.size() > max_chunks) {
+        return result;
+      }
+    }
+    ++num_records;
+    reverse_index_iter.Next();
+  }
+  // Reverse index ended right after a full chunk, so there is no record to start the rest with.
+  if (num_records != 0 && num_records % records_per_chunk == 0) {
+    result.emplace_back();
+  }
+  return result;
+}
+
+Result<IntraTxnWriteId> PrepareApplyIntentsChunk(
+    const TransactionId& transaction_id,
+    const AbortedSubTransactionSet& aborted,
+    HybridTime commit_ht,
+    const KeyBounds* key_bounds,
+    const Slice& start_key,
+    const Slice& end_key,
+    rocksdb::DB* intents_db,
+    rocksdb::WriteBatch* regular_batch) {
+  KeyBytes txn_reverse_index_prefix;
+  Slice transaction_id_slice = transaction_id.AsSlice();
+  AppendTransactionKeyPrefix(transaction_id, &txn_reverse_index_prefix);
+  txn_reverse_index_prefix.AppendValueType(ValueType::kMaxByte);
+  const Slice upperbound = end_key.empty() ? txn_reverse_index_prefix.AsSlice() : end_key;
+
+  auto reverse_index_iter = CreateRocksDBIterator(
+      intents_db, &KeyBounds::kNoBounds, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+      rocksdb::kDefaultQueryId, nullptr /* read_filter */, &upperbound);
+  auto intent_iter = CreateRocksDBIterator(
+      intents_db, key_bounds, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none,
+      rocksdb::kDefaultQueryId);
+
+  // Write id is taken from applied intents, so any lower bound could be used as initial value.
+  IntraTxnWriteId write_id = 0;
+  for (reverse_index_iter.Seek(start_key); reverse_index_iter.Valid();
+       reverse_index_iter.Next()) {
+    const Slice key_slice(reverse_index_iter.key());
+    // Skip transaction metadata, see PrepareApplyIntentsBatch.
+    if (key_slice.size() <= txn_reverse_index_prefix.size()) {
+      continue;
+    }
+    auto reverse_index_value = VERIFY_RESULT(ReverseIndexIntentKey(reverse_index_iter.value()));
+    if (IsWithinBounds(key_bounds, reverse_index_value)) {
+      RETURN_NOT_OK(IntentToWriteRequest(
+          transaction_id_slice, aborted, commit_ht, key_slice, reverse_index_value,
+          &intent_iter, regular_batch, &write_id));
+    }
+  }
+
+  return write_id;
+}
+
 std::string ApplyTransactionState::ToString() const {
   return Format(
       "{ key: $0 write_id: $1 aborted: $2 }", Slice(key).ToDebugString(), write_id, aborted);
@@ -251,6 +251,44 @@ Result<ApplyTransactionState> PrepareApplyIntentsBatch(
     rocksdb::DB* intents_db,
     rocksdb::WriteBatch* intents_batch);
 
+// Stores apply state of the transaction, that should be continued from key, to regular_batch.
+ApplyTransactionState StoreApplyState(
+    const Slice& transaction_id_slice, const Slice& key, IntraTxnWriteId write_id,
+    const AbortedSubTransactionSet& aborted, HybridTime commit_ht,
+    rocksdb::WriteBatch* regular_batch);
+
+// Adds removal of apply state, stored by StoreApplyState, to regular_batch.
+void RemoveApplyState(
+    const Slice& transaction_id_slice, HybridTime commit_ht, IntraTxnWriteId write_id,
+    rocksdb::WriteBatch* regular_batch);
+
+// Splits transaction reverse index, starting from start_key or from its beginning when start_key
+// is empty, into chunks of records_per_chunk records.
+// Returns keys of first records of chunks. At most max_chunks full chunks are returned, the last
+// key starts the rest of reverse index, that does not contain a full chunk or exceeds max_chunks.
+// The last key is empty when the reverse index ends right after the last full chunk.
+Result<std::vector<std::string>> SplitApplyIntents(
+    const TransactionId& transaction_id,
+    const Slice& start_key,
+    size_t records_per_chunk,
+    size_t max_chunks,
+    rocksdb::DB* intents_db);
+
+// Fills regular_batch with intents referenced by transaction reverse index records in
+// [start_key, end_key), empty end_key means the end of reverse index. Unlike
+// PrepareApplyIntentsBatch, it does not store apply state and does not remove intents, so chunks
+// of the same transaction could be prepared in parallel.
+// Returns write id of the last applied intent, or 0 if nothing was applied.
+Result<IntraTxnWriteId> PrepareApplyIntentsChunk(
+    const TransactionId& transaction_id,
+    const AbortedSubTransactionSet& aborted,
+    HybridTime commit_ht,
+    const KeyBounds* key_bounds,
+    const Slice& start_key,
+    const Slice& end_key,
+    rocksdb::DB* intents_db,
+    rocksdb::WriteBatch* regular_batch);
+
 void AppendTransactionKeyPrefix(const TransactionId& transaction_id, docdb::KeyBytes* out);
 
 // Class that is used while combining external intents into single key value pair.
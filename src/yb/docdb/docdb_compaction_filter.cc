@@ -21,6 +21,7 @@
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/key_bounds.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/value_type.h"
 
@@ -41,6 +42,36 @@ using rocksdb::FilterDecision;
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Repacks packed_row without the columns that were deleted from the schema. Returns false if the
+// packed row does not contain deleted columns, so it could be kept as is.
+Result<bool> RemoveDeletedColumns(
+    const Slice& packed_row_value, const ColumnIds& deleted_cols, std::string* out) {
+  PackedRow packed_row;
+  RETURN_NOT_OK(packed_row.Decode(packed_row_value));
+  bool has_deleted_columns = false;
+  for (const auto& column : packed_row.columns()) {
+    if (deleted_cols.count(column.first)) {
+      has_deleted_columns = true;
+      break;
+    }
+  }
+  if (!has_deleted_columns) {
+    return false;
+  }
+  RowPacker packer(packed_row.schema_version());
+  for (const auto& column : packed_row.columns()) {
+    if (!deleted_cols.count(column.first)) {
+      packer.AddEncodedValue(column.first, column.second);
+    }
+  }
+  *out = packer.Complete();
+  return true;
+}
+
+} // namespace
+
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilter::DocDBCompactionFilter(
@@ -112,6 +143,9 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   }
 
   sub_key_ends_.resize(num_shared_components);
+  if (num_shared_components == 0) {
+    doc_has_packed_row_ = false;
+  }
 
   RETURN_NOT_OK(SubDocKey::DecodeDocKeyAndSubKeyEnds(key, &sub_key_ends_));
   const size_t new_stack_size = sub_key_ends_.size();
@@ -223,6 +257,9 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   const auto value_type = static_cast<ValueType>(
       value_slice.FirstByteOr(ValueTypeAsChar::kInvalid));
   const Expiration curr_exp(ht.hybrid_time(), value.ttl());
+  if (value_type == ValueType::kPackedRow) {
+    doc_has_packed_row_ = true;
+  }
 
   // If within the merge block.
   //     If the row is a TTL row, delete it.
@@ -303,6 +340,20 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
     value.EncodeAndAppend(new_value, &value_slice);
   }
 
+  // Columns deleted from the schema are dropped from packed rows, the same way as their separately
+  // stored values are discarded above.
+  if (value_type == ValueType::kPackedRow && !has_expired && retention_.deleted_cols &&
+      !retention_.deleted_cols->empty()) {
+    std::string packed_row;
+    if (VERIFY_RESULT(RemoveDeletedColumns(value_slice, *retention_.deleted_cols, &packed_row))) {
+      Slice packed_row_slice(packed_row);
+      *value_changed = true;
+      new_value->clear();
+      // Control fields of value already reflect the changes made above.
+      value.EncodeAndAppend(new_value, &packed_row_slice);
+    }
+  }
+
   // If we are backfilling an index table, we want to preserve the delete markers in the table
   // until the backfill process is completed. For other normal use cases, delete markers/tombstones
   // can be cleaned up on a major compaction.
@@ -314,7 +365,7 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
   return value_type == ValueType::kTombstone && is_major_compaction_ &&
-                 !retention_.retain_delete_markers_in_major_compaction
+                 !retention_.retain_delete_markers_in_major_compaction && !doc_has_packed_row_
              ? FilterDecision::kDiscard
              : FilterDecision::kKeep;
 }
@@ -367,6 +418,14 @@ const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+Slice DocDBCompactionFilterFactory::SubcompactionBoundaryPrefix(const Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::kWholeDocKey);
+  if (!doc_key_size.ok()) {
+    return Slice();
+  }
+  return user_key.Prefix(*doc_key_size);
+}
+
 // ------------------------------------------------------------------------------------------------
 
 HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective() {
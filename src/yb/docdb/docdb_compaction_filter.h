@@ -157,6 +157,11 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // the Filter function.
   bool filter_usage_logged_ = false;
   bool within_merge_block_ = false;
+
+  // Whether the document that is being processed has a packed row at or below the history cutoff.
+  // Column values of a packed row are not stored under their own keys, so tombstones for those
+  // columns cannot be removed while the packed row is there.
+  bool doc_has_packed_row_ = false;
 };
 
 // A strategy for deciding how the history of old database operations should be retained during
@@ -176,6 +181,10 @@ class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // The filter tracks overwrites and TTL of a document across its subkeys, so subcompactions are
+  // split only at document key boundaries.
+  Slice SubcompactionBoundaryPrefix(const Slice& user_key) const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
   const KeyBounds* key_bounds_;
@@ -0,0 +1,225 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+
+#include "yb/gutil/macros.h"
+
+#include "yb/rocksdb/table/block_builder.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
+
+#include "yb/util/format.h"
+#include "yb/util/monotime.h"
+#include "yb/util/random.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace yb::size_literals;
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr size_t kNumRows = 20000;
+constexpr size_t kBlockSize = 32_KB;
+constexpr uint32_t kMaxDictBytes = 16_KB;
+
+const char* const kCities[] = {
+    "Sunnyvale", "San Francisco", "New York", "Seattle", "Austin", "Chicago", "Boston"};
+
+// Returns DocDB key/values of a YSQL like table with a few columns, one of them is a JSON document.
+// Keys are returned in order, with RocksDB internal key suffix.
+std::vector<std::pair<std::string, std::string>> GenerateKeyValues() {
+  Random rnd(42);
+  std::vector<std::pair<std::string, std::string>> result;
+  const auto hybrid_time = HybridTime::FromMicros(1600000000000000);
+  for (size_t row = 0; row != kNumRows; ++row) {
+    const auto user_id = Format("user-$0", rnd.Next() % 1000000);
+    DocKey doc_key(
+        static_cast<DocKeyHash>(rnd.Next()), {PrimitiveValue(user_id)},
+        {PrimitiveValue(static_cast<int64_t>(row))});
+    const std::string city = kCities[rnd.Uniform(arraysize(kCities))];
+    std::vector<std::pair<ColumnId, PrimitiveValue>> columns = {
+        {ColumnId(10), PrimitiveValue(static_cast<int64_t>(rnd.Uniform(100000)))},
+        {ColumnId(11), PrimitiveValue(city)},
+        {ColumnId(12), PrimitiveValue(Format(
+            R"({"name": "$0", "email": "$0@example.com", "city": "$1", "active": $2, )"
+            R"("tags": ["customer", "tier$3"], "visits": $4})",
+            user_id, city, rnd.OneIn(2), rnd.Uniform(4), rnd.Uniform(1000)))},
+    };
+    for (const auto& column : columns) {
+      auto key = SubDocKey(doc_key, PrimitiveValue(column.first), hybrid_time)
+          .Encode().ToStringBuffer();
+      rocksdb::PutFixed64(&key, (row << 8) | 1);
+      result.emplace_back(std::move(key), Value(column.second).Encode());
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<std::string> BuildDataBlocks(
+    const std::vector<std::pair<std::string, std::string>>& key_values) {
+  std::vector<std::string> result;
+  rocksdb::BlockBuilder builder(
+      /* block_restart_interval= */ 16,
+      rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
+  for (const auto& key_value : key_values) {
+    builder.Add(key_value.first, key_value.second);
+    if (builder.CurrentSizeEstimate() >= kBlockSize) {
+      result.push_back(builder.Finish().ToBuffer());
+      builder.Reset();
+    }
+  }
+  if (!builder.empty()) {
+    result.push_back(builder.Finish().ToBuffer());
+  }
+  return result;
+}
+
+std::string TrainDictionary(const std::vector<std::string>& blocks) {
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  for (const auto& block : blocks) {
+    samples.append(block);
+    sample_sizes.push_back(block.size());
+  }
+  return rocksdb::ZSTD_TrainDictionary(samples, sample_sizes, kMaxDictBytes);
+}
+
+bool Compress(
+    rocksdb::CompressionType type, const rocksdb::CompressionOptions& options,
+    const std::string& raw, const rocksdb::CompressionDict* dict, std::string* output) {
+  output->clear();
+  switch (type) {
+    case rocksdb::kSnappyCompression:
+      return rocksdb::Snappy_Compress(options, raw.data(), raw.size(), output);
+    case rocksdb::kZlibCompression:
+      return rocksdb::Zlib_Compress(options, 2, raw.data(), raw.size(), output);
+    case rocksdb::kLZ4Compression:
+      return rocksdb::LZ4_Compress(options, 2, raw.data(), raw.size(), output);
+    case rocksdb::kZSTDNotFinalCompression:
+      return rocksdb::ZSTD_Compress(options, raw.data(), raw.size(), output, dict);
+    default:
+      return false;
+  }
+}
+
+std::unique_ptr<char[]> Uncompress(
+    rocksdb::CompressionType type, const std::string& compressed,
+    const rocksdb::UncompressionDict* dict, size_t raw_size) {
+  int size = 0;
+  switch (type) {
+    case rocksdb::kSnappyCompression: {
+      std::unique_ptr<char[]> result(new char[raw_size]);
+      if (!rocksdb::Snappy_Uncompress(compressed.data(), compressed.size(), result.get())) {
+        return nullptr;
+      }
+      return result;
+    }
+    case rocksdb::kZlibCompression:
+      return std::unique_ptr<char[]>(
+          rocksdb::Zlib_Uncompress(compressed.data(), compressed.size(), &size, 2));
+    case rocksdb::kLZ4Compression:
+      return std::unique_ptr<char[]>(
+          rocksdb::LZ4_Uncompress(compressed.data(), compressed.size(), &size, 2));
+    case rocksdb::kZSTDNotFinalCompression:
+      return std::unique_ptr<char[]>(
+          rocksdb::ZSTD_Uncompress(compressed.data(), compressed.size(), &size, dict));
+    default:
+      return nullptr;
+  }
+}
+
+} // namespace
+
+class DocDBCompressionTest : public YBTest {
+};
+
+// Compares compression ratio and speed of supported compression types on DocDB data blocks.
+TEST_F(DocDBCompressionTest, BenchmarkDataBlockCompression) {
+  const auto blocks = BuildDataBlocks(GenerateKeyValues());
+  size_t raw_size = 0;
+  for (const auto& block : blocks) {
+    raw_size += block.size();
+  }
+  LOG(INFO) << "Data blocks: " << blocks.size() << ", raw size: " << raw_size;
+
+  struct Config {
+    rocksdb::CompressionType type;
+    bool use_dict;
+  };
+  const std::vector<Config> configs = {
+      {rocksdb::kSnappyCompression, false},
+      {rocksdb::kZlibCompression, false},
+      {rocksdb::kLZ4Compression, false},
+      {rocksdb::kZSTDNotFinalCompression, false},
+      {rocksdb::kZSTDNotFinalCompression, true},
+  };
+
+  rocksdb::CompressionOptions options;
+  std::string compressed;
+  for (const auto& config : configs) {
+    if (!rocksdb::CompressionTypeSupported(config.type)) {
+      LOG(INFO) << rocksdb::CompressionTypeToString(config.type) << " is not supported, skipping";
+      continue;
+    }
+    // Dictionaries are digested once per table, like BlockBasedTableBuilder and BlockBasedTable
+    // do.
+    std::unique_ptr<rocksdb::CompressionDict> compression_dict;
+    std::unique_ptr<rocksdb::UncompressionDict> uncompression_dict;
+    size_t compressed_size = 0;
+    if (config.use_dict) {
+      auto dict = TrainDictionary(blocks);
+      ASSERT_FALSE(dict.empty());
+      compressed_size = dict.size();
+      uncompression_dict = std::make_unique<rocksdb::UncompressionDict>(dict);
+      compression_dict = std::make_unique<rocksdb::CompressionDict>(std::move(dict), options);
+    }
+
+    MonoDelta compress_time = MonoDelta::kZero;
+    MonoDelta uncompress_time = MonoDelta::kZero;
+    for (const auto& block : blocks) {
+      auto start = MonoTime::Now();
+      ASSERT_TRUE(Compress(config.type, options, block, compression_dict.get(), &compressed));
+      compress_time += MonoTime::Now() - start;
+      compressed_size += compressed.size();
+
+      start = MonoTime::Now();
+      auto uncompressed = Uncompress(
+          config.type, compressed, uncompression_dict.get(), block.size());
+      uncompress_time += MonoTime::Now() - start;
+      ASSERT_NE(uncompressed, nullptr);
+      ASSERT_EQ(block, std::string(uncompressed.get(), block.size()));
+    }
+
+    const double mb = static_cast<double>(raw_size) / 1_MB;
+    LOG(INFO) << rocksdb::CompressionTypeToString(config.type)
+              << (config.use_dict ? " with dictionary" : "")
+              << ": ratio " << static_cast<double>(raw_size) / compressed_size
+              << ", compress " << mb / compress_time.ToSeconds() << " MB/s"
+              << ", uncompress " << mb / uncompress_time.ToSeconds() << " MB/s";
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
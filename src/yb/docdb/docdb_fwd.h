@@ -25,6 +25,7 @@ namespace docdb {
 
 class ConsensusFrontier;
 class DeadlineInfo;
+class DeadlockDetector;
 class DocDBCompactionFilterFactory;
 class DocKey;
 class DocOperation;
@@ -34,6 +35,7 @@ class DocWriteBatch;
 class HistoryRetentionPolicy;
 class IntentAwareIterator;
 class KeyBytes;
+class LockBatch;
 class ManualHistoryRetentionPolicy;
 class PgsqlWriteOperation;
 class PrimitiveValue;
@@ -41,6 +43,7 @@ class QLWriteOperation;
 class RedisWriteOperation;
 class SharedLockManager;
 class SubDocKey;
+class WaitQueue;
 class YQLRowwiseIteratorIf;
 class YQLStorageIf;
 
@@ -13,6 +13,7 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 
+#include <algorithm>
 #include <memory>
 #include <thread>
 
@@ -34,7 +35,9 @@
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/db/writebuffer.h"
 #include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/memtable/prefix_hash_skiplist_rep.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/persistent_cache.h"
 #include "yb/rocksdb/rate_limiter.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/filtering_iterator.h"
@@ -44,6 +47,7 @@
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/priority_thread_pool.h"
 #include "yb/util/result.h"
 #include "yb/util/size_literals.h"
@@ -92,6 +96,22 @@ DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024
              "Threshold beyond which compaction is considered large.");
 DEFINE_uint64(rocksdb_max_file_size_for_compaction, 0,
              "Maximal allowed file size to participate in RocksDB compaction. 0 - unlimited.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Maximum number of subcompactions a large compaction is split into. Subcompactions "
+             "process disjoint ranges of document keys in parallel on the priority thread pool. "
+             "1 - compactions are not split.");
+TAG_FLAG(rocksdb_max_subcompactions, advanced);
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, false,
+            "Whether writers of a RocksDB write group insert their batches into the regular DB "
+            "memtable in parallel, instead of the group leader inserting all of them. Sequence "
+            "numbers are still assigned by the leader in the group order.");
+TAG_FLAG(rocksdb_allow_concurrent_memtable_write, advanced);
+DEFINE_int32(docdb_memtable_hash_index_buckets, 0,
+             "Number of buckets in the hash index of regular DB memtables. Entries are indexed by "
+             "the encoded document key up to hashed components, so point reads of hash "
+             "partitioned tables don't need to seek through the whole memtable. 0 - memtables "
+             "without hash index. Not used when rocksdb_allow_concurrent_memtable_write is set.");
+TAG_FLAG(docdb_memtable_hash_index_buckets, advanced);
 DEFINE_int32(rocksdb_max_write_buffer_number, 2,
              "Maximum number of write buffers that are built up in memory.");
 
@@ -115,6 +135,11 @@ DEFINE_int32(memstore_size_mb, 128,
 
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_bool(use_docdb_aware_xor_filter, false,
+            "Whether new SST files should use xor filters instead of bloom filters for "
+            "DocDbAwareFilterPolicy. Files written with either filter remain readable regardless "
+            "of this flag. Has effect only when use_docdb_aware_bloom_filter is set.");
+TAG_FLAG(use_docdb_aware_xor_filter, experimental);
 // Empirically 2 is a minimal value that provides best performance on sequential scan.
 DEFINE_int32(max_nexts_to_avoid_seek, 2,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
@@ -143,6 +168,11 @@ DEFINE_string(compression_type, "Snappy",
               "On-disk compression type to use in RocksDB."
               "By default, Snappy is used if supported.");
 
+DEFINE_int32(compression_max_dict_bytes, 0,
+             "Maximum size of dictionary trained for each SST file to compress its data blocks. "
+             "Only used with ZSTD compression type, 0 means that dictionary is not used.");
+TAG_FLAG(compression_max_dict_bytes, advanced);
+
 DEFINE_int32(block_restart_interval, kDefaultBlockStartInterval,
              "Controls the number of keys to look at for computing the diff encoding.");
 
@@ -158,7 +188,8 @@ Result<rocksdb::CompressionType> GetConfiguredCompressionType(const std::string&
     rocksdb::kNoCompression,
     rocksdb::kSnappyCompression,
     rocksdb::kZlibCompression,
-    rocksdb::kLZ4Compression
+    rocksdb::kLZ4Compression,
+    rocksdb::kZSTDNotFinalCompression
   };
   for (const auto& compression_type : kValidRocksDBCompressionTypes) {
     if (flag_value == rocksdb::CompressionTypeToString(compression_type)) {
@@ -313,6 +344,12 @@ void PerformRocksDBSeek(
 
 namespace {
 
+// Returns size of the encoded document key up to hashed components, or 0 for keys without hash.
+size_t HashedDocKeyPrefixSize(const Slice& key) {
+  auto size_result = DocKey::EncodedSizeAndHashPresent(key, DocKeyPart::kUpToHash);
+  return (size_result.ok() && size_result->second) ? size_result->first : 0;
+}
+
 rocksdb::ReadOptions PrepareReadOptions(
     rocksdb::DB* rocksdb,
     BloomFilterMode bloom_filter_mode,
@@ -327,6 +364,10 @@ rocksdb::ReadOptions PrepareReadOptions(
     DCHECK(user_key_for_filter);
     read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
         NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
+    // Filter key contains hashed components of the document key, so the read does not leave the
+    // memtable hash index bucket. Filter key without hashed components, e.g. table-level intent
+    // checked by conflict resolution, could be followed by keys with any hashed components.
+    read_opts.memtable_prefix_seek = HashedDocKeyPrefixSize(*user_key_for_filter) != 0;
   }
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
@@ -369,6 +410,22 @@ namespace {
 
 std::mutex rocksdb_flags_mutex;
 
+// Extracts the encoded document key up to hashed components, for keys without hash returns empty
+// prefix. Each filter policy key of a hashed document key contains this prefix, so reads
+// restricted by filter key could use memtable hash index bucket of this prefix.
+class HashedDocKeyPrefixExtractor : public rocksdb::SliceTransform {
+ public:
+  const char* Name() const override { return "HashedDocKeyPrefixExtractor"; }
+
+  Slice Transform(const Slice& key) const override {
+    return Slice(key.data(), HashedDocKeyPrefixSize(key));
+  }
+
+  bool InDomain(const Slice& key) const override { return true; }
+
+  bool InRange(const Slice& prefix) const override { return true; }
+};
+
 int32_t GetMaxBackgroundFlushes() {
   const auto kNumCpus = base::NumCPUs();
   if (FLAGS_rocksdb_max_background_flushes == -1) {
@@ -594,6 +651,7 @@ void InitRocksDBOptions(
   // Since the flag validator for FLAGS_compression_type will fail if the result of this call is not
   // OK, this CHECK_RESULT should never fail and is safe.
   options->compression = CHECK_RESULT(GetConfiguredCompressionType(FLAGS_compression_type));
+  options->compression_opts.max_dict_bytes = std::max(FLAGS_compression_max_dict_bytes, 0);
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -609,15 +667,33 @@ void InitRocksDBOptions(
     table_options.cache_index_and_filter_blocks = false;
   }
 
+  if (tablet_options.persistent_cache) {
+    table_options.persistent_cache = tablet_options.persistent_cache;
+    // Deleted SST files should not occupy the persistent cache until their blocks are evicted.
+    options->listeners.push_back(
+        rocksdb::NewPersistentCacheFileDeletionListener(tablet_options.persistent_cache));
+  }
+
   AutoInitFromBlockBasedTableOptions(&table_options);
 
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     const auto filter_block_size_bits = table_options.filter_block_size * 8;
-    table_options.filter_policy = std::make_shared<const DocDbAwareV3FilterPolicy>(
+    auto bloom_filter_policy = std::make_shared<const DocDbAwareV3FilterPolicy>(
         filter_block_size_bits, options->info_log.get());
+    auto xor_filter_policy = std::make_shared<const DocDbAwareV3XorFilterPolicy>(
+        filter_block_size_bits);
     table_options.supported_filter_policies =
         std::make_shared<rocksdb::BlockBasedTableOptions::FilterPoliciesMap>();
+    // Filter policy name is stored in the meta index of each SST file, so files written with
+    // bloom and xor filters could coexist.
+    if (FLAGS_use_docdb_aware_xor_filter) {
+      table_options.filter_policy = xor_filter_policy;
+      AddSupportedFilterPolicy(bloom_filter_policy, &table_options);
+    } else {
+      table_options.filter_policy = bloom_filter_policy;
+      AddSupportedFilterPolicy(xor_filter_policy, &table_options);
+    }
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareHashedComponentsFilterPolicy>(
             filter_block_size_bits, options->info_log.get()), &table_options);
     AddSupportedFilterPolicy(std::make_shared<const DocDbAwareV2FilterPolicy>(
@@ -659,6 +735,7 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
+    options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
     options->rate_limiter = tablet_options.rate_limiter ? tablet_options.rate_limiter
                                                         : CreateRocksDBRateLimiter();
   } else {
@@ -668,12 +745,30 @@ void InitRocksDBOptions(
 
   options->max_write_buffer_number = FLAGS_rocksdb_max_write_buffer_number;
 
-  options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
-      0 /* lookahead */, rocksdb::ConcurrentWrites::kFalse);
+  if (FLAGS_rocksdb_allow_concurrent_memtable_write) {
+    options->allow_concurrent_memtable_write = true;
+    options->enable_write_thread_adaptive_yield = true;
+    options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
+        0 /* lookahead */, rocksdb::ConcurrentWrites::kTrue);
+  } else {
+    DisableConcurrentMemTableWrites(options);
+    if (FLAGS_docdb_memtable_hash_index_buckets > 0) {
+      options->memtable_factory = std::make_shared<rocksdb::PrefixHashSkipListRepFactory>(
+          std::make_shared<HashedDocKeyPrefixExtractor>(),
+          FLAGS_docdb_memtable_hash_index_buckets);
+    }
+  }
 
   options->iterator_replacer = std::make_shared<rocksdb::IteratorReplacer>(&WrapIterator);
 }
 
+void DisableConcurrentMemTableWrites(rocksdb::Options* options) {
+  options->allow_concurrent_memtable_write = false;
+  options->enable_write_thread_adaptive_yield = false;
+  options->memtable_factory = std::make_shared<rocksdb::SkipListFactory>(
+      0 /* lookahead */, rocksdb::ConcurrentWrites::kFalse);
+}
+
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix) {
   options->log_prefix = log_prefix;
   options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
@@ -130,6 +130,10 @@ void InitRocksDBOptions(
     const tablet::TabletOptions& tablet_options,
     rocksdb::BlockBasedTableOptions table_options = rocksdb::BlockBasedTableOptions());
 
+// Makes the group leader insert all batches of a write group into the memtable, and uses the
+// single writer memtable that supports erasing entries in place.
+void DisableConcurrentMemTableWrites(rocksdb::Options* options);
+
 // Sets logs prefix for RocksDB options. This will also reinitialize options->info_log.
 void SetLogPrefix(rocksdb::Options* options, const std::string& log_prefix);
 
@@ -21,6 +21,7 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_types.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/value_type.h"
 
@@ -102,6 +103,17 @@ Result<std::string> DocDBValueToDebugStrInternal(Slice value_slice, KeyType key_
   // Empty values are allowed for weak intents.
   if (!value_slice.empty() || key_type != KeyType::kIntentKey) {
     Value v;
+    Slice packed_row_slice = value_slice;
+    RETURN_NOT_OK_PREPEND(
+        v.DecodeControlFields(&packed_row_slice),
+        Format("Error: failed to decode value $0", prefix));
+    if (DecodeValueType(packed_row_slice) == ValueType::kPackedRow) {
+      PackedRow packed_row;
+      RETURN_NOT_OK_PREPEND(
+          packed_row.Decode(packed_row_slice),
+          Format("Error: failed to decode packed row $0", prefix));
+      return prefix + packed_row.ToString();
+    }
     RETURN_NOT_OK_PREPEND(
         v.Decode(value_slice),
         Format("Error: failed to decode value $0", prefix));
@@ -26,7 +26,11 @@ namespace docdb {
 LockBatch::LockBatch(SharedLockManager* lock_manager, LockBatchEntries&& key_to_intent_type,
                      CoarseTimePoint deadline)
     : data_(std::move(key_to_intent_type), lock_manager) {
-  if (!empty() && !lock_manager->Lock(&data_.key_to_type, deadline)) {
+  Lock(deadline);
+}
+
+void LockBatch::Lock(CoarseTimePoint deadline) {
+  if (!empty() && !data_.shared_lock_manager->Lock(&data_.key_to_type, deadline)) {
     data_.shared_lock_manager = nullptr;
     std::string batch_str;
     if (FLAGS_dump_lock_keys) {
@@ -44,10 +48,31 @@ LockBatch::~LockBatch() {
 
 void LockBatch::Reset() {
   if (!empty()) {
-    VLOG(1) << "Auto-unlocking a LockBatch with " << size() << " keys";
-    DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+    if (!data_.unlocked) {
+      VLOG(1) << "Auto-unlocking a LockBatch with " << size() << " keys";
+      DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+    }
     data_.key_to_type.clear();
+    data_.unlocked = false;
+  }
+}
+
+void LockBatch::Unlock() {
+  if (empty() || data_.unlocked) {
+    return;
+  }
+  VLOG(1) << "Temporarily unlocking a LockBatch with " << size() << " keys";
+  DCHECK_NOTNULL(data_.shared_lock_manager)->Unlock(data_.key_to_type);
+  data_.unlocked = true;
+}
+
+Status LockBatch::Relock(CoarseTimePoint deadline) {
+  if (!data_.unlocked) {
+    return data_.status;
   }
+  data_.unlocked = false;
+  Lock(deadline);
+  return data_.status;
 }
 
 void LockBatch::MoveFrom(LockBatch* other) {
@@ -74,9 +74,20 @@ class LockBatch {
   // Unlocks this batch if it is non-empty.
   void Reset();
 
+  // Releases the locks, but keeps the keys, so the batch could be locked again with Relock.
+  // Used while the operation waits for conflicting transactions.
+  void Unlock();
+
+  // Locks keys of the batch that was released with Unlock.
+  // Returns TryAgain if was not able to obtain locks until deadline, in this case the batch
+  // becomes empty.
+  CHECKED_STATUS Relock(CoarseTimePoint deadline);
+
  private:
   void MoveFrom(LockBatch* other);
 
+  void Lock(CoarseTimePoint deadline);
+
   struct Data {
     Data() = default;
     Data(LockBatchEntries&& key_to_type_, SharedLockManager* shared_lock_manager_) :
@@ -93,6 +104,9 @@ class LockBatch {
     SharedLockManager* shared_lock_manager = nullptr;
 
     Status status;
+
+    // Whether keys were released by Unlock.
+    bool unlocked = false;
   };
 
   Data data_;
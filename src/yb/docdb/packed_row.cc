@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/gutil/casts.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/format.h"
+#include "yb/util/result.h"
+#include "yb/util/status_format.h"
+
+namespace yb {
+namespace docdb {
+
+RowPacker::RowPacker(uint32_t schema_version) {
+  result_.push_back(ValueTypeAsChar::kPackedRow);
+  util::FastAppendUnsignedVarIntToStr(schema_version, &result_);
+}
+
+void RowPacker::AddValue(ColumnId column_id, const PrimitiveValue& value) {
+  AddEncodedValue(column_id, value.ToValue());
+}
+
+void RowPacker::AddEncodedValue(ColumnId column_id, const Slice& encoded_value) {
+  util::FastAppendUnsignedVarIntToStr(column_id.rep(), &result_);
+  util::FastAppendUnsignedVarIntToStr(encoded_value.size(), &result_);
+  result_.append(encoded_value.cdata(), encoded_value.size());
+  ++num_columns_;
+}
+
+std::string RowPacker::Complete() {
+  num_columns_ = 0;
+  return std::move(result_);
+}
+
+Status PackedRow::Decode(const Slice& value) {
+  Slice input = value;
+  if (!input.TryConsumeByte(ValueTypeAsChar::kPackedRow)) {
+    return STATUS_FORMAT(
+        Corruption, "Packed row expected, but value type is $0: $1",
+        DecodeValueType(value), value.ToDebugHexString());
+  }
+  schema_version_ = narrow_cast<uint32_t>(VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input)));
+  columns_.clear();
+  while (!input.empty()) {
+    ColumnId column_id;
+    RETURN_NOT_OK(ColumnId::FromInt64(
+        VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input)), &column_id));
+    auto size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input));
+    if (size > input.size()) {
+      return STATUS_FORMAT(
+          Corruption, "Not enough bytes for value of column $0 in packed row: $1, need $2",
+          column_id, input.size(), size);
+    }
+    columns_.emplace_back(column_id, input.Prefix(size));
+    input.remove_prefix(size);
+  }
+  return Status::OK();
+}
+
+const Slice* PackedRow::FindColumn(ColumnId column_id) const {
+  for (const auto& column : columns_) {
+    if (column.first == column_id) {
+      return &column.second;
+    }
+  }
+  return nullptr;
+}
+
+std::string PackedRow::ToString() const {
+  std::string result = Format("PACKED_ROW[$0]{", schema_version_);
+  bool first = true;
+  for (const auto& column : columns_) {
+    if (!first) {
+      result += ", ";
+    }
+    first = false;
+    PrimitiveValue value;
+    auto status = value.DecodeFromValue(column.second);
+    result += Format(
+        "$0: $1", column.first, status.ok() ? value.ToString() : status.ToString());
+  }
+  result += "}";
+  return result;
+}
+
+}  // namespace docdb
+}  // namespace yb
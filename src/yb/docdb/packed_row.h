@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H
+#define YB_DOCDB_PACKED_ROW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/column_id.h"
+
+#include "yb/util/slice.h"
+#include "yb/util/status_fwd.h"
+
+namespace yb {
+namespace docdb {
+
+class PrimitiveValue;
+
+// A packed row holds all non-key columns of a row written by a single insert in one RocksDB value,
+// stored at the DocKey of the row (i.e. where an init marker would be). Later updates of individual
+// columns are still written as separate SubDocKeys with higher hybrid times and override the packed
+// values on read, while entries older than the packed row are overwritten by it.
+//
+// Encoding (after the usual value control fields):
+//   ValueType::kPackedRow
+//   schema version                      - unsigned varint
+//   for each non-null column:
+//     column id                         - unsigned varint
+//     size of the encoded column value  - unsigned varint
+//     column value, as produced by PrimitiveValue::ToValue
+//
+// Columns are identified by id rather than by position, so a packed row written with an older
+// schema version remains readable after columns are added or dropped.
+class RowPacker {
+ public:
+  explicit RowPacker(uint32_t schema_version);
+
+  void AddValue(ColumnId column_id, const PrimitiveValue& value);
+
+  // Adds a column value that is already encoded as by PrimitiveValue::ToValue.
+  void AddEncodedValue(ColumnId column_id, const Slice& encoded_value);
+
+  size_t num_columns() const { return num_columns_; }
+
+  // Returns the encoded packed row and resets the packer.
+  std::string Complete();
+
+ private:
+  std::string result_;
+  size_t num_columns_ = 0;
+};
+
+// Decoded representation of a packed row. Column values reference the encoded packed row, so it
+// should outlive this object.
+class PackedRow {
+ public:
+  // Decodes a packed row from value, that should start with ValueType::kPackedRow, i.e. value
+  // control fields should already be consumed.
+  CHECKED_STATUS Decode(const Slice& value);
+
+  uint32_t schema_version() const { return schema_version_; }
+
+  const std::vector<std::pair<ColumnId, Slice>>& columns() const { return columns_; }
+
+  // Returns the encoded value of the specified column or nullptr if the packed row does not
+  // contain it.
+  const Slice* FindColumn(ColumnId column_id) const;
+
+  std::string ToString() const;
+
+ private:
+  uint32_t schema_version_ = 0;
+  std::vector<std::pair<ColumnId, Slice>> columns_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_PACKED_ROW_H
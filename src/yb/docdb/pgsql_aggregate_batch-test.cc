@@ -0,0 +1,117 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_expr.h"
+#include "yb/docdb/pgsql_aggregate_batch.h"
+
+#include "yb/util/random.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+constexpr ColumnIdRep kInt32Column = 11;
+constexpr ColumnIdRep kInt64Column = 12;
+constexpr ColumnIdRep kDoubleColumn = 13;
+
+void AddTarget(
+    bfpg::TSOpcode opcode, ColumnIdRep column_id,
+    google::protobuf::RepeatedPtrField<PgsqlExpressionPB>* targets) {
+  auto* tscall = targets->Add()->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(opcode));
+  auto* operand = tscall->add_operands();
+  if (column_id < 0) {
+    // COUNT(*) is sent as COUNT of a non-null constant.
+    operand->mutable_value()->set_int64_value(0);
+  } else {
+    operand->set_column_id(column_id);
+  }
+}
+
+} // namespace
+
+class PgsqlAggregateBatchTest : public YBTest {
+};
+
+TEST_F(PgsqlAggregateBatchTest, MatchesPerRowEvaluation) {
+  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> targets;
+  AddTarget(bfpg::TSOpcode::kCount, -1, &targets);
+  AddTarget(bfpg::TSOpcode::kCount, kInt32Column, &targets);
+  AddTarget(bfpg::TSOpcode::kSumInt32, kInt32Column, &targets);
+  AddTarget(bfpg::TSOpcode::kSumInt64, kInt64Column, &targets);
+  AddTarget(bfpg::TSOpcode::kSumDouble, kDoubleColumn, &targets);
+
+  auto batch = PgsqlAggregateBatch::Create(targets, /* batch_size= */ 7);
+  ASSERT_NE(batch, nullptr);
+
+  DocExprExecutor executor;
+  std::vector<QLExprResult> expected(targets.size());
+
+  Random rnd(42);
+  QLTableRow row;
+  for (int i = 0; i != 100; ++i) {
+    row.Clear();
+    if (rnd.OneIn(3)) {
+      row.AllocColumn(kInt32Column).value.set_int32_value(rnd.Next32() % 1000);
+    }
+    if (!rnd.OneIn(5)) {
+      row.AllocColumn(kInt64Column).value.set_int64_value(rnd.Next64() % 1000000);
+    }
+    row.AllocColumn(kDoubleColumn).value.set_double_value(i * 0.5);
+
+    batch->AddRow(row);
+    for (int target = 0; target != targets.size(); ++target) {
+      ASSERT_OK(executor.EvalExpr(targets.Get(target), row, expected[target].Writer()));
+    }
+  }
+
+  std::vector<QLExprResult> actual;
+  batch->Complete(&actual);
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i != expected.size(); ++i) {
+    ASSERT_EQ(expected[i].Value().ShortDebugString(), actual[i].Value().ShortDebugString())
+        << "Target: " << i;
+  }
+}
+
+TEST_F(PgsqlAggregateBatchTest, Empty) {
+  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> targets;
+  AddTarget(bfpg::TSOpcode::kCount, -1, &targets);
+  AddTarget(bfpg::TSOpcode::kSumInt64, kInt64Column, &targets);
+
+  auto batch = PgsqlAggregateBatch::Create(targets, /* batch_size= */ 16);
+  ASSERT_NE(batch, nullptr);
+
+  QLTableRow row;
+  batch->AddRow(row);
+
+  std::vector<QLExprResult> result;
+  batch->Complete(&result);
+  ASSERT_EQ(2, result.size());
+  ASSERT_EQ(1, result[0].Value().int64_value());
+  // SUM over nulls only is null.
+  ASSERT_TRUE(result[1].IsNull());
+}
+
+TEST_F(PgsqlAggregateBatchTest, Unsupported) {
+  google::protobuf::RepeatedPtrField<PgsqlExpressionPB> targets;
+  AddTarget(bfpg::TSOpcode::kCount, -1, &targets);
+  AddTarget(bfpg::TSOpcode::kMax, kInt64Column, &targets);
+
+  ASSERT_EQ(PgsqlAggregateBatch::Create(targets, /* batch_size= */ 16), nullptr);
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,205 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/pgsql_aggregate_batch.h"
+
+#include "yb/bfpg/tserver_opcodes.h"
+
+#include "yb/common/ql_value.h"
+
+#include "yb/gutil/macros.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+template <class T>
+T SumValues(const std::vector<T>& values) {
+  T result = 0;
+  for (auto value : values) {
+    result += value;
+  }
+  return result;
+}
+
+int64_t CountNotNull(const std::vector<uint8_t>& not_null) {
+  int64_t result = 0;
+  for (auto value : not_null) {
+    result += value;
+  }
+  return result;
+}
+
+} // namespace
+
+PgsqlAggregateBatch::PgsqlAggregateBatch(size_t batch_size) : batch_size_(batch_size) {
+}
+
+std::unique_ptr<PgsqlAggregateBatch> PgsqlAggregateBatch::Create(
+    const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& targets, size_t batch_size) {
+  std::unique_ptr<PgsqlAggregateBatch> result(new PgsqlAggregateBatch(batch_size));
+  result->aggregates_.reserve(targets.size());
+  for (const auto& target : targets) {
+    if (!target.has_tscall() || target.tscall().operands_size() != 1) {
+      return nullptr;
+    }
+    const auto& operand = target.tscall().operands(0);
+    Aggregate aggregate;
+    aggregate.opcode = target.tscall().opcode();
+    switch (static_cast<bfpg::TSOpcode>(aggregate.opcode)) {
+      case bfpg::TSOpcode::kCount:
+        if (operand.has_column_id()) {
+          aggregate.kind = AggregateKind::kCountColumn;
+        } else if (operand.has_value() && !QLValue::IsNull(operand.value())) {
+          aggregate.kind = AggregateKind::kCountAll;
+        } else {
+          return nullptr;
+        }
+        break;
+      case bfpg::TSOpcode::kSumInt8: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt16: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt32: FALLTHROUGH_INTENDED;
+      case bfpg::TSOpcode::kSumInt64:
+        aggregate.kind = AggregateKind::kSumInt;
+        break;
+      case bfpg::TSOpcode::kSumFloat:
+        aggregate.kind = AggregateKind::kSumFloat;
+        break;
+      case bfpg::TSOpcode::kSumDouble:
+        aggregate.kind = AggregateKind::kSumDouble;
+        break;
+      default:
+        return nullptr;
+    }
+    if (aggregate.kind != AggregateKind::kCountAll) {
+      // System columns, i.e. ybctid, are not stored in the row.
+      if (!operand.has_column_id() || operand.column_id() < 0) {
+        return nullptr;
+      }
+      aggregate.column_id = operand.column_id();
+      aggregate.not_null.reserve(batch_size);
+    }
+    result->aggregates_.push_back(std::move(aggregate));
+  }
+  return result;
+}
+
+void PgsqlAggregateBatch::AddRow(const QLTableRow& row) {
+  for (auto& aggregate : aggregates_) {
+    if (aggregate.kind == AggregateKind::kCountAll) {
+      continue;
+    }
+    const auto* value = row.GetColumn(aggregate.column_id);
+    const bool is_null = value == nullptr || QLValue::IsNull(*value);
+    aggregate.not_null.push_back(!is_null);
+    switch (aggregate.kind) {
+      case AggregateKind::kCountAll: FALLTHROUGH_INTENDED;
+      case AggregateKind::kCountColumn:
+        break;
+      case AggregateKind::kSumInt: {
+        int64_t int_value = 0;
+        if (!is_null) {
+          switch (static_cast<bfpg::TSOpcode>(aggregate.opcode)) {
+            case bfpg::TSOpcode::kSumInt8:
+              int_value = value->int8_value();
+              break;
+            case bfpg::TSOpcode::kSumInt16:
+              int_value = value->int16_value();
+              break;
+            case bfpg::TSOpcode::kSumInt32:
+              int_value = value->int32_value();
+              break;
+            default:
+              int_value = value->int64_value();
+              break;
+          }
+        }
+        aggregate.int_values.push_back(int_value);
+        break;
+      }
+      case AggregateKind::kSumFloat:
+        aggregate.float_values.push_back(is_null ? 0 : value->float_value());
+        break;
+      case AggregateKind::kSumDouble:
+        aggregate.double_values.push_back(is_null ? 0 : value->double_value());
+        break;
+    }
+  }
+  if (++num_batch_rows_ >= batch_size_) {
+    AggregateBatch();
+  }
+}
+
+void PgsqlAggregateBatch::AggregateBatch() {
+  for (auto& aggregate : aggregates_) {
+    switch (aggregate.kind) {
+      case AggregateKind::kCountAll:
+        aggregate.count += num_batch_rows_;
+        break;
+      case AggregateKind::kCountColumn:
+        aggregate.count += CountNotNull(aggregate.not_null);
+        break;
+      case AggregateKind::kSumInt:
+        aggregate.count += CountNotNull(aggregate.not_null);
+        aggregate.int_sum += SumValues(aggregate.int_values);
+        aggregate.int_values.clear();
+        break;
+      case AggregateKind::kSumFloat:
+        aggregate.count += CountNotNull(aggregate.not_null);
+        aggregate.float_sum += SumValues(aggregate.float_values);
+        aggregate.float_values.clear();
+        break;
+      case AggregateKind::kSumDouble:
+        aggregate.count += CountNotNull(aggregate.not_null);
+        aggregate.double_sum += SumValues(aggregate.double_values);
+        aggregate.double_values.clear();
+        break;
+    }
+    aggregate.not_null.clear();
+  }
+  num_batch_rows_ = 0;
+}
+
+void PgsqlAggregateBatch::Complete(std::vector<QLExprResult>* aggr_result) {
+  AggregateBatch();
+
+  aggr_result->resize(aggregates_.size());
+  for (size_t i = 0; i != aggregates_.size(); ++i) {
+    const auto& aggregate = aggregates_[i];
+    // Aggregates over no rows or only over nulls are null, as with per-row evaluation.
+    if (aggregate.count == 0) {
+      continue;
+    }
+    auto& result = (*aggr_result)[i].ForceNewValue();
+    const bool is_first = result.IsNull();
+    switch (aggregate.kind) {
+      case AggregateKind::kCountAll: FALLTHROUGH_INTENDED;
+      case AggregateKind::kCountColumn:
+        result.set_int64_value(aggregate.count + (is_first ? 0 : result.int64_value()));
+        break;
+      case AggregateKind::kSumInt:
+        result.set_int64_value(aggregate.int_sum + (is_first ? 0 : result.int64_value()));
+        break;
+      case AggregateKind::kSumFloat:
+        result.set_float_value(aggregate.float_sum + (is_first ? 0 : result.float_value()));
+        break;
+      case AggregateKind::kSumDouble:
+        result.set_double_value(aggregate.double_sum + (is_first ? 0 : result.double_value()));
+        break;
+    }
+  }
+}
+
+}  // namespace docdb
+}  // namespace yb
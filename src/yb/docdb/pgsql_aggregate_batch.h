@@ -0,0 +1,87 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PGSQL_AGGREGATE_BATCH_H
+#define YB_DOCDB_PGSQL_AGGREGATE_BATCH_H
+
+#include <memory>
+#include <vector>
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/common/ql_expr.h"
+
+namespace yb {
+namespace docdb {
+
+// Evaluates aggregates of a YSQL read request over batches of rows, instead of evaluating target
+// expressions for each row as PgsqlReadOperation::EvalAggregate does.
+//
+// For every aggregate, values of its column are copied from matched rows into a plain column
+// vector. When batch_size rows are collected, each aggregate is computed by a tight loop over its
+// vector, so there is no expression evaluation and QLValue boxing per row and aggregate.
+//
+// Only COUNT(*), COUNT(column) and SUM(column) are supported. Create returns nullptr when any of
+// the targets is something else, in that case the caller should fall back to per-row evaluation.
+class PgsqlAggregateBatch {
+ public:
+  static std::unique_ptr<PgsqlAggregateBatch> Create(
+      const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& targets, size_t batch_size);
+
+  // Adds a row that matched the where clause, aggregating the batch when it is full.
+  void AddRow(const QLTableRow& row);
+
+  // Aggregates the remaining rows and merges results into aggr_result, that contains one entry
+  // per target, the same way per-row evaluation does.
+  void Complete(std::vector<QLExprResult>* aggr_result);
+
+ private:
+  enum class AggregateKind {
+    kCountAll,
+    kCountColumn,
+    kSumInt,
+    kSumFloat,
+    kSumDouble,
+  };
+
+  struct Aggregate {
+    AggregateKind kind;
+    int opcode;
+    ColumnIdRep column_id = -1;
+
+    // Column vectors of the current batch. Null values are stored as zeroes, so sums could be
+    // computed without checking not_null.
+    std::vector<int64_t> int_values;
+    std::vector<float> float_values;
+    std::vector<double> double_values;
+    std::vector<uint8_t> not_null;
+
+    // Aggregated over all completed batches.
+    int64_t count = 0;
+    int64_t int_sum = 0;
+    float float_sum = 0;
+    double double_sum = 0;
+  };
+
+  explicit PgsqlAggregateBatch(size_t batch_size);
+
+  void AggregateBatch();
+
+  const size_t batch_size_;
+  size_t num_batch_rows_ = 0;
+  std::vector<Aggregate> aggregates_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_PGSQL_AGGREGATE_BATCH_H
@@ -33,6 +33,8 @@
 #include "yb/docdb/docdb_pgapi.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
+#include "yb/docdb/pgsql_aggregate_batch.h"
 #include "yb/docdb/primitive_value_util.h"
 #include "yb/docdb/ql_storage_interface.h"
 
@@ -56,6 +58,17 @@ DEFINE_bool(pgsql_consistent_transactional_paging, true,
             "be stale. The latter is preferable for long scans. The data returned for the first "
             "page of results is never stale regardless of this flag.");
 
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Whether YSQL inserts should store all non-key columns of a row in a single packed "
+            "RocksDB value instead of writing a separate key/value pair per column.");
+TAG_FLAG(ysql_enable_packed_row, experimental);
+
+DEFINE_int32(ysql_aggregate_batch_size, 1024,
+             "Number of rows collected before COUNT and SUM aggregates pushed down with YSQL reads "
+             "are computed over column vectors of the batch. 0 disables batching, so aggregates "
+             "are evaluated for each row.");
+TAG_FLAG(ysql_aggregate_batch_size, advanced);
+
 DEFINE_test_flag(int32, slowdown_pgsql_aggregate_read_ms, 0,
                  "If set > 0, slows down the response to pgsql aggregate read by this amount.");
 
@@ -409,10 +422,17 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     }
   }
 
-  RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
-      DocPath(encoded_doc_key_.as_slice(), PrimitiveValue::kLivenessColumn),
-      Value(PrimitiveValue()),
-      data.read_time, data.deadline, request_.stmt_id()));
+  // Upserts and backfill may overwrite an existing row, keeping the columns that are not
+  // specified in the request, so they are always written column by column.
+  boost::optional<RowPacker> packer;
+  if (FLAGS_ysql_enable_packed_row && !is_upsert && !request_.is_backfill()) {
+    packer.emplace(request_.schema_version());
+  } else {
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice(), PrimitiveValue::kLivenessColumn),
+        Value(PrimitiveValue()),
+        data.read_time, data.deadline, request_.stmt_id()));
+  }
 
   for (const auto& column_value : request_.column_values()) {
     // Get the column.
@@ -432,12 +452,31 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data, IsUps
     const SubDocument sub_doc =
         SubDocument::FromQLValuePB(expr_result.Value(), column.sorting_type());
 
+    if (packer) {
+      // Null columns are not stored in the packed row.
+      if (sub_doc.value_type() != ValueType::kTombstone) {
+        SCHECK(sub_doc.IsPrimitive(), InternalError,
+               Format("Unexpected value type for packed column $0: $1",
+                      column_id, sub_doc.value_type()));
+        packer->AddValue(column_id, sub_doc);
+      }
+      continue;
+    }
+
     // Inserting into specified column.
     DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
     RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
         sub_path, sub_doc, data.read_time, data.deadline, request_.stmt_id()));
   }
 
+  if (packer) {
+    // The packed row is written at the row's DocKey. Its presence also marks the row as existing,
+    // so the liveness column is not needed.
+    auto& key_value = data.doc_write_batch->AddRaw();
+    key_value.first = encoded_doc_key_.as_slice().ToBuffer();
+    key_value.second = packer->Complete();
+  }
+
   RETURN_NOT_OK(PopulateResultSet(table_row));
 
   response_->set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
@@ -926,6 +965,12 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const YQLStorageIf& ql_storage,
 
   VTRACE(1, "Initialized iterator");
 
+  std::unique_ptr<PgsqlAggregateBatch> aggregate_batch;
+  if (request_.is_aggregate() && FLAGS_ysql_aggregate_batch_size > 0) {
+    aggregate_batch = PgsqlAggregateBatch::Create(
+        request_.targets(), FLAGS_ysql_aggregate_batch_size);
+  }
+
   // Set scan start time.
   bool scan_time_exceeded = false;
 
@@ -962,7 +1007,9 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const YQLStorageIf& ql_storage,
     }
     if (is_match) {
       match_count++;
-      if (request_.is_aggregate()) {
+      if (aggregate_batch) {
+        aggregate_batch->AddRow(row);
+      } else if (request_.is_aggregate()) {
         RETURN_NOT_OK(EvalAggregate(row));
       } else {
         RETURN_NOT_OK(PopulateResultSet(row, result_buffer));
@@ -977,6 +1024,9 @@ Result<size_t> PgsqlReadOperation::ExecuteScalar(const YQLStorageIf& ql_storage,
   }
 
   if (request_.is_aggregate() && match_count > 0) {
+    if (aggregate_batch) {
+      aggregate_batch->Complete(&aggr_result_);
+    }
     RETURN_NOT_OK(PopulateAggregate(row, result_buffer));
     ++fetched_rows;
   }
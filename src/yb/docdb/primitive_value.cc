@@ -69,6 +69,7 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kMergeFlags: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;  \
@@ -268,6 +269,7 @@ string PrimitiveValue::ToString(AutoDecodeKeys auto_decode_keys) const {
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
     case ValueType::kExternalIntents: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kGreaterThanIntentType:
       break;
     case ValueType::kLowest:
@@ -623,6 +625,7 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kSystemColumnId: FALLTHROUGH_INTENDED;
     case ValueType::kHybridTime: FALLTHROUGH_INTENDED;
     case ValueType::kExternalIntents: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kInvalid: FALLTHROUGH_INTENDED;
     case ValueType::kLowest: FALLTHROUGH_INTENDED;
     case ValueType::kHighest: FALLTHROUGH_INTENDED;
@@ -1259,6 +1262,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kUuidDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTimestampDescending: FALLTHROUGH_INTENDED;
     case ValueType::kExternalIntents: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
     case ValueType::kLowest: FALLTHROUGH_INTENDED;
     case ValueType::kHighest: FALLTHROUGH_INTENDED;
     case ValueType::kMaxByte:
@@ -11,8 +11,10 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
+#include <random>
 #include <stack>
 #include <thread>
 
@@ -122,6 +124,28 @@ TEST_F(SharedLockManagerTest, LockBatchReset) {
   EXPECT_TRUE(lb.empty());
 }
 
+TEST_F(SharedLockManagerTest, LockBatchUnlockRelock) {
+  LockBatch lb = TestLockBatch();
+  lb.Unlock();
+  EXPECT_EQ(2, lb.size());
+
+  // Released keys could be locked by another batch.
+  {
+    LockBatch lb2 = TestLockBatch(CoarseMonoClock::now() + 10ms);
+    ASSERT_OK(lb2.status());
+    ASSERT_NOK(lb.Relock(CoarseMonoClock::now() + 10ms));
+    ASSERT_TRUE(lb.empty());
+  }
+
+  lb = TestLockBatch();
+  lb.Unlock();
+  ASSERT_OK(lb.Relock(CoarseTimePoint::max()));
+  EXPECT_EQ(2, lb.size());
+
+  LockBatch lb_fail = TestLockBatch(CoarseMonoClock::now() + 10ms);
+  ASSERT_FALSE(lb_fail.status().ok());
+}
+
 // Launch pairs of threads. Each pair tries to lock/unlock on the same key sequence.
 // This catches bug in SharedLockManager when condition is waited incorrectly.
 TEST_F(SharedLockManagerTest, QuickLockUnlock) {
@@ -186,6 +210,76 @@ TEST_F(SharedLockManagerTest, LockConflicts) {
   tp.Shutdown();
 }
 
+// Waiter should be woken up when conflicting lock is released by another thread.
+TEST_F(SharedLockManagerTest, WaitForUnlock) {
+  auto lb1 = std::make_unique<LockBatch>(TestLockBatch());
+  ASSERT_OK(lb1->status());
+
+  std::atomic<bool> locked{false};
+  std::thread waiter([this, &locked] {
+    auto lb2 = TestLockBatch();
+    ASSERT_OK(lb2.status());
+    locked.store(true, std::memory_order_release);
+  });
+
+  std::this_thread::sleep_for(100ms);
+  EXPECT_FALSE(locked.load(std::memory_order_acquire));
+  lb1.reset();
+  ASSERT_OK(WaitFor([&locked] { return locked.load(std::memory_order_acquire); }, 5s,
+                    "Waiter locked"));
+  waiter.join();
+}
+
+// Measures lock/unlock throughput of batches on random keys, depending on number of threads.
+TEST_F(SharedLockManagerTest, LockUnlockThroughput) {
+  constexpr int kKeys = 10000;
+  constexpr size_t kBatchSize = 4;
+  constexpr int kDurationMs = 2000;
+
+  for (size_t num_threads : {1, 2, 4, 8, 16, 32}) {
+    std::atomic<bool> stop_requested{false};
+    std::atomic<size_t> total_batches{0};
+    std::vector<std::thread> threads;
+    while (threads.size() != num_threads) {
+      threads.emplace_back([this, &stop_requested, &total_batches] {
+        std::mt19937_64 rng(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        std::uniform_int_distribution<int> key_distribution(0, kKeys - 1);
+        size_t batches = 0;
+        while (!stop_requested.load(std::memory_order_acquire)) {
+          std::vector<int> key_indexes;
+          while (key_indexes.size() != kBatchSize) {
+            key_indexes.push_back(key_distribution(rng));
+          }
+          // Keys are locked in sorted order, the same way as docdb does.
+          std::sort(key_indexes.begin(), key_indexes.end());
+          key_indexes.erase(
+              std::unique(key_indexes.begin(), key_indexes.end()), key_indexes.end());
+          LockBatchEntries entries;
+          for (auto key_index : key_indexes) {
+            entries.push_back(LockBatchEntry {
+              .key = RefCntPrefix(Format("key_$0", key_index)),
+              .intent_types = IntentTypeSet({IntentType::kStrongWrite, IntentType::kStrongRead}),
+            });
+          }
+          LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+          ++batches;
+        }
+        total_batches.fetch_add(batches, std::memory_order_acq_rel);
+      });
+    }
+
+    std::this_thread::sleep_for(kDurationMs * 1ms);
+    stop_requested.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    LOG(INFO) << "Threads: " << num_threads << ", batches per second: "
+              << total_batches.load() * 1000 / kDurationMs;
+    ASSERT_GT(total_batches.load(), 0U);
+  }
+}
+
 TEST_F(SharedLockManagerTest, DumpKeys) {
   FLAGS_dump_lock_keys = true;
 
@@ -14,16 +14,26 @@
 #include "yb/docdb/shared_lock_manager.h"
 
 #include <array>
-#include <condition_variable>
+#include <atomic>
 #include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include <boost/container/small_vector.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <glog/logging.h>
 
 #include "yb/docdb/lock_batch.h"
 
+#include "yb/gutil/linux_syscall_support.h"
+#include "yb/gutil/port.h"
+
 #include "yb/util/enums.h"
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/scope_exit.h"
@@ -105,29 +115,86 @@ bool IntentTypeSetsConflict(IntentTypeSet lhs, IntentTypeSet rhs) {
   return false;
 }
 
+namespace {
+
+// Word that threads could wait on until it is changed by another thread, without a mutex.
+// Uses futex on Linux, and falls back to sleeping in short intervals on other platforms.
+class WaitWord {
+ public:
+  int32_t Load() const {
+    return value_.load(std::memory_order_acquire);
+  }
+
+  // Waits until the word is changed from expected value, or deadline passes.
+  // Could wake up spuriously, so caller should recheck its condition.
+  void Wait(int32_t expected, CoarseTimePoint deadline) {
+#ifndef __APPLE__
+    struct timespec ts;
+    struct timespec* timeout = nullptr;
+    if (deadline != CoarseTimePoint::max()) {
+      MonoDelta(deadline - CoarseMonoClock::now()).ToTimeSpec(&ts);
+      timeout = &ts;
+    }
+    sys_futex(reinterpret_cast<int32_t*>(&value_), FUTEX_WAIT | FUTEX_PRIVATE_FLAG, expected,
+              reinterpret_cast<struct kernel_timespec*>(timeout), nullptr, 0);
+#else
+    (void)expected;
+    std::this_thread::sleep_for(std::min<CoarseDuration>(
+        deadline - CoarseMonoClock::now(), std::chrono::milliseconds(1)));
+#endif
+  }
+
+  // Changes the word and wakes up all threads waiting on it.
+  void NotifyAll() {
+    value_.fetch_add(1, std::memory_order_acq_rel);
+#ifndef __APPLE__
+    sys_futex(reinterpret_cast<int32_t*>(&value_), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, INT_MAX,
+              nullptr, nullptr, 0);
+#endif
+  }
+
+ private:
+  std::atomic<int32_t> value_{0};
+};
+
+// Number of shards in lock table is 2^kLockShardsBits.
+constexpr size_t kLockShardsBits = 4;
+constexpr size_t kNumLockShards = 1ULL << kLockShardsBits;
+
+size_t LockShardIndex(const RefCntPrefix& key) {
+  // Multiplicative hashing, so all bits of key hash affect the shard index.
+  constexpr uint64_t kMultiplier = 0x9e3779b97f4a7c15ULL;
+  return (RefCntPrefixHash()(key) * kMultiplier) >> (64 - kLockShardsBits);
+}
+
+} // namespace
+
 struct LockedBatchEntry {
-  // Taken only for short duration, with no blocking wait.
-  mutable std::mutex mutex;
+  // Shard of lock table that owns this entry.
+  const size_t shard_idx;
 
-  std::condition_variable cond_var;
+  // Changed when some locks are released, so waiters could recheck whether they could proceed.
+  WaitWord wait_word;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
-  size_t ref_count = 0;
+  // Refcounting for garbage collection. Can only be changed while the shard mutex is locked.
+  // Shard mutex resides in lock manager and the same for all LockBatchEntries of the shard.
+  // Atomic, so ToString could read it without the shard mutex.
+  std::atomic<size_t> ref_count{0};
 
   // Number of holders for each type
   std::atomic<LockState> num_holding{0};
 
   std::atomic<size_t> num_waiters{0};
 
+  explicit LockedBatchEntry(size_t shard_idx_) : shard_idx(shard_idx_) {}
+
   MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline);
 
   void Unlock(IntentTypeSet lock);
 
   std::string ToString() const {
-    std::lock_guard<std::mutex> lock(mutex);
-    return Format("{ ref_count: $0 num_holding: $1 num_waiters: $2 }",
-                  ref_count, num_holding.load(std::memory_order_acquire),
+    return Format("{ shard_idx: $0 ref_count: $1 num_holding: $2 num_waiters: $3 }",
+                  shard_idx, ref_count.load(std::memory_order_relaxed), num_holding.load(std::memory_order_acquire),
                   num_waiters.load(std::memory_order_acquire));
   }
 };
@@ -138,28 +205,36 @@ class SharedLockManager::Impl {
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty())
+          << "Locks not empty in dtor: " << yb::ToString(shard.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Part of the lock table, that contains keys with the same LockShardIndex.
+  // Sharding lets batches on unrelated keys reserve lock entries concurrently.
+  struct CACHELINE_ALIGNED LockShard {
+    // The shard mutex should be taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  };
+
+  // Make sure the entries exist in the lock table and fill pointers to them, so we can access
+  // them without holding the shard locks.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
-
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  std::array<LockShard, kNumLockShards> shards_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -197,20 +272,20 @@ bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
       }
       continue;
     }
-    num_waiters.fetch_add(1, std::memory_order_release);
+    num_waiters.fetch_add(1, std::memory_order_seq_cst);
     auto se = ScopeExit([this] {
       num_waiters.fetch_sub(1, std::memory_order_release);
     });
-    std::unique_lock<std::mutex> lock(mutex);
-    old_value = num_holding.load(std::memory_order_acquire);
+    // Read wait word before rechecking the state, so we don't miss wake up from Unlock that
+    // happens between the check and the wait.
+    auto wait_value = wait_word.Load();
+    old_value = num_holding.load(std::memory_order_seq_cst);
     if ((old_value & kIntentTypeSetConflicts[type_idx]) != 0) {
-      if (deadline != CoarseTimePoint::max()) {
-        if (cond_var.wait_until(lock, deadline) == std::cv_status::timeout) {
-          return false;
-        }
-      } else {
-        cond_var.wait(lock);
+      if (CoarseMonoClock::now() >= deadline) {
+        return false;
       }
+      wait_word.Wait(wait_value, deadline);
+      old_value = num_holding.load(std::memory_order_acquire);
     }
   }
 }
@@ -224,12 +299,12 @@ void LockedBatchEntry::Unlock(IntentTypeSet lock_types) {
   LockState new_state;
   for (;;) {
     new_state = old_state - sub;
-    if (num_holding.compare_exchange_weak(old_state, new_state, std::memory_order_acq_rel)) {
+    if (num_holding.compare_exchange_weak(old_state, new_state, std::memory_order_seq_cst)) {
       break;
     }
   }
 
-  if (!num_waiters.load(std::memory_order_acquire)) {
+  if (!num_waiters.load(std::memory_order_seq_cst)) {
     return;
   }
 
@@ -246,13 +321,7 @@ void LockedBatchEntry::Unlock(IntentTypeSet lock_types) {
     return;
   }
 
-  {
-    // Lock/unlock mutex as a barrier for Lock.
-    // So we don't unlock and notify between check and wait in Lock.
-    std::lock_guard<std::mutex> lock(mutex);
-  }
-
-  cond_var.notify_all();
+  wait_word.NotifyAll();
 }
 
 bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline) {
@@ -278,20 +347,38 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
 }
 
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
-  for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
-    if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
-      } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+  // Shard mutexes are taken one at a time in increasing shard order, each at most once per batch.
+  boost::container::small_vector<size_t, 16> shard_indexes;
+  shard_indexes.reserve(key_to_intent_type->size());
+  std::array<bool, kNumLockShards> used_shards = {};
+  for (const auto& key_and_intent_type : *key_to_intent_type) {
+    shard_indexes.push_back(LockShardIndex(key_and_intent_type.key));
+    used_shards[shard_indexes.back()] = true;
+  }
+  for (size_t shard_idx = 0; shard_idx != kNumLockShards; ++shard_idx) {
+    if (!used_shards[shard_idx]) {
+      continue;
+    }
+    auto& shard = shards_[shard_idx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (size_t i = 0; i != key_to_intent_type->size(); ++i) {
+      if (shard_indexes[i] != shard_idx) {
+        continue;
+      }
+      auto& key_and_intent_type = (*key_to_intent_type)[i];
+      auto& value = shard.locks[key_and_intent_type.key];
+      if (!value) {
+        if (!shard.free_lock_entries.empty()) {
+          value = shard.free_lock_entries.back();
+          shard.free_lock_entries.pop_back();
+        } else {
+          shard.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>(shard_idx));
+          value = shard.lock_entries.back().get();
+        }
       }
+      value->ref_count.fetch_add(1, std::memory_order_relaxed);
+      key_and_intent_type.locked = value;
     }
-    value->ref_count++;
-    key_and_intent_type.locked = value;
   }
 }
 
@@ -306,11 +393,24 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  std::array<bool, kNumLockShards> used_shards = {};
   for (const auto& item : key_to_intent_type) {
-    if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+    used_shards[item.locked->shard_idx] = true;
+  }
+  for (size_t shard_idx = 0; shard_idx != kNumLockShards; ++shard_idx) {
+    if (!used_shards[shard_idx]) {
+      continue;
+    }
+    auto& shard = shards_[shard_idx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& item : key_to_intent_type) {
+      if (item.locked->shard_idx != shard_idx) {
+        continue;
+      }
+      if (item.locked->ref_count.fetch_sub(1, std::memory_order_relaxed) == 1) {
+        shard.locks.erase(item.key);
+        shard.free_lock_entries.push_back(item.locked);
+      }
     }
   }
 }
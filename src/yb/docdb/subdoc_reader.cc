@@ -31,6 +31,7 @@
 #include "yb/docdb/expiration.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/docdb/key_bytes.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -179,6 +180,10 @@ class LazySubDocumentHolder {
   // if it has not yet been constructed.
   Result<SubDocument*> Get();
 
+  // Removes the SubDocument specified by this instance from its parent, in case it was not
+  // constructed through this instance but was already added to the parent, e.g. from a packed row.
+  CHECKED_STATUS EraseFromParent();
+
  private:
   // The constructed SubDocument specified by this instance.
   SubDocument* target_ = nullptr;
@@ -224,10 +229,34 @@ Result<SubDocument*> LazySubDocumentHolder::Get() {
       "never get here.");
 }
 
+Status LazySubDocumentHolder::EraseFromParent() {
+  if (target_ || !parent_ || !parent_->IsConstructed()) {
+    return Status::OK();
+  }
+  SubDocument* current = parent_->target_;
+  Slice temp = key_;
+  temp.remove_prefix(parent_->key_.size());
+  for (;;) {
+    PrimitiveValue child_key_part;
+    RETURN_NOT_OK(child_key_part.DecodeFromKey(&temp));
+    if (temp.empty()) {
+      if (current->GetChild(child_key_part)) {
+        current->DeleteChild(child_key_part);
+      }
+      return Status::OK();
+    }
+    current = current->GetChild(child_key_part);
+    if (!current) {
+      return Status::OK();
+    }
+  }
+}
+
 // This class provides a wrapper to access data corresponding to a RocksDB row.
 class DocDbRowData {
  public:
-  DocDbRowData(const Slice& key, const DocHybridTime& write_time, Value&& value);
+  DocDbRowData(
+      const Slice& key, const DocHybridTime& write_time, Value&& value, std::string&& packed_row);
 
   static Result<std::unique_ptr<DocDbRowData>> CurrentRow(IntentAwareIterator* iter);
 
@@ -243,19 +272,26 @@ class DocDbRowData {
 
   bool IsPrimitiveValue() const { return IsPrimitiveValueType(value_.value_type()); }
 
+  // Packed row is represented as a collection, whose children are populated from packed_row().
+  bool IsPackedRow() const { return !packed_row_.empty(); }
+
+  const std::string& packed_row() const { return packed_row_; }
+
   PrimitiveValue* mutable_primitive_value() { return value_.mutable_primitive_value(); }
 
  private:
   const KeyBytes target_key_;
   const DocHybridTime write_time_;
   Value value_;
+  const std::string packed_row_;
 
   DISALLOW_COPY_AND_ASSIGN(DocDbRowData);
 };
 
 DocDbRowData::DocDbRowData(
-    const Slice& key, const DocHybridTime& write_time, Value&& value):
-    target_key_(std::move(key)), write_time_(std::move(write_time)), value_(std::move(value)) {}
+    const Slice& key, const DocHybridTime& write_time, Value&& value, std::string&& packed_row):
+    target_key_(std::move(key)), write_time_(std::move(write_time)), value_(std::move(value)),
+    packed_row_(std::move(packed_row)) {}
 
 Result<std::unique_ptr<DocDbRowData>> DocDbRowData::CurrentRow(IntentAwareIterator* iter) {
   auto key_data = VERIFY_RESULT(iter->FetchKey());
@@ -265,16 +301,27 @@ Result<std::unique_ptr<DocDbRowData>> DocDbRowData::CurrentRow(IntentAwareIterat
       << ", global limit: " << iter->read_time().global_limit
       << ", write time: " << key_data.write_time.hybrid_time();
   Value value;
+  std::string packed_row;
   // TODO -- we could optimize be decoding directly into a SubDocument instance on the heap which
   // could be later bound to our result SubDocument. This could work if e.g. Value could be
   // initialized with a PrimitiveValue*.
-  RETURN_NOT_OK(value.Decode(iter->value()));
+  Slice value_slice = iter->value();
+  RETURN_NOT_OK(value.DecodeControlFields(&value_slice));
+  if (DecodeValueType(value_slice) == ValueType::kPackedRow) {
+    *value.mutable_primitive_value() = PrimitiveValue::kObject;
+    packed_row = value_slice.ToBuffer();
+  } else {
+    RETURN_NOT_OK_PREPEND(
+        value.mutable_primitive_value()->DecodeFromValue(value_slice),
+        Format("Failed to decode value in $0", iter->value().ToDebugHexString()));
+  }
 
   if (key_data.write_time == DocHybridTime::kMin) {
     return STATUS(Corruption, "No hybrid timestamp found on entry");
   }
 
-  return std::make_unique<DocDbRowData>(key_data.key, key_data.write_time, std::move(value));
+  return std::make_unique<DocDbRowData>(
+      key_data.key, key_data.write_time, std::move(value), std::move(packed_row));
 }
 
 // This class provides a convenience handle for modifying a SubDocument specified by a provided
@@ -291,8 +338,14 @@ class DocDbRowAssembler {
 
   CHECKED_STATUS SetEmptyCollection();
 
+  // Populates children of an empty collection with the columns of the packed row.
+  CHECKED_STATUS SetPackedColumns(const DocDbRowData& row);
+
   CHECKED_STATUS SetTombstone();
 
+  // Drops the value populated from the packed row of an ancestor, if any.
+  CHECKED_STATUS ErasePackedValue();
+
   CHECKED_STATUS SetPrimitiveValue(DocDbRowData* row);
 
   Result<bool> HasStoredValue();
@@ -310,6 +363,24 @@ Status DocDbRowAssembler::SetEmptyCollection() {
   return Status::OK();
 }
 
+Status DocDbRowAssembler::SetPackedColumns(const DocDbRowData& row) {
+  PackedRow packed_row;
+  RETURN_NOT_OK(packed_row.Decode(row.packed_row()));
+  auto* subdoc = VERIFY_RESULT(root_.Get());
+  const auto write_time = row.write_time().hybrid_time().GetPhysicalValueMicros();
+  for (const auto& column : packed_row.columns()) {
+    PrimitiveValue value;
+    RETURN_NOT_OK(value.DecodeFromValue(column.second));
+    value.SetWriteTime(write_time);
+    subdoc->SetChild(PrimitiveValue(column.first), SubDocument(std::move(value)));
+  }
+  return Status::OK();
+}
+
+Status DocDbRowAssembler::ErasePackedValue() {
+  return root_.EraseFromParent();
+}
+
 Status DocDbRowAssembler::SetTombstone() {
   if (!root_.IsConstructed()) {
     // Do not construct a child subdocument from the parent if it is not constructed, since this is
@@ -582,6 +653,10 @@ Result<uint32_t> ProcessChildren(ScopedDocDbCollectionContext* collection) {
 Status ProcessCollection(ScopedDocDbRowContextWithData* scope) {
   // Set this row to an empty collection since it is alive/valid before processing its children.
   RETURN_NOT_OK(scope->mutable_assembler()->SetEmptyCollection());
+  if (scope->data()->IsPackedRow()) {
+    // Children written after the packed row are processed below and override packed columns.
+    RETURN_NOT_OK(scope->mutable_assembler()->SetPackedColumns(*scope->data()));
+  }
   RETURN_NOT_OK(ProcessChildren(scope->collection()));
   return Status::OK();
 }
@@ -600,8 +675,14 @@ Status ProcessSubDocument(ScopedDocDbRowContextWithData* scope) {
   auto data = scope->data();
   auto assembler = scope->mutable_assembler();
   auto obsolescence_tracker = scope->obsolescence_tracker();
+  const bool is_obsolete = obsolescence_tracker->IsObsolete(data->write_time());
+
+  if (data->IsTombstone() && !is_obsolete) {
+    // A column deleted after its row was packed should not surface the packed value.
+    RETURN_NOT_OK(assembler->ErasePackedValue());
+  }
 
-  if (data->IsTombstone() || obsolescence_tracker->IsObsolete(data->write_time())) {
+  if (data->IsTombstone() || is_obsolete) {
     if (data->IsPrimitiveValue()) {
       VLOG(4) << "Discarding overwritten or expired primitive value";
       return assembler->SetTombstone();
@@ -636,13 +717,25 @@ SubDocumentReader::SubDocumentReader(
     const KeyBytes& target_subdocument_key,
     IntentAwareIterator* iter,
     DeadlineInfo* deadline_info,
-    const ObsolescenceTracker& ancestor_obsolescence_tracker):
+    const ObsolescenceTracker& ancestor_obsolescence_tracker,
+    const boost::optional<PackedColumnData>& packed_column):
     target_subdocument_key_(target_subdocument_key), iter_(iter), deadline_info_(deadline_info),
-    ancestor_obsolescence_tracker_(ancestor_obsolescence_tracker) {}
+    ancestor_obsolescence_tracker_(ancestor_obsolescence_tracker), packed_column_(packed_column) {}
+
+Status SubDocumentReader::GetPackedColumn(SubDocument* result) {
+  PrimitiveValue value;
+  RETURN_NOT_OK(value.DecodeFromValue(packed_column_->encoded_value));
+  value.SetWriteTime(packed_column_->write_time.hybrid_time().GetPhysicalValueMicros());
+  *result = SubDocument(std::move(value));
+  return Status::OK();
+}
 
 Status SubDocumentReader::Get(SubDocument* result) {
   IntentAwareIteratorPrefixScope target_scope(target_subdocument_key_, iter_);
   if (!iter_->valid()) {
+    if (packed_column_) {
+      return GetPackedColumn(result);
+    }
     *result = SubDocument(ValueType::kInvalid);
     return Status::OK();
   }
@@ -650,6 +743,10 @@ Status SubDocumentReader::Get(SubDocument* result) {
   auto current_key = first_row->key();
 
   if (current_key == target_subdocument_key_) {
+    if (packed_column_ && first_row->write_time() < packed_column_->write_time) {
+      // The latest entry for this column was overwritten by the packed row.
+      return GetPackedColumn(result);
+    }
     ScopedDocDbRowContextWithData context(
         std::move(first_row), iter_, deadline_info_, result, ancestor_obsolescence_tracker_);
     return ProcessSubDocument(&context);
@@ -664,6 +761,9 @@ Status SubDocumentReader::Get(SubDocument* result) {
   RETURN_NOT_OK(collection.SetFirstChild(std::move(first_row)));
   auto num_children = VERIFY_RESULT(ProcessChildren(&collection));
   if (num_children == 0) {
+    if (packed_column_) {
+      return GetPackedColumn(result);
+    }
     *result = SubDocument(ValueType::kTombstone);
   }
   return Status::OK();
@@ -676,13 +776,37 @@ SubDocumentReaderBuilder::SubDocumentReaderBuilder(
 Result<std::unique_ptr<SubDocumentReader>> SubDocumentReaderBuilder::Build(
     const KeyBytes& sub_doc_key) {
   return std::make_unique<SubDocumentReader>(
-      sub_doc_key, iter_, deadline_info_, parent_obsolescence_tracker_);
+      sub_doc_key, iter_, deadline_info_, parent_obsolescence_tracker_,
+      VERIFY_RESULT(GetPackedColumn(sub_doc_key)));
+}
+
+Result<boost::optional<PackedColumnData>> SubDocumentReaderBuilder::GetPackedColumn(
+    const KeyBytes& sub_doc_key) const {
+  if (!packed_row_write_time_.is_valid() || sub_doc_key.size() <= root_doc_key_size_) {
+    return boost::none;
+  }
+  Slice subkeys = sub_doc_key.AsSlice().WithoutPrefix(root_doc_key_size_);
+  PrimitiveValue column_key;
+  RETURN_NOT_OK(column_key.DecodeFromKey(&subkeys));
+  if (!subkeys.empty() || column_key.value_type() != ValueType::kColumnId) {
+    return boost::none;
+  }
+  const auto* encoded_value = packed_row_.FindColumn(column_key.GetColumnId());
+  if (!encoded_value) {
+    return boost::none;
+  }
+  return PackedColumnData {
+    .encoded_value = *encoded_value,
+    .write_time = packed_row_write_time_,
+  };
 }
 
 Status SubDocumentReaderBuilder::InitObsolescenceInfo(
     const ObsolescenceTracker& table_obsolescence_tracker,
     const Slice& root_doc_key, const Slice& target_subdocument_key) {
   parent_obsolescence_tracker_ = table_obsolescence_tracker;
+  root_doc_key_size_ = root_doc_key.size();
+  packed_row_write_time_ = DocHybridTime::kInvalid;
 
   // Look at ancestors to collect ttl/write-time metadata.
   IntentAwareIteratorPrefixScope prefix_scope(root_doc_key, iter_);
@@ -715,6 +839,16 @@ Status SubDocumentReaderBuilder::UpdateWithParentWriteInfo(
   }
 
   parent_obsolescence_tracker_ = parent_obsolescence_tracker_.Child(doc_ht);
+
+  if (!value.empty() && parent_key_without_ht.size() == root_doc_key_size_) {
+    Value control_fields;
+    RETURN_NOT_OK(control_fields.DecodeControlFields(&value));
+    if (DecodeValueType(value) == ValueType::kPackedRow) {
+      packed_row_value_.assign(value.cdata(), value.size());
+      RETURN_NOT_OK(packed_row_.Decode(packed_row_value_));
+      packed_row_write_time_ = doc_ht;
+    }
+  }
   return Status::OK();
 }
 
@@ -17,12 +17,15 @@
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "yb/common/doc_hybrid_time.h"
 #include "yb/common/read_hybrid_time.h"
 #include "yb/common/transaction.h"
 
 #include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/expiration.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/value.h"
 
 #include "yb/gutil/macros.h"
@@ -74,6 +77,12 @@ class ObsolescenceTracker {
 };
 
 
+// Value of a column taken from the packed row stored at the root of the document.
+struct PackedColumnData {
+  Slice encoded_value;
+  DocHybridTime write_time;
+};
+
 // This class orchestrates the creation of a SubDocument stored in RocksDB with key
 // target_subdocument_key, respecting the expiration and high write time passed to it on
 // construction.
@@ -83,7 +92,8 @@ class SubDocumentReader {
       const KeyBytes& target_subdocument_key,
       IntentAwareIterator* iter,
       DeadlineInfo* deadline_info,
-      const ObsolescenceTracker& ancestor_obsolescence_tracker);
+      const ObsolescenceTracker& ancestor_obsolescence_tracker,
+      const boost::optional<PackedColumnData>& packed_column = boost::none);
 
   // Populate the provided SubDocument* with the data for the provided target_subdocument_key. This
   // method assumes the provided IntentAwareIterator is pointing to the beginning of the range which
@@ -92,12 +102,17 @@ class SubDocumentReader {
   CHECKED_STATUS Get(SubDocument* result);
 
  private:
+  CHECKED_STATUS GetPackedColumn(SubDocument* result);
+
   const KeyBytes& target_subdocument_key_;
   IntentAwareIterator* const iter_;
   DeadlineInfo* const deadline_info_;
   // Tracks the combined obsolescence info of not only this SubDocument's direct parent but all
   // ancestors of the SubDocument.
   ObsolescenceTracker ancestor_obsolescence_tracker_;
+  // Value of the target column in the packed row of the document, used when the column was not
+  // updated after the row was packed.
+  boost::optional<PackedColumnData> packed_column_;
 };
 
 // This class is responsible for initializing TTL and overwrite metadata based on parent rows, and
@@ -121,9 +136,20 @@ class SubDocumentReaderBuilder {
  private:
   CHECKED_STATUS UpdateWithParentWriteInfo(const Slice& parent_key_without_ht);
 
+  // Returns the packed value of the column identified by sub_doc_key, if the root of the document
+  // is a packed row that contains it.
+  Result<boost::optional<PackedColumnData>> GetPackedColumn(const KeyBytes& sub_doc_key) const;
+
   IntentAwareIterator* iter_;
   DeadlineInfo* deadline_info_;
   ObsolescenceTracker parent_obsolescence_tracker_;
+
+  size_t root_doc_key_size_ = 0;
+  // Packed row stored at the root of the document, if any. packed_row_ references
+  // packed_row_value_.
+  std::string packed_row_value_;
+  PackedRow packed_row_;
+  DocHybridTime packed_row_write_time_ = DocHybridTime::kInvalid;
 };
 
 }  // namespace docdb
@@ -98,6 +98,8 @@ namespace docdb {
     ((kDoubleDescending, 'L'))  /* ASCII code 76 */ \
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kUInt32, 'O'))  /* ASCII code 79 */ \
+    /* Value that holds all non-key columns of a row, see packed_row.h. Never used in keys. */ \
+    ((kPackedRow, 'Q'))  /* ASCII code 81 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kUInt64, 'U')) /* ASCII code 85 */ \
@@ -169,7 +171,7 @@ struct ValueTypeAsChar {
 };
 
 // All primitive value types fall into this range, but not all value types in this range are
-// primitive (e.g. object and tombstone are not).
+// primitive (e.g. object, tombstone and packed row are not).
 
 constexpr ValueType kMinPrimitiveValueType = ValueType::kNullLow;
 constexpr ValueType kMaxPrimitiveValueType = ValueType::kNullHigh;
@@ -190,7 +192,7 @@ constexpr inline bool IsCollectionType(const ValueType value_type) {
 constexpr inline bool IsPrimitiveValueType(const ValueType value_type) {
   return (kMinPrimitiveValueType <= value_type && value_type <= kMaxPrimitiveValueType &&
           !IsCollectionType(value_type) &&
-          value_type != ValueType::kTombstone) ||
+          value_type != ValueType::kTombstone && value_type != ValueType::kPackedRow) ||
          value_type == ValueType::kTransactionApplyState ||
          value_type == ValueType::kExternalTransactionId;
 }
@@ -0,0 +1,191 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <future>
+#include <thread>
+
+#include <boost/optional.hpp>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/transaction_error.h"
+
+#include "yb/docdb/wait_queue.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
+
+using namespace std::literals;
+
+DECLARE_int32(wait_queue_poll_interval_ms);
+
+namespace yb {
+namespace docdb {
+
+class WaitQueueTest : public YBTest {
+ protected:
+  void TearDown() override {
+    queue_.Shutdown();
+    YBTest::TearDown();
+  }
+
+  // Starts wait of waiter for blockers, the returned status is set when wait is done.
+  std::shared_ptr<boost::optional<Status>> Wait(
+      const TransactionId& waiter, std::vector<TransactionId> blockers,
+      CoarseTimePoint deadline = CoarseTimePoint::max()) {
+    auto result = std::make_shared<boost::optional<Status>>();
+    queue_.WaitOn(waiter, /* priority= */ 1, blockers, deadline, [result](const Status& status) {
+      *result = status;
+    });
+    return result;
+  }
+
+  WaitQueue queue_{"T test: ", scoped_refptr<MetricEntity>()};
+};
+
+TEST_F(WaitQueueTest, SignalResolved) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  auto t3 = TransactionId::GenerateRandom();
+
+  auto wait1 = Wait(t1, {t2, t3});
+  auto wait2 = Wait(t2, {t3});
+  ASSERT_TRUE(queue_.HasWaiters());
+
+  std::vector<WaitingTransactionData> waits;
+  queue_.GetWaitingTransactions(&waits);
+  ASSERT_EQ(waits.size(), 2U);
+
+  queue_.SignalResolved(t2);
+  ASSERT_TRUE(*wait1);
+  ASSERT_OK(**wait1);
+  ASSERT_FALSE(*wait2);
+
+  queue_.SignalResolved(t3);
+  ASSERT_TRUE(*wait2);
+  ASSERT_OK(**wait2);
+  ASSERT_FALSE(queue_.HasWaiters());
+}
+
+TEST_F(WaitQueueTest, Poll) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  auto t3 = TransactionId::GenerateRandom();
+
+  auto now = CoarseMonoClock::now();
+  auto expiring = Wait(t1, {t3}, now + 1ms);
+  auto waiting = Wait(t2, {t3});
+
+  queue_.Poll(now + 2ms);
+  ASSERT_TRUE(*expiring);
+  ASSERT_TRUE((**expiring).IsTryAgain());
+  ASSERT_EQ(TransactionError(**expiring).value(), TransactionErrorCode::kConflict);
+  ASSERT_FALSE(*waiting);
+
+  // Waiter is resumed to recheck blockers, even when none of them was signaled.
+  queue_.Poll(now + FLAGS_wait_queue_poll_interval_ms * 1ms + 1s);
+  ASSERT_TRUE(*waiting);
+  ASSERT_OK(**waiting);
+}
+
+TEST_F(WaitQueueTest, FailDeadlocked) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+
+  auto wait1 = Wait(t1, {t2});
+  auto wait2 = Wait(t2, {t1});
+
+  ASSERT_EQ(queue_.FailDeadlocked(t1), 1U);
+  ASSERT_TRUE(*wait1);
+  ASSERT_EQ(TransactionError(**wait1).value(), TransactionErrorCode::kDeadlock);
+  ASSERT_FALSE(*wait2);
+  ASSERT_EQ(queue_.FailDeadlocked(t1), 0U);
+}
+
+TEST_F(WaitQueueTest, Shutdown) {
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+
+  auto before = Wait(t1, {t2});
+  queue_.Shutdown();
+  ASSERT_TRUE(*before);
+  ASSERT_TRUE((**before).IsAborted());
+
+  auto after = Wait(t1, {t2});
+  ASSERT_TRUE(*after);
+  ASSERT_TRUE((**after).IsAborted());
+  ASSERT_FALSE(queue_.HasWaiters());
+}
+
+// Waiters are resumed in the resume pool, and waiters discarded by the pool on shutdown are
+// failed instead of hanging.
+TEST_F(WaitQueueTest, ResumePool) {
+  std::unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("resume").set_max_threads(1).Build(&pool));
+  WaitQueue queue("T test: ", scoped_refptr<MetricEntity>(), pool.get());
+
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  auto t3 = TransactionId::GenerateRandom();
+  const auto test_thread = std::this_thread::get_id();
+
+  std::atomic<bool> slow_resumed_in_pool{false};
+  std::promise<Status> slow_promise;
+  queue.WaitOn(t1, /* priority= */ 1, {t3}, CoarseTimePoint::max(), [&](const Status& status) {
+    slow_resumed_in_pool = std::this_thread::get_id() != test_thread;
+    // Block the only pool thread, so the next waiter stays queued.
+    std::this_thread::sleep_for(200ms);
+    slow_promise.set_value(status);
+  });
+  std::promise<Status> queued_promise;
+  queue.WaitOn(t2, /* priority= */ 1, {t3}, CoarseTimePoint::max(), [&](const Status& status) {
+    queued_promise.set_value(status);
+  });
+
+  queue.SignalResolved(t3);
+  queue.Shutdown();
+
+  ASSERT_OK(slow_promise.get_future().get());
+  ASSERT_TRUE(slow_resumed_in_pool.load());
+  // Queued waiter either was run before shutdown, or was discarded and failed.
+  auto queued_status = queued_promise.get_future().get();
+  ASSERT_TRUE(queued_status.ok() || queued_status.IsAborted()) << queued_status;
+
+  pool->Shutdown();
+}
+
+// Waiter is failed when its resume task could not be submitted to the pool.
+TEST_F(WaitQueueTest, ResumePoolRejects) {
+  std::unique_ptr<ThreadPool> pool;
+  ASSERT_OK(ThreadPoolBuilder("resume").set_max_threads(1).Build(&pool));
+  WaitQueue queue("T test: ", scoped_refptr<MetricEntity>(), pool.get());
+
+  auto t1 = TransactionId::GenerateRandom();
+  auto t2 = TransactionId::GenerateRandom();
+  std::promise<Status> promise;
+  queue.WaitOn(t1, /* priority= */ 1, {t2}, CoarseTimePoint::max(), [&](const Status& status) {
+    promise.set_value(status);
+  });
+
+  pool->Shutdown();
+  queue.SignalResolved(t2);
+  auto status = promise.get_future().get();
+  ASSERT_TRUE(status.IsAborted()) << status;
+
+  queue.Shutdown();
+}
+
+} // namespace docdb
+} // namespace yb
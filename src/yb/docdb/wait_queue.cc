@@ -0,0 +1,299 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/wait_queue.h"
+
+#include <algorithm>
+
+#include <gflags/gflags.h>
+
+#include "yb/common/transaction_error.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/status_format.h"
+#include "yb/util/threadpool.h"
+#include "yb/util/trace.h"
+
+using namespace std::literals;
+
+DEFINE_bool(enable_wait_queues, false,
+            "Whether transactional writes that conflict with pending transactions wait for them "
+            "to be resolved, instead of aborting lower priority transactions or failing with "
+            "a conflict error.");
+TAG_FLAG(enable_wait_queues, advanced);
+TAG_FLAG(enable_wait_queues, runtime);
+
+DEFINE_int32(wait_queue_poll_interval_ms, 100,
+             "Waiters in a wait queue recheck status of the transactions they are waiting for "
+             "at least this often, since an aborted transaction could be cleaned up lazily.");
+TAG_FLAG(wait_queue_poll_interval_ms, advanced);
+TAG_FLAG(wait_queue_poll_interval_ms, runtime);
+
+METRIC_DEFINE_gauge_uint64(
+    tablet, wait_queue_waiters, "Wait Queue Waiters", yb::MetricUnit::kTransactions,
+    "Number of operations waiting for conflicting transactions in the wait queue.");
+
+METRIC_DEFINE_coarse_histogram(
+    tablet, wait_queue_wait_time, "Wait Queue Wait Time", yb::MetricUnit::kMicroseconds,
+    "Time an operation waited in the wait queue before being resumed or failed.");
+
+METRIC_DEFINE_counter(
+    tablet, wait_queue_deadlocks, "Wait Queue Deadlocks", yb::MetricUnit::kTransactions,
+    "Number of waits failed because the waiting transaction was chosen as a deadlock victim.");
+
+namespace yb {
+namespace docdb {
+
+std::string WaitingTransactionData::ToString() const {
+  return YB_STRUCT_TO_STRING(id, priority, blockers);
+}
+
+struct WaitQueue::Waiter {
+  TransactionId id;
+  uint64_t priority;
+  std::vector<TransactionId> blockers;
+  CoarseTimePoint start_time;
+  CoarseTimePoint deadline;
+  WaitDoneCallback callback;
+};
+
+namespace {
+
+// Invokes waiter callback in the resume pool. If the pool rejects or discards the task, e.g.
+// during shutdown, the callback is invoked with Aborted status, so the waiter does not hang.
+class ResumeTask {
+ public:
+  ResumeTask(WaitDoneCallback callback, Status status)
+      : callback_(std::move(callback)), status_(std::move(status)) {}
+
+  ~ResumeTask() {
+    if (callback_) {
+      Abort();
+    }
+  }
+
+  void Run() {
+    Invoke(status_);
+  }
+
+  void Abort() {
+    Invoke(STATUS(Aborted, "Wait queue is shutting down"));
+  }
+
+ private:
+  void Invoke(const Status& status) {
+    auto callback = std::move(callback_);
+    callback_ = nullptr;
+    callback(status);
+  }
+
+  WaitDoneCallback callback_;
+  Status status_;
+};
+
+} // namespace
+
+WaitQueue::WaitQueue(std::string log_prefix, const scoped_refptr<MetricEntity>& metric_entity,
+                     ThreadPool* resume_pool)
+    : log_prefix_(std::move(log_prefix)),
+      resume_token_(
+          resume_pool ? resume_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT) : nullptr) {
+  if (metric_entity) {
+    waiters_gauge_ = METRIC_wait_queue_waiters.Instantiate(metric_entity, 0);
+    wait_time_histogram_ = METRIC_wait_queue_wait_time.Instantiate(metric_entity);
+    deadlocks_counter_ = METRIC_wait_queue_deadlocks.Instantiate(metric_entity);
+  }
+}
+
+WaitQueue::~WaitQueue() {
+  if (resume_token_) {
+    resume_token_->Shutdown();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_IF_WITH_PREFIX(DFATAL, !waiters_.empty())
+      << "Destroying wait queue with " << waiters_.size() << " waiters";
+}
+
+void WaitQueue::WaitOn(const TransactionId& waiter, uint64_t priority,
+                       const std::vector<TransactionId>& blockers, CoarseTimePoint deadline,
+                       WaitDoneCallback callback) {
+  auto data = std::make_shared<Waiter>(Waiter {
+    .id = waiter,
+    .priority = priority,
+    .blockers = blockers,
+    .start_time = CoarseMonoClock::now(),
+    .deadline = deadline,
+    .callback = std::move(callback),
+  });
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!shutdown_) {
+      VLOG_WITH_PREFIX(4) << "Wait: " << waiter << " for " << AsString(blockers);
+      for (const auto& blocker : blockers) {
+        waiters_by_blocker_[blocker].push_back(data);
+      }
+      waiters_.insert(data);
+      UpdateWaitersMetricUnlocked();
+      return;
+    }
+  }
+  data->callback(STATUS(Aborted, "Wait queue is shutting down"));
+}
+
+void WaitQueue::SignalResolved(const TransactionId& id) {
+  std::vector<WaiterPtr> resumed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = waiters_by_blocker_.find(id);
+    if (it == waiters_by_blocker_.end()) {
+      return;
+    }
+    // Copy, since removal modifies the vector.
+    resumed = it->second;
+    for (const auto& waiter : resumed) {
+      RemoveUnlocked(waiter);
+    }
+    UpdateWaitersMetricUnlocked();
+  }
+  VLOG_WITH_PREFIX(4) << "Resolved: " << id << ", resumed: " << resumed.size();
+  Resume(resumed, Status::OK());
+}
+
+void WaitQueue::Poll(CoarseTimePoint now) {
+  std::vector<WaiterPtr> resumed;
+  std::vector<WaiterPtr> expired;
+  const auto recheck_interval = FLAGS_wait_queue_poll_interval_ms * 1ms;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& waiter : waiters_) {
+      if (waiter->deadline <= now) {
+        expired.push_back(waiter);
+      } else if (waiter->start_time + recheck_interval <= now) {
+        resumed.push_back(waiter);
+      }
+    }
+    for (const auto& waiter : resumed) {
+      RemoveUnlocked(waiter);
+    }
+    for (const auto& waiter : expired) {
+      RemoveUnlocked(waiter);
+    }
+    UpdateWaitersMetricUnlocked();
+  }
+  Resume(resumed, Status::OK());
+  for (const auto& waiter : expired) {
+    Resume({waiter}, STATUS_EC_FORMAT(
+        TryAgain, TransactionError(TransactionErrorCode::kConflict),
+        "$0 timed out waiting for conflicting transactions: $1",
+        waiter->id, AsString(waiter->blockers)));
+  }
+}
+
+size_t WaitQueue::FailDeadlocked(const TransactionId& waiter) {
+  std::vector<WaiterPtr> failed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& data : waiters_) {
+      if (data->id == waiter) {
+        failed.push_back(data);
+      }
+    }
+    for (const auto& data : failed) {
+      RemoveUnlocked(data);
+    }
+    UpdateWaitersMetricUnlocked();
+  }
+  if (failed.empty()) {
+    return 0;
+  }
+  LOG_WITH_PREFIX(INFO) << "Deadlock detected, failing waits of " << waiter;
+  if (deadlocks_counter_) {
+    deadlocks_counter_->IncrementBy(failed.size());
+  }
+  Resume(failed, STATUS_EC_FORMAT(
+      TryAgain, TransactionError(TransactionErrorCode::kDeadlock),
+      "Deadlock detected, $0 was chosen as a victim", waiter));
+  return failed.size();
+}
+
+void WaitQueue::GetWaitingTransactions(std::vector<WaitingTransactionData>* out) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& waiter : waiters_) {
+    out->push_back(WaitingTransactionData {
+      .id = waiter->id,
+      .priority = waiter->priority,
+      .blockers = waiter->blockers,
+    });
+  }
+}
+
+void WaitQueue::Shutdown() {
+  std::vector<WaiterPtr> failed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+    failed.assign(waiters_.begin(), waiters_.end());
+    waiters_.clear();
+    waiters_by_blocker_.clear();
+    UpdateWaitersMetricUnlocked();
+  }
+  Resume(failed, STATUS(Aborted, "Wait queue is shutting down"));
+  if (resume_token_) {
+    // Waits for callbacks that are running, queued callbacks are invoked with Aborted status.
+    resume_token_->Shutdown();
+  }
+}
+
+void WaitQueue::RemoveUnlocked(const WaiterPtr& waiter) {
+  for (const auto& blocker : waiter->blockers) {
+    auto it = waiters_by_blocker_.find(blocker);
+    if (it == waiters_by_blocker_.end()) {
+      continue;
+    }
+    auto& waiters = it->second;
+    waiters.erase(std::remove(waiters.begin(), waiters.end(), waiter), waiters.end());
+    if (waiters.empty()) {
+      waiters_by_blocker_.erase(it);
+    }
+  }
+  waiters_.erase(waiter);
+}
+
+void WaitQueue::Resume(const std::vector<WaiterPtr>& waiters, const Status& status) {
+  auto now = CoarseMonoClock::now();
+  for (const auto& waiter : waiters) {
+    IncrementHistogram(wait_time_histogram_, MonoDelta(now - waiter->start_time).ToMicroseconds());
+    TRACE("Resumed after waiting for $0: $1", AsString(waiter->blockers), status.ToString());
+    if (!resume_token_) {
+      waiter->callback(status);
+      continue;
+    }
+    auto task = std::make_shared<ResumeTask>(waiter->callback, status);
+    if (!resume_token_->SubmitFunc([task] { task->Run(); }).ok()) {
+      task->Abort();
+    }
+  }
+}
+
+void WaitQueue::UpdateWaitersMetricUnlocked() {
+  num_waiters_.store(waiters_.size(), std::memory_order_release);
+  if (waiters_gauge_) {
+    waiters_gauge_->set_value(waiters_.size());
+  }
+}
+
+} // namespace docdb
+} // namespace yb
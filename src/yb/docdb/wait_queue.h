@@ -0,0 +1,136 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_WAIT_QUEUE_H
+#define YB_DOCDB_WAIT_QUEUE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <gflags/gflags_declare.h>
+
+#include "yb/common/transaction.h"
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/util/metrics_fwd.h"
+#include "yb/util/monotime.h"
+
+DECLARE_bool(enable_wait_queues);
+
+namespace yb {
+
+class ThreadPool;
+class ThreadPoolToken;
+
+namespace docdb {
+
+// Transaction that waits for other transactions to be resolved.
+struct WaitingTransactionData {
+  TransactionId id;
+  uint64_t priority;
+  // Transactions that hold conflicting intents.
+  std::vector<TransactionId> blockers;
+
+  std::string ToString() const;
+};
+
+using WaitDoneCallback = std::function<void(const Status&)>;
+
+// Parks conflict resolution of transactions that conflict with pending transactions, instead of
+// failing or aborting on conflict. There is a separate instance per tablet.
+//
+// A waiter is resumed when any of its blockers is resolved at this tablet, i.e. committed and
+// applied, or aborted and cleaned up. Since the tablet could learn about an aborted blocker
+// only lazily, waiters are also resumed periodically to recheck status of their blockers.
+// A resumed waiter is removed from the queue, it is up to the waiter to resolve conflicts again
+// and wait more if necessary.
+//
+// Waiter callbacks are invoked without holding the queue lock. When resume_pool is specified,
+// they are invoked in that pool, so callbacks could block, e.g. to reacquire locks. Otherwise
+// they are invoked in the thread that resumes the waiter, and caller should not hold locks that
+// could be required by the callback.
+class WaitQueue {
+ public:
+  WaitQueue(std::string log_prefix, const scoped_refptr<MetricEntity>& metric_entity,
+            ThreadPool* resume_pool = nullptr);
+  ~WaitQueue();
+
+  // Parks waiter until one of blockers is resolved, the deadline passes or the waiter is failed.
+  // Callback receives OK status when the waiter should retry conflict resolution, otherwise
+  // the reason why the waiter should give up.
+  void WaitOn(const TransactionId& waiter, uint64_t priority,
+              const std::vector<TransactionId>& blockers, CoarseTimePoint deadline,
+              WaitDoneCallback callback);
+
+  // Resumes waiters that wait for the specified transaction.
+  void SignalResolved(const TransactionId& id);
+
+  // Resumes waiters that were not resumed for --wait_queue_poll_interval_ms, and fails waiters
+  // whose deadline has passed.
+  void Poll(CoarseTimePoint now);
+
+  // Fails all waits of the specified transaction, that was chosen as a deadlock victim.
+  // Returns the number of failed waits.
+  size_t FailDeadlocked(const TransactionId& waiter);
+
+  // Appends transactions that currently wait in this queue to out.
+  void GetWaitingTransactions(std::vector<WaitingTransactionData>* out);
+
+  bool HasWaiters() const {
+    return num_waiters_.load(std::memory_order_acquire) != 0;
+  }
+
+  // Fails all waiters. Waiters that arrive after shutdown are failed immediately.
+  void Shutdown();
+
+ private:
+  struct Waiter;
+  using WaiterPtr = std::shared_ptr<Waiter>;
+
+  void RemoveUnlocked(const WaiterPtr& waiter) REQUIRES(mutex_);
+  void Resume(const std::vector<WaiterPtr>& waiters, const Status& status);
+  void UpdateWaitersMetricUnlocked() REQUIRES(mutex_);
+
+  const std::string& LogPrefix() const {
+    return log_prefix_;
+  }
+
+  const std::string log_prefix_;
+
+  // Runs waiter callbacks, if resume pool was specified.
+  std::unique_ptr<ThreadPoolToken> resume_token_;
+
+  std::mutex mutex_;
+  // Waiters, keyed by the transactions they are waiting for.
+  std::unordered_map<TransactionId, std::vector<WaiterPtr>, TransactionIdHash> waiters_by_blocker_
+      GUARDED_BY(mutex_);
+  std::unordered_set<WaiterPtr> waiters_ GUARDED_BY(mutex_);
+  bool shutdown_ GUARDED_BY(mutex_) = false;
+  std::atomic<size_t> num_waiters_{0};
+
+  scoped_refptr<AtomicGauge<uint64_t>> waiters_gauge_;
+  scoped_refptr<Histogram> wait_time_histogram_;
+  scoped_refptr<Counter> deadlocks_counter_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_WAIT_QUEUE_H
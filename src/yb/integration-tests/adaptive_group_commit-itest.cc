@@ -0,0 +1,149 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/test_workload.h"
+
+#include "yb/server/server_base.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+
+#include "yb/util/format.h"
+#include "yb/util/metrics.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Write);
+METRIC_DECLARE_histogram(preparer_batch_size);
+METRIC_DECLARE_histogram(preparer_batch_delay);
+
+DECLARE_bool(enable_adaptive_group_replicate_batching);
+
+DEFINE_int32(adaptive_group_commit_test_duration_ms, 5000,
+             "Duration of the workload in each run of adaptive group commit test.");
+
+namespace yb {
+
+namespace {
+
+struct RunStats {
+  int num_write_threads = 0;
+  int64_t rows_inserted = 0;
+  double write_latency_us = 0;
+  double batch_size = 0;
+  double batch_delay_us = 0;
+
+  std::string ToString() const {
+    return Format(
+        "{ write_threads: $0 rows_per_second: $1 write_latency_us: $2 batch_size: $3 "
+            "batch_delay_us: $4 }",
+        num_write_threads, rows_inserted * 1000 / FLAGS_adaptive_group_commit_test_duration_ms,
+        write_latency_us, batch_size, batch_delay_us);
+  }
+};
+
+} // namespace
+
+class AdaptiveGroupCommitITest : public YBTest {
+ protected:
+  void TearDown() override {
+    if (cluster_) {
+      cluster_->Shutdown();
+    }
+    YBTest::TearDown();
+  }
+
+  // Returns mean value of the histogram over all tablet servers.
+  double ServerMean(const HistogramPrototype& prototype) {
+    int64_t count = 0;
+    double sum = 0;
+    for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto entity = cluster_->mini_tablet_server(i)->server()->metric_entity();
+      auto histogram = prototype.Instantiate(entity);
+      count += histogram->TotalCount();
+      sum += histogram->MeanValueForTests() * histogram->TotalCount();
+    }
+    return count ? sum / count : 0;
+  }
+
+  // Returns mean value of the histogram over tablet leaders.
+  double LeaderMean(const HistogramPrototype& prototype) {
+    int64_t count = 0;
+    double sum = 0;
+    for (const auto& peer : ListTabletPeers(cluster_.get(), ListPeersFilter::kLeaders)) {
+      auto histogram = prototype.Instantiate(peer->tablet()->GetTabletMetricsEntity());
+      count += histogram->TotalCount();
+      sum += histogram->MeanValueForTests() * histogram->TotalCount();
+    }
+    return count ? sum / count : 0;
+  }
+
+  // Starts fresh cluster with the specified batching mode, and runs write workload with the
+  // specified number of writers against a single tablet.
+  RunStats Run(bool adaptive, int num_write_threads) {
+    FLAGS_enable_adaptive_group_replicate_batching = adaptive;
+
+    MiniClusterOptions opts;
+    opts.num_tablet_servers = 3;
+    cluster_ = std::make_unique<MiniCluster>(opts);
+    EXPECT_OK(cluster_->Start());
+
+    TestWorkload workload(cluster_.get());
+    workload.set_num_tablets(1);
+    workload.set_num_write_threads(num_write_threads);
+    workload.set_write_batch_size(1);
+    workload.set_timeout_allowed(true);
+    workload.Setup();
+
+    workload.Start();
+    SleepFor(FLAGS_adaptive_group_commit_test_duration_ms * 1ms);
+    workload.StopAndJoin();
+
+    RunStats result;
+    result.num_write_threads = num_write_threads;
+    result.rows_inserted = workload.rows_inserted();
+    result.write_latency_us =
+        ServerMean(METRIC_handler_latency_yb_tserver_TabletServerService_Write);
+    result.batch_size = LeaderMean(METRIC_preparer_batch_size);
+    result.batch_delay_us = LeaderMean(METRIC_preparer_batch_delay);
+
+    cluster_->Shutdown();
+    cluster_.reset();
+    return result;
+  }
+
+  std::unique_ptr<MiniCluster> cluster_;
+};
+
+// Compares throughput and write latency of fixed and adaptive group replicate batching under
+// different client concurrency.
+TEST_F(AdaptiveGroupCommitITest, YB_DISABLE_TEST_IN_TSAN(CompareConcurrency)) {
+  for (int num_write_threads : {1, 8, 64}) {
+    auto fixed = Run(/* adaptive= */ false, num_write_threads);
+    LOG(INFO) << "Fixed batching: " << fixed.ToString();
+    auto adaptive = Run(/* adaptive= */ true, num_write_threads);
+    LOG(INFO) << "Adaptive batching: " << adaptive.ToString();
+
+    ASSERT_GT(fixed.rows_inserted, 0);
+    ASSERT_GT(adaptive.rows_inserted, 0);
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,152 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/test_workload.h"
+
+#include "yb/server/server_base.h"
+
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+
+#include "yb/util/format.h"
+#include "yb/util/metrics.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_UpdateConsensus);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Write);
+
+DECLARE_bool(enable_multi_raft_heartbeat_batcher);
+DECLARE_bool(enable_multi_raft_update_batching);
+DECLARE_uint64(multi_raft_batch_size);
+
+DEFINE_int32(multi_raft_batching_test_num_tablets, 32,
+             "Number of tablets in the table used by multi raft batching test.");
+DEFINE_int32(multi_raft_batching_test_duration_ms, 10000,
+             "Duration of the workload in each run of multi raft batching test.");
+
+namespace yb {
+
+namespace {
+
+constexpr int kNumTabletServers = 3;
+
+struct RunStats {
+  int64_t rows_inserted = 0;
+  int64_t update_rpcs = 0;
+  double write_latency_us = 0;
+  CpuTimes cpu;
+
+  std::string ToString() const {
+    return Format(
+        "{ rows_inserted: $0 update_rpcs: $1 rpcs_per_row: $2 write_latency_us: $3 "
+            "cpu_user_s: $4 cpu_system_s: $5 }",
+        rows_inserted, update_rpcs,
+        rows_inserted ? static_cast<double>(update_rpcs) / rows_inserted : 0,
+        write_latency_us, cpu.user_cpu_seconds(), cpu.system_cpu_seconds());
+  }
+};
+
+} // namespace
+
+class MultiRaftBatchingITest : public YBTest {
+ protected:
+  void TearDown() override {
+    if (cluster_) {
+      cluster_->Shutdown();
+    }
+    YBTest::TearDown();
+  }
+
+  int64_t TotalCount(const HistogramPrototype& prototype, double* mean = nullptr) {
+    int64_t result = 0;
+    double sum = 0;
+    for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto entity = cluster_->mini_tablet_server(i)->server()->metric_entity();
+      auto histogram = prototype.Instantiate(entity);
+      auto count = histogram->TotalCount();
+      result += count;
+      sum += histogram->MeanValueForTests() * count;
+    }
+    if (mean) {
+      *mean = result ? sum / result : 0;
+    }
+    return result;
+  }
+
+  // Starts fresh cluster with the specified batching mode, and runs write workload against it.
+  RunStats Run(bool batching) {
+    FLAGS_enable_multi_raft_heartbeat_batcher = batching;
+    FLAGS_enable_multi_raft_update_batching = batching;
+    FLAGS_multi_raft_batch_size = batching ? 64 : 1;
+
+    MiniClusterOptions opts;
+    opts.num_tablet_servers = kNumTabletServers;
+    cluster_ = std::make_unique<MiniCluster>(opts);
+    EXPECT_OK(cluster_->Start());
+
+    TestWorkload workload(cluster_.get());
+    workload.set_num_tablets(FLAGS_multi_raft_batching_test_num_tablets);
+    workload.set_num_write_threads(16);
+    workload.set_write_batch_size(1);
+    workload.set_timeout_allowed(true);
+    workload.Setup();
+
+    auto rpcs_before =
+        TotalCount(METRIC_handler_latency_yb_consensus_ConsensusService_UpdateConsensus) +
+        TotalCount(METRIC_handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus);
+
+    RunStats result;
+    Stopwatch stopwatch(Stopwatch::ALL_THREADS);
+    stopwatch.start();
+    workload.Start();
+    SleepFor(FLAGS_multi_raft_batching_test_duration_ms * 1ms);
+    workload.StopAndJoin();
+    stopwatch.stop();
+
+    result.cpu = stopwatch.elapsed();
+    result.rows_inserted = workload.rows_inserted();
+    result.update_rpcs =
+        TotalCount(METRIC_handler_latency_yb_consensus_ConsensusService_UpdateConsensus) +
+        TotalCount(METRIC_handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus) -
+        rpcs_before;
+    TotalCount(METRIC_handler_latency_yb_tserver_TabletServerService_Write,
+               &result.write_latency_us);
+
+    cluster_->Shutdown();
+    cluster_.reset();
+    return result;
+  }
+
+  std::unique_ptr<MiniCluster> cluster_;
+};
+
+// Compares number of consensus RPCs, CPU usage and write latency with and without batching of
+// UpdateConsensus requests that carry operations.
+TEST_F(MultiRaftBatchingITest, YB_DISABLE_TEST_IN_TSAN(CompareBatching)) {
+  auto plain = Run(/* batching= */ false);
+  LOG(INFO) << "Without batching: " << plain.ToString();
+  auto batched = Run(/* batching= */ true);
+  LOG(INFO) << "With batching: " << batched.ToString();
+
+  ASSERT_GT(plain.rows_inserted, 0);
+  ASSERT_GT(batched.rows_inserted, 0);
+}
+
+} // namespace yb
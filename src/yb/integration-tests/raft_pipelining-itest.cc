@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/test_workload.h"
+
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+using namespace yb::size_literals;
+
+DECLARE_int32(consensus_max_inflight_requests_per_peer);
+DECLARE_bool(consensus_send_encoded_ops);
+DECLARE_uint64(consensus_max_batch_size_bytes);
+DECLARE_int32(TEST_inject_follower_update_latency_ms);
+
+DEFINE_int32(raft_pipelining_test_latency_ms, 5,
+             "Latency injected into each UpdateConsensus request by raft pipelining test.");
+DEFINE_int32(raft_pipelining_test_duration_ms, 10000,
+             "Duration of the workload in each run of raft pipelining test.");
+
+namespace yb {
+
+class RaftPipeliningITest : public YBTest {
+ protected:
+  void TearDown() override {
+    if (cluster_) {
+      cluster_->Shutdown();
+    }
+    YBTest::TearDown();
+  }
+
+  // Starts fresh cluster with the specified number of in-flight requests per peer, and returns
+  // the number of rows written to a single tablet.
+  int64_t Run(int max_inflight_requests, bool send_encoded_ops = false) {
+    FLAGS_consensus_max_inflight_requests_per_peer = max_inflight_requests;
+    FLAGS_consensus_send_encoded_ops = send_encoded_ops;
+    // Small batches make replication throughput limited by the round trip time.
+    FLAGS_consensus_max_batch_size_bytes = 64_KB;
+    FLAGS_TEST_inject_follower_update_latency_ms = FLAGS_raft_pipelining_test_latency_ms;
+
+    MiniClusterOptions opts;
+    opts.num_tablet_servers = 3;
+    cluster_ = std::make_unique<MiniCluster>(opts);
+    EXPECT_OK(cluster_->Start());
+
+    TestWorkload workload(cluster_.get());
+    workload.set_num_tablets(1);
+    workload.set_num_write_threads(32);
+    workload.set_write_batch_size(4);
+    workload.set_payload_bytes(1_KB);
+    workload.set_timeout_allowed(true);
+    workload.Setup();
+
+    workload.Start();
+    SleepFor(FLAGS_raft_pipelining_test_duration_ms * 1ms);
+    workload.StopAndJoin();
+
+    auto result = workload.rows_inserted();
+    cluster_->Shutdown();
+    cluster_.reset();
+    return result;
+  }
+
+  std::unique_ptr<MiniCluster> cluster_;
+};
+
+// Compares write throughput of a single tablet with and without pipelining of UpdateConsensus
+// requests, while each request to a follower is delayed to emulate cross zone round trips.
+TEST_F(RaftPipeliningITest, YB_DISABLE_TEST_IN_TSAN(CompareThroughput)) {
+  auto plain = Run(/* max_inflight_requests= */ 1);
+  LOG(INFO) << "Without pipelining, rows inserted: " << plain << ", rows per second: "
+            << plain * 1000 / FLAGS_raft_pipelining_test_duration_ms;
+  auto pipelined = Run(/* max_inflight_requests= */ 8);
+  LOG(INFO) << "With pipelining, rows inserted: " << pipelined << ", rows per second: "
+            << pipelined * 1000 / FLAGS_raft_pipelining_test_duration_ms;
+
+  ASSERT_GT(plain, 0);
+  ASSERT_GT(pipelined, 0);
+}
+
+// Ops are moved from the request to its tail when they are sent encoded, pipelining should still
+// be used in this case.
+TEST_F(RaftPipeliningITest, YB_DISABLE_TEST_IN_TSAN(PipeliningWithEncodedOps)) {
+  auto plain = Run(/* max_inflight_requests= */ 1, /* send_encoded_ops= */ true);
+  LOG(INFO) << "Without pipelining, rows inserted: " << plain << ", rows per second: "
+            << plain * 1000 / FLAGS_raft_pipelining_test_duration_ms;
+  auto pipelined = Run(/* max_inflight_requests= */ 8, /* send_encoded_ops= */ true);
+  LOG(INFO) << "With pipelining, rows inserted: " << pipelined << ", rows per second: "
+            << pipelined * 1000 / FLAGS_raft_pipelining_test_duration_ms;
+
+  ASSERT_GT(plain, 0);
+  ASSERT_GT(pipelined, 0);
+}
+
+} // namespace yb
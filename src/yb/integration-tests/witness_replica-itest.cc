@@ -0,0 +1,159 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/client/client.h"
+#include "yb/client/client-test-util.h"
+#include "yb/client/table_handle.h"
+
+#include "yb/consensus/consensus.h"
+
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/test_workload.h"
+
+#include "yb/master/catalog_entity_info.h"
+
+#include "yb/tablet/tablet_peer.h"
+
+#include "yb/tserver/mini_tablet_server.h"
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
+
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+
+class WitnessReplicaITest : public YBTest {
+ protected:
+  void TearDown() override {
+    if (cluster_) {
+      cluster_->Shutdown();
+    }
+    YBTest::TearDown();
+  }
+
+  Result<tablet::TabletPeerPtr> LookupPeer(size_t ts_idx) {
+    return cluster_->mini_tablet_server(ts_idx)->server()->tablet_manager()->LookupTablet(
+        tablet_id_);
+  }
+
+  // Returns index of the tablet server hosting the tablet peer with the specified role.
+  Result<size_t> FindServerWithRole(PeerRole role) {
+    for (size_t i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      auto peer = LookupPeer(i);
+      if (peer.ok() && (**peer).consensus() && (**peer).consensus()->role() == role) {
+        return i;
+      }
+    }
+    return STATUS_FORMAT(NotFound, "No peer with role $0", PeerRole_Name(role));
+  }
+
+  std::unique_ptr<MiniCluster> cluster_;
+  TabletId tablet_id_;
+};
+
+// Leader and witness form a majority of the config, but operations replicated only to them should
+// not be committed. Otherwise they would be lost when the leader fails, because the witness
+// cannot become leader and the regular follower does not have them.
+TEST_F(WitnessReplicaITest, LeaderFailureAfterReplicationToWitness) {
+  MiniClusterOptions opts;
+  opts.num_tablet_servers = 3;
+  cluster_ = std::make_unique<MiniCluster>(opts);
+  ASSERT_OK(cluster_->Start());
+
+  auto client = ASSERT_RESULT(cluster_->CreateClient());
+  master::ReplicationInfoPB replication_info;
+  replication_info.mutable_live_replicas()->set_num_replicas(2);
+  replication_info.mutable_witnesses()->set_num_replicas(1);
+  ASSERT_OK(client->SetReplicationInfo(replication_info));
+
+  TestWorkload workload(cluster_.get());
+  workload.set_num_tablets(1);
+  workload.set_num_write_threads(1);
+  workload.set_write_timeout_millis(1000);
+  workload.set_timeout_allowed(true);
+  workload.Setup();
+
+  const auto table_info = ASSERT_RESULT(FindTable(cluster_.get(), workload.table_name()));
+  const auto tablet_ids = ListTabletIdsForTable(cluster_.get(), table_info->id());
+  ASSERT_EQ(tablet_ids.size(), 1U);
+  tablet_id_ = *tablet_ids.begin();
+
+  size_t leader_idx = 0;
+  size_t follower_idx = 0;
+  size_t witness_idx = 0;
+  ASSERT_OK(WaitFor([&]() -> Result<bool> {
+    auto leader = FindServerWithRole(PeerRole::LEADER);
+    auto follower = FindServerWithRole(PeerRole::FOLLOWER);
+    auto witness = FindServerWithRole(PeerRole::WITNESS);
+    if (!leader.ok() || !follower.ok() || !witness.ok()) {
+      return false;
+    }
+    leader_idx = *leader;
+    follower_idx = *follower;
+    witness_idx = *witness;
+    return true;
+  }, 30s, "Leader, follower and witness"));
+
+  auto leader = ASSERT_RESULT(LookupPeer(leader_idx));
+  auto witness = ASSERT_RESULT(LookupPeer(witness_idx));
+  ASSERT_OK(WaitFor([leader] {
+    return leader->consensus()->GetLastCommittedOpId() ==
+           leader->consensus()->GetLastReceivedOpId();
+  }, 10s, "Leader commits all operations"));
+  const auto committed_op_id = leader->consensus()->GetLastCommittedOpId();
+
+  cluster_->mini_tablet_server(follower_idx)->Shutdown();
+  workload.Start();
+  ASSERT_OK(WaitFor([witness, committed_op_id] {
+    return witness->consensus()->GetLastReceivedOpId().index > committed_op_id.index;
+  }, 10s, "Witness receives operations"));
+  SleepFor(1s);
+  ASSERT_EQ(leader->consensus()->GetLastCommittedOpId(), committed_op_id);
+  ASSERT_EQ(workload.rows_inserted(), 0);
+
+  // Operations are committed as soon as the regular follower catches up.
+  ASSERT_OK(cluster_->mini_tablet_server(follower_idx)->Start());
+  ASSERT_OK(WaitFor([&workload] {
+    return workload.rows_inserted() > 0;
+  }, 30s, "Rows inserted"));
+  workload.StopAndJoin();
+  const auto rows_inserted = workload.rows_inserted();
+  LOG(INFO) << "Rows inserted: " << rows_inserted;
+
+  // Wait until the regular follower has everything the witness has, so the witness votes for it.
+  ASSERT_OK(WaitFor([this, follower_idx, witness]() -> Result<bool> {
+    auto follower = LookupPeer(follower_idx);
+    return follower.ok() && (**follower).consensus() &&
+           (**follower).consensus()->GetLastReceivedOpId() ==
+               witness->consensus()->GetLastReceivedOpId();
+  }, 30s, "Regular follower catches up"));
+
+  // Every committed operation is present at the regular follower, so it could be elected after
+  // the leader fails and serve all inserted rows.
+  cluster_->mini_tablet_server(leader_idx)->Shutdown();
+  ASSERT_OK(WaitFor([this, follower_idx]() -> Result<bool> {
+    auto follower = LookupPeer(follower_idx);
+    return follower.ok() && (**follower).consensus() &&
+           (**follower).consensus()->role() == PeerRole::LEADER;
+  }, 30s, "Regular follower becomes leader"));
+
+  client::TableHandle table;
+  ASSERT_OK(table.Open(workload.table_name(), client.get()));
+  ASSERT_GE(client::CountTableRows(table), rows_inserted);
+}
+
+}  // namespace yb
@@ -74,7 +74,7 @@ struct TabletReplica {
   TSDescriptor* ts_desc;
   tablet::RaftGroupStatePB state;
   PeerRole role;
-  consensus::PeerMemberType member_type;
+  consensus::PeerMemberType member_type = consensus::PeerMemberType::UNKNOWN_MEMBER_TYPE;
   MonoTime time_updated;
 
   // Replica is reporting that load balancer moves should be disabled. This could happen in the case
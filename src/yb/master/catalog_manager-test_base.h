@@ -240,6 +240,9 @@ class TestLoadBalancerBase {
     gflags::SetCommandLineOption("leader_balance_threshold", "0");
     PrepareTestState(ts_descs_multi_az);
     TestLeaderBlacklist();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestMissingWitness();
   }
 
  protected:
@@ -948,6 +951,38 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestMissingWitness() {
+    LOG(INFO) << "Testing re-creation of missing witnesses";
+    replication_info_.mutable_live_replicas()->set_num_replicas(kDefaultNumReplicas);
+    replication_info_.mutable_witnesses()->set_num_replicas(1);
+
+    // Only tablet 0 has a witness, on the new tablet server.
+    ts_descs_.push_back(SetupTS("3333", "a"));
+    {
+      std::shared_ptr<TabletReplicaMap> replicas =
+          std::const_pointer_cast<TabletReplicaMap>(tablets_[0]->GetReplicaLocations());
+      TabletReplica replica;
+      NewReplica(ts_descs_[3].get(), tablet::RaftGroupStatePB::RUNNING, PeerRole::WITNESS,
+                 &replica);
+      replica.member_type = consensus::PeerMemberType::WITNESS;
+      InsertOrDie(replicas.get(), ts_descs_[3]->permanent_uuid(), replica);
+      tablets_[0]->SetReplicaLocations(replicas);
+    }
+
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+
+    // The witness does not make tablet 0 over-replicated.
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+
+    // Witnesses are added for the other tablets to the only tablet server that does not host them.
+    string placeholder;
+    const auto expected_to_ts = ts_descs_[3]->permanent_uuid();
+    for (size_t i = 1; i != tablets_.size(); ++i) {
+      TestAddLoad(tablets_[i]->tablet_id(), placeholder, expected_to_ts);
+    }
+  }
+
   // Methods to prepare the state of the current test.
   void PrepareTestState(const TSDescriptorVector& ts_descs) {
     // Clear old state.
@@ -8990,8 +8990,26 @@ Status CatalogManager::HandlePlacementUsingReplicationInfo(
     const ReplicationInfoPB& replication_info,
     const TSDescriptorVector& all_ts_descs,
     consensus::RaftConfigPB* config) {
-  return HandlePlacementUsingPlacementInfo(replication_info.live_replicas(),
-                                           all_ts_descs, PeerMemberType::VOTER, config);
+  RETURN_NOT_OK(HandlePlacementUsingPlacementInfo(replication_info.live_replicas(),
+                                                  all_ts_descs, PeerMemberType::VOTER, config));
+  return HandleWitnessPlacement(replication_info, all_ts_descs, config);
+}
+
+Status CatalogManager::HandleWitnessPlacement(const ReplicationInfoPB& replication_info,
+                                              const TSDescriptorVector& ts_descs,
+                                              consensus::RaftConfigPB* config) {
+  if (replication_info.witnesses().num_replicas() <= 0) {
+    return Status::OK();
+  }
+  // Witnesses should not share tablet servers with the replicas selected so far.
+  TSDescriptorVector available_ts_descs;
+  for (const auto& ts_desc : ts_descs) {
+    if (!consensus::IsRaftConfigMember(ts_desc->permanent_uuid(), *config)) {
+      available_ts_descs.push_back(ts_desc);
+    }
+  }
+  return HandlePlacementUsingPlacementInfo(replication_info.witnesses(), available_ts_descs,
+                                           PeerMemberType::WITNESS, config);
 }
 
 Status CatalogManager::HandlePlacementUsingPlacementInfo(const PlacementInfoPB& placement_info,
@@ -613,6 +613,12 @@ class CatalogManager :
       const TSDescriptorVector& all_ts_descs,
       consensus::RaftConfigPB* config);
 
+  // Adds witnesses requested by the replication info to the config, on tablet servers that do not
+  // host other replicas of the tablet yet.
+  CHECKED_STATUS HandleWitnessPlacement(const ReplicationInfoPB& replication_info,
+                                        const TSDescriptorVector& ts_descs,
+                                        consensus::RaftConfigPB* config);
+
   // Handles the config creation for a given placement.
   CHECKED_STATUS HandlePlacementUsingPlacementInfo(const PlacementInfoPB& placement_info,
                                                    const TSDescriptorVector& ts_descs,
@@ -188,8 +188,10 @@ Result<std::string> CatalogManagerUtil::GetPlacementUuidFromRaftPeer(
     const ReplicationInfoPB& replication_info, const consensus::RaftPeerPB& peer) {
   switch (peer.member_type()) {
     case consensus::PeerMemberType::PRE_VOTER:
-    case consensus::PeerMemberType::VOTER: {
-      // This peer is a live replica.
+    case consensus::PeerMemberType::VOTER:
+    case consensus::PeerMemberType::PRE_WITNESS:
+    case consensus::PeerMemberType::WITNESS: {
+      // This peer is a live replica or a witness in the live cluster.
       return replication_info.live_replicas().placement_uuid();
     }
     case consensus::PeerMemberType::PRE_OBSERVER:
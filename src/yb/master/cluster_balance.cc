@@ -256,6 +256,12 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
       RETURN_NOT_OK(PopulatePlacementInfo(tablet, &pb));
     }
     state_->placement_by_table_[table_id] = std::move(pb);
+    if (state_->options_->type == LIVE) {
+      const auto& replication_info = VERIFY_RESULT(GetTableReplicationInfo(tablet->table()));
+      if (replication_info.witnesses().num_replicas() > 0) {
+        state_->witness_placement_by_table_[table_id] = replication_info.witnesses();
+      }
+    }
   }
 
   return state_->UpdateTablet(tablet);
@@ -774,6 +780,24 @@ Result<bool> ClusterLoadBalancer::HandleAddIfMissingPlacement(
   return false;
 }
 
+Result<bool> ClusterLoadBalancer::HandleAddIfMissingWitness(
+    TabletId* out_tablet_id, TabletServerId* out_to_ts) {
+  for (const auto& tablet_id : state_->tablets_missing_witnesses_) {
+    const auto& table_id = GetTabletMap().at(tablet_id)->table()->id();
+    const auto& placement_info = state_->witness_placement_by_table_.at(table_id);
+    for (const auto& ts_uuid : state_->sorted_load_) {
+      if (VERIFY_RESULT(state_->CanAddTabletToTabletServer(tablet_id, ts_uuid, &placement_info))) {
+        *out_tablet_id = tablet_id;
+        *out_to_ts = ts_uuid;
+        RETURN_NOT_OK(AddWitness(tablet_id, ts_uuid));
+        state_->tablets_missing_witnesses_.erase(tablet_id);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 Result<bool> ClusterLoadBalancer::HandleAddIfWrongPlacement(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
   for (const auto& tablet_id : state_->tablets_wrong_placement_) {
@@ -830,6 +854,12 @@ Result<bool> ClusterLoadBalancer::HandleAddReplicas(
     return true;
   }
 
+  // Witnesses lost together with their tablet servers are re-created with the same priority as
+  // missing regular replicas, because they also count towards the majority.
+  if (VERIFY_RESULT(HandleAddIfMissingWitness(out_tablet_id, out_to_ts))) {
+    return true;
+  }
+
   // Handle wrong placements as next priority, as these could be servers we're moving off of, so
   // we can decommission ASAP.
   if (VERIFY_RESULT(HandleAddIfWrongPlacement(out_tablet_id, out_from_ts, out_to_ts))) {
@@ -1337,6 +1367,13 @@ Status ClusterLoadBalancer::AddReplica(const TabletId& tablet_id, const TabletSe
   return state_->AddReplica(tablet_id, to_ts);
 }
 
+Status ClusterLoadBalancer::AddWitness(const TabletId& tablet_id, const TabletServerId& to_ts) {
+  LOG(INFO) << Substitute("Adding witness of tablet $0 to $1", tablet_id, to_ts);
+  RETURN_NOT_OK(SendAddWitnessRequest(GetTabletMap().at(tablet_id), to_ts));
+  // Remote bootstrap of the witness loads the tablet server like a regular replica.
+  return state_->AddReplica(tablet_id, to_ts);
+}
+
 Status ClusterLoadBalancer::RemoveReplica(
     const TabletId& tablet_id, const TabletServerId& ts_uuid) {
   LOG(INFO) << Substitute("Removing replica $0 from tablet $1", ts_uuid, tablet_id);
@@ -1518,6 +1555,18 @@ Status ClusterLoadBalancer::SendReplicaChanges(
   return Status::OK();
 }
 
+Status ClusterLoadBalancer::SendAddWitnessRequest(
+    scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid) {
+  auto l = tablet->LockForRead();
+  SCHECK_EQ(state_->pending_add_replica_tasks_[tablet->table()->id()].count(tablet->tablet_id()),
+            0U,
+            IllegalState,
+            "Sending duplicate add replica task.");
+  catalog_manager_->SendAddServerRequest(
+      tablet, consensus::PeerMemberType::PRE_WITNESS, l->pb.committed_consensus_state(), ts_uuid);
+  return Status::OK();
+}
+
 consensus::PeerMemberType ClusterLoadBalancer::GetDefaultMemberType() {
   if (state_->options_->type == LIVE) {
     return consensus::PeerMemberType::PRE_VOTER;
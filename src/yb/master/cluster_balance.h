@@ -171,6 +171,11 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
+  // Issue the call to CatalogManager to add a PRE_WITNESS peer at ts_uuid to the config of this
+  // tablet.
+  virtual Status SendAddWitnessRequest(
+      scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid);
+
   // If type_ is live, return PRE_VOTER, otherwise, return PRE_OBSERVER.
   consensus::PeerMemberType GetDefaultMemberType();
 
@@ -226,6 +231,13 @@ class ClusterLoadBalancer {
   Result<bool> HandleAddIfMissingPlacement(TabletId* out_tablet_id, TabletServerId* out_to_ts)
       REQUIRES_SHARED(catalog_manager_->mutex_);
 
+  // If a tablet has fewer witnesses than its replication info requires, add a witness on a tablet
+  // server that does not host the tablet yet.
+  //
+  // Returns true if a witness was actually added.
+  Result<bool> HandleAddIfMissingWitness(TabletId* out_tablet_id, TabletServerId* out_to_ts)
+      REQUIRES_SHARED(catalog_manager_->mutex_);
+
   // If we find a tablet with peers that violate the placement information, we want to move load
   // away from the invalid placement peers, to new peers that are valid. To ensure we do not
   // under-replicate a tablet, we first find the tablet server to add load to, essentially
@@ -296,6 +308,11 @@ class ClusterLoadBalancer {
   CHECKED_STATUS AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts)
       REQUIRES_SHARED(catalog_manager_->mutex_);
 
+  // Issue the change config and modify the in-memory state for adding a witness on the specified
+  // tablet server.
+  CHECKED_STATUS AddWitness(const TabletId& tablet_id, const TabletServerId& to_ts)
+      REQUIRES_SHARED(catalog_manager_->mutex_);
+
   // Issue the change config and modify the in-memory state for removing a replica on the specified
   // tablet server.
   CHECKED_STATUS RemoveReplica(
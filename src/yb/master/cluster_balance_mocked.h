@@ -65,6 +65,12 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     return Status::OK();
   }
 
+  Status SendAddWitnessRequest(
+      scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid) override {
+    // Do nothing.
+    return Status::OK();
+  }
+
   void GetPendingTasks(const TableId& table_uuid,
                        TabletToTabletServerMap* pending_add_replica_tasks,
                        TabletToTabletServerMap* pending_remove_replica_tasks,
@@ -13,6 +13,8 @@
 
 #include "yb/master/cluster_balance_util.h"
 
+#include "yb/consensus/quorum_util.h"
+
 #include "yb/gutil/map-util.h"
 
 #include "yb/master/catalog_entity_info.h"
@@ -286,6 +288,18 @@ Status PerTableLoadState::UpdateTablet(TabletInfo *tablet) {
     tablets_wrong_placement_.insert(tablet_id);
   }
 
+  auto witness_placement_it = witness_placement_by_table_.find(tablet->table()->id());
+  if (witness_placement_it != witness_placement_by_table_.end()) {
+    int num_witnesses = 0;
+    for (auto it = witness_replicas_.lower_bound(std::make_pair(tablet_id, TabletServerId()));
+         it != witness_replicas_.end() && it->first == tablet_id; ++it) {
+      ++num_witnesses;
+    }
+    if (num_witnesses < witness_placement_it->second.num_replicas()) {
+      tablets_missing_witnesses_.insert(tablet_id);
+    }
+  }
+
   return Status::OK();
 }
 
@@ -406,7 +420,8 @@ Result<bool> PerTableLoadState::CanAddTabletToTabletServer(
     return false;
   }
   // We cannot add a tablet to a tablet server if it is already serving it.
-  if (ts_meta.running_tablets.count(tablet_id) || ts_meta.starting_tablets.count(tablet_id)) {
+  if (ts_meta.running_tablets.count(tablet_id) || ts_meta.starting_tablets.count(tablet_id) ||
+      witness_replicas_.count(std::make_pair(tablet_id, to_ts))) {
     return false;
   }
   // If we ask to use placement information, check against it.
@@ -712,6 +727,11 @@ std::shared_ptr<const TabletReplicaMap> PerTableLoadState::GetReplicaLocations(
   auto replica_map = tablet->GetReplicaLocations();
   for (const auto& it : *replica_map) {
     const TabletReplica& replica = it.second;
+    if (consensus::IsWitnessMemberType(replica.member_type)) {
+      // Witnesses are not moved by the load balancer, only re-created when missing.
+      witness_replicas_.emplace(tablet->tablet_id(), it.first);
+      continue;
+    }
     bool is_replica_live =  IsTsInLivePlacement(replica.ts_desc);
     if (is_replica_live && options_->type == LIVE) {
       replica_locations->emplace(it.first, replica);
@@ -381,6 +381,10 @@ class PerTableLoadState {
   // track of the placement block policies between cluster and table level.
   std::unordered_map<TableId, PlacementInfoPB> placement_by_table_;
 
+  // Map from table id to placement information for the witnesses of this table. Only tables that
+  // have witnesses configured are present.
+  std::unordered_map<TableId, PlacementInfoPB> witness_placement_by_table_;
+
   // Total number of running tablets in the clusters (including replicas).
   int total_running_ = 0;
 
@@ -396,6 +400,10 @@ class PerTableLoadState {
   // listed in the placement blocks).
   std::set<TabletId> tablets_missing_replicas_;
 
+  // Set of tablet ids that have fewer witnesses than configured, for instance because a failed
+  // witness was removed from the Raft config.
+  std::set<TabletId> tablets_missing_witnesses_;
+
   // Set of tablet ids that have been temporarily over-replicated. This is used to pick tablets
   // to potentially bring back down to their proper configured size, if there are more running than
   // expected.
@@ -419,6 +427,11 @@ class PerTableLoadState {
   // List of tablet ids that have been added to a new tablet server.
   std::set<TabletId> tablets_added_;
 
+  // Pairs of tablet id and tablet server id for the witness replicas. Witnesses are never moved or
+  // removed by the load balancer, only re-created when missing. We must not add a regular replica
+  // to a tablet server that hosts a witness of the tablet.
+  std::set<std::pair<TabletId, TabletServerId>> witness_replicas_;
+
   // Number of leaders per each tablet server to balance below.
   int leader_balance_threshold_ = 0;
 
@@ -46,6 +46,8 @@
 
 #include "yb/consensus/consensus_meta.h"
 
+#include "yb/docdb/deadlock_detector.h"
+
 #include "yb/gutil/bind.h"
 
 #include "yb/master/master_fwd.h"
@@ -142,6 +144,7 @@ Master::Master(const MasterOptions& opts)
     catalog_manager_(new enterprise::CatalogManager(this)),
     path_handlers_(new MasterPathHandlers(this)),
     flush_manager_(new FlushManager(this, catalog_manager())),
+    deadlock_detector_(new docdb::DeadlockDetector()),
     init_future_(init_status_.get_future()),
     opts_(opts),
     maintenance_manager_(new MaintenanceManager(MaintenanceManager::DEFAULT_OPTIONS)),
@@ -40,6 +40,8 @@
 #include "yb/consensus/consensus.fwd.h"
 #include "yb/consensus/metadata.fwd.h"
 
+#include "yb/docdb/docdb_fwd.h"
+
 #include "yb/gutil/thread_annotations.h"
 #include "yb/gutil/macros.h"
 
@@ -96,6 +98,10 @@ class Master : public tserver::DbServerBase {
 
   FlushManager* flush_manager() const { return flush_manager_.get(); }
 
+  // Detects deadlocks among transactions waiting in tablet wait queues, using waits reported
+  // by tablet servers in heartbeats.
+  docdb::DeadlockDetector& deadlock_detector() { return *deadlock_detector_; }
+
   PermissionsManager& permissions_manager();
 
   EncryptionManager& encryption_manager();
@@ -203,6 +209,7 @@ class Master : public tserver::DbServerBase {
   std::unique_ptr<enterprise::CatalogManager> catalog_manager_;
   std::unique_ptr<MasterPathHandlers> path_handlers_;
   std::unique_ptr<FlushManager> flush_manager_;
+  std::unique_ptr<docdb::DeadlockDetector> deadlock_detector_;
 
   // For initializing the catalog manager.
   std::unique_ptr<ThreadPool> init_pool_;
@@ -13,11 +13,14 @@
 
 #include "yb/common/common_flags.h"
 
+#include "yb/docdb/deadlock_detector.h"
+
 #include "yb/master/catalog_entity_info.pb.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master_heartbeat.service.h"
 #include "yb/master/master_service_base.h"
 #include "yb/master/master_service_base-internal.h"
+#include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
 
 #include "yb/util/flag_tags.h"
@@ -125,6 +128,8 @@ class MasterHeartbeatServiceImpl : public MasterServiceBase, public MasterHeartb
 
     ts_desc->UpdateHeartbeat(req);
 
+    ProcessTransactionWaits(*ts_desc, *req, resp);
+
     // Adjust the table report limit per heartbeat so this can be dynamically changed.
     if (ts_desc->HasCapability(CAPABILITY_TabletReportLimit)) {
       resp->set_tablet_report_limit(FLAGS_tablet_report_limit);
@@ -194,6 +199,38 @@ class MasterHeartbeatServiceImpl : public MasterServiceBase, public MasterHeartb
     rpc.RespondSuccess();
   }
 
+ private:
+  void ProcessTransactionWaits(
+      const TSDescriptor& ts_desc, const TSHeartbeatRequestPB& req, TSHeartbeatResponsePB* resp) {
+    std::vector<docdb::WaitingTransactionData> waits;
+    waits.reserve(req.transaction_waits().size());
+    for (const auto& wait_pb : req.transaction_waits()) {
+      auto id = FullyDecodeTransactionId(wait_pb.transaction_id());
+      if (!id.ok()) {
+        LOG(WARNING) << "Bad waiting transaction from " << ts_desc.permanent_uuid() << ": "
+                     << id.status();
+        continue;
+      }
+      docdb::WaitingTransactionData wait {
+        .id = *id,
+        .priority = wait_pb.priority(),
+        .blockers = {},
+      };
+      for (const auto& blocker_pb : wait_pb.blockers()) {
+        auto blocker = FullyDecodeTransactionId(blocker_pb);
+        if (blocker.ok()) {
+          wait.blockers.push_back(*blocker);
+        }
+      }
+      waits.push_back(std::move(wait));
+    }
+
+    auto victims = server_->deadlock_detector().ProcessWaits(
+        ts_desc.permanent_uuid(), std::move(waits), CoarseMonoClock::now());
+    for (const auto& id : victims) {
+      resp->add_deadlocked_transactions(id.data(), id.size());
+    }
+  }
 };
 
 } // namespace
@@ -531,7 +531,8 @@ void SysCatalogTable::SetupTabletPeer(const scoped_refptr<tablet::RaftGroupMetad
       Bind(&SysCatalogTable::SysCatalogStateChanged, Unretained(this), metadata->raft_group_id()),
       metric_registry_,
       nullptr /* tablet_splitter */,
-      master_->async_client_initializer().get_client_future());
+      master_->async_client_initializer().get_client_future(),
+      nullptr /* transaction_status_cache */);
 
   std::atomic_store(&tablet_peer_, tablet_peer);
 }
@@ -68,6 +68,21 @@ extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits);
 extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                                      bool strict_capacity_limit);
 
+// Decides whether a new entry is added to the single touch cache, when it is full.
+enum class CacheAdmissionPolicy {
+  // Every new entry is added, evicting the least recently used entries.
+  kAdmitAll,
+  // New entry is added only when it was accessed more frequently than the least recently used
+  // entry that would be evicted for it, as estimated by a count-min sketch of recent accesses.
+  // So one large scan does not wipe out frequently accessed entries. See "TinyLFU: A Highly
+  // Efficient Cache Admission Policy" by Einziger, Friedman and Manes.
+  kTinyLFU,
+};
+
+extern shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                                     bool strict_capacity_limit,
+                                     CacheAdmissionPolicy admission_policy);
+
 using QueryId = int64_t;
 // Query ids to represent values for the default query id.
 constexpr QueryId kDefaultQueryId = 0;
@@ -166,6 +166,14 @@ class CompactionFilterFactory {
   virtual std::unique_ptr<CompactionFilter> CreateCompactionFilter(
       const CompactionFilter::Context& context) = 0;
 
+  // Returns prefix of the user key, such that all keys with this prefix should be processed by the
+  // same compaction filter, because the filter keeps state across them. Subcompaction boundaries
+  // are truncated to this prefix. Empty result means that the key could not be used as a
+  // boundary. By default keys could be split at any point.
+  virtual Slice SubcompactionBoundaryPrefix(const Slice& user_key) const {
+    return user_key;
+  }
+
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
 };
@@ -591,7 +591,10 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, all files are in level 0 and compaction could already produce several
+    // non-overlapping output files there (see max_file_size_for_compaction), so subcompaction
+    // outputs could be placed there as well.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
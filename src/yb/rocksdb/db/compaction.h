@@ -299,6 +299,11 @@ class Compaction {
   yb::PriorityThreadPoolSuspender* suspender() { return suspender_; }
   void SetSuspender(yb::PriorityThreadPoolSuspender* value) { suspender_ = value; }
 
+  // Priority of the thread pool task running this compaction, subcompactions are submitted to the
+  // thread pool with the same priority.
+  int priority() const { return priority_; }
+  void SetPriority(int value) { priority_ = value; }
+
  private:
   Compaction(VersionStorageInfo* input_version,
              const MutableCFOptions& mutable_cf_options,
@@ -388,6 +393,7 @@ class Compaction {
   CompactionReason compaction_reason_;
 
   yb::PriorityThreadPoolSuspender* suspender_ = nullptr;
+  int priority_ = 0;
 };
 
 // Utility function
@@ -32,9 +32,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
 #include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <thread>
@@ -51,6 +53,7 @@
 #include "yb/rocksdb/db/memtable.h"
 #include "yb/rocksdb/db/memtable_list.h"
 #include "yb/rocksdb/db/merge_helper.h"
+#include "yb/rocksdb/db/table_cache.h"
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/port/likely.h"
 #include "yb/rocksdb/port/port.h"
@@ -61,6 +64,7 @@
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table/internal_iterator.h"
 #include "yb/rocksdb/table/table_builder.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
@@ -72,6 +76,8 @@
 #include "yb/util/stats/perf_step_timer.h"
 #include "yb/rocksdb/util/sync_point.h"
 
+#include "yb/util/format.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/result.h"
 #include "yb/util/stats/iostats_context_imp.h"
 #include "yb/util/string_util.h"
@@ -123,6 +129,12 @@ struct CompactionJob::SubcompactionState {
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
 
+  // Suspender of the thread pool task running this subcompaction, if any.
+  yb::PriorityThreadPoolSuspender* suspender = nullptr;
+
+  // Largest user frontier returned by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
+
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
       : compaction(c),
@@ -154,6 +166,8 @@ struct CompactionJob::SubcompactionState {
     num_output_records = std::move(o.num_output_records);
     compaction_job_stats = std::move(o.compaction_job_stats);
     approx_size = std::move(o.approx_size);
+    suspender = o.suspender;
+    largest_user_frontier = std::move(o.largest_user_frontier);
     return *this;
   }
 
@@ -314,6 +328,9 @@ void CompactionJob::Prepare() {
   }
 }
 
+// Number of keys sampled from each input file per subcompaction to choose subcompaction boundaries.
+constexpr size_t kSampledKeysPerSubcompaction = 4;
+
 struct RangeWithSize {
   Range range;
   uint64_t size;
@@ -353,6 +370,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
         for (size_t i = 0; i < num_files; i++) {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
+          // Level 0 files usually cover almost the same key range with a single level universal
+          // compaction, so their boundaries alone do not allow to split the range.
+          AddSampledBoundaries(flevel->files[i], &bounds);
         }
       } else {
         // For all other levels add the smallest/largest key in the level to
@@ -414,6 +434,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
   double mean = subcompactions != 0 ? sum * 1.0 / subcompactions
                                     : std::numeric_limits<double>::max();
 
+  // Compaction filter could keep state across keys with the same prefix, so such keys should be
+  // processed by the same subcompaction.
+  CompactionFilterFactory* filter_factory = nullptr;
+  if (cfd->ioptions()->compaction_filter == nullptr) {
+    filter_factory = cfd->ioptions()->compaction_filter_factory;
+  }
+
   if (subcompactions > 1) {
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
@@ -426,7 +453,16 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory != nullptr) {
+          boundary = filter_factory->SubcompactionBoundaryPrefix(boundary);
+        }
+        if (boundary.empty() ||
+            (!boundaries_.empty() && cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+          // Could not split here, add the range to the current subcompaction.
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -439,6 +475,35 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::AddSampledBoundaries(
+    const FdWithBoundaries& file, std::vector<Slice>* bounds) {
+  auto* cfd = compact_->compaction->column_family_data();
+  const size_t max_keys = db_options_.max_subcompactions * kSampledKeysPerSubcompaction;
+  auto trwh = cfd->table_cache()->GetTableReader(
+      env_options_, cfd->internal_comparator(), file.fd, kDefaultQueryId, /* no_io = */ false,
+      /* file_read_hist = */ nullptr, /* skip_filters = */ true);
+  if (!trwh.ok()) {
+    LOG(WARNING) << "Failed to open file " << file.fd.GetNumber()
+                 << " to sample subcompaction boundaries: " << trwh.status();
+    return;
+  }
+  auto keys = trwh->table_reader->GetSampleKeys(max_keys);
+  if (!keys.ok()) {
+    LOG_IF(WARNING, !keys.status().IsNotSupported())
+        << "Failed to sample subcompaction boundaries from file " << file.fd.GetNumber() << ": "
+        << keys.status();
+    return;
+  }
+  for (auto& key : *keys) {
+    // Keys from the index are internal keys.
+    if (key.size() < kLastInternalComponentSize) {
+      continue;
+    }
+    sampled_keys_.push_back(std::move(key));
+    bounds->emplace_back(sampled_keys_.back());
+  }
+}
+
 Result<FileNumbersHolder> CompactionJob::Run() {
   TEST_SYNC_POINT("CompactionJob::Run():Start");
   log_buffer_->FlushBufferToLog();
@@ -448,23 +513,34 @@ Result<FileNumbersHolder> CompactionJob::Run() {
   assert(num_threads > 0);
   const uint64_t start_micros = env_->NowMicros();
 
-  // Launch a thread for each of subcompactions 1...num_threads-1
-  std::vector<std::thread> thread_pool;
-  thread_pool.reserve(num_threads - 1);
   FileNumbersHolder file_numbers_holder(file_numbers_provider_->CreateHolder());
   file_numbers_holder.Reserve(num_threads);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this, &file_numbers_holder,
-                             &compact_->sub_compact_states[i]);
-  }
+  auto* priority_thread_pool = db_options_.priority_thread_pool_for_compactions_and_flushes;
+  if (num_threads > 1 && priority_thread_pool != nullptr) {
+    RunSubcompactionsInThreadPool(priority_thread_pool, &file_numbers_holder);
+  } else {
+    // Launch a thread for each of subcompactions 1...num_threads-1
+    std::vector<std::thread> thread_pool;
+    thread_pool.reserve(num_threads - 1);
+    for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
+      thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
+                               &file_numbers_holder, &compact_->sub_compact_states[i]);
+    }
 
-  // Always schedule the first subcompaction (whether or not there are also
-  // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(&file_numbers_holder, &compact_->sub_compact_states[0]);
+    // Always schedule the first subcompaction (whether or not there are also
+    // others) in the current thread to be efficient with resources
+    compact_->sub_compact_states[0].suspender = compact_->compaction->suspender();
+    ProcessKeyValueCompaction(&file_numbers_holder, &compact_->sub_compact_states[0]);
+
+    // Wait for all other threads (if there are any) to finish execution
+    for (auto& thread : thread_pool) {
+      thread.join();
+    }
+  }
 
-  // Wait for all other threads (if there are any) to finish execution
-  for (auto& thread : thread_pool) {
-    thread.join();
+  for (const auto& state : compact_->sub_compact_states) {
+    UserFrontier::Update(
+        state.largest_user_frontier.get(), UpdateUserValueType::kLargest, &largest_user_frontier_);
   }
 
   if (output_directory_ && !db_options_.disableDataSync) {
@@ -576,6 +652,113 @@ Status CompactionJob::Install(const MutableCFOptions& mutable_cf_options) {
   return status;
 }
 
+namespace {
+
+// Tracks subcompactions that were taken for execution. Subcompactions are submitted to the priority
+// thread pool, but the compaction thread also runs the ones that were not started by the pool yet,
+// so the compaction does not wait for free threads when the pool is busy.
+class SubcompactionScheduler {
+ public:
+  explicit SubcompactionScheduler(size_t num_subcompactions) : taken_(num_subcompactions) {}
+
+  // Returns true if the caller should run subcompaction with the specified index, and then call
+  // Finished.
+  bool Take(size_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (taken_[index]) {
+      return false;
+    }
+    taken_[index] = true;
+    ++running_;
+    return true;
+  }
+
+  void Finished() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--running_ == 0) {
+      cond_.notify_all();
+    }
+  }
+
+  void WaitRunning() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return running_ == 0; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::vector<bool> taken_;
+  size_t running_ = 0;
+};
+
+class SubcompactionTask : public yb::PriorityThreadPoolTask {
+ public:
+  typedef std::function<void(yb::PriorityThreadPoolSuspender*)> Runner;
+
+  SubcompactionTask(
+      std::shared_ptr<SubcompactionScheduler> scheduler, size_t index, int job_id, Runner runner)
+      : scheduler_(std::move(scheduler)), index_(index), job_id_(job_id),
+        runner_(std::move(runner)) {}
+
+  void Run(const Status& status, yb::PriorityThreadPoolSuspender* suspender) override {
+    // Cancelled subcompaction is run by the compaction thread. The task could also be started after
+    // the compaction is complete, so runner_ should not be used unless the subcompaction is taken.
+    if (!status.ok() || !scheduler_->Take(index_)) {
+      return;
+    }
+    runner_(suspender);
+    scheduler_->Finished();
+  }
+
+  bool ShouldRemoveWithKey(void* key) override {
+    return false;
+  }
+
+  std::string ToString() const override {
+    return yb::Format("{ subcompaction: $0 job_id: $1 serial_no: $2 }",
+                      index_, job_id_, SerialNo());
+  }
+
+ private:
+  std::shared_ptr<SubcompactionScheduler> scheduler_;
+  const size_t index_;
+  const int job_id_;
+  Runner runner_;
+};
+
+} // namespace
+
+void CompactionJob::RunSubcompactionsInThreadPool(
+    yb::PriorityThreadPool* thread_pool, FileNumbersHolder* holder) {
+  auto& states = compact_->sub_compact_states;
+  auto scheduler = std::make_shared<SubcompactionScheduler>(states.size());
+  for (size_t i = 1; i < states.size(); i++) {
+    auto* state = &states[i];
+    std::unique_ptr<yb::PriorityThreadPoolTask> task = std::make_unique<SubcompactionTask>(
+        scheduler, i, job_id_, [this, holder, state](yb::PriorityThreadPoolSuspender* suspender) {
+          state->suspender = suspender;
+          ProcessKeyValueCompaction(holder, state);
+        });
+    auto status = thread_pool->Submit(compact_->compaction->priority(), &task);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to submit subcompaction " << i << " of job " << job_id_ << ": "
+                   << status;
+    }
+  }
+
+  // Run the first subcompaction, and the ones that were not started by the thread pool yet, in the
+  // current thread.
+  for (size_t i = 0; i < states.size(); i++) {
+    if (scheduler->Take(i)) {
+      states[i].suspender = compact_->compaction->suspender();
+      ProcessKeyValueCompaction(holder, &states[i]);
+      scheduler->Finished();
+    }
+  }
+  scheduler->WaitRunning();
+}
+
 void CompactionJob::ProcessKeyValueCompaction(
     FileNumbersHolder* holder, SubcompactionState* sub_compact) {
   assert(sub_compact != nullptr);
@@ -610,7 +793,7 @@ void CompactionJob::ProcessKeyValueCompaction(
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
     // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -996,7 +1179,7 @@ Status CompactionJob::OpenCompactionOutputFile(
         (*writable_file)->SetPreallocationBlockSize(preallocation_block_size);
       }
       writer->reset(new WritableFileWriter(
-          std::move(*writable_file), env_options_, sub_compact->compaction->suspender()));
+          std::move(*writable_file), env_options_, sub_compact->suspender));
     };
 
     const bool is_split_sst = cfd->ioptions()->table_factory->IsSplitSstForWriteSupported();
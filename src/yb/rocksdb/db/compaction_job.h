@@ -56,10 +56,17 @@
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/thread_local.h"
 
+namespace yb {
+
+class PriorityThreadPool;
+
+} // namespace yb
+
 namespace rocksdb {
 
 using yb::Result;
 
+struct FdWithBoundaries;
 class MemTable;
 class TableCache;
 class Version;
@@ -106,6 +113,13 @@ class CompactionJob {
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
 
+  // Adds keys sampled from the index of the input file as potential subcompaction boundaries.
+  void AddSampledBoundaries(const FdWithBoundaries& file, std::vector<Slice>* bounds);
+
+  // Runs subcompactions in the priority thread pool with the priority of the compaction.
+  void RunSubcompactionsInThreadPool(
+      yb::PriorityThreadPool* thread_pool, FileNumbersHolder* holder);
+
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
   void AllocateCompactionOutputFileNumbers();
@@ -178,6 +192,8 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
+  // Keys sampled from the input files, that are referenced by potential subcompaction boundaries.
+  std::deque<std::string> sampled_keys_;
   // Stores the approx size of keys covered in the range of each subcompaction
   std::vector<uint64_t> sizes_;
 
@@ -256,6 +256,7 @@ class DBImpl::CompactionTask : public ThreadPoolTask {
 
   void DoRun(yb::PriorityThreadPoolSuspender* suspender) override {
     compaction_->SetSuspender(suspender);
+    compaction_->SetPriority(priority_);
     db_impl_->BackgroundCallCompaction(manual_compaction_, std::move(compaction_holder_), this);
   }
 
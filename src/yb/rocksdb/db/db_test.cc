@@ -43,6 +43,7 @@
 #include "yb/rocksdb/db/version_set.h"
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/experimental.h"
+#include "yb/rocksdb/memtable/prefix_hash_skiplist_rep.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/perf_context.h"
 #include "yb/rocksdb/perf_level.h"
@@ -5367,6 +5368,187 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+// Writers of the same write group insert their batches concurrently, check that sequence numbers
+// and frontiers of all batches are applied.
+TEST_F(DBTest, ConcurrentMemtableWritesWithFrontiers) {
+  constexpr int kNumThreads = 8;
+  constexpr int kBatchesPerThread = 200;
+  constexpr int kKeysPerBatch = 3;
+
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.allow_concurrent_memtable_write = true;
+  options.enable_write_thread_adaptive_yield = true;
+  options.memtable_factory = std::make_shared<SkipListFactory>();
+  options.boundary_extractor = test::MakeBoundaryValuesExtractor();
+  DestroyAndReopen(options);
+
+  const auto initial_sequence = db_->GetLatestSequenceNumber();
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i != kBatchesPerThread; ++i) {
+        const int batch_idx = t * kBatchesPerThread + i;
+        test::TestUserFrontiers frontiers(batch_idx + 1, batch_idx + 1);
+        WriteBatch batch;
+        batch.SetFrontiers(&frontiers);
+        for (int k = 0; k != kKeysPerBatch; ++k) {
+          batch.Put(yb::Format("$0_$1", Key(batch_idx), k), Key(batch_idx));
+        }
+        WriteOptions write_options;
+        write_options.disableWAL = true;
+        ASSERT_OK(db_->Write(write_options, &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  constexpr int kNumBatches = kNumThreads * kBatchesPerThread;
+  ASSERT_EQ(initial_sequence + kNumBatches * kKeysPerBatch, db_->GetLatestSequenceNumber());
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  ASSERT_EQ(kNumBatches,
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+  for (int batch_idx = 0; batch_idx != kNumBatches; ++batch_idx) {
+    for (int k = 0; k != kKeysPerBatch; ++k) {
+      ASSERT_EQ(Key(batch_idx), Get(yb::Format("$0_$1", Key(batch_idx), k)));
+    }
+  }
+}
+
+TEST_F(DBTest, PrefixHashSkipListMemTable) {
+  constexpr int kNumPrefixes = 10;
+  constexpr int kKeysPerPrefix = 10;
+
+  Options options = CurrentOptions();
+  // Use a few buckets, so different prefixes share the same bucket.
+  options.memtable_factory = std::make_shared<PrefixHashSkipListRepFactory>(
+      std::shared_ptr<const SliceTransform>(NewFixedPrefixTransform(3)), 4);
+  DestroyAndReopen(options);
+
+  auto key = [](int prefix, int idx) {
+    return std::string(3, static_cast<char>('a' + prefix)) + std::to_string(idx);
+  };
+  for (int idx = 0; idx != kKeysPerPrefix; ++idx) {
+    for (int prefix = kNumPrefixes; prefix-- > 0;) {
+      ASSERT_OK(Put(key(prefix, idx), yb::ToString(prefix * kKeysPerPrefix + idx)));
+    }
+  }
+  for (int prefix = 0; prefix != kNumPrefixes; ++prefix) {
+    for (int idx = 0; idx != kKeysPerPrefix; ++idx) {
+      ASSERT_EQ(yb::ToString(prefix * kKeysPerPrefix + idx), Get(key(prefix, idx)));
+    }
+  }
+  ASSERT_EQ("NOT_FOUND", Get("ccc"));
+
+  // Total order iteration returns all keys in order.
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ASSERT_EQ(key(count / kKeysPerPrefix, count % kKeysPerPrefix), iter->key().ToBuffer());
+      ++count;
+    }
+    ASSERT_EQ(kNumPrefixes * kKeysPerPrefix, count);
+    iter->Seek(key(3, 5));
+    ASSERT_TRUE(iter->Valid());
+    iter->Prev();
+    ASSERT_EQ(key(3, 4), iter->key().ToBuffer());
+  }
+
+  // Prefix seek iterates the bucket of the seek target, so all keys with the same prefix are
+  // returned in order.
+  {
+    ReadOptions read_options;
+    read_options.memtable_prefix_seek = true;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->Seek(key(2, 5));
+    for (int idx = 5; idx != kKeysPerPrefix; ++idx) {
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(key(2, idx), iter->key().ToBuffer());
+      iter->Next();
+    }
+    iter->Seek(key(2, 5));
+    iter->Prev();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(2, 4), iter->key().ToBuffer());
+    iter->SeekToLast();
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(kNumPrefixes - 1, kKeysPerPrefix - 1), iter->key().ToBuffer());
+  }
+
+  // Single delete erases the entry from both the ordered list and its bucket.
+  ASSERT_OK(SingleDelete(key(4, 0)));
+  ASSERT_EQ("NOT_FOUND", Get(key(4, 0)));
+  {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    iter->Seek(key(4, 0));
+    ASSERT_TRUE(iter->Valid());
+    ASSERT_EQ(key(4, 1), iter->key().ToBuffer());
+  }
+
+  ASSERT_OK(Flush());
+  for (int prefix = 0; prefix != kNumPrefixes; ++prefix) {
+    for (int idx = prefix == 4 ? 1 : 0; idx != kKeysPerPrefix; ++idx) {
+      ASSERT_EQ(yb::ToString(prefix * kKeysPerPrefix + idx), Get(key(prefix, idx)));
+    }
+  }
+}
+
+namespace {
+
+// Mimics DocDB hashed prefix extractor: keys starting with '!' (like table-level intents) have
+// empty prefix, other keys use first 3 bytes as prefix.
+class EmptyPrefixForGroupEndTransform : public SliceTransform {
+ public:
+  const char* Name() const override { return "EmptyPrefixForGroupEndTransform"; }
+
+  Slice Transform(const Slice& src) const override {
+    return Slice(src.data(), src.starts_with('!') ? 0 : std::min<size_t>(src.size(), 3));
+  }
+
+  bool InDomain(const Slice& src) const override { return true; }
+
+  bool InRange(const Slice& dst) const override { return true; }
+};
+
+} // namespace
+
+TEST_F(DBTest, PrefixHashSkipListMemTableEmptyPrefixSeek) {
+  Options options = CurrentOptions();
+  options.memtable_factory = std::make_shared<PrefixHashSkipListRepFactory>(
+      std::make_shared<EmptyPrefixForGroupEndTransform>(), 4);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("aaa1", "1"));
+  ASSERT_OK(Put("bbb1", "2"));
+
+  // Seek target with empty prefix could be followed by keys with any prefix, so prefix seek
+  // should not be limited to the bucket of empty prefix.
+  ReadOptions read_options;
+  read_options.memtable_prefix_seek = true;
+  std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+  iter->Seek("!");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("aaa1", iter->key().ToBuffer());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("bbb1", iter->key().ToBuffer());
+  iter->Next();
+  ASSERT_FALSE(iter->Valid());
+
+  ASSERT_OK(Put("!", "0"));
+  iter.reset(db_->NewIterator(read_options));
+  iter->Seek("!");
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("!", iter->key().ToBuffer());
+  iter->Next();
+  ASSERT_TRUE(iter->Valid());
+  ASSERT_EQ("aaa1", iter->key().ToBuffer());
+}
+
 TEST_F(DBTest, SanitizeNumThreads) {
   for (int attempt = 0; attempt < 2; attempt++) {
     const size_t kTotalTasks = 8;
@@ -28,6 +28,12 @@
 #include "yb/rocksdb/util/file_util.h"
 #include "yb/rocksdb/util/sync_point.h"
 
+#include "yb/util/format.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
 namespace rocksdb {
 
 static std::string CompressibleString(Random* rnd, int len) {
@@ -1464,6 +1470,112 @@ TEST_F(DBTestUniversalCompaction, IncludeFilesSmallerThanThreshold) {
   GenerateFilesAndCheckCompactionResult(options, file_sizes, value_size, 1);
 }
 
+namespace {
+
+// Records prefixes of keys processed by each compaction filter, prefix is the part of the key
+// before '/'.
+class PrefixTrackingFilterFactory : public CompactionFilterFactory {
+ public:
+  class PrefixTrackingFilter : public CompactionFilter {
+   public:
+    explicit PrefixTrackingFilter(PrefixTrackingFilterFactory* factory) : factory_(factory) {}
+
+    FilterDecision Filter(int level, const Slice& key, const Slice& value, std::string* new_value,
+                          bool* value_changed) override {
+      prefixes_.insert(factory_->SubcompactionBoundaryPrefix(key).ToBuffer());
+      return FilterDecision::kKeep;
+    }
+
+    void CompactionFinished() override {
+      std::lock_guard<std::mutex> lock(factory_->mutex_);
+      factory_->prefixes_per_filter_.push_back(std::move(prefixes_));
+    }
+
+    const char* Name() const override { return "PrefixTrackingFilter"; }
+
+   private:
+    PrefixTrackingFilterFactory* factory_;
+    std::set<std::string> prefixes_;
+  };
+
+  std::unique_ptr<CompactionFilter> CreateCompactionFilter(
+      const CompactionFilter::Context& context) override {
+    return std::make_unique<PrefixTrackingFilter>(this);
+  }
+
+  Slice SubcompactionBoundaryPrefix(const Slice& user_key) const override {
+    const auto* end = static_cast<const uint8_t*>(
+        memchr(user_key.data(), '/', user_key.size()));
+    return end ? Slice(user_key.data(), end) : Slice();
+  }
+
+  const char* Name() const override { return "PrefixTrackingFilterFactory"; }
+
+  std::vector<std::set<std::string>> prefixes_per_filter() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return prefixes_per_filter_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::set<std::string>> prefixes_per_filter_;
+};
+
+} // namespace
+
+// Checks that single level universal compaction is split into subcompactions, and keys with the
+// same prefix, as reported by compaction filter factory, are processed by the same subcompaction.
+TEST_F(DBTestUniversalCompaction, SingleLevelSubcompactions) {
+  constexpr int kNumFiles = 4;
+  constexpr int kNumPrefixes = 1000;
+  constexpr int kMaxSubcompactions = 4;
+
+  for (bool use_priority_thread_pool : {false, true}) {
+    yb::PriorityThreadPool thread_pool(kMaxSubcompactions);
+    auto filter_factory = std::make_shared<PrefixTrackingFilterFactory>();
+    Options options;
+    options.compaction_style = kCompactionStyleUniversal;
+    options.num_levels = 1;
+    options.write_buffer_size = 10_MB;
+    options.disable_auto_compactions = true;
+    options.target_file_size_base = 64_KB;
+    options.max_subcompactions = kMaxSubcompactions;
+    options.compaction_filter_factory = filter_factory;
+    if (use_priority_thread_pool) {
+      options.priority_thread_pool_for_compactions_and_flushes = &thread_pool;
+    }
+    options = CurrentOptions(options);
+    DestroyAndReopen(options);
+
+    Random rnd(301);
+    for (int file = 0; file != kNumFiles; ++file) {
+      for (int prefix = 0; prefix != kNumPrefixes; ++prefix) {
+        ASSERT_OK(Put(yb::Format("$0/$1", Key(prefix), file), RandomString(&rnd, 100)));
+      }
+      ASSERT_OK(Flush());
+    }
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+    const auto prefixes_per_filter = filter_factory->prefixes_per_filter();
+    ASSERT_GT(prefixes_per_filter.size(), 1);
+    ASSERT_LE(prefixes_per_filter.size(), kMaxSubcompactions);
+    std::set<std::string> all_prefixes;
+    for (const auto& prefixes : prefixes_per_filter) {
+      for (const auto& prefix : prefixes) {
+        ASSERT_TRUE(all_prefixes.insert(prefix).second) << "Prefix split: " << prefix;
+      }
+    }
+    ASSERT_EQ(kNumPrefixes, all_prefixes.size());
+
+    for (int prefix = 0; prefix != kNumPrefixes; ++prefix) {
+      for (int file = 0; file != kNumFiles; ++file) {
+        ASSERT_NE("NOT_FOUND", Get(yb::Format("$0/$1", Key(prefix), file)));
+      }
+    }
+    Close();
+  }
+}
+
 }  // namespace rocksdb
 
 #endif  // !defined(ROCKSDB_LITE)
@@ -49,9 +49,10 @@ int main() {
 #include "yb/rocksdb/port/stack_trace.h"
 #include "yb/rocksdb/comparator.h"
 #include "yb/rocksdb/memtablerep.h"
+#include "yb/rocksdb/memtable/prefix_hash_skiplist_rep.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/slice_transform.h"
-#include "yb/rocksdb/util/arena.h"
+#include "yb/rocksdb/util/concurrent_arena.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/testutil.h"
@@ -64,6 +65,8 @@ DEFINE_string(benchmarks, "fillrandom",
               "Comma-separated list of benchmarks to run. Options:\n"
               "\tfillrandom             -- write N random values\n"
               "\tfillseq                -- write N values in sequential order\n"
+              "\tfillrandomparallel     -- N threads concurrently write random\n"
+              "\t                          values, using concurrent inserts\n"
               "\treadrandom             -- read N values in random order\n"
               "\treadseq                -- scan the DB\n"
               "\treadwrite              -- 1 thread writes while N - 1 threads "
@@ -79,7 +82,9 @@ DEFINE_string(memtablerep, "skiplist",
               "\tskiplist            -- backed by a skiplist\n"
               "\tvector              -- backed by an std::vector\n"
               "\thashskiplist        -- backed by a hash skip list\n"
-              "\thashlinklist        -- backed by a hash linked list\n");
+              "\thashlinklist        -- backed by a hash linked list\n"
+              "\tprefixhashskiplist  -- backed by an ordered skiplist with a hash\n"
+              "\t                       index of skiplists by key prefix\n");
 
 DEFINE_int64(bucket_count, 1000000,
              "bucket_count parameter to pass into NewHashSkiplistRepFactory or "
@@ -249,6 +254,18 @@ class FillBenchmarkThread : public BenchmarkThread {
                         num_ops, read_hits) {}
 
   void FillOne() {
+    auto key = key_gen_->Next();
+    Insert(key, ++(*sequence_), /* concurrently= */ false);
+  }
+
+  void operator()() override {
+    for (unsigned int i = 0; i < num_ops_; ++i) {
+      FillOne();
+    }
+  }
+
+ protected:
+  void Insert(uint64_t key, uint64_t sequence, bool concurrently) {
     char* buf = nullptr;
     auto internal_key_size = 16;
     auto encoded_len =
@@ -256,24 +273,44 @@ class FillBenchmarkThread : public BenchmarkThread {
     KeyHandle handle = table_->Allocate(encoded_len, &buf);
     assert(buf != nullptr);
     char* p = EncodeVarint32(buf, internal_key_size);
-    auto key = key_gen_->Next();
     EncodeFixed64(p, key);
     p += 8;
-    EncodeFixed64(p, ++(*sequence_));
+    EncodeFixed64(p, sequence);
     p += 8;
     Slice bytes = generator_.Generate(FLAGS_item_size);
     memcpy(p, bytes.data(), FLAGS_item_size);
     p += FLAGS_item_size;
     assert(p == buf + encoded_len);
-    table_->Insert(handle);
+    if (concurrently) {
+      table_->InsertConcurrently(handle);
+    } else {
+      table_->Insert(handle);
+    }
     *bytes_written_ += encoded_len;
   }
+};
+
+// Inserts keys concurrently with other writer threads, as done by parallel memtable writes.
+// Each thread writes its own subset of keys, so keys never collide.
+class ParallelFillBenchmarkThread : public FillBenchmarkThread {
+ public:
+  ParallelFillBenchmarkThread(MemTableRep* table, KeyGenerator* key_gen,
+                              uint64_t* bytes_written, uint64_t num_ops,
+                              uint32_t thread_idx, uint32_t num_threads)
+      : FillBenchmarkThread(table, key_gen, bytes_written, nullptr, nullptr,
+                            num_ops, nullptr),
+        thread_idx_(thread_idx), num_threads_(num_threads) {}
 
   void operator()() override {
-    for (unsigned int i = 0; i < num_ops_; ++i) {
-      FillOne();
+    for (uint64_t i = 0; i < num_ops_; ++i) {
+      auto key = key_gen_->Next() * num_threads_ + thread_idx_;
+      Insert(key, i + 1, /* concurrently= */ true);
     }
   }
+
+ private:
+  const uint32_t thread_idx_;
+  const uint32_t num_threads_;
 };
 
 class ConcurrentFillBenchmarkThread : public FillBenchmarkThread {
@@ -489,6 +526,38 @@ class FillBenchmark : public Benchmark {
   }
 };
 
+class ParallelFillBenchmark : public Benchmark {
+ public:
+  explicit ParallelFillBenchmark(MemTableRep* table)
+      : Benchmark(table, nullptr, nullptr, FLAGS_num_threads) {
+    num_write_ops_per_thread_ = FLAGS_num_operations / FLAGS_num_threads;
+  }
+
+  void RunThreads(std::vector<std::thread>* threads, uint64_t* bytes_written,
+                  uint64_t* bytes_read, bool write,
+                  uint64_t* read_hits) override {
+    std::vector<std::unique_ptr<Random64>> rngs;
+    std::vector<std::unique_ptr<KeyGenerator>> key_gens;
+    std::vector<uint64_t> thread_bytes_written(num_threads_);
+    for (uint32_t i = 0; i < num_threads_; ++i) {
+      rngs.push_back(std::make_unique<Random64>(FLAGS_seed + i));
+      key_gens.push_back(std::make_unique<KeyGenerator>(
+          rngs.back().get(), UNIQUE_RANDOM, num_write_ops_per_thread_));
+    }
+    for (uint32_t i = 0; i < num_threads_; ++i) {
+      threads->emplace_back(ParallelFillBenchmarkThread(
+          table_, key_gens[i].get(), &thread_bytes_written[i],
+          num_write_ops_per_thread_, i, num_threads_));
+    }
+    for (auto& thread : *threads) {
+      thread.join();
+    }
+    for (auto thread_bytes : thread_bytes_written) {
+      *bytes_written += thread_bytes;
+    }
+  }
+};
+
 class ReadBenchmark : public Benchmark {
  public:
   explicit ReadBenchmark(MemTableRep* table, KeyGenerator* key_gen,
@@ -608,6 +677,11 @@ int main(int argc, char** argv) {
         FLAGS_if_log_bucket_dist_when_flash, FLAGS_threshold_use_skiplist));
     options.prefix_extractor.reset(
         rocksdb::NewFixedPrefixTransform(FLAGS_prefix_length));
+  } else if (FLAGS_memtablerep == "prefixhashskiplist") {
+    factory.reset(new rocksdb::PrefixHashSkipListRepFactory(
+        std::shared_ptr<const rocksdb::SliceTransform>(
+            rocksdb::NewFixedPrefixTransform(FLAGS_prefix_length)),
+        FLAGS_bucket_count));
   } else {
     fprintf(stdout, "Unknown memtablerep: %s\n", FLAGS_memtablerep.c_str());
     exit(1);
@@ -616,7 +690,7 @@ int main(int argc, char** argv) {
   rocksdb::InternalKeyComparator internal_key_comp(
       rocksdb::BytewiseComparator());
   rocksdb::MemTable::KeyComparator key_comp(internal_key_comp);
-  rocksdb::Arena arena;
+  rocksdb::ConcurrentArena arena;
   rocksdb::WriteBuffer wb(FLAGS_write_buffer_size);
   rocksdb::MemTableAllocator memtable_allocator(&arena, &wb);
   uint64_t sequence;
@@ -653,6 +727,13 @@ int main(int argc, char** argv) {
                                               FLAGS_num_operations));
       benchmark.reset(new rocksdb::FillBenchmark(memtablerep.get(),
                                                  key_gen.get(), &sequence));
+    } else if (name == rocksdb::Slice("fillrandomparallel")) {
+      if (!factory->IsInsertConcurrentlySupported()) {
+        fprintf(stdout, "%s does not support concurrent inserts\n", FLAGS_memtablerep.c_str());
+        exit(1);
+      }
+      memtablerep.reset(createMemtableRep());
+      benchmark.reset(new rocksdb::ParallelFillBenchmark(memtablerep.get()));
     } else if (name == rocksdb::Slice("readrandom")) {
       key_gen.reset(new rocksdb::KeyGenerator(&rng, rocksdb::RANDOM,
                                               FLAGS_num_operations));
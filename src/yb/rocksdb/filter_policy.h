@@ -215,6 +215,15 @@ extern const FilterPolicy* NewBloomFilterPolicy(int bits_per_key,
 extern const FilterPolicy* NewFixedSizeFilterPolicy(size_t total_bits,
                                                     double error_rate,
                                                     Logger* logger);
+
+// Return a new filter policy that uses xor filters with 8-bit fingerprints divided into fixed-size
+// blocks. The false positive rate is about 0.4% and each filter block stores as many keys as fit
+// into total_bits at about 9.84 bits per key, while a bloom filter needs about 11.5 bits per key
+// for the same false positive rate.
+//
+// Callers must delete the result after any database that is using the filter policy has been
+// closed.
+extern const FilterPolicy* NewFixedSizeXorFilterPolicy(size_t total_bits);
 }  // namespace rocksdb
 
 #endif  // YB_ROCKSDB_FILTER_POLICY_H
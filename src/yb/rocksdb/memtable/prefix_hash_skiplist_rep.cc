@@ -0,0 +1,229 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/memtable/prefix_hash_skiplist_rep.h"
+
+#include <atomic>
+
+#include "yb/rocksdb/db/memtable.h"
+#include "yb/rocksdb/db/skiplist.h"
+#include "yb/rocksdb/util/murmurhash.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Memtable rep that keeps all entries in an ordered skip list, and also indexes them by prefix in
+// a fixed array of buckets, each pointing to a skip list of entries, whose prefixes are hashed to
+// this bucket. Both lists contain pointers to the same entries.
+//
+// Lookups and prefix iterators use the bucket of the key prefix, that is much smaller than the
+// whole memtable. Total order iterators use the ordered list, so range scans don't need to merge
+// buckets.
+//
+// Requires external synchronization for writes, reads could be done concurrently with a write.
+class PrefixHashSkipListRep : public MemTableRep {
+ public:
+  PrefixHashSkipListRep(
+      const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+      const SliceTransform* transform, size_t bucket_count)
+      : MemTableRep(allocator),
+        bucket_count_(bucket_count),
+        transform_(transform),
+        compare_(compare),
+        allocator_(allocator),
+        ordered_list_(compare, allocator) {
+    auto mem = allocator->AllocateAligned(sizeof(std::atomic<void*>) * bucket_count);
+    buckets_ = new (mem) std::atomic<Bucket*>[bucket_count];
+    for (size_t i = 0; i < bucket_count_; ++i) {
+      buckets_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  void Insert(KeyHandle handle) override {
+    auto* key = static_cast<char*>(handle);
+    ordered_list_.Insert(key);
+    GetInitializedBucket(Prefix(UserKey(key)))->Insert(key);
+  }
+
+  bool Erase(KeyHandle handle, const KeyComparator& comparator) override {
+    auto* key = static_cast<char*>(handle);
+    if (!ordered_list_.Erase(key, comparator)) {
+      return false;
+    }
+    auto* bucket = GetBucket(Prefix(UserKey(key)));
+    LOG_IF(DFATAL, bucket == nullptr || !bucket->Erase(key, comparator))
+        << "Entry erased from the ordered list is missing in its bucket";
+    return true;
+  }
+
+  bool Contains(const char* key) const override {
+    auto* bucket = GetBucket(Prefix(UserKey(key)));
+    return bucket != nullptr && bucket->Contains(key);
+  }
+
+  size_t ApproximateMemoryUsage() override {
+    // All memory is allocated through allocator; nothing to report here
+    return 0;
+  }
+
+  void Get(const LookupKey& k, void* callback_args,
+           bool (*callback_func)(void* arg, const char* entry)) override {
+    auto* bucket = GetBucket(Prefix(k.user_key()));
+    if (bucket == nullptr) {
+      return;
+    }
+    Bucket::Iterator iter(bucket);
+    for (iter.Seek(k.memtable_key().cdata());
+         iter.Valid() && callback_func(callback_args, iter.key());
+         iter.Next()) {
+    }
+  }
+
+  uint64_t ApproximateNumEntries(const Slice& start_ikey, const Slice& end_ikey) override {
+    std::string tmp;
+    uint64_t start_count = ordered_list_.EstimateCount(EncodeKey(&tmp, start_ikey));
+    uint64_t end_count = ordered_list_.EstimateCount(EncodeKey(&tmp, end_ikey));
+    return (end_count >= start_count) ? (end_count - start_count) : 0;
+  }
+
+  MemTableRep::Iterator* GetIterator(Arena* arena) override {
+    return NewIterator(arena, /* prefix_seek= */ false);
+  }
+
+  MemTableRep::Iterator* GetDynamicPrefixIterator(Arena* arena) override {
+    return NewIterator(arena, /* prefix_seek= */ true);
+  }
+
+ private:
+  typedef SkipList<const char*, const MemTableRep::KeyComparator&> Bucket;
+
+  // Iterates over the ordered list, or over the bucket of the seek target prefix when prefix
+  // seek is used. In the latter case the iterator could return entries with other prefixes hashed
+  // to the same bucket, so it is valid only while the caller stays within the prefix it seeked to.
+  // Seek to a key with empty prefix, SeekToFirst and SeekToLast always switch to the ordered
+  // list.
+  class Iterator : public MemTableRep::Iterator {
+   public:
+    Iterator(const PrefixHashSkipListRep& rep, bool prefix_seek)
+        : rep_(rep), prefix_seek_(prefix_seek), iter_(&rep.ordered_list_) {}
+
+    bool Valid() const override {
+      return list_ != nullptr && iter_.Valid();
+    }
+
+    const char* key() const override {
+      DCHECK(Valid());
+      return iter_.key();
+    }
+
+    void Next() override {
+      DCHECK(Valid());
+      iter_.Next();
+    }
+
+    void Prev() override {
+      DCHECK(Valid());
+      iter_.Prev();
+    }
+
+    void Seek(const Slice& internal_key, const char* memtable_key) override {
+      if (prefix_seek_) {
+        auto prefix = rep_.Prefix(ExtractUserKey(internal_key));
+        // Seek target without prefix, could be followed by entries with any prefix, so it uses
+        // the ordered list.
+        SetList(prefix.empty() ? &rep_.ordered_list_ : rep_.GetBucket(prefix));
+        if (list_ == nullptr) {
+          return;
+        }
+      }
+      iter_.Seek(memtable_key != nullptr ? memtable_key : EncodeKey(&tmp_, internal_key));
+    }
+
+    void SeekToFirst() override {
+      SetList(&rep_.ordered_list_);
+      iter_.SeekToFirst();
+    }
+
+    void SeekToLast() override {
+      SetList(&rep_.ordered_list_);
+      iter_.SeekToLast();
+    }
+
+   private:
+    void SetList(const Bucket* list) {
+      if (list_ != list) {
+        list_ = list;
+        iter_.SetList(list);
+      }
+    }
+
+    const PrefixHashSkipListRep& rep_;
+    const bool prefix_seek_;
+    const Bucket* list_ = &rep_.ordered_list_;
+    // Should not be used when list_ is nullptr.
+    Bucket::Iterator iter_;
+    std::string tmp_; // For passing to EncodeKey
+  };
+
+  MemTableRep::Iterator* NewIterator(Arena* arena, bool prefix_seek) {
+    if (arena == nullptr) {
+      return new Iterator(*this, prefix_seek);
+    }
+    auto mem = arena->AllocateAligned(sizeof(Iterator));
+    return new (mem) Iterator(*this, prefix_seek);
+  }
+
+  Slice Prefix(const Slice& user_key) const {
+    return transform_->Transform(user_key);
+  }
+
+  Bucket* GetBucket(const Slice& prefix) const {
+    auto hash = MurmurHash(prefix.data(), static_cast<int>(prefix.size()), 0) % bucket_count_;
+    return buckets_[hash].load(std::memory_order_acquire);
+  }
+
+  Bucket* GetInitializedBucket(const Slice& prefix) {
+    auto hash = MurmurHash(prefix.data(), static_cast<int>(prefix.size()), 0) % bucket_count_;
+    auto* bucket = buckets_[hash].load(std::memory_order_acquire);
+    if (bucket == nullptr) {
+      auto addr = allocator_->AllocateAligned(sizeof(Bucket));
+      bucket = new (addr) Bucket(compare_, allocator_);
+      buckets_[hash].store(bucket, std::memory_order_release);
+    }
+    return bucket;
+  }
+
+  const size_t bucket_count_;
+  const SliceTransform* const transform_;
+  const MemTableRep::KeyComparator& compare_;
+  MemTableAllocator* const allocator_;
+
+  // Contains all entries in order.
+  Bucket ordered_list_;
+
+  // Maps hashed prefixes to skip lists of entries with such prefixes.
+  std::atomic<Bucket*>* buckets_;
+};
+
+} // namespace
+
+MemTableRep* PrefixHashSkipListRepFactory::CreateMemTableRep(
+    const MemTableRep::KeyComparator& compare, MemTableAllocator* allocator,
+    const SliceTransform* transform, Logger* logger) {
+  // Prefix is defined by the factory, so it does not depend on the prefix extractor of the
+  // column family.
+  return new PrefixHashSkipListRep(compare, allocator, transform_.get(), bucket_count_);
+}
+
+}  // namespace rocksdb
@@ -168,9 +168,14 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+  // Maximum size of dictionary used to compress data blocks of SST file. The dictionary is trained
+  // on the first data blocks of each SST file and stored in the file, so similar keys and values
+  // in different blocks are compressed better. Only supported by ZSTD compression.
+  // Default: 0, i.e. dictionary is not used.
+  uint32_t max_dict_bytes;
+  CompressionOptions() : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -1514,6 +1519,12 @@ struct ReadOptions {
   // Default: false
   bool pin_data;
 
+  // The caller reads only keys that have the same prefix as the seek target, where prefix is
+  // defined by the memtable rep, so memtables could use their prefix index to serve the read.
+  // Unlike prefix_extractor based prefix seek, does not affect SST files.
+  // Default: false
+  bool memtable_prefix_seek = false;
+
   // Query id designated for the read.
   QueryId query_id = kDefaultQueryId;
 
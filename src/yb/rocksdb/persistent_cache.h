@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSDB_PERSISTENT_CACHE_H
+#define YB_ROCKSDB_PERSISTENT_CACHE_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/rocksdb/status.h"
+
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class MetricEntity;
+
+} // namespace yb
+
+namespace rocksdb {
+
+class Env;
+class EventListener;
+
+// Secondary tier of the block cache, that keeps raw SST blocks on a local device, which is faster
+// than the one that holds SST files. Unlike Cache, it keeps its contents across restarts.
+//
+// Blocks are identified by the unique id of the SST file, that does not change after restart,
+// and offset of the block in this file. Path of the SST file is stored along with the block, so
+// blocks of the deleted files could be erased.
+class PersistentCache {
+ public:
+  virtual ~PersistentCache() {}
+
+  // Schedules adding a block read from the file. Returns immediately, the block is copied and
+  // written to the cache in background. The block could be dropped if the writer falls behind.
+  virtual void Insert(
+      const Slice& file_id, const std::string& file_path, uint64_t offset, const Slice& block) = 0;
+
+  // Reads the block of the file into buf if the cache has it. Returns NotFound otherwise, or when
+  // the cached block size does not match the size.
+  virtual Status Lookup(
+      const Slice& file_id, const std::string& file_path, uint64_t offset, size_t size,
+      char* buf) = 0;
+
+  // Erases all blocks of the file, should be called when the file is deleted.
+  virtual void EraseFile(const std::string& file_path) = 0;
+
+  // Erases all blocks of the files located in the directory or its subdirectories. Should be called
+  // when the whole directory is deleted, so per file deletion notifications are not sent.
+  virtual void EraseDirectory(const std::string& dir_path) = 0;
+
+  // Returns the number of bytes used on the device.
+  virtual size_t GetUsage() const = 0;
+
+  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
+};
+
+struct LogStructuredPersistentCacheOptions {
+  Env* env = nullptr;
+
+  // Directory that contains cache files.
+  std::string path;
+
+  // Maximum size of all cache files.
+  size_t capacity = 0;
+
+  // Blocks are appended to a cache file until it reaches this size. When total size exceeds
+  // capacity, the oldest file is deleted with all the blocks it contains.
+  size_t file_size = 64 * 1024 * 1024;
+
+  // Maximum size of blocks scheduled for writing. New blocks are dropped when it is exceeded.
+  size_t max_pending_bytes = 32 * 1024 * 1024;
+};
+
+// Creates persistent cache that appends blocks to a sequence of files in the specified directory,
+// and keeps an in-memory index of them. Index is restored from existing files on startup, blocks
+// of SST files that no longer exist are dropped.
+Status NewLogStructuredPersistentCache(
+    const LogStructuredPersistentCacheOptions& options, std::shared_ptr<PersistentCache>* result);
+
+// Returns listener that erases blocks of deleted SST files from the cache.
+std::shared_ptr<EventListener> NewPersistentCacheFileDeletionListener(
+    std::shared_ptr<PersistentCache> cache);
+
+}  // namespace rocksdb
+
+#endif  // YB_ROCKSDB_PERSISTENT_CACHE_H
@@ -46,6 +46,7 @@ namespace rocksdb {
 
 // -- Block-based Table
 class FlushBlockPolicyFactory;
+class PersistentCache;
 struct TableReaderOptions;
 struct TableBuilderOptions;
 class TableBuilder;
@@ -121,6 +122,11 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL, data blocks read from SST files are also kept in this cache, that is stored on
+  // a local device and survives restarts. It is checked after block_cache and
+  // block_cache_compressed, before reading the SST file.
+  std::shared_ptr<PersistentCache> persistent_cache = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -588,4 +588,31 @@ yb::Result<Slice> Block::GetMiddleKey(
   return Slice(key_ptr, key_size);
 }
 
+yb::Result<std::vector<Slice>> Block::GetSampleKeys(
+    const KeyValueEncodingFormat key_value_encoding_format, size_t max_keys) const {
+  if (size_ < kMinBlockSize) {
+    return BadBlockContentsError();
+  }
+
+  std::vector<Slice> result;
+  const size_t num_restarts = size_ == kMinBlockSize ? 0 : NumRestarts();
+  const size_t num_keys = std::min(num_restarts, max_keys);
+  result.reserve(num_keys);
+  for (size_t i = 0; i != num_keys; ++i) {
+    // Take the middle restart point of each of num_keys equal parts.
+    const auto restart_idx = (2 * i + 1) * num_restarts / (2 * num_keys);
+    const auto entry_offset = DecodeFixed32(
+        data_ + restart_offset_ + restart_idx * sizeof(uint32_t));
+    uint32_t key_size;
+    const char* key_ptr = DecodeRestartEntry(
+        key_value_encoding_format, data_ + entry_offset, data_ + restart_offset_, data_,
+        &key_size);
+    if (key_ptr == nullptr) {
+      return BadEntryInBlockError("DecodeRestartEntry failed");
+    }
+    result.emplace_back(key_ptr, key_size);
+  }
+  return result;
+}
+
 }  // namespace rocksdb
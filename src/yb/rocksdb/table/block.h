@@ -26,6 +26,7 @@
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <vector>
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
 #include <malloc.h>
 #endif
@@ -104,6 +105,11 @@ class Block {
   // points description).
   yb::Result<Slice> GetMiddleKey(KeyValueEncodingFormat key_value_encoding_format) const;
 
+  // Returns up to max_keys restart keys from this block, evenly spaced among restart points. Keys
+  // point into the block contents.
+  yb::Result<std::vector<Slice>> GetSampleKeys(
+      KeyValueEncodingFormat key_value_encoding_format, size_t max_keys) const;
+
  private:
   BlockContents contents_;
   const char* data_;            // contents_.data.data()
@@ -32,6 +32,7 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -110,6 +111,7 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const CompressionDict* compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -163,7 +165,7 @@ Slice CompressBlock(const Slice& raw,
       break;     // fall back to no compression.
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -177,6 +179,10 @@ Slice CompressBlock(const Slice& raw,
   return raw;
 }
 
+// Size of data blocks buffered to train compression dictionary, relative to max_dict_bytes.
+// zstd recommends to use about 100 times more samples than the dictionary size.
+constexpr size_t kCompressionDictSamplesRatio = 100;
+
 }  // namespace
 
 // kBlockBasedTableMagicNumber was picked by running
@@ -301,6 +307,20 @@ struct BlockBasedTableBuilder::Rep {
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // Data block that is not written yet, because data blocks are used to train compression_dict.
+  struct BufferedDataBlock {
+    std::string contents;
+    std::string last_key;
+    std::string next_block_first_key;
+  };
+
+  // Whether data blocks are buffered until there are enough samples to train compression_dict.
+  bool buffer_data_blocks = false;
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  size_t buffered_data_size = 0;
+  // Dictionary used to compress data blocks, null if dictionary is not used.
+  std::unique_ptr<CompressionDict> compression_dict;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   yb::MemTrackerPtr mem_tracker;
@@ -386,6 +406,13 @@ BlockBasedTableBuilder::Rep::Rep(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
 
+  // Block based filter and hash index need data blocks to be written as soon as they are
+  // completed, so data blocks could not be buffered to train a dictionary for them.
+  buffer_data_blocks =
+      compression_type == kZSTDNotFinalCompression && ZSTD_Supported() &&
+      compression_opts.max_dict_bytes > 0 && filter_type != FilterType::kBlockBasedFilter &&
+      table_options.index_type != IndexType::kHashSearch;
+
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -498,12 +525,65 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
-  size_t data_block_size = 0;
 
+  if (r->buffer_data_blocks) {
+    if (!r->data_block_builder.empty()) {
+      const Slice contents = r->data_block_builder.Finish();
+      r->buffered_data_blocks.push_back(Rep::BufferedDataBlock {
+          contents.ToBuffer(), r->last_key, next_block_first_key.ToBuffer() });
+      r->buffered_data_size += contents.size();
+      r->data_block_builder.Reset();
+    }
+    if (r->buffered_data_size >=
+            r->compression_opts.max_dict_bytes * kCompressionDictSamplesRatio) {
+      WriteBufferedDataBlocks();
+    }
+    return;
+  }
+
+  size_t data_block_size = 0;
   if (!r->data_block_builder.empty()) {
     data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
         r->data_writer.get());
   }
+  AddDataIndexEntry(data_block_size, &r->last_key, next_block_first_key);
+}
+
+void BlockBasedTableBuilder::WriteBufferedDataBlocks() {
+  Rep* const r = rep_;
+  r->buffer_data_blocks = false;
+
+  std::string samples;
+  samples.reserve(r->buffered_data_size);
+  std::vector<size_t> sample_sizes;
+  sample_sizes.reserve(r->buffered_data_blocks.size());
+  for (const auto& block : r->buffered_data_blocks) {
+    samples.append(block.contents);
+    sample_sizes.push_back(block.contents.size());
+  }
+  // Blocks are compressed without dictionary if it could not be trained.
+  auto dict = ZSTD_TrainDictionary(samples, sample_sizes, r->compression_opts.max_dict_bytes);
+  if (!dict.empty()) {
+    r->compression_dict = std::make_unique<CompressionDict>(std::move(dict), r->compression_opts);
+  }
+  samples.clear();
+  samples.shrink_to_fit();
+
+  auto blocks = std::move(r->buffered_data_blocks);
+  r->buffered_data_blocks.clear();
+  r->buffered_data_size = 0;
+  for (auto& block : blocks) {
+    if (!ok()) return;
+    const size_t data_block_size = WriteBlock(
+        block.contents, &r->data_pending_handle, r->data_writer.get(),
+        r->compression_dict.get());
+    AddDataIndexEntry(data_block_size, &block.last_key, block.next_block_first_key);
+  }
+}
+
+void BlockBasedTableBuilder::AddDataIndexEntry(
+    size_t data_block_size, std::string* last_key, const Slice& next_block_first_key) {
+  Rep* const r = rep_;
   if (!ok()) return;
 
   if (!r->table_options.skip_table_builder_flush) {
@@ -526,7 +606,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -576,14 +656,16 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice* const next_block_firs
 size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
                                           BlockHandle* handle,
                                           FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
+  size_t block_size = WriteBlock(
+      block->Finish(), handle, writer_info, rep_->compression_dict.get());
   block->Reset();
   return block_size;
 }
 
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
     BlockHandle* handle,
-    FileWriterWithOffsetAndCachePrefix* writer_info) {
+    FileWriterWithOffsetAndCachePrefix* writer_info,
+    const CompressionDict* compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -596,7 +678,8 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict,
+                      &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -717,6 +800,9 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->buffer_data_blocks) {
+    WriteBufferedDataBlocks();
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(nullptr);  // no more filter block
   }
@@ -743,6 +829,15 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && r->compression_dict) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(
+        r->compression_dict->raw(), kNoCompression, &compression_dict_block_handle,
+        r->metadata_writer.get());
+    meta_index_builder.Add(
+        block_based_table::kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
@@ -865,8 +960,10 @@ uint64_t BlockBasedTableBuilder::NumEntries() const {
 }
 
 uint64_t BlockBasedTableBuilder::TotalFileSize() const {
-  return rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
-      rep_->metadata_writer->offset;
+  // Buffered data blocks are accounted, so output files of compaction are cut at about the same
+  // size when compression dictionary is used.
+  return (rep_->is_split_sst() ? rep_->metadata_writer->offset + rep_->data_writer->offset :
+      rep_->metadata_writer->offset) + rep_->buffered_data_size;
 }
 
 uint64_t BlockBasedTableBuilder::BaseFileSize() const {
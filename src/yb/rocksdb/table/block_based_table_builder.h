@@ -40,6 +40,7 @@ namespace rocksdb {
 
 class BlockBuilder;
 class BlockHandle;
+class CompressionDict;
 class WritableFile;
 struct BlockBasedTableOptions;
 
@@ -115,7 +116,8 @@ class BlockBasedTableBuilder : public TableBuilder {
                     FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const CompressionDict* compression_dict = nullptr);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -133,6 +135,13 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Trains compression dictionary on buffered data blocks and writes them to disk.
+  void WriteBufferedDataBlocks();
+
+  // Adds index entry for the data block that was just written to data_pending_handle.
+  void AddDataIndexEntry(
+      size_t data_block_size, std::string* last_key, const Slice& next_block_first_key);
+
   // Flush the current filter block into disk. next_block_first_filter_key should be nullptr if this
   // is the last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
@@ -27,6 +27,8 @@ namespace block_based_table {
 constexpr char kFilterBlockPrefix[] = "filter.";
 constexpr char kFullFilterBlockPrefix[] = "fullfilter.";
 constexpr char kFixedSizeFilterBlockPrefix[] = "fixedsizefilter.";
+// Meta block with dictionary used to compress data blocks, see CompressionOptions::max_dict_bytes.
+constexpr char kCompressionDictBlock[] = "rocksdb.compression_dict";
 
 // Read the block identified by "handle" from "file".
 // The only relevant option is options.verify_checksums for now.
@@ -36,10 +38,11 @@ inline CHECKED_STATUS ReadBlockFromFile(
     RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
     const BlockHandle& handle, std::unique_ptr<Block>* result, Env* env,
     const std::shared_ptr<yb::MemTracker>& mem_tracker,
-    bool do_uncompress = true) {
+    bool do_uncompress = true, const UncompressionDict* compression_dict = nullptr,
+    const PersistentCacheContext* persistent_cache = nullptr) {
   BlockContents contents;
   Status s = ReadBlockContents(file, footer, options, handle, &contents, env,
-                               mem_tracker, do_uncompress);
+                               mem_tracker, do_uncompress, compression_dict, persistent_cache);
   if (s.ok()) {
     result->reset(new Block(std::move(contents)));
   }
@@ -55,6 +55,7 @@
 #include "yb/rocksdb/table/two_level_iterator.h"
 #include "yb/rocksdb/table_properties.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/statistics.h"
@@ -149,6 +150,10 @@ struct BlockBasedTable::FileReaderWithCachePrefix {
   // Similar prefix, but for compressed blocks cache:
   block_based_table::CacheKeyPrefixBuffer compressed_cache_key_prefix;
 
+  // Unique id of the file used as a key in persistent cache, empty if the file does not have a
+  // unique id, so its blocks could not be persisted.
+  block_based_table::CacheKeyPrefixBuffer persistent_cache_file_id;
+
   explicit FileReaderWithCachePrefix(unique_ptr<RandomAccessFileReader>&& _reader) :
       reader(std::move(_reader)) {}
 };
@@ -242,6 +247,9 @@ struct BlockBasedTable::Rep {
 
   DataIndexLoadMode data_index_load_mode = static_cast<DataIndexLoadMode>(0);
   yb::MemTrackerPtr mem_tracker;
+
+  // Dictionary used to compress data blocks, null if data blocks are compressed without it.
+  std::unique_ptr<UncompressionDict> compression_dict;
 };
 
 // BlockEntryIteratorState doesn't actually store any iterator state and is only used as an adapter
@@ -312,6 +320,18 @@ void BlockBasedTable::SetupCacheKeyPrefix(Rep* rep,
         reader_with_cache_prefix->reader->file(),
         &reader_with_cache_prefix->compressed_cache_key_prefix);
   }
+  reader_with_cache_prefix->persistent_cache_file_id.size = 0;
+  if (rep->table_options.persistent_cache != nullptr) {
+    // Id generated by the block cache is not stable across restarts, so it could not be used here.
+    auto& file_id = reader_with_cache_prefix->persistent_cache_file_id;
+    file_id.size = reader_with_cache_prefix->reader->file()->GetUniqueId(file_id.data);
+    if (file_id.size == 0) {
+      YB_LOG_EVERY_N_SECS(WARNING, 60)
+          << "Persistent block cache is not used for "
+          << reader_with_cache_prefix->reader->file()->filename()
+          << ": file system does not provide unique file id";
+    }
+  }
 }
 
 KeyValueEncodingFormat BlockBasedTable::GetKeyValueEncodingFormat(const BlockType block_type) {
@@ -425,6 +445,8 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
 
   RETURN_NOT_OK(new_table->ReadPropertiesBlock(meta_iter.get()));
 
+  RETURN_NOT_OK(new_table->ReadCompressionDictBlock(meta_iter.get()));
+
   RETURN_NOT_OK(new_table->SetupFilter(meta_iter.get()));
 
   if (data_index_load_mode == DataIndexLoadMode::PRELOAD_ON_OPEN) {
@@ -572,6 +594,24 @@ Status BlockBasedTable::ReadPropertiesBlock(InternalIterator* meta_iter) {
   return Status::OK();
 }
 
+Status BlockBasedTable::ReadCompressionDictBlock(InternalIterator* meta_iter) {
+  BlockHandle handle;
+  if (!FindMetaBlock(meta_iter, block_based_table::kCompressionDictBlock, &handle).ok()) {
+    return Status::OK();
+  }
+  BlockContents contents;
+  RETURN_NOT_OK(ReadBlockContents(
+      rep_->base_reader_with_cache_prefix->reader.get(), rep_->footer, ReadOptions::kDefault,
+      handle, &contents, rep_->ioptions.env, rep_->mem_tracker, /* do_uncompress = */ false));
+  rep_->compression_dict = std::make_unique<UncompressionDict>(contents.data);
+  return Status::OK();
+}
+
+const UncompressionDict* BlockBasedTable::GetCompressionDict(BlockType block_type) const {
+  // Only data blocks are compressed with dictionary.
+  return block_type == BlockType::kData ? rep_->compression_dict.get() : nullptr;
+}
+
 Status BlockBasedTable::SetupFilter(InternalIterator* meta_iter) {
   // Find filter handle and filter type.
   if (!rep_->filter_policy) {
@@ -758,7 +798,8 @@ Status BlockBasedTable::GetDataBlockFromCache(
     Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const UncompressionDict* compression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -802,7 +843,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, compression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -830,7 +871,8 @@ Status BlockBasedTable::PutDataBlockToCache(
     Cache* block_cache, Cache* block_cache_compressed,
     const ReadOptions& read_options, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const UncompressionDict* compression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -839,7 +881,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, compression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -932,7 +974,7 @@ FilterBlockReader* BlockBasedTable::ReadFilterBlock(const BlockHandle& filter_ha
     case FilterType::kFixedSizeFilter:
       return new FixedSizeFilterBlockReader(
           rep->prefix_filtering ? rep->ioptions.prefix_extractor : nullptr,
-          rep->table_options, rep->whole_key_filtering, std::move(block));
+          rep->filter_policy, rep->whole_key_filtering, std::move(block));
       break;
   }
   RLOG(InfoLogLevel::FATAL_LEVEL, rep->ioptions.info_log, "Corrupted filter_type: %d",
@@ -1191,6 +1233,15 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  const auto* compression_dict = GetCompressionDict(block_type);
+  PersistentCacheContext persistent_cache_context;
+  const PersistentCacheContext* persistent_cache = nullptr;
+  if (block_type == BlockType::kData && reader->persistent_cache_file_id.size != 0) {
+    persistent_cache_context.cache = rep_->table_options.persistent_cache.get();
+    persistent_cache_context.file_id = Slice(
+        reader->persistent_cache_file_id.data, reader->persistent_cache_file_id.size);
+    persistent_cache = &persistent_cache_context;
+  }
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1211,7 +1262,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
 
     s = GetDataBlockFromCache(
         key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        rep_->table_options.format_version, block_type, rep_->mem_tracker, compression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
@@ -1219,13 +1270,15 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            rep_->mem_tracker, block_cache_compressed == nullptr, compression_dict,
+            persistent_cache);
       }
 
       if (s.ok()) {
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
                                 ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                compression_dict);
       }
     }
   }
@@ -1244,7 +1297,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, /* do_uncompress = */ true, compression_dict, persistent_cache);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1935,4 +1988,21 @@ yb::Result<std::string> BlockBasedTable::GetMiddleKey() {
   return iter->key().ToBuffer();
 }
 
+yb::Result<std::vector<std::string>> BlockBasedTable::GetSampleKeys(size_t max_keys) {
+  auto index_reader = VERIFY_RESULT(GetIndexReader(ReadOptions::kDefault));
+
+  // TODO: remove this trick after https://github.com/yugabyte/yugabyte-db/issues/4720 is resolved.
+  auto se = yb::ScopeExit([this, &index_reader] {
+    index_reader.Release(rep_->table_options.block_cache.get());
+  });
+
+  const auto index_keys = VERIFY_RESULT(index_reader.value->GetSampleKeys(max_keys));
+  std::vector<std::string> result;
+  result.reserve(index_keys.size());
+  for (const auto& key : index_keys) {
+    result.push_back(key.ToBuffer());
+  }
+  return result;
+}
+
 }  // namespace rocksdb
@@ -52,6 +52,7 @@ class InternalKeyComparator;
 class Iterator;
 class TableCache;
 class TableReader;
+class UncompressionDict;
 class WritableFile;
 struct BlockBasedTableOptions;
 struct EnvOptions;
@@ -188,6 +189,8 @@ class BlockBasedTable : public TableReader {
 
   yb::Result<std::string> GetMiddleKey() override;
 
+  yb::Result<std::vector<std::string>> GetSampleKeys(size_t max_keys) override;
+
   ~BlockBasedTable();
 
   bool TEST_filter_block_preloaded() const;
@@ -251,7 +254,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const UncompressionDict* compression_dict = nullptr);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
   // This method will perform decompression against raw_block if needed and then
@@ -266,7 +270,8 @@ class BlockBasedTable : public TableReader {
       Cache* block_cache, Cache* block_cache_compressed,
       const ReadOptions& read_options, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const UncompressionDict* compression_dict = nullptr);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -291,6 +296,12 @@ class BlockBasedTable : public TableReader {
 
   CHECKED_STATUS SetupFilter(InternalIterator* meta_iter);
 
+  // Loads dictionary used to compress data blocks, if the table has one.
+  CHECKED_STATUS ReadCompressionDictBlock(InternalIterator* meta_iter);
+
+  // Returns dictionary used to compress blocks of the specified type.
+  const UncompressionDict* GetCompressionDict(BlockType block_type) const;
+
   // Read the meta block from sst.
   static CHECKED_STATUS ReadMetaBlock(
       Rep* rep, std::unique_ptr<Block>* meta_block, std::unique_ptr<InternalIterator>* iter);
@@ -114,10 +114,10 @@ Slice FixedSizeFilterBlockBuilder::Finish() {
 
 FixedSizeFilterBlockReader::FixedSizeFilterBlockReader(
     const SliceTransform* prefix_extractor,
-    const BlockBasedTableOptions& table_opt,
+    const FilterPolicy* filter_policy,
     bool whole_key_filtering,
     BlockContents&& contents)
-    : policy_(table_opt.filter_policy.get()),
+    : policy_(filter_policy),
       prefix_extractor_(prefix_extractor),
       whole_key_filtering_(whole_key_filtering),
       contents_(std::move(contents)) {
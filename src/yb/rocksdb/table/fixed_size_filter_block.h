@@ -81,9 +81,11 @@ class FixedSizeFilterBlockBuilder : public FilterBlockBuilder {
 // KeyMayMatch and PrefixMayMatch would trigger filter checking.
 class FixedSizeFilterBlockReader : public FilterBlockReader {
  public:
-  // REQUIRES: "contents" and *policy must stay live while *this is live.
+  // REQUIRES: "contents" and *filter_policy must stay live while *this is live.
+  // filter_policy should be the policy the SST file was written with, which could differ from
+  // the one in table options.
   FixedSizeFilterBlockReader(const SliceTransform* prefix_extractor,
-                             const BlockBasedTableOptions& table_opt,
+                             const FilterPolicy* filter_policy,
                              bool whole_key_filtering,
                              BlockContents&& contents);
   FixedSizeFilterBlockReader(const FixedSizeFilterBlockReader&) = delete;
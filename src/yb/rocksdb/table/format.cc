@@ -28,6 +28,7 @@
 #include <string>
 
 #include "yb/rocksdb/env.h"
+#include "yb/rocksdb/persistent_cache.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/crc32c.h"
@@ -401,6 +402,35 @@ Status ReadBlock(
   return s;
 }
 
+// Reads the block with trailer from the persistent cache, returns false if it is not there. The block
+// is verified in the same way as the block read from the file, so a corrupted cache entry is
+// treated as a miss.
+bool ReadBlockFromPersistentCache(
+    RandomAccessFileReader* file, const Footer& footer, const ReadOptions& options,
+    const BlockHandle& handle, const PersistentCacheContext& persistent_cache, Slice* contents,
+    char* buf) {
+  const size_t expected_read_size = static_cast<size_t>(handle.size()) + kBlockTrailerSize;
+  auto status = persistent_cache.cache->Lookup(
+      persistent_cache.file_id, file->file()->filename(), handle.offset(), expected_read_size,
+      buf);
+  if (!status.ok()) {
+    if (!status.IsNotFound()) {
+      LOG(WARNING) << "Failed to read block " << handle.ToDebugString() << " of "
+                   << file->file()->filename() << " from persistent cache: " << status;
+    }
+    return false;
+  }
+  if (options.verify_checksums) {
+    status = VerifyBlockChecksum(file, footer, handle, buf, handle.size());
+    if (!status.ok()) {
+      LOG(WARNING) << "Persistent cache: " << status;
+      return false;
+    }
+  }
+  *contents = Slice(buf, expected_read_size);
+  return true;
+}
+
 }  // namespace
 
 TrackedAllocation::TrackedAllocation()
@@ -445,7 +475,9 @@ BlockContents::BlockContents(
 Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
                          const ReadOptions& options, const BlockHandle& handle,
                          BlockContents* contents, Env* env,
-                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested) {
+                         const yb::MemTrackerPtr& mem_tracker, bool decompression_requested,
+                         const UncompressionDict* compression_dict,
+                         const PersistentCacheContext* persistent_cache) {
   Status status;
   Slice slice;
   size_t n = static_cast<size_t>(handle.size());
@@ -464,7 +496,19 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
     used_buf = heap_buf.get();
   }
 
-  status = ReadBlock(file, footer, options, handle, &slice, used_buf);
+  bool read_from_persistent_cache = false;
+  if (persistent_cache != nullptr) {
+    read_from_persistent_cache = ReadBlockFromPersistentCache(
+        file, footer, options, handle, *persistent_cache, &slice, used_buf);
+  }
+
+  if (!read_from_persistent_cache) {
+    status = ReadBlock(file, footer, options, handle, &slice, used_buf);
+    if (status.ok() && persistent_cache != nullptr) {
+      persistent_cache->cache->Insert(
+          persistent_cache->file_id, file->file()->filename(), handle.offset(), slice);
+    }
+  }
 
   if (!status.ok()) {
     LOG(ERROR) << __func__ << ": " << status << "\n" << yb::GetStackTrace();
@@ -476,7 +520,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
   compression_type = static_cast<rocksdb::CompressionType>(slice.data()[n]);
 
   if (decompression_requested && compression_type != kNoCompression) {
-    return UncompressBlockContents(slice.cdata(), n, contents, footer.version(), mem_tracker);
+    return UncompressBlockContents(
+        slice.cdata(), n, contents, footer.version(), mem_tracker, compression_dict);
   }
 
   if (slice.cdata() != used_buf) {
@@ -503,7 +548,8 @@ Status ReadBlockContents(RandomAccessFileReader* file, const Footer& footer,
 Status UncompressBlockContents(const char* data, size_t n,
                                BlockContents* contents,
                                uint32_t format_version,
-                               const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+                               const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                               const UncompressionDict* compression_dict) {
   std::unique_ptr<char[]> ubuf;
   int decompress_size = 0;
   assert(data[n] != kNoCompression);
@@ -572,7 +618,7 @@ Status UncompressBlockContents(const char* data, size_t n,
       break;
     case kZSTDNotFinalCompression:
       ubuf =
-          std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size));
+          std::unique_ptr<char[]>(ZSTD_Uncompress(data, n, &decompress_size, compression_dict));
       if (!ubuf) {
         static char zstd_corrupt_msg[] =
             "ZSTD not supported or corrupted ZSTD compressed block contents";
@@ -40,6 +40,8 @@ class MemTracker;
 namespace rocksdb {
 
 class Block;
+class PersistentCache;
+class UncompressionDict;
 struct ReadOptions;
 
 // the length of the magic number in bytes.
@@ -248,15 +250,27 @@ struct BlockContents {
   BlockContents& operator=(BlockContents&& other) = default;
 };
 
+// Identifies blocks of the file in the persistent cache, see
+// BlockBasedTableOptions::persistent_cache.
+struct PersistentCacheContext {
+  PersistentCache* cache = nullptr;
+  Slice file_id;
+};
+
 // Read the block identified by "handle" from "file".  On failure
 // return non-OK.  On success fill *result and return OK.
+// compression_dict is the dictionary used to compress the block, it is only used for data blocks.
+// If persistent_cache is specified, the block is looked up there before reading the file, and
+// added there after reading the file.
 extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const Footer& footer,
                                 const ReadOptions& options,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const UncompressionDict* compression_dict = nullptr,
+                                const PersistentCacheContext* persistent_cache = nullptr);
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -268,7 +282,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const UncompressionDict* compression_dict = nullptr);
 
 // Implementation details follow.  Clients should ignore,
 
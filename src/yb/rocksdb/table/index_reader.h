@@ -62,6 +62,11 @@ class IndexReader {
   // written into the index (see ShortenedIndexBuilder).
   virtual Result<Slice> GetMiddleKey() = 0;
 
+  // Returns up to max_keys keys from the index, that split it into roughly equal parts. Keys have
+  // the same limitations as in GetMiddleKey. Only the top level of the index is sampled, so no
+  // additional IO is required.
+  virtual Result<std::vector<Slice>> GetSampleKeys(size_t max_keys) = 0;
+
   // The size of the index.
   virtual size_t size() const = 0;
   // Memory usage of the index block
@@ -114,6 +119,8 @@ class BinarySearchIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSampleKeys(size_t max_keys) override;
+
  private:
   BinarySearchIndexReader(const ComparatorPtr& comparator,
                           std::unique_ptr<Block>&& index_block)
@@ -160,6 +167,8 @@ class HashIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSampleKeys(size_t max_keys) override;
+
  private:
   HashIndexReader(const ComparatorPtr& comparator, std::unique_ptr<Block>&& index_block)
       : IndexReader(comparator), index_block_(std::move(index_block)) {
@@ -201,6 +210,8 @@ class MultiLevelIndexReader : public IndexReader {
 
   Result<Slice> GetMiddleKey() override;
 
+  Result<std::vector<Slice>> GetSampleKeys(size_t max_keys) override;
+
  private:
   size_t size() const override { return top_level_index_block_->size(); }
 
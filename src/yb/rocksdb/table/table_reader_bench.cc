@@ -26,9 +26,12 @@ int main() {
 }
 #else
 
+#include <cinttypes>
+
 #include <gflags/gflags.h>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/db/db_impl.h"
@@ -253,6 +256,16 @@ void TableReaderBenchmark(const Options& opts, const EnvOptions& env_options,
       for_iterator ? "iterator" : (if_query_empty_keys ? "empty" : "non_empty"),
       measured_by_nanosecond ? "nanosecond" : "microsecond",
       hist.ToString().c_str());
+  if (!through_db) {
+    // Compare memory used by different filter policies for the same keys.
+    auto props = table_reader->GetTableProperties();
+    const uint64_t num_keys = static_cast<uint64_t>(num_keys1) * num_keys2;
+    fprintf(
+        stderr, "Filter policy: %s, filter size: %" PRIu64 " bytes (%.2f bits per key), "
+        "filter index size: %" PRIu64 " bytes\n",
+        props->filter_policy_name.empty() ? "none" : props->filter_policy_name.c_str(),
+        props->filter_size, props->filter_size * 8.0 / num_keys, props->filter_index_size);
+  }
   if (!through_db) {
     env->DeleteFile(file_name);
   } else {
@@ -277,6 +290,11 @@ DEFINE_bool(through_db, false, "If enable, a DB instance will be created and "
 DEFINE_bool(mmap_read, true, "Whether use mmap read");
 DEFINE_string(table_factory, "block_based",
               "Table factory to use: `block_based` (default) or `plain_table`.");
+DEFINE_string(filter_policy, "none",
+              "Filter policy to use with block_based table: `none` (default), "
+              "`fixed_size_bloom` or `fixed_size_xor`.");
+DEFINE_int64(filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits,
+             "Size of each filter block in bits for fixed size filter policies.");
 DEFINE_string(time_unit, "microsecond",
               "The time unit used for measuring performance. User can specify "
               "`microsecond` (default) or `nanosecond`");
@@ -310,7 +328,19 @@ int main(int argc, char** argv) {
     options.prefix_extractor.reset(rocksdb::NewFixedPrefixTransform(
         FLAGS_prefix_len));
   } else if (FLAGS_table_factory == "block_based") {
-    tf.reset(new rocksdb::BlockBasedTableFactory());
+    rocksdb::BlockBasedTableOptions table_options;
+    if (FLAGS_filter_policy == "fixed_size_bloom") {
+      table_options.filter_policy.reset(rocksdb::NewFixedSizeFilterPolicy(
+          FLAGS_filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate,
+          nullptr));
+    } else if (FLAGS_filter_policy == "fixed_size_xor") {
+      table_options.filter_policy.reset(
+          rocksdb::NewFixedSizeXorFilterPolicy(FLAGS_filter_block_size_bits));
+    } else if (FLAGS_filter_policy != "none") {
+      fprintf(stderr, "Invalid filter policy %s\n", FLAGS_filter_policy.c_str());
+      return 1;
+    }
+    tf.reset(new rocksdb::BlockBasedTableFactory(table_options));
   } else {
     fprintf(stderr, "Invalid table type %s\n", FLAGS_table_factory.c_str());
   }
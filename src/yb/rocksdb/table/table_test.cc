@@ -65,7 +65,10 @@
 #include "yb/rocksdb/util/testharness.h"
 #include "yb/rocksdb/util/testutil.h"
 
+#include "yb/gutil/macros.h"
+
 #include "yb/util/enums.h"
+#include "yb/util/format.h"
 #include "yb/util/string_util.h"
 #include "yb/util/test_macros.h"
 
@@ -307,7 +310,7 @@ class TableConstructor: public Constructor {
                             internal_comparator,
                             int_tbl_prop_collector_factories,
                             options.compression,
-                            CompressionOptions(),
+                            options.compression_opts,
                             /* skip_filters */ false),
         TablePropertiesCollectorFactory::Context::kUnknownColumnFamily,
         file_writer_.get()));
@@ -1585,6 +1588,68 @@ TEST_F(BlockBasedTableTest, NumBlockStat) {
             c.GetTableReader()->GetTableProperties()->num_data_blocks);
 }
 
+namespace {
+
+// Builds table of document like values with the specified compression dictionary size, returns
+// size of its data blocks.
+uint64_t BuildTableWithCompressionDict(uint32_t max_dict_bytes) {
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator());
+  Options options;
+  options.compression = kZSTDNotFinalCompression;
+  options.compression_opts.max_dict_bytes = max_dict_bytes;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 4096;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  const char* const kCities[] = {"Sunnyvale", "San Francisco", "New York", "Seattle", "Austin"};
+  for (int i = 0; i < 10000; ++i) {
+    char key[32];
+    snprintf(key, sizeof(key), "user%08d", i);
+    const auto* city = kCities[rnd.Uniform(static_cast<int>(arraysize(kCities)))];
+    c.Add(key, yb::Format(
+        R"({"id": $0, "name": "user $1", "email": "user$1@example.com", "city": "$2", )"
+        R"("active": $3, "score": $4})", i, rnd.Next() % 100000, city, rnd.OneIn(2),
+        rnd.Uniform(1000)));
+  }
+
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  const ImmutableCFOptions ioptions(options);
+  c.Finish(options, ioptions, table_options,
+           GetPlainInternalComparator(options.comparator), &keys, &kvmap);
+
+  std::unique_ptr<InternalIterator> iter(c.NewIterator());
+  iter->SeekToFirst();
+  for (const auto& kv : kvmap) {
+    EXPECT_TRUE(iter->Valid());
+    if (!iter->Valid()) {
+      break;
+    }
+    EXPECT_EQ(kv.first, iter->key().ToBuffer());
+    EXPECT_EQ(kv.second, iter->value().ToBuffer());
+    iter->Next();
+  }
+  EXPECT_FALSE(iter->Valid());
+  EXPECT_OK(iter->status());
+
+  return c.GetTableReader()->GetTableProperties()->data_size;
+}
+
+} // namespace
+
+TEST_F(BlockBasedTableTest, CompressionDictionary) {
+  if (!ZSTD_Supported()) {
+    fprintf(stderr, "skipping zstd compression dictionary test\n");
+    return;
+  }
+  const auto size_without_dict = BuildTableWithCompressionDict(0);
+  const auto size_with_dict = BuildTableWithCompressionDict(4096);
+  LOG(INFO) << "Data size without dictionary: " << size_without_dict
+            << ", with dictionary: " << size_with_dict;
+  ASSERT_LT(size_with_dict, size_without_dict);
+}
+
 // A simple tool that takes the snapshot of block cache statistics.
 class BlockCachePropertiesSnapshot {
  public:
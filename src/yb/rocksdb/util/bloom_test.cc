@@ -236,7 +236,22 @@ class FixedSizeFilterBloomTestContext : public BloomTestContext {
           nullptr)};
 };
 
-YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter));
+class FixedSizeXorFilterTestContext : public BloomTestContext {
+ public:
+  const FilterPolicy& filter_policy() const override { return *filter_policy_.get(); }
+
+  size_t max_keys() const override { return std::numeric_limits<size_t>::max(); }
+
+  void CheckFilterSize(size_t filter_size, size_t num_keys) const override {
+    ASSERT_LE(filter_size, FilterPolicy::kDefaultFixedSizeFilterBits / 8 + 12) << num_keys;
+  }
+
+ private:
+  std::unique_ptr<const FilterPolicy> filter_policy_{
+      NewFixedSizeXorFilterPolicy(FilterPolicy::kDefaultFixedSizeFilterBits)};
+};
+
+YB_DEFINE_ENUM(BuilderReaderBloomTestType, (kFullFilter)(kFixedSizeFilter)(kFixedSizeXorFilter));
 
 namespace {
 
@@ -246,6 +261,8 @@ std::unique_ptr<const BloomTestContext> CreateContext(BuilderReaderBloomTestType
       return std::make_unique<FullFilterBloomTestContext>();
     case BuilderReaderBloomTestType::kFixedSizeFilter:
       return std::make_unique<FixedSizeFilterBloomTestContext>();
+    case BuilderReaderBloomTestType::kFixedSizeXorFilter:
+      return std::make_unique<FixedSizeXorFilterTestContext>();
   }
   FATAL_INVALID_ENUM_VALUE(BuilderReaderBloomTestType, type);
 }
@@ -374,7 +391,8 @@ TEST_P(BuilderReaderBloomTest, FullVaryingLengths) {
 
 INSTANTIATE_TEST_CASE_P(, BuilderReaderBloomTest, ::testing::Values(
     BuilderReaderBloomTestType::kFullFilter,
-    BuilderReaderBloomTestType::kFixedSizeFilter));
+    BuilderReaderBloomTestType::kFixedSizeFilter,
+    BuilderReaderBloomTestType::kFixedSizeXorFilter));
 
 }  // namespace rocksdb
 
@@ -24,6 +24,9 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/statistics.h"
@@ -373,6 +376,81 @@ class LRUHandleDeleter {
   autovector<LRUHandle*> handles_;
 };
 
+// Count-min sketch of recent accesses to cache keys, used by the TinyLFU admission policy.
+//
+// Each key is mapped to one counter in each of kSketchDepth rows, and its access frequency is
+// estimated as the minimum of those counters. Counters saturate at kSketchMaxCount. After
+// kSketchResetMultiplier * width increments all counters are halved, so the frequency of keys
+// that are no longer accessed decays.
+constexpr size_t kSketchDepth = 4;
+constexpr uint8_t kSketchMaxCount = 15;
+constexpr size_t kSketchResetMultiplier = 10;
+constexpr size_t kSketchMinWidth = 256;
+// Sketch width is picked to have a counter per entry in each row, assuming entries of this size.
+constexpr size_t kSketchEntryChargeEstimate = 8192;
+
+class FrequencySketch {
+ public:
+  void Resize(size_t capacity) {
+    size_t width = kSketchMinWidth;
+    while (width < capacity / kSketchEntryChargeEstimate) {
+      width *= 2;
+    }
+    if (width == width_) {
+      return;
+    }
+    width_ = width;
+    counters_.assign(width_ * kSketchDepth, 0);
+    num_increments_ = 0;
+  }
+
+  void Increment(uint32_t hash) {
+    bool incremented = false;
+    for (size_t row = 0; row != kSketchDepth; ++row) {
+      auto& counter = counters_[Index(hash, row)];
+      if (counter < kSketchMaxCount) {
+        ++counter;
+        incremented = true;
+      }
+    }
+    if (incremented && ++num_increments_ >= kSketchResetMultiplier * width_) {
+      Reset();
+    }
+  }
+
+  uint8_t Estimate(uint32_t hash) const {
+    uint8_t result = kSketchMaxCount;
+    for (size_t row = 0; row != kSketchDepth; ++row) {
+      result = std::min(result, counters_[Index(hash, row)]);
+    }
+    return result;
+  }
+
+ private:
+  // High bits of the hash are used to pick the shard, so they are the same for all keys of the
+  // shard. The hash is remixed with a different seed for each row.
+  size_t Index(uint32_t hash, size_t row) const {
+    uint32_t h = hash + static_cast<uint32_t>(row + 1) * 0x9e3779b9U;
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return row * width_ + (h & (width_ - 1));
+  }
+
+  void Reset() {
+    for (auto& counter : counters_) {
+      counter >>= 1;
+    }
+    num_increments_ /= 2;
+  }
+
+  size_t width_ = 0;
+  std::vector<uint8_t> counters_;
+  size_t num_increments_ = 0;
+};
+
 // A single shard of sharded cache.
 class LRUCache {
  public:
@@ -392,6 +470,11 @@ class LRUCache {
   // Set the flag to reject insertion if cache if full.
   void SetStrictCapacityLimit(bool strict_capacity_limit);
 
+  // Should be called before SetCapacity.
+  void SetAdmissionPolicy(CacheAdmissionPolicy admission_policy) {
+    admission_policy_ = admission_policy;
+  }
+
   // Like Cache methods, but with an extra "hash" parameter.
   Status Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                 void* value, size_t charge, void (*deleter)(const Slice& key, void* value),
@@ -456,6 +539,10 @@ class LRUCache {
   // Checks if the corresponding subcache contains space.
   bool HasFreeSpace(const SubCacheType subcache_type);
 
+  // Returns whether the new single touch entry should be added to the cache, according to the
+  // admission policy.
+  bool Admit(const LRUHandle* e);
+
   size_t TotalUsage() const {
     return single_touch_sub_cache_.Usage() + multi_touch_sub_cache_.Usage();
   }
@@ -463,6 +550,11 @@ class LRUCache {
   // Whether to reject insertion if cache reaches its full capacity.
   bool strict_capacity_limit_ = false;
 
+  CacheAdmissionPolicy admission_policy_ = CacheAdmissionPolicy::kAdmitAll;
+
+  // Used only by the TinyLFU admission policy.
+  FrequencySketch frequency_sketch_;
+
   // mutex_ protects the following state.
   // We don't count mutex_ as the cache's internal state so semantically we
   // don't mind mutex_ invoking the non-const actions.
@@ -559,6 +651,9 @@ void LRUCache::SetCapacity(size_t capacity) {
     MutexLock l(&mutex_);
     multi_touch_capacity_ = round((1 - FLAGS_cache_single_touch_ratio) * capacity);
     total_capacity_ = capacity;
+    if (admission_policy_ == CacheAdmissionPolicy::kTinyLFU) {
+      frequency_sketch_.Resize(capacity);
+    }
     EvictFromLRU(0, &last_reference_list, MULTI_TOUCH);
     EvictFromLRU(0, &last_reference_list, SINGLE_TOUCH);
   }
@@ -577,6 +672,9 @@ void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                                 Statistics* statistics)  {
   MutexLock l(&mutex_);
+  if (admission_policy_ == CacheAdmissionPolicy::kTinyLFU) {
+    frequency_sketch_.Increment(hash);
+  }
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     assert(e->in_cache);
@@ -632,6 +730,11 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId q
     bool was_hit = (e != nullptr);
     if (was_hit) {
       metrics_->cache_hits->Increment();
+      if (e->GetSubCacheType() == SubCacheType::MULTI_TOUCH) {
+        metrics_->multi_touch_cache_hits->Increment();
+      } else {
+        metrics_->single_touch_cache_hits->Increment();
+      }
     } else {
       metrics_->cache_misses->Increment();
     }
@@ -651,6 +754,20 @@ bool LRUCache::HasFreeSpace(const SubCacheType subcache_type) {
   FATAL_INVALID_ENUM_VALUE(SubCacheType, subcache_type);
 }
 
+bool LRUCache::Admit(const LRUHandle* e) {
+  if (admission_policy_ != CacheAdmissionPolicy::kTinyLFU) {
+    return true;
+  }
+  LRUSubCache* sub_cache = GetSubCache(SINGLE_TOUCH);
+  if (sub_cache->Usage() + e->charge <= GetSubCacheCapacity(SINGLE_TOUCH) ||
+      sub_cache->IsLRUEmpty()) {
+    return true;
+  }
+  // The least recently used entry is the first one to be evicted for the new entry.
+  const LRUHandle* victim = sub_cache->LRU_Head().next;
+  return frequency_sketch_.Estimate(e->hash) > frequency_sketch_.Estimate(victim->hash);
+}
+
 void LRUCache::Release(Cache::Handle* handle) {
   if (handle == nullptr) {
     return;
@@ -713,6 +830,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   LRUHandle* e = reinterpret_cast<LRUHandle*>(
                     new char[sizeof(LRUHandle) - 1 + key.size()]);
   Status s;
+  bool admitted = true;
   LRUHandleDeleter last_reference_list(metrics_.get());
 
   e->value = value;
@@ -744,10 +862,25 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
     }
-    EvictFromLRU(charge, &last_reference_list, subcache_type);
+    admitted = subcache_type == MULTI_TOUCH || Admit(e);
+    if (admitted) {
+      EvictFromLRU(charge, &last_reference_list, subcache_type);
+    }
     LRUSubCache* sub_cache = GetSubCache(subcache_type);
-    // If the cache no longer has any more space in the given pool.
-    if (strict_capacity_limit_ &&
+    if (!admitted) {
+      // The entry is not added to the hash table and is freed as soon as it is not referenced,
+      // so the caller could still use the returned handle.
+      e->in_cache = false;
+      if (handle == nullptr) {
+        e->refs = 0;
+        last_reference_list.Add(e);
+      } else {
+        e->refs = 1;
+        sub_cache->IncrementUsage(e->charge);
+        *handle = reinterpret_cast<Cache::Handle*>(e);
+      }
+      s = Status::OK();
+    } else if (strict_capacity_limit_ &&
         sub_cache->Usage() - sub_cache->LRU_Usage() + charge > GetSubCacheCapacity(subcache_type)) {
       if (handle == nullptr) {
         last_reference_list.Add(e);
@@ -786,7 +919,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       }
       s = Status::OK();
     }
-    if (statistics != nullptr) {
+    if (statistics != nullptr && admitted) {
       if (s.ok()) {
         RecordTick(statistics, BLOCK_CACHE_ADD);
         RecordTick(statistics, BLOCK_CACHE_BYTES_WRITE, charge);
@@ -802,6 +935,9 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       }
     }
     if (metrics_ != nullptr) {
+      if (!admitted) {
+        metrics_->admission_rejections->Increment();
+      }
       if (subcache_type == MULTI_TOUCH) {
         metrics_->multi_touch_cache_usage->IncrementBy(charge);
       } else {
@@ -866,7 +1002,7 @@ class ShardedLRUCache : public Cache {
 
  public:
   ShardedLRUCache(size_t capacity, int num_shard_bits,
-                  bool strict_capacity_limit)
+                  bool strict_capacity_limit, CacheAdmissionPolicy admission_policy)
       : last_id_(0),
         num_shard_bits_(num_shard_bits),
         capacity_(capacity),
@@ -877,6 +1013,7 @@ class ShardedLRUCache : public Cache {
     const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
     for (int s = 0; s < num_shards; s++) {
       shards_[s].SetStrictCapacityLimit(strict_capacity_limit);
+      shards_[s].SetAdmissionPolicy(admission_policy);
       shards_[s].SetCapacity(per_shard);
     }
   }
@@ -1026,11 +1163,18 @@ shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits) {
 
 shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
                               bool strict_capacity_limit) {
+  return NewLRUCache(capacity, num_shard_bits, strict_capacity_limit,
+                     CacheAdmissionPolicy::kAdmitAll);
+}
+
+shared_ptr<Cache> NewLRUCache(size_t capacity, int num_shard_bits,
+                              bool strict_capacity_limit,
+                              CacheAdmissionPolicy admission_policy) {
   if (num_shard_bits >= 20) {
     return nullptr;  // the cache cannot be sharded into too many fine pieces
   }
   return std::make_shared<ShardedLRUCache>(capacity, num_shard_bits,
-                                           strict_capacity_limit);
+                                           strict_capacity_limit, admission_policy);
 }
 
 }  // namespace rocksdb
@@ -61,6 +61,16 @@ DEFINE_int32(lookup_percent, 50,
 DEFINE_int32(erase_percent, 10,
              "Ratio of erase to total workload (expressed as a percentage)");
 
+DEFINE_bool(replay_mixed_trace, false,
+            "Instead of the concurrent random workload, replay a trace of point lookups mixed "
+            "with scans against each cache admission policy and report hit ratios");
+DEFINE_int32(trace_hot_keys_log, 14,
+             "Point lookups read keys in [0, 2^trace_hot_keys_log) with a skewed distribution");
+DEFINE_int32(trace_scan_length, 100000, "Number of blocks read by each scan");
+DEFINE_int32(trace_lookups_per_scan, 200000, "Number of point lookups between scans");
+DEFINE_int32(trace_num_scans, 20, "Number of scans in the trace");
+DEFINE_int32(trace_block_size, 32 * KB, "Charge of each block in the trace");
+
 namespace rocksdb {
 
 class CacheBench;
@@ -157,7 +167,7 @@ class CacheBench {
       // Cast uint64* to be char*, data would be copied to cache
       Slice key(reinterpret_cast<char*>(&rand_key), 8);
       // do insert
-      cache_->Insert(key, new char[10], 1, &deleter);
+      cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
     }
   }
 
@@ -235,11 +245,11 @@ class CacheBench {
       int32_t prob_op = thread->rnd.Uniform(100);
       if (prob_op >= 0 && prob_op < FLAGS_insert_percent) {
         // do insert
-        cache_->Insert(key, new char[10], 1, &deleter);
+        cache_->Insert(key, kDefaultQueryId, new char[10], 1, &deleter);
       } else if (prob_op -= FLAGS_insert_percent &&
                  prob_op < FLAGS_lookup_percent) {
         // do lookup
-        auto handle = cache_->Lookup(key);
+        auto handle = cache_->Lookup(key, kDefaultQueryId);
         if (handle) {
           cache_->Release(handle);
         }
@@ -264,6 +274,53 @@ class CacheBench {
     printf("----------------------------\n");
   }
 };
+
+// Replays the same trace against a cache with the specified admission policy. The trace is a
+// sequence of point lookups of hot keys, that are interrupted by scans of keys that are not read
+// otherwise. Each point lookup and each scan uses its own query id, like read requests do.
+// On a miss the block is inserted into the cache, as the block based table reader does.
+void ReplayMixedTrace(CacheAdmissionPolicy admission_policy, const char* name) {
+  auto cache = NewLRUCache(FLAGS_cache_size, FLAGS_num_shard_bits, false, admission_policy);
+  Random rnd(301);
+  QueryId query_id = kDefaultQueryId;
+  uint64_t next_scan_key = 1ULL << 40;
+  uint64_t lookups = 0;
+  uint64_t lookup_hits = 0;
+  uint64_t scan_reads = 0;
+  uint64_t scan_hits = 0;
+
+  auto read = [&cache](uint64_t block_key, QueryId read_query_id) {
+    Slice key(reinterpret_cast<char*>(&block_key), sizeof(block_key));
+    auto handle = cache->Lookup(key, read_query_id);
+    if (handle) {
+      cache->Release(handle);
+      return true;
+    }
+    cache->Insert(key, read_query_id, new char[1], FLAGS_trace_block_size, &deleter);
+    return false;
+  };
+
+  for (int scan = 0; scan <= FLAGS_trace_num_scans; ++scan) {
+    for (int i = 0; i != FLAGS_trace_lookups_per_scan; ++i) {
+      ++lookups;
+      lookup_hits += read(rnd.Skewed(FLAGS_trace_hot_keys_log), ++query_id);
+    }
+    if (scan == FLAGS_trace_num_scans) {
+      break;
+    }
+    ++query_id;
+    for (int i = 0; i != FLAGS_trace_scan_length; ++i) {
+      ++scan_reads;
+      scan_hits += read(next_scan_key++, query_id);
+    }
+  }
+
+  fprintf(stdout, "%-12s: point lookup hit ratio %.4f, scan hit ratio %.4f, usage %" PRIu64 "\n",
+          name, static_cast<double>(lookup_hits) / lookups,
+          scan_reads ? static_cast<double>(scan_hits) / scan_reads : 0.0,
+          static_cast<uint64_t>(cache->GetUsage()));
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
@@ -274,6 +331,12 @@ int main(int argc, char** argv) {
     exit(1);
   }
 
+  if (FLAGS_replay_mixed_trace) {
+    rocksdb::ReplayMixedTrace(rocksdb::CacheAdmissionPolicy::kAdmitAll, "LRU");
+    rocksdb::ReplayMixedTrace(rocksdb::CacheAdmissionPolicy::kTinyLFU, "TinyLFU");
+    return 0;
+  }
+
   rocksdb::CacheBench bench;
   if (FLAGS_populate_cache) {
     bench.PopulateCache();
@@ -465,6 +465,59 @@ TEST_F(CacheTest, EvictionPolicyMultiTouch) {
   ASSERT_LT(kCacheSize * FLAGS_cache_single_touch_ratio, cache_->GetUsage());
 }
 
+TEST_F(CacheTest, TinyLFUAdmission) {
+  constexpr int kCapacity = 40;
+  constexpr int kNumHotKeys = 20;
+  constexpr int kNumHotKeyLookups = 10;
+  constexpr int kNumScanKeys = 200;
+
+  for (auto admission_policy : {CacheAdmissionPolicy::kAdmitAll, CacheAdmissionPolicy::kTinyLFU}) {
+    auto cache = NewLRUCache(kCapacity, 0, false, admission_policy);
+
+    // Hot keys are repeatedly read by point lookups. Lookups use the same query id, so the whole
+    // cache is used as single touch cache.
+    for (int i = 0; i != kNumHotKeyLookups; ++i) {
+      for (int key = 0; key != kNumHotKeys; ++key) {
+        if (Lookup(cache, key) == -1) {
+          ASSERT_OK(Insert(cache, key, key));
+        }
+      }
+    }
+
+    // Scan reads each key once.
+    for (int key = 1000; key != 1000 + kNumScanKeys; ++key) {
+      ASSERT_EQ(-1, Lookup(cache, key));
+      ASSERT_OK(Insert(cache, key, key));
+    }
+    ASSERT_EQ(kCapacity, cache->GetUsage());
+
+    int num_cached_hot_keys = 0;
+    for (int key = 0; key != kNumHotKeys; ++key) {
+      if (Lookup(cache, key) != -1) {
+        ++num_cached_hot_keys;
+      }
+    }
+    if (admission_policy == CacheAdmissionPolicy::kAdmitAll) {
+      ASSERT_EQ(0, num_cached_hot_keys);
+      continue;
+    }
+    ASSERT_EQ(kNumHotKeys, num_cached_hot_keys);
+
+    // Rejected entry is still available through the returned handle, and is deleted when the
+    // handle is released.
+    Cache::Handle* handle = nullptr;
+    ASSERT_OK(cache->Insert(EncodeKey(5000), kTestQueryId, EncodeValue(5001), 1,
+                            &CacheTest::Deleter, &handle));
+    ASSERT_NE(nullptr, handle);
+    ASSERT_EQ(5001, DecodeValue(cache->Value(handle)));
+    ASSERT_EQ(kCapacity + 1, cache->GetUsage());
+    cache->Release(handle);
+    ASSERT_EQ(5000, deleted_keys_.back());
+    ASSERT_EQ(kCapacity, cache->GetUsage());
+    ASSERT_EQ(-1, Lookup(cache, 5000));
+  }
+}
+
 TEST_F(CacheTest, HeavyEntries) {
   // Add a bunch of light and heavy entries and then count the combined
   // size of items still in the cache, which must be approximately the
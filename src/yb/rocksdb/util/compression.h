@@ -25,11 +25,15 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
 
+#include "yb/util/slice.h"
+
 #ifdef SNAPPY
 #include <snappy.h>
 #endif
@@ -48,6 +52,7 @@
 #endif
 
 #if defined(ZSTD)
+#include <zdict.h>
 #include <zstd.h>
 #endif
 
@@ -620,8 +625,105 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+#ifdef ZSTD
+// CompressionOptions::level defaults to -1, that is the default level for zlib, but a fast mode
+// with poor compression ratio for zstd.
+inline int ZSTD_CompressionLevel(const CompressionOptions& opts) {
+  constexpr int kZSTDDefaultCompressionLevel = 3;
+  return opts.level < 0 ? kZSTDDefaultCompressionLevel : opts.level;
+}
+
+namespace compression {
+
+// zstd contexts are reused by all compressions and decompressions performed by the thread,
+// instead of allocating them for every block.
+inline ZSTD_CCtx* ZSTDCompressionContext() {
+  static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> context(
+      ZSTD_createCCtx(), &ZSTD_freeCCtx);
+  return context.get();
+}
+
+inline ZSTD_DCtx* ZSTDDecompressionContext() {
+  static thread_local std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context(
+      ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  return context.get();
+}
+
+} // namespace compression
+#endif
+
+// Dictionary trained by ZSTD_TrainDictionary, digested by zstd for compression. It is built once
+// per table and used for all blocks compressed with it.
+class CompressionDict {
+ public:
+  CompressionDict(std::string raw, const CompressionOptions& opts) : raw_(std::move(raw)) {
+#ifdef ZSTD
+    cdict_ = ZSTD_createCDict(raw_.data(), raw_.size(), ZSTD_CompressionLevel(opts));
+#endif
+  }
+
+  CompressionDict(const CompressionDict&) = delete;
+  void operator=(const CompressionDict&) = delete;
+
+  ~CompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeCDict(cdict_);
+#endif
+  }
+
+  const std::string& raw() const {
+    return raw_;
+  }
+
+#ifdef ZSTD
+  const ZSTD_CDict* cdict() const {
+    return cdict_;
+  }
+#endif
+
+ private:
+  std::string raw_;
+#ifdef ZSTD
+  ZSTD_CDict* cdict_ = nullptr;
+#endif
+};
+
+// Dictionary used to compress data blocks of a table, digested by zstd for decompression. It is
+// built once when the table is opened and could be used by concurrent reads.
+class UncompressionDict {
+ public:
+  explicit UncompressionDict(const Slice& raw) {
+#ifdef ZSTD
+    ddict_ = ZSTD_createDDict(raw.data(), raw.size());
+#endif
+  }
+
+  UncompressionDict(const UncompressionDict&) = delete;
+  void operator=(const UncompressionDict&) = delete;
+
+  ~UncompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeDDict(ddict_);
+#endif
+  }
+
+#ifdef ZSTD
+  const ZSTD_DDict* ddict() const {
+    return ddict_;
+  }
+#endif
+
+ private:
+#ifdef ZSTD
+  ZSTD_DDict* ddict_ = nullptr;
+#endif
+};
+
+// compression_dict is a dictionary trained by ZSTD_TrainDictionary, the same dictionary should be
+// passed to ZSTD_Uncompress.
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const CompressionDict* compression_dict = nullptr) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +735,16 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  auto* context = compression::ZSTDCompressionContext();
+  size_t outlen;
+  if (!compression_dict || !compression_dict->cdict()) {
+    outlen = ZSTD_compressCCtx(context, &(*output)[output_header_len], compressBound,
+                               input, length, ZSTD_CompressionLevel(opts));
+  } else {
+    outlen = ZSTD_compress_usingCDict(context, &(*output)[output_header_len], compressBound,
+                                      input, length, compression_dict->cdict());
+  }
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +754,8 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size,
+                             const UncompressionDict* compression_dict = nullptr) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -653,14 +763,43 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
-  char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  std::unique_ptr<char[]> output(new char[output_len]);
+  auto* context = compression::ZSTDDecompressionContext();
+  size_t actual_output_length;
+  if (!compression_dict || !compression_dict->ddict()) {
+    actual_output_length = ZSTD_decompressDCtx(
+        context, output.get(), output_len, input_data, input_length);
+  } else {
+    actual_output_length = ZSTD_decompress_usingDDict(
+        context, output.get(), output_len, input_data, input_length, compression_dict->ddict());
+  }
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
-  return output;
+  return output.release();
 #endif
   return nullptr;
 }
 
+// Trains a zstd dictionary of at most max_dict_bytes from samples, that are stored one after
+// another in samples and have sizes specified in sample_sizes. Returns an empty string if the
+// dictionary could not be trained, e.g. because there are too few samples.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_sizes,
+                                        size_t max_dict_bytes) {
+#ifdef ZSTD
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_len = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(dict_len)) {
+    return std::string();
+  }
+  dict.resize(dict_len);
+  return dict;
+#endif
+  return std::string();
+}
+
 }  // namespace rocksdb
@@ -825,8 +825,19 @@ Status ParseColumnFamilyOption(const std::string& name,
         return STATUS(InvalidArgument,
             "unable to parse the specified CF option " + name);
       }
+      end = value.find(':', start);
       new_options->compression_opts.strategy =
-          ParseInt(value.substr(start, value.size() - start));
+          ParseInt(value.substr(start, end == std::string::npos ? end : end - start));
+      // max_dict_bytes is optional for backwards compatibility.
+      if (end != std::string::npos) {
+        start = end + 1;
+        if (start >= value.size()) {
+          return STATUS(InvalidArgument,
+              "unable to parse the specified CF option " + name);
+        }
+        new_options->compression_opts.max_dict_bytes =
+            ParseUint32(value.substr(start, value.size() - start));
+      }
     } else if (name == "compaction_options_fifo") {
       new_options->compaction_options_fifo.max_table_files_size =
           ParseUint64(value);
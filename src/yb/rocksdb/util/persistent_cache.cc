@@ -0,0 +1,567 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/persistent_cache.h"
+
+#include <inttypes.h>
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/listener.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+#include "yb/rocksdb/util/logging.h"
+#include "yb/rocksdb/util/mutexlock.h"
+
+#include "yb/gutil/stringprintf.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/status_log.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr char kCacheFileSuffix[] = ".pcache";
+
+// Cache file is a sequence of records:
+//   crc32c of the rest of the record   - fixed32
+//   index key size                     - fixed32
+//   SST file path size                 - fixed32
+//   block size                         - fixed32
+//   index key
+//   SST file path
+//   block
+constexpr size_t kRecordHeaderSize = 4 * sizeof(uint32_t);
+
+// Index key is a length prefixed SST file id followed by the block offset, so all blocks of the
+// file share the same index key prefix.
+std::string FileIndexKeyPrefix(const Slice& file_id) {
+  std::string result;
+  PutLengthPrefixedSlice(&result, file_id);
+  return result;
+}
+
+std::string IndexKey(const Slice& file_id, uint64_t offset) {
+  auto result = FileIndexKeyPrefix(file_id);
+  PutVarint64(&result, offset);
+  return result;
+}
+
+Slice ExtractFileIndexKeyPrefix(Slice index_key) {
+  const auto* start = index_key.cdata();
+  Slice file_id;
+  if (!GetLengthPrefixedSlice(&index_key, &file_id)) {
+    return Slice();
+  }
+  return Slice(start, file_id.cend());
+}
+
+void AppendRecord(const Slice& key, const Slice& file_path, const Slice& block,
+                  std::string* buffer) {
+  const auto start = buffer->size();
+  PutFixed32(buffer, 0);
+  PutFixed32(buffer, static_cast<uint32_t>(key.size()));
+  PutFixed32(buffer, static_cast<uint32_t>(file_path.size()));
+  PutFixed32(buffer, static_cast<uint32_t>(block.size()));
+  buffer->append(key.cdata(), key.size());
+  buffer->append(file_path.cdata(), file_path.size());
+  buffer->append(block.cdata(), block.size());
+  const auto crc = crc32c::Value(
+      buffer->data() + start + sizeof(uint32_t), buffer->size() - start - sizeof(uint32_t));
+  EncodeFixed32(&(*buffer)[start], crc);
+}
+
+// Returns the record size specified by the header.
+size_t DecodeRecordSize(const char* header) {
+  return kRecordHeaderSize + DecodeFixed32(header + sizeof(uint32_t)) +
+         DecodeFixed32(header + 2 * sizeof(uint32_t)) +
+         DecodeFixed32(header + 3 * sizeof(uint32_t));
+}
+
+Status DecodeRecord(const Slice& record, Slice* key, Slice* file_path, Slice* block) {
+  if (record.size() < kRecordHeaderSize || DecodeRecordSize(record.cdata()) != record.size()) {
+    return STATUS_FORMAT(Corruption, "Bad persistent cache record size: $0", record.size());
+  }
+  const auto expected_crc = DecodeFixed32(record.cdata());
+  const auto crc = crc32c::Value(
+      record.cdata() + sizeof(uint32_t), record.size() - sizeof(uint32_t));
+  if (crc != expected_crc) {
+    return STATUS_FORMAT(
+        Corruption, "Persistent cache record checksum mismatch: $0 vs $1", crc, expected_crc);
+  }
+  const char* data = record.cdata() + kRecordHeaderSize;
+  const auto key_size = DecodeFixed32(record.cdata() + sizeof(uint32_t));
+  const auto file_path_size = DecodeFixed32(record.cdata() + 2 * sizeof(uint32_t));
+  const auto block_size = DecodeFixed32(record.cdata() + 3 * sizeof(uint32_t));
+  *key = Slice(data, key_size);
+  *file_path = Slice(data + key_size, file_path_size);
+  *block = Slice(data + key_size + file_path_size, block_size);
+  return Status::OK();
+}
+
+struct CacheFile {
+  uint64_t number;
+  std::string path;
+  std::unique_ptr<RandomAccessFile> reader;
+  size_t size = 0;
+  // Index keys of blocks appended to this file, to erase them from the index when this file is
+  // deleted.
+  std::vector<std::string> keys;
+};
+
+typedef std::shared_ptr<CacheFile> CacheFilePtr;
+
+struct BlockLocation {
+  CacheFilePtr file;
+  uint64_t offset;
+  size_t record_size;
+};
+
+struct PendingBlock {
+  std::string key;
+  std::string file_path;
+  std::string block;
+};
+
+class LogStructuredPersistentCache : public PersistentCache {
+ public:
+  explicit LogStructuredPersistentCache(const LogStructuredPersistentCacheOptions& options)
+      : options_(options), cond_(&mutex_) {}
+
+  ~LogStructuredPersistentCache() {
+    {
+      MutexLock lock(&mutex_);
+      stop_ = true;
+      cond_.SignalAll();
+    }
+    if (writer_thread_.joinable()) {
+      writer_thread_.join();
+    }
+    if (writable_file_) {
+      WARN_NOT_OK(writable_file_->Close(), "Failed to close persistent cache file");
+    }
+  }
+
+  Status Open() {
+    RETURN_NOT_OK(options_.env->CreateDirIfMissing(options_.path));
+    RETURN_NOT_OK(Recover());
+    writer_thread_ = std::thread(&LogStructuredPersistentCache::WriterLoop, this);
+    return Status::OK();
+  }
+
+  void Insert(const Slice& file_id, const std::string& file_path, uint64_t offset,
+              const Slice& block) override {
+    PendingBlock pending_block{IndexKey(file_id, offset), file_path, block.ToBuffer()};
+    MutexLock lock(&mutex_);
+    if (stop_ || index_.count(pending_block.key)) {
+      return;
+    }
+    if (pending_bytes_ + block.size() > options_.max_pending_bytes) {
+      if (metrics_) {
+        metrics_->insert_drops->Increment();
+      }
+      return;
+    }
+    pending_bytes_ += block.size();
+    pending_.push_back(std::move(pending_block));
+    cond_.Signal();
+  }
+
+  Status Lookup(const Slice& file_id, const std::string& file_path, uint64_t offset, size_t size,
+                char* buf) override {
+    const auto key = IndexKey(file_id, offset);
+    BlockLocation location;
+    {
+      MutexLock lock(&mutex_);
+      auto it = index_.find(key);
+      if (it == index_.end()) {
+        if (metrics_) {
+          metrics_->misses->Increment();
+        }
+        return STATUS(NotFound, "Block not found in persistent cache");
+      }
+      location = it->second;
+    }
+
+    std::unique_ptr<uint8_t[]> scratch(new uint8_t[location.record_size]);
+    Slice record;
+    Slice record_key, record_file_path, block;
+    auto status = location.file->reader->Read(
+        location.offset, location.record_size, &record, scratch.get());
+    if (status.ok()) {
+      status = DecodeRecord(record, &record_key, &record_file_path, &block);
+    }
+    if (status.ok() && (record_key != key || record_file_path != file_path ||
+                        block.size() != size)) {
+      status = STATUS_FORMAT(
+          Corruption, "Persistent cache record does not match block $0 of $1",
+          offset, file_path);
+    }
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to read block from persistent cache: " << status;
+      MutexLock lock(&mutex_);
+      auto it = index_.find(key);
+      if (it != index_.end() && it->second.file == location.file &&
+          it->second.offset == location.offset) {
+        index_.erase(it);
+      }
+      if (metrics_) {
+        metrics_->misses->Increment();
+      }
+      return status;
+    }
+
+    memcpy(buf, block.data(), size);
+    if (metrics_) {
+      metrics_->hits->Increment();
+    }
+    return Status::OK();
+  }
+
+  void EraseFile(const std::string& file_path) override {
+    MutexLock lock(&mutex_);
+    auto it = file_key_prefix_by_path_.find(file_path);
+    if (it == file_key_prefix_by_path_.end()) {
+      return;
+    }
+    EraseFromIndex(it->second);
+    file_key_prefix_by_path_.erase(it);
+  }
+
+  void EraseDirectory(const std::string& dir_path) override {
+    const auto dir_prefix = dir_path + "/";
+    MutexLock lock(&mutex_);
+    for (auto it = file_key_prefix_by_path_.begin(); it != file_key_prefix_by_path_.end();) {
+      if (Slice(it->first).starts_with(dir_prefix)) {
+        EraseFromIndex(it->second);
+        it = file_key_prefix_by_path_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  size_t GetUsage() const override {
+    MutexLock lock(&mutex_);
+    return usage_;
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    auto metrics = std::make_shared<yb::PersistentCacheMetrics>(entity);
+    MutexLock lock(&mutex_);
+    metrics_ = std::move(metrics);
+    metrics_->usage->set_value(usage_);
+  }
+
+ private:
+  std::string CacheFileName(uint64_t number) const {
+    return StringPrintf("%s/%010" PRIu64 "%s", options_.path.c_str(), number, kCacheFileSuffix);
+  }
+
+  Status Recover();
+  Status RecoverFile(uint64_t number, std::unordered_map<std::string, bool>* sst_exists);
+  void WriterLoop();
+  Status WriteBlocks(std::deque<PendingBlock>* blocks);
+  Status NewFile();
+
+  // REQUIRES: mutex_ is held.
+  void EraseFromIndex(const std::string& file_key_prefix) {
+    const Slice prefix(file_key_prefix);
+    auto index_it = index_.lower_bound(file_key_prefix);
+    while (index_it != index_.end() && Slice(index_it->first).starts_with(prefix)) {
+      index_it = index_.erase(index_it);
+    }
+  }
+
+  // REQUIRES: mutex_ is held.
+  void AddToIndex(const std::string& key, const std::string& file_path, BlockLocation location);
+  void DeleteOldestFile();
+  void UpdateUsage(int64_t delta);
+
+  const LogStructuredPersistentCacheOptions options_;
+
+  mutable port::Mutex mutex_;
+  port::CondVar cond_;
+  std::map<std::string, BlockLocation> index_;
+  std::unordered_map<std::string, std::string> file_key_prefix_by_path_;
+  std::deque<CacheFilePtr> files_;
+  size_t usage_ = 0;
+  std::deque<PendingBlock> pending_;
+  size_t pending_bytes_ = 0;
+  bool stop_ = false;
+  std::shared_ptr<yb::PersistentCacheMetrics> metrics_;
+
+  std::thread writer_thread_;
+
+  // Accessed only by the writer thread, after Open.
+  CacheFilePtr current_file_;
+  std::unique_ptr<WritableFile> writable_file_;
+  uint64_t next_file_number_ = 1;
+};
+
+Status LogStructuredPersistentCache::Recover() {
+  std::vector<std::string> children;
+  RETURN_NOT_OK(options_.env->GetChildren(options_.path, &children));
+  std::vector<uint64_t> numbers;
+  for (const auto& child : children) {
+    const Slice name(child);
+    if (!name.ends_with(kCacheFileSuffix)) {
+      continue;
+    }
+    Slice number_str(name.data(), name.size() - strlen(kCacheFileSuffix));
+    uint64_t number = 0;
+    if (ConsumeDecimalNumber(&number_str, &number) && number_str.empty()) {
+      numbers.push_back(number);
+    }
+  }
+  std::sort(numbers.begin(), numbers.end());
+
+  std::unordered_map<std::string, bool> sst_exists;
+  for (auto number : numbers) {
+    auto status = RecoverFile(number, &sst_exists);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to recover persistent cache file " << CacheFileName(number)
+                   << ": " << status;
+      WARN_NOT_OK(options_.env->DeleteFile(CacheFileName(number)),
+                  "Failed to delete persistent cache file");
+    }
+    next_file_number_ = number + 1;
+  }
+
+  MutexLock lock(&mutex_);
+  while (!files_.empty() && usage_ > options_.capacity) {
+    DeleteOldestFile();
+  }
+  LOG(INFO) << "Recovered persistent cache at " << options_.path << ": " << index_.size()
+            << " blocks in " << files_.size() << " files, " << usage_ << " bytes";
+  return Status::OK();
+}
+
+Status LogStructuredPersistentCache::RecoverFile(
+    uint64_t number, std::unordered_map<std::string, bool>* sst_exists) {
+  auto file = std::make_shared<CacheFile>();
+  file->number = number;
+  file->path = CacheFileName(number);
+  uint64_t file_size = 0;
+  RETURN_NOT_OK(options_.env->GetFileSize(file->path, &file_size));
+  std::unique_ptr<SequentialFile> reader;
+  RETURN_NOT_OK(options_.env->NewSequentialFile(file->path, &reader, EnvOptions()));
+  RETURN_NOT_OK(options_.env->NewRandomAccessFile(file->path, &file->reader, EnvOptions()));
+
+  MutexLock lock(&mutex_);
+  std::string record;
+  uint8_t header_buf[kRecordHeaderSize];
+  // Records are read until the end of the file or the first record that was not fully written.
+  for (;;) {
+    Slice header;
+    RETURN_NOT_OK(reader->Read(kRecordHeaderSize, &header, header_buf));
+    if (header.size() < kRecordHeaderSize) {
+      break;
+    }
+    const auto record_size = DecodeRecordSize(header.cdata());
+    if (file->size + record_size > file_size) {
+      break;
+    }
+    record.resize(record_size);
+    memcpy(&record[0], header.data(), kRecordHeaderSize);
+    Slice body;
+    auto* body_buf = reinterpret_cast<uint8_t*>(&record[kRecordHeaderSize]);
+    RETURN_NOT_OK(reader->Read(record_size - kRecordHeaderSize, &body, body_buf));
+    if (body.size() != record_size - kRecordHeaderSize) {
+      break;
+    }
+    if (body.data() != body_buf) {
+      memcpy(body_buf, body.data(), body.size());
+    }
+    Slice key, file_path, block;
+    if (!DecodeRecord(record, &key, &file_path, &block).ok()) {
+      break;
+    }
+
+    // Blocks of SST files that were deleted while the server was down are dropped.
+    auto path = file_path.ToBuffer();
+    auto exists_it = sst_exists->find(path);
+    if (exists_it == sst_exists->end()) {
+      exists_it = sst_exists->emplace(path, options_.env->FileExists(path).ok()).first;
+    }
+    if (exists_it->second) {
+      AddToIndex(key.ToBuffer(), path, BlockLocation{file, file->size, record_size});
+    }
+    file->size += record_size;
+  }
+
+  files_.push_back(file);
+  UpdateUsage(file->size);
+  return Status::OK();
+}
+
+void LogStructuredPersistentCache::WriterLoop() {
+  std::deque<PendingBlock> blocks;
+  for (;;) {
+    {
+      MutexLock lock(&mutex_);
+      while (pending_.empty() && !stop_) {
+        cond_.Wait();
+      }
+      if (stop_) {
+        return;
+      }
+      blocks.swap(pending_);
+      pending_bytes_ = 0;
+    }
+    auto status = WriteBlocks(&blocks);
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to write blocks to persistent cache: " << status;
+      // Start a new file after the failure, since the current one could contain a partially
+      // written record.
+      current_file_.reset();
+    }
+    blocks.clear();
+  }
+}
+
+Status LogStructuredPersistentCache::WriteBlocks(std::deque<PendingBlock>* blocks) {
+  struct AppendedBlock {
+    const PendingBlock* block;
+    uint64_t offset;
+    size_t record_size;
+  };
+  std::string buffer;
+  std::vector<AppendedBlock> appended;
+  auto it = blocks->begin();
+  while (it != blocks->end()) {
+    if (!current_file_ || current_file_->size >= options_.file_size) {
+      RETURN_NOT_OK(NewFile());
+    }
+    buffer.clear();
+    appended.clear();
+    // Only the writer thread changes the size of the current file.
+    const auto file_offset = current_file_->size;
+    while (it != blocks->end() && file_offset + buffer.size() < options_.file_size) {
+      const auto record_start = buffer.size();
+      AppendRecord(it->key, it->file_path, it->block, &buffer);
+      appended.push_back(AppendedBlock{&*it, file_offset + record_start,
+                                       buffer.size() - record_start});
+      ++it;
+    }
+    RETURN_NOT_OK(writable_file_->Append(buffer));
+    RETURN_NOT_OK(writable_file_->Flush());
+
+    MutexLock lock(&mutex_);
+    current_file_->size += buffer.size();
+    UpdateUsage(buffer.size());
+    for (const auto& appended_block : appended) {
+      AddToIndex(appended_block.block->key, appended_block.block->file_path,
+                 BlockLocation{current_file_, appended_block.offset, appended_block.record_size});
+    }
+    if (metrics_) {
+      metrics_->inserts->IncrementBy(appended.size());
+    }
+  }
+  return Status::OK();
+}
+
+Status LogStructuredPersistentCache::NewFile() {
+  if (writable_file_) {
+    RETURN_NOT_OK(writable_file_->Close());
+    writable_file_.reset();
+  }
+  auto file = std::make_shared<CacheFile>();
+  file->number = next_file_number_++;
+  file->path = CacheFileName(file->number);
+  RETURN_NOT_OK(options_.env->NewWritableFile(file->path, &writable_file_, EnvOptions()));
+  // Encrypted environment writes the file header on creation, it should be visible to the reader.
+  RETURN_NOT_OK(writable_file_->Flush());
+  RETURN_NOT_OK(options_.env->NewRandomAccessFile(file->path, &file->reader, EnvOptions()));
+
+  MutexLock lock(&mutex_);
+  // Free space for the new file.
+  while (!files_.empty() && usage_ + options_.file_size > options_.capacity) {
+    DeleteOldestFile();
+  }
+  files_.push_back(file);
+  current_file_ = std::move(file);
+  return Status::OK();
+}
+
+void LogStructuredPersistentCache::AddToIndex(
+    const std::string& key, const std::string& file_path, BlockLocation location) {
+  location.file->keys.push_back(key);
+  index_[key] = std::move(location);
+  file_key_prefix_by_path_[file_path] = ExtractFileIndexKeyPrefix(key).ToBuffer();
+}
+
+void LogStructuredPersistentCache::DeleteOldestFile() {
+  auto file = std::move(files_.front());
+  files_.pop_front();
+  for (const auto& key : file->keys) {
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second.file == file) {
+      index_.erase(it);
+    }
+  }
+  UpdateUsage(-static_cast<int64_t>(file->size));
+  // Readers that are still holding the file could continue reading it after deletion.
+  WARN_NOT_OK(options_.env->DeleteFile(file->path), "Failed to delete persistent cache file");
+}
+
+void LogStructuredPersistentCache::UpdateUsage(int64_t delta) {
+  usage_ += delta;
+  if (metrics_) {
+    metrics_->usage->set_value(usage_);
+  }
+}
+
+class FileDeletionListener : public EventListener {
+ public:
+  explicit FileDeletionListener(std::shared_ptr<PersistentCache> cache)
+      : cache_(std::move(cache)) {}
+
+  void OnTableFileDeleted(const TableFileDeletionInfo& info) override {
+    // Data blocks are read from the data file, and the rest from the base file.
+    cache_->EraseFile(info.file_path);
+    cache_->EraseFile(TableBaseToDataFileName(info.file_path));
+  }
+
+ private:
+  std::shared_ptr<PersistentCache> cache_;
+};
+
+} // namespace
+
+Status NewLogStructuredPersistentCache(
+    const LogStructuredPersistentCacheOptions& options, std::shared_ptr<PersistentCache>* result) {
+  auto cache = std::make_shared<LogStructuredPersistentCache>(options);
+  RETURN_NOT_OK(cache->Open());
+  *result = std::move(cache);
+  return Status::OK();
+}
+
+std::shared_ptr<EventListener> NewPersistentCacheFileDeletionListener(
+    std::shared_ptr<PersistentCache> cache) {
+  return std::make_shared<FileDeletionListener>(std::move(cache));
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,214 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/persistent_cache.h"
+#include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
+
+#include "yb/util/test_macros.h"
+
+namespace rocksdb {
+
+namespace {
+
+constexpr size_t kBlockSize = 4096;
+constexpr int kWaitIterations = 1000;
+constexpr int kWaitIntervalMicros = 10000;
+
+std::string MakeBlock(int index) {
+  return std::string(kBlockSize, static_cast<char>('a' + index % 26));
+}
+
+}  // namespace
+
+class PersistentCacheTest : public RocksDBTest {
+ protected:
+  void SetUp() override {
+    RocksDBTest::SetUp();
+    env_ = Env::Default();
+    dir_ = test::TmpDir(env_) + "/persistent_cache_test";
+    cache_dir_ = dir_ + "/cache";
+    DestroyDir(cache_dir_);
+    DestroyDir(dir_);
+    ASSERT_OK(env_->CreateDirIfMissing(dir_));
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    DestroyDir(cache_dir_);
+    DestroyDir(dir_);
+    RocksDBTest::TearDown();
+  }
+
+  void DestroyDir(const std::string& dir) {
+    std::vector<std::string> children;
+    if (!env_->GetChildren(dir, &children).ok()) {
+      return;
+    }
+    for (const auto& child : children) {
+      if (child != "." && child != "..") {
+        env_->DeleteFile(dir + "/" + child);
+      }
+    }
+    env_->DeleteDir(dir);
+  }
+
+  void OpenCache(size_t capacity = 16 * kBlockSize * 100) {
+    cache_.reset();
+    LogStructuredPersistentCacheOptions options;
+    options.env = env_;
+    options.path = cache_dir_;
+    options.capacity = capacity;
+    options.file_size = 16 * kBlockSize;
+    ASSERT_OK(NewLogStructuredPersistentCache(options, &cache_));
+  }
+
+  // Creates a fake SST file, the cache checks that it exists during recovery.
+  std::string CreateSstFile(const std::string& name) {
+    const auto path = dir_ + "/" + name;
+    EXPECT_OK(WriteStringToFile(env_, "sst", path));
+    return path;
+  }
+
+  Status Lookup(const std::string& file_id, const std::string& path, uint64_t offset,
+                std::string* block) {
+    block->resize(kBlockSize);
+    return cache_->Lookup(file_id, path, offset, kBlockSize, &(*block)[0]);
+  }
+
+  // Blocks are written in background, so waits until the block becomes available.
+  bool WaitForBlock(const std::string& file_id, const std::string& path, uint64_t offset) {
+    std::string block;
+    for (int i = 0; i != kWaitIterations; ++i) {
+      if (Lookup(file_id, path, offset, &block).ok()) {
+        return true;
+      }
+      env_->SleepForMicroseconds(kWaitIntervalMicros);
+    }
+    return false;
+  }
+
+  Env* env_ = nullptr;
+  std::string dir_;
+  std::string cache_dir_;
+  std::shared_ptr<PersistentCache> cache_;
+};
+
+TEST_F(PersistentCacheTest, InsertLookup) {
+  OpenCache();
+  const auto path = CreateSstFile("000001.sst");
+  for (int i = 0; i != 10; ++i) {
+    cache_->Insert("file1", path, i * kBlockSize, MakeBlock(i));
+  }
+  ASSERT_TRUE(WaitForBlock("file1", path, 9 * kBlockSize));
+
+  std::string block;
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_OK(Lookup("file1", path, i * kBlockSize, &block));
+    ASSERT_EQ(MakeBlock(i), block);
+  }
+  ASSERT_TRUE(Lookup("file2", path, 0, &block).IsNotFound());
+  ASSERT_TRUE(Lookup("file1", path, 10 * kBlockSize, &block).IsNotFound());
+  // Block with a different size or file path is not returned.
+  ASSERT_NOK(cache_->Lookup("file1", path, 0, kBlockSize / 2, &block[0]));
+  ASSERT_NOK(Lookup("file1", dir_ + "/000002.sst", 0, &block));
+  ASSERT_GE(cache_->GetUsage(), 10 * kBlockSize);
+}
+
+TEST_F(PersistentCacheTest, Recover) {
+  OpenCache();
+  const auto path1 = CreateSstFile("000001.sst");
+  const auto path2 = CreateSstFile("000002.sst");
+  for (int i = 0; i != 5; ++i) {
+    cache_->Insert("file1", path1, i * kBlockSize, MakeBlock(i));
+    cache_->Insert("file2", path2, i * kBlockSize, MakeBlock(i + 5));
+  }
+  ASSERT_TRUE(WaitForBlock("file1", path1, 4 * kBlockSize));
+  ASSERT_TRUE(WaitForBlock("file2", path2, 4 * kBlockSize));
+
+  // Blocks of the file deleted while the cache was closed are dropped during recovery.
+  cache_.reset();
+  ASSERT_OK(env_->DeleteFile(path2));
+  OpenCache();
+
+  std::string block;
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_OK(Lookup("file1", path1, i * kBlockSize, &block));
+    ASSERT_EQ(MakeBlock(i), block);
+    ASSERT_TRUE(Lookup("file2", path2, i * kBlockSize, &block).IsNotFound());
+  }
+}
+
+TEST_F(PersistentCacheTest, EraseFile) {
+  OpenCache();
+  const auto path1 = CreateSstFile("000001.sst");
+  const auto path2 = CreateSstFile("000002.sst");
+  cache_->Insert("file1", path1, 0, MakeBlock(1));
+  cache_->Insert("file2", path2, 0, MakeBlock(2));
+  ASSERT_TRUE(WaitForBlock("file1", path1, 0));
+  ASSERT_TRUE(WaitForBlock("file2", path2, 0));
+
+  cache_->EraseFile(path1);
+  std::string block;
+  ASSERT_TRUE(Lookup("file1", path1, 0, &block).IsNotFound());
+  ASSERT_OK(Lookup("file2", path2, 0, &block));
+  ASSERT_EQ(MakeBlock(2), block);
+}
+
+TEST_F(PersistentCacheTest, EraseDirectory) {
+  OpenCache();
+  ASSERT_OK(env_->CreateDirIfMissing(dir_ + "/tablet1"));
+  ASSERT_OK(env_->CreateDirIfMissing(dir_ + "/tablet1.intents"));
+  const auto path1 = CreateSstFile("tablet1/000001.sst");
+  const auto path2 = CreateSstFile("tablet1.intents/000001.sst");
+  cache_->Insert("file1", path1, 0, MakeBlock(1));
+  cache_->Insert("file2", path2, 0, MakeBlock(2));
+  ASSERT_TRUE(WaitForBlock("file1", path1, 0));
+  ASSERT_TRUE(WaitForBlock("file2", path2, 0));
+
+  // Directory with the same name prefix is not affected.
+  cache_->EraseDirectory(dir_ + "/tablet1");
+  std::string block;
+  ASSERT_TRUE(Lookup("file1", path1, 0, &block).IsNotFound());
+  ASSERT_OK(Lookup("file2", path2, 0, &block));
+  ASSERT_EQ(MakeBlock(2), block);
+}
+
+TEST_F(PersistentCacheTest, Capacity) {
+  // Cache fits 2 files, so the oldest files are deleted with their blocks.
+  OpenCache(/* capacity= */ 32 * kBlockSize);
+  const auto path = CreateSstFile("000001.sst");
+  constexpr int kNumBlocks = 100;
+  for (int i = 0; i != kNumBlocks; ++i) {
+    cache_->Insert("file1", path, i * kBlockSize, MakeBlock(i));
+    ASSERT_TRUE(WaitForBlock("file1", path, i * kBlockSize));
+  }
+  std::string block;
+  ASSERT_TRUE(Lookup("file1", path, 0, &block).IsNotFound());
+  ASSERT_OK(Lookup("file1", path, (kNumBlocks - 1) * kBlockSize, &block));
+  ASSERT_LE(cache_->GetUsage(), 32 * kBlockSize + kBlockSize * 2);
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
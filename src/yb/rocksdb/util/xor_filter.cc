@@ -0,0 +1,288 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "yb/rocksdb/filter_policy.h"
+
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/hash.h"
+
+#include "yb/util/logging.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+typedef FilterPolicy::FilterType FilterType;
+
+namespace {
+
+// Xor filter with 8-bit fingerprints, see "Xor Filters: Faster and Smaller Than Bloom and Cuckoo
+// Filters" by Graf and Lemire (https://arxiv.org/abs/1912.08258).
+//
+// Each key is mapped to 3 cells, one in each third of the fingerprint array, and the filter is
+// built so that xor of those 3 cells is equal to the fingerprint of the key. The array holds
+// 1.23 * n + 32 cells, so false positive rate is 1/256 at about 9.84 bits per key. A bloom filter
+// needs about 11.5 bits per key for the same false positive rate.
+//
+// Encoding:
+//   fingerprints                 - 3 * block_length bytes
+//   seed                         - fixed64
+//   block_length                 - fixed32
+//
+// Filter with a block_length that does not match its size is treated as matching all keys, that
+// is used when the filter could not be constructed.
+constexpr size_t kSlackCells = 32;
+constexpr double kCellsPerKey = 1.23;
+constexpr size_t kMetaDataSize = sizeof(uint64_t) + sizeof(uint32_t);
+constexpr uint32_t kMatchAllBlockLength = std::numeric_limits<uint32_t>::max();
+constexpr int kMaxConstructionAttempts = 100;
+
+inline uint64_t KeyHash(const Slice& key) {
+  return (static_cast<uint64_t>(BloomHash(key)) << 32) | Hash(key.data(), key.size(), 0x2c7f4a1b);
+}
+
+// Finalizer of MurmurHash3, mixes the key hash with seed of a construction attempt.
+inline uint64_t MixHash(uint64_t hash, uint64_t seed) {
+  hash += seed;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+inline uint32_t Reduce(uint32_t hash, uint32_t n) {
+  return static_cast<uint32_t>((static_cast<uint64_t>(hash) * n) >> 32);
+}
+
+inline uint64_t RotateLeft(uint64_t value, int shift) {
+  return (value << shift) | (value >> (64 - shift));
+}
+
+inline uint8_t Fingerprint(uint64_t hash) {
+  return static_cast<uint8_t>(hash ^ (hash >> 32));
+}
+
+inline void GetCells(uint64_t hash, uint32_t block_length, uint32_t* cells) {
+  cells[0] = Reduce(static_cast<uint32_t>(hash), block_length);
+  cells[1] = Reduce(static_cast<uint32_t>(RotateLeft(hash, 21)), block_length) + block_length;
+  cells[2] = Reduce(static_cast<uint32_t>(RotateLeft(hash, 42)), block_length) + 2 * block_length;
+}
+
+// Xor filter could not be constructed incrementally, so the builder collects key hashes and builds
+// the filter in Finish.
+class FixedSizeXorFilterBitsBuilder : public FilterBitsBuilder {
+ public:
+  FixedSizeXorFilterBitsBuilder(const FixedSizeXorFilterBitsBuilder&) = delete;
+  void operator=(const FixedSizeXorFilterBitsBuilder&) = delete;
+
+  explicit FixedSizeXorFilterBitsBuilder(size_t total_bits) {
+    DCHECK_GT(total_bits, 0);
+    const size_t total_cells = total_bits / 8;
+    max_keys_ = total_cells > kSlackCells
+        ? static_cast<size_t>((total_cells - kSlackCells) / kCellsPerKey) : 0;
+    max_keys_ = std::max<size_t>(max_keys_, 1);
+    hashes_.reserve(max_keys_);
+  }
+
+  void AddKey(const Slice& key) override {
+    hashes_.push_back(KeyHash(key));
+  }
+
+  bool IsFull() const override { return hashes_.size() >= max_keys_; }
+
+  Slice Finish(std::unique_ptr<const char[]>* buf) override;
+
+ private:
+  // Tries to build the filter with specified seed, returns false if it is not possible.
+  bool TryBuild(uint64_t seed, uint32_t block_length, char* fingerprints);
+
+  size_t max_keys_;
+  std::vector<uint64_t> hashes_;
+};
+
+Slice FixedSizeXorFilterBitsBuilder::Finish(std::unique_ptr<const char[]>* buf) {
+  // Keys may be duplicated, and the same hash could not be mapped to a cell of its own.
+  std::sort(hashes_.begin(), hashes_.end());
+  hashes_.erase(std::unique(hashes_.begin(), hashes_.end()), hashes_.end());
+
+  const size_t num_keys = hashes_.size();
+  uint32_t block_length = 0;
+  if (num_keys != 0) {
+    block_length = static_cast<uint32_t>(
+        (kSlackCells + static_cast<size_t>(std::ceil(kCellsPerKey * num_keys))) / 3);
+  }
+  const size_t array_length = 3 * static_cast<size_t>(block_length);
+
+  std::unique_ptr<char[]> data(new char[array_length + kMetaDataSize]);
+  uint64_t seed = 0;
+  bool built = num_keys == 0;
+  for (int attempt = 0; !built && attempt != kMaxConstructionAttempts; ++attempt) {
+    seed = MixHash(attempt, 0x9e3779b97f4a7c15ULL);
+    built = TryBuild(seed, block_length, data.get());
+  }
+  size_t filter_size = array_length + kMetaDataSize;
+  if (!built) {
+    LOG(DFATAL) << "Failed to build xor filter for " << num_keys << " keys";
+    block_length = kMatchAllBlockLength;
+    filter_size = kMetaDataSize;
+  }
+  EncodeFixed64(data.get() + filter_size - kMetaDataSize, seed);
+  EncodeFixed32(data.get() + filter_size - kMetaDataSize + sizeof(uint64_t), block_length);
+
+  hashes_.clear();
+  buf->reset(data.release());
+  return Slice(buf->get(), filter_size);
+}
+
+bool FixedSizeXorFilterBitsBuilder::TryBuild(
+    uint64_t seed, uint32_t block_length, char* fingerprints) {
+  const size_t array_length = 3 * static_cast<size_t>(block_length);
+  // For each cell: xor of hashes of keys mapped to it and their number.
+  std::vector<uint64_t> xor_masks(array_length);
+  std::vector<uint32_t> counts(array_length);
+  uint32_t cells[3];
+  for (auto hash : hashes_) {
+    hash = MixHash(hash, seed);
+    GetCells(hash, block_length, cells);
+    for (auto cell : cells) {
+      xor_masks[cell] ^= hash;
+      ++counts[cell];
+    }
+  }
+
+  // Peel keys that are the only ones mapped to some cell. Such key could get any fingerprint
+  // assigned to this cell after the rest of the keys are assigned, so it is pushed to the stack.
+  std::vector<uint32_t> queue;
+  queue.reserve(array_length);
+  for (uint32_t cell = 0; cell != array_length; ++cell) {
+    if (counts[cell] == 1) {
+      queue.push_back(cell);
+    }
+  }
+  std::vector<std::pair<uint64_t, uint32_t>> stack;
+  stack.reserve(hashes_.size());
+  while (!queue.empty()) {
+    const auto cell = queue.back();
+    queue.pop_back();
+    if (counts[cell] != 1) {
+      continue;
+    }
+    const auto hash = xor_masks[cell];
+    stack.emplace_back(hash, cell);
+    GetCells(hash, block_length, cells);
+    for (auto key_cell : cells) {
+      xor_masks[key_cell] ^= hash;
+      if (--counts[key_cell] == 1) {
+        queue.push_back(key_cell);
+      }
+    }
+  }
+
+  if (stack.size() != hashes_.size()) {
+    return false;
+  }
+
+  std::fill_n(fingerprints, array_length, 0);
+  for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+    GetCells(it->first, block_length, cells);
+    // Cell that is assigned by this key is still zero here.
+    fingerprints[it->second] = static_cast<char>(
+        Fingerprint(it->first) ^ fingerprints[cells[0]] ^ fingerprints[cells[1]] ^
+        fingerprints[cells[2]]);
+  }
+  return true;
+}
+
+class FixedSizeXorFilterBitsReader : public FilterBitsReader {
+ public:
+  FixedSizeXorFilterBitsReader(const FixedSizeXorFilterBitsReader&) = delete;
+  void operator=(const FixedSizeXorFilterBitsReader&) = delete;
+
+  explicit FixedSizeXorFilterBitsReader(const Slice& contents)
+      : fingerprints_(contents.cdata()) {
+    if (contents.size() < kMetaDataSize) {
+      return;
+    }
+    const char* meta_data = contents.cdata() + contents.size() - kMetaDataSize;
+    seed_ = DecodeFixed64(meta_data);
+    block_length_ = DecodeFixed32(meta_data + sizeof(uint64_t));
+    match_all_ = 3 * static_cast<uint64_t>(block_length_) + kMetaDataSize != contents.size();
+  }
+
+  bool MayMatch(const Slice& entry) override {
+    if (match_all_) {
+      return true;
+    }
+    if (block_length_ == 0) {
+      // Empty filter.
+      return false;
+    }
+    const auto hash = MixHash(KeyHash(entry), seed_);
+    uint32_t cells[3];
+    GetCells(hash, block_length_, cells);
+    return Fingerprint(hash) == static_cast<uint8_t>(
+        fingerprints_[cells[0]] ^ fingerprints_[cells[1]] ^ fingerprints_[cells[2]]);
+  }
+
+ private:
+  const char* fingerprints_;
+  uint64_t seed_ = 0;
+  uint32_t block_length_ = 0;
+  bool match_all_ = true;
+};
+
+class FixedSizeXorFilterPolicy : public FilterPolicy {
+ public:
+  explicit FixedSizeXorFilterPolicy(size_t total_bits) : total_bits_(total_bits) {}
+
+  FilterType GetFilterType() const override { return FilterType::kFixedSizeFilter; }
+
+  const char* Name() const override {
+    return "rocksdb.FixedSizeXorFilter";
+  }
+
+  // Not used in FixedSizeFilter. GetFilterBitsBuilder/Reader interface should be used.
+  void CreateFilter(const Slice* keys, int n, std::string* dst) const override {
+    assert(!"FixedSizeXorFilterPolicy::CreateFilter is not supported");
+  }
+
+  bool KeyMayMatch(const Slice& key, const Slice& filter) const override {
+    assert(!"FixedSizeXorFilterPolicy::KeyMayMatch is not supported");
+    return true;
+  }
+
+  FilterBitsBuilder* GetFilterBitsBuilder() const override {
+    return new FixedSizeXorFilterBitsBuilder(total_bits_);
+  }
+
+  FilterBitsReader* GetFilterBitsReader(const Slice& contents) const override {
+    return new FixedSizeXorFilterBitsReader(contents);
+  }
+
+ private:
+  size_t total_bits_;
+};
+
+}  // namespace
+
+const FilterPolicy* NewFixedSizeXorFilterPolicy(size_t total_bits) {
+  return new FixedSizeXorFilterPolicy(total_bits);
+}
+
+}  // namespace rocksdb
@@ -212,12 +212,21 @@ void OutboundCall::NotifyTransferred(const Status& status, Connection* conn) {
 
 void OutboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>* output) {
   output->push_back(std::move(buffer_));
+  for (auto& buffer : request_tail_) {
+    output->push_back(std::move(buffer));
+  }
+  request_tail_.clear();
   buffer_consumption_ = ScopedTrackedConsumption();
 }
 
 Status OutboundCall::SetRequestParam(AnyMessageConstPtr req, const MemTrackerPtr& mem_tracker) {
+  request_tail_ = std::move(controller_->request_tail_);
+  size_t tail_size = 0;
+  for (const auto& buffer : request_tail_) {
+    tail_size += buffer.size();
+  }
   auto req_size = req.SerializedSize();
-  size_t message_size = SerializedMessageSize(req_size, 0);
+  size_t message_size = SerializedMessageSize(req_size, tail_size);
 
   using Output = google::protobuf::io::CodedOutputStream;
   auto timeout_ms = VERIFY_RESULT(TimeoutMs());
@@ -238,7 +247,8 @@ Status OutboundCall::SetRequestParam(AnyMessageConstPtr req, const MemTrackerPtr
 
   // 1. The length for the whole request, not including the 4-byte
   // length prefix.
-  NetworkByteOrder::Store32(dst, narrow_cast<uint32_t>(total_size - kMsgLengthPrefixLength));
+  NetworkByteOrder::Store32(
+      dst, narrow_cast<uint32_t>(total_size + tail_size - kMsgLengthPrefixLength));
   dst += sizeof(uint32_t);
 
   // 2. The varint-prefixed RequestHeader PB
@@ -255,9 +265,9 @@ Status OutboundCall::SetRequestParam(AnyMessageConstPtr req, const MemTrackerPtr
   if (mem_tracker) {
     buffer_consumption_ = ScopedTrackedConsumption(mem_tracker, buffer_.size());
   }
-  RETURN_NOT_OK(SerializeMessage(req, req_size, buffer_, 0, header_size));
+  RETURN_NOT_OK(SerializeMessage(req, req_size, buffer_, tail_size, header_size));
   if (method_metrics_) {
-    IncrementCounterBy(method_metrics_->request_bytes, buffer_.size());
+    IncrementCounterBy(method_metrics_->request_bytes, buffer_.size() + tail_size);
   }
   return Status::OK();
 }
@@ -411,6 +411,9 @@ class OutboundCall : public RpcCall {
   // Consumption of buffer_.
   ScopedTrackedConsumption buffer_consumption_;
 
+  // Encoded fields of the request, sent after buffer_. See RpcController::set_request_tail.
+  std::vector<RefCntBuffer> request_tail_;
+
   // Once a response has been received for this call, contains that response.
   CallResponse call_response_;
 
@@ -72,6 +72,7 @@ void RpcController::Swap(RpcController* other) {
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
   std::swap(invoke_callback_mode_, other->invoke_callback_mode_);
+  std::swap(request_tail_, other->request_tail_);
 }
 
 void RpcController::Reset() {
@@ -80,6 +81,7 @@ void RpcController::Reset() {
     CHECK(finished());
   }
   call_.reset();
+  request_tail_.clear();
 }
 
 bool RpcController::finished() const {
@@ -33,6 +33,7 @@
 #define YB_RPC_RPC_CONTROLLER_H
 
 #include <memory>
+#include <vector>
 
 #include <glog/logging.h>
 
@@ -40,6 +41,7 @@
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status_fwd.h"
 
 namespace yb {
@@ -141,6 +143,13 @@ class RpcController {
   // Return the configured timeout.
   MonoDelta timeout() const;
 
+  // Sets buffers with already encoded fields of the request message. They are sent after the
+  // serialized request without copying, so the receiver parses them as part of the request.
+  // Applies only to the next call made with this controller, not supported for local calls.
+  void set_request_tail(std::vector<RefCntBuffer> tail) {
+    request_tail_ = std::move(tail);
+  }
+
   // Returns the slice pointing to the i-th sidecar upon success.
   //
   // Should only be called if the call's finished, but the controller has not
@@ -153,6 +162,7 @@ class RpcController {
 
  private:
   friend class OutboundCall;
+  friend class LocalOutboundCall;
   friend class Proxy;
 
   MonoDelta timeout_;
@@ -164,6 +174,9 @@ class RpcController {
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPoolNormal;
 
+  // Moved to the call when request is serialized.
+  std::vector<RefCntBuffer> request_tail_;
+
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
 
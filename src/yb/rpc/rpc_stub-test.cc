@@ -837,6 +837,32 @@ TEST_F(RpcStubTest, ExpireInQueue) {
   latch.Wait();
 }
 
+// Fields sent in the request tail are parsed as part of the request, overriding the value of the
+// non repeated field set in the request itself.
+TEST_F(RpcStubTest, RequestTail) {
+  CalculatorServiceProxy proxy(proxy_cache_.get(), server_hostport_);
+
+  std::vector<RefCntBuffer> tail;
+  for (const auto* data : {"first tail", "second tail"}) {
+    rpc_test::EchoRequestPB tail_req;
+    tail_req.set_data(data);
+    tail.emplace_back(tail_req.SerializeAsString());
+  }
+
+  RpcController controller;
+  controller.set_request_tail(std::move(tail));
+  rpc_test::EchoRequestPB req;
+  req.set_data("request");
+  rpc_test::EchoResponsePB resp;
+  ASSERT_OK(proxy.Echo(req, &resp, &controller));
+  ASSERT_EQ("second tail", resp.data());
+
+  // Tail is used only by one call.
+  controller.Reset();
+  ASSERT_OK(proxy.Echo(req, &resp, &controller));
+  ASSERT_EQ("request", resp.data());
+}
+
 TEST_F(RpcStubTest, TrafficMetrics) {
   constexpr size_t kStringLen = 1_KB;
   constexpr size_t kUpperBytesLimit = kStringLen + 64;
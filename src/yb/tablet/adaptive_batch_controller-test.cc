@@ -0,0 +1,112 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/adaptive_batch_controller.h"
+
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int64(adaptive_group_replicate_target_latency_us);
+DECLARE_uint64(adaptive_group_replicate_max_batch_size);
+DECLARE_int64(adaptive_group_replicate_max_delay_us);
+
+namespace yb {
+namespace tablet {
+
+class AdaptiveBatchControllerTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_max_group_replicate_batch_size = 16;
+    FLAGS_adaptive_group_replicate_target_latency_us = 1000;
+    FLAGS_adaptive_group_replicate_max_batch_size = 64;
+    FLAGS_adaptive_group_replicate_max_delay_us = 400;
+  }
+
+  // Submits num_ops operations arriving with the specified interval.
+  void Submit(AdaptiveBatchController* controller, int num_ops, CoarseDuration interval) {
+    for (int i = 0; i != num_ops; ++i) {
+      now_ += interval;
+      controller->OperationSubmitted(now_);
+    }
+  }
+
+  CoarseTimePoint now_ = CoarseMonoClock::now();
+};
+
+TEST_F(AdaptiveBatchControllerTest, GrowsUnderTarget) {
+  AdaptiveBatchController controller(nullptr);
+  ASSERT_EQ(16U, controller.BatchSizeLimit());
+  // No delay before any statistics are known.
+  ASSERT_EQ(MonoDelta::kZero, controller.BatchDelay(1));
+
+  Submit(&controller, 100, 10us);
+  for (int i = 0; i != 100; ++i) {
+    controller.OperationReplicated(200us);
+    controller.BatchReplicated(controller.BatchSizeLimit(), MonoDelta::kZero);
+  }
+  // Full batches and low latency grow the limit up to the maximum.
+  ASSERT_EQ(64U, controller.BatchSizeLimit());
+  // Operations arrive often, so it is worth waiting for them.
+  auto delay = controller.BatchDelay(1);
+  ASSERT_GT(delay, MonoDelta::kZero);
+  ASSERT_LE(delay, MonoDelta::FromMicroseconds(FLAGS_adaptive_group_replicate_max_delay_us));
+  // Full batch is never delayed.
+  ASSERT_EQ(MonoDelta::kZero, controller.BatchDelay(64));
+}
+
+TEST_F(AdaptiveBatchControllerTest, NoDelayForRareOperations) {
+  AdaptiveBatchController controller(nullptr);
+  // Single client, that waits for its own writes.
+  Submit(&controller, 100, 2ms);
+  for (int i = 0; i != 100; ++i) {
+    controller.OperationReplicated(200us);
+    controller.BatchReplicated(1, MonoDelta::kZero);
+  }
+  ASSERT_EQ(MonoDelta::kZero, controller.BatchDelay(1));
+}
+
+TEST_F(AdaptiveBatchControllerTest, BacksOffDelayOverTarget) {
+  AdaptiveBatchController controller(nullptr);
+  Submit(&controller, 100, 10us);
+  for (int i = 0; i != 100; ++i) {
+    controller.OperationReplicated(200us);
+    controller.BatchReplicated(controller.BatchSizeLimit(), MonoDelta::kZero);
+  }
+  ASSERT_GT(controller.BatchDelay(1), MonoDelta::kZero);
+
+  for (int i = 0; i != 100; ++i) {
+    controller.OperationReplicated(5ms);
+    controller.BatchReplicated(controller.BatchSizeLimit(), MonoDelta::kZero);
+  }
+  ASSERT_GT(controller.LatencyEstimate(),
+            MonoDelta::FromMicroseconds(FLAGS_adaptive_group_replicate_target_latency_us));
+  // Only the delay is backed off, operations that are already queued are still batched.
+  ASSERT_EQ(64U, controller.BatchSizeLimit());
+  ASSERT_EQ(MonoDelta::kZero, controller.BatchDelay(1));
+}
+
+TEST_F(AdaptiveBatchControllerTest, LimitNotBelowNonAdaptive) {
+  FLAGS_adaptive_group_replicate_max_batch_size = 8;
+  AdaptiveBatchController controller(nullptr);
+  Submit(&controller, 100, 10us);
+  for (int i = 0; i != 100; ++i) {
+    controller.OperationReplicated(5ms);
+    controller.BatchReplicated(controller.BatchSizeLimit(), MonoDelta::kZero);
+  }
+  ASSERT_EQ(16U, controller.BatchSizeLimit());
+}
+
+} // namespace tablet
+} // namespace yb
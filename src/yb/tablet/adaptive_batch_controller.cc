@@ -0,0 +1,208 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/adaptive_batch_controller.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_bool(enable_adaptive_group_replicate_batching, false,
+            "Whether the preparer chooses the size of replicated batches and the delay to wait "
+            "for more operations adaptively, targeting "
+            "--adaptive_group_replicate_target_latency_us. When false, batches are limited by "
+            "--max_group_replicate_batch_size and are replicated without delay.");
+TAG_FLAG(enable_adaptive_group_replicate_batching, advanced);
+TAG_FLAG(enable_adaptive_group_replicate_batching, runtime);
+
+DEFINE_int64(adaptive_group_replicate_target_latency_us, 5000,
+             "Target latency between submission and replication of a leader-side operation, used "
+             "by adaptive group replicate batching.");
+TAG_FLAG(adaptive_group_replicate_target_latency_us, advanced);
+TAG_FLAG(adaptive_group_replicate_target_latency_us, runtime);
+
+DEFINE_uint64(adaptive_group_replicate_max_batch_size, 256,
+              "Upper bound for the number of operations in a replicated batch chosen by adaptive "
+              "group replicate batching.");
+TAG_FLAG(adaptive_group_replicate_max_batch_size, advanced);
+TAG_FLAG(adaptive_group_replicate_max_batch_size, runtime);
+
+DEFINE_int64(adaptive_group_replicate_max_delay_us, 500,
+             "Upper bound for the time the preparer waits for more operations before replicating "
+             "a batch, when adaptive group replicate batching is enabled.");
+TAG_FLAG(adaptive_group_replicate_max_delay_us, advanced);
+TAG_FLAG(adaptive_group_replicate_max_delay_us, runtime);
+
+METRIC_DEFINE_coarse_histogram(
+    tablet, preparer_batch_size, "Preparer Batch Size", yb::MetricUnit::kOperations,
+    "Number of leader-side operations submitted for replication in a single batch.");
+
+METRIC_DEFINE_coarse_histogram(
+    tablet, preparer_batch_delay, "Preparer Batch Delay", yb::MetricUnit::kMicroseconds,
+    "Time the preparer waited for more operations before replicating a batch.");
+
+METRIC_DEFINE_coarse_histogram(
+    tablet, leader_operation_replication_latency, "Leader Operation Replication Latency",
+    yb::MetricUnit::kMicroseconds,
+    "Time between submission of a leader-side operation to the preparer and its replication.");
+
+METRIC_DEFINE_gauge_uint64(
+    tablet, preparer_batch_size_limit, "Preparer Batch Size Limit", yb::MetricUnit::kOperations,
+    "Maximal number of operations in a replicated batch, as chosen by the preparer.");
+
+METRIC_DEFINE_gauge_int64(
+    tablet, preparer_latency_estimate, "Preparer Latency Estimate", yb::MetricUnit::kMicroseconds,
+    "Moving average of the latency between submission and replication of leader-side "
+    "operations, used to choose batch size limit and delay.");
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Weight of a new sample in the moving averages is 1 / kSmoothingFactor.
+constexpr int64_t kSmoothingFactor = 8;
+
+// Intervals between arrivals above this value are considered idle periods rather than load, and
+// reset the arrival interval estimate.
+constexpr int64_t kIdleArrivalIntervalUs = 1000000;
+
+void UpdateMovingAverage(int64_t sample, int64_t* average) {
+  if (*average == 0) {
+    *average = std::max<int64_t>(sample, 1);
+  } else {
+    *average += (sample - *average) / kSmoothingFactor;
+  }
+}
+
+// The limit is never below the one used without adaptive batching.
+size_t MinBatchSize() {
+  return std::max<uint64_t>(FLAGS_max_group_replicate_batch_size, 1);
+}
+
+size_t MaxBatchSize() {
+  return std::max<uint64_t>(FLAGS_adaptive_group_replicate_max_batch_size, MinBatchSize());
+}
+
+} // namespace
+
+AdaptiveBatchController::AdaptiveBatchController(
+    const scoped_refptr<MetricEntity>& metric_entity)
+    : batch_size_limit_(MinBatchSize()) {
+  if (metric_entity) {
+    batch_size_histogram_ = METRIC_preparer_batch_size.Instantiate(metric_entity);
+    batch_delay_histogram_ = METRIC_preparer_batch_delay.Instantiate(metric_entity);
+    replication_latency_histogram_ =
+        METRIC_leader_operation_replication_latency.Instantiate(metric_entity);
+    batch_size_limit_gauge_ =
+        METRIC_preparer_batch_size_limit.Instantiate(metric_entity, batch_size_limit_);
+    latency_estimate_gauge_ = METRIC_preparer_latency_estimate.Instantiate(metric_entity, 0);
+  }
+}
+
+AdaptiveBatchController::~AdaptiveBatchController() = default;
+
+void AdaptiveBatchController::OperationSubmitted(CoarseTimePoint now) {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  if (last_arrival_ != CoarseTimePoint()) {
+    auto interval_us = MonoDelta(now - last_arrival_).ToMicroseconds();
+    if (interval_us >= kIdleArrivalIntervalUs) {
+      arrival_interval_us_ = 0;
+    } else {
+      UpdateMovingAverage(interval_us, &arrival_interval_us_);
+    }
+  }
+  last_arrival_ = now;
+}
+
+void AdaptiveBatchController::OperationReplicated(MonoDelta latency) {
+  auto latency_us = latency.ToMicroseconds();
+  IncrementHistogram(replication_latency_histogram_, latency_us);
+  int64_t estimate;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    UpdateMovingAverage(latency_us, &latency_us_);
+    estimate = latency_us_;
+  }
+  if (latency_estimate_gauge_) {
+    latency_estimate_gauge_->set_value(estimate);
+  }
+}
+
+size_t AdaptiveBatchController::BatchSizeLimit() {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return std::max(std::min(batch_size_limit_, MaxBatchSize()), MinBatchSize());
+}
+
+MonoDelta AdaptiveBatchController::BatchDelay(size_t batch_size) {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  if (batch_size >= batch_size_limit_ || delay_us_ == 0) {
+    return MonoDelta::kZero;
+  }
+  // Waiting only makes sense when the next operation is expected to arrive before the delay
+  // expires, e.g. a single client that waits for its own writes never benefits from it.
+  if (arrival_interval_us_ == 0 || arrival_interval_us_ > delay_us_) {
+    return MonoDelta::kZero;
+  }
+  return MonoDelta::FromMicroseconds(
+      std::min(delay_us_, FLAGS_adaptive_group_replicate_max_delay_us));
+}
+
+void AdaptiveBatchController::BatchReplicated(size_t batch_size, MonoDelta delay) {
+  IncrementHistogram(batch_size_histogram_, batch_size);
+  IncrementHistogram(batch_delay_histogram_, delay.ToMicroseconds());
+
+  const auto target_us = FLAGS_adaptive_group_replicate_target_latency_us;
+  const auto max_delay_us = std::max<int64_t>(FLAGS_adaptive_group_replicate_max_delay_us, 0);
+  size_t new_limit;
+  {
+    std::lock_guard<simple_spinlock> lock(mutex_);
+    if (latency_us_ == 0) {
+      // No latency samples yet.
+      return;
+    }
+    if (latency_us_ > target_us) {
+      // Over the target, back off the delay multiplicatively. The batch size limit is kept, since
+      // batching operations that are already in the queue does not add latency, and smaller
+      // batches would only increase the number of Raft rounds under load.
+      delay_us_ /= 2;
+    } else if (latency_us_ * 4 < target_us * 3) {
+      // Comfortably below the target, there is room to trade latency for throughput.
+      if (batch_size >= batch_size_limit_) {
+        batch_size_limit_ = std::min(
+            batch_size_limit_ + std::max<size_t>(batch_size_limit_ / 4, 1), MaxBatchSize());
+      }
+      const auto delay_step = std::max<int64_t>(max_delay_us / kSmoothingFactor, 1);
+      if (arrival_interval_us_ != 0 && latency_us_ + delay_us_ + delay_step < target_us) {
+        delay_us_ = std::min(delay_us_ + delay_step, max_delay_us);
+      }
+    }
+    batch_size_limit_ = std::max(std::min(batch_size_limit_, MaxBatchSize()), MinBatchSize());
+    new_limit = batch_size_limit_;
+  }
+  if (batch_size_limit_gauge_) {
+    batch_size_limit_gauge_->set_value(new_limit);
+  }
+}
+
+MonoDelta AdaptiveBatchController::LatencyEstimate() {
+  std::lock_guard<simple_spinlock> lock(mutex_);
+  return MonoDelta::FromMicroseconds(latency_us_);
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,88 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_ADAPTIVE_BATCH_CONTROLLER_H
+#define YB_TABLET_ADAPTIVE_BATCH_CONTROLLER_H
+
+#include <gflags/gflags_declare.h>
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/locks.h"
+#include "yb/util/metrics_fwd.h"
+#include "yb/util/monotime.h"
+
+DECLARE_bool(enable_adaptive_group_replicate_batching);
+DECLARE_uint64(max_group_replicate_batch_size);
+
+namespace yb {
+namespace tablet {
+
+// Chooses how many leader-side operations the preparer groups into a single Raft round, and how
+// long it could wait for more operations to arrive before replicating a batch.
+//
+// The controller targets --adaptive_group_replicate_target_latency_us for the time between the
+// submission of an operation and its replication. While the observed latency is below the target,
+// it grows the batch size limit when batches are full, and grows the delay when operations arrive
+// frequently enough to join a waiting batch. When the latency exceeds the target, the delay is
+// reduced multiplicatively. The batch size limit is never below --max_group_replicate_batch_size.
+//
+// OperationSubmitted and OperationReplicated could be invoked concurrently from any thread, the
+// remaining methods are invoked by the preparer task.
+class AdaptiveBatchController {
+ public:
+  // metric_entity could be null, in this case metrics are not collected.
+  explicit AdaptiveBatchController(const scoped_refptr<MetricEntity>& metric_entity);
+  ~AdaptiveBatchController();
+
+  // Records arrival of a leader-side operation.
+  void OperationSubmitted(CoarseTimePoint now);
+
+  // Records latency between submission and replication of a leader-side operation.
+  void OperationReplicated(MonoDelta latency);
+
+  // Maximal number of operations that could be replicated in a single batch.
+  size_t BatchSizeLimit();
+
+  // Time that the preparer could wait for more operations before replicating a batch of
+  // batch_size operations. Zero when no operations are expected to arrive in time.
+  MonoDelta BatchDelay(size_t batch_size);
+
+  // Invoked after a batch of batch_size operations was submitted for replication, delay is the time
+  // the preparer waited for more operations. Adjusts the limits using the recent statistics.
+  void BatchReplicated(size_t batch_size, MonoDelta delay);
+
+  // Current estimate of the latency between submission and replication of an operation.
+  MonoDelta LatencyEstimate();
+
+ private:
+  simple_spinlock mutex_;
+  size_t batch_size_limit_ GUARDED_BY(mutex_);
+  int64_t delay_us_ GUARDED_BY(mutex_) = 0;
+  // Exponentially weighted moving averages of the replication latency and of the interval between
+  // operation arrivals. Zero when there are no samples yet.
+  int64_t latency_us_ GUARDED_BY(mutex_) = 0;
+  int64_t arrival_interval_us_ GUARDED_BY(mutex_) = 0;
+  CoarseTimePoint last_arrival_ GUARDED_BY(mutex_);
+
+  scoped_refptr<Histogram> batch_size_histogram_;
+  scoped_refptr<Histogram> batch_delay_histogram_;
+  scoped_refptr<Histogram> replication_latency_histogram_;
+  scoped_refptr<AtomicGauge<uint64_t>> batch_size_limit_gauge_;
+  scoped_refptr<AtomicGauge<int64_t>> latency_estimate_gauge_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_ADAPTIVE_BATCH_CONTROLLER_H
@@ -40,6 +40,7 @@
 #include "yb/tserver/tserver_error.h"
 
 #include "yb/util/async_util.h"
+#include "yb/util/enums.h"
 #include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
@@ -65,9 +66,34 @@ std::string Operation::ToString() const {
 }
 
 
+namespace {
+
+// Operations that only modify tablet data, so they are not applied by witness replicas.
+bool IsDataOperation(OperationType operation_type) {
+  switch (operation_type) {
+    case OperationType::kWrite: FALLTHROUGH_INTENDED;
+    case OperationType::kUpdateTransaction: FALLTHROUGH_INTENDED;
+    case OperationType::kSnapshot: FALLTHROUGH_INTENDED;
+    case OperationType::kTruncate: FALLTHROUGH_INTENDED;
+    case OperationType::kHistoryCutoff:
+      return true;
+    case OperationType::kChangeMetadata: FALLTHROUGH_INTENDED;
+    case OperationType::kEmpty: FALLTHROUGH_INTENDED;
+    case OperationType::kSplit:
+      return false;
+  }
+  FATAL_INVALID_ENUM_VALUE(OperationType, operation_type);
+}
+
+} // namespace
+
 Status Operation::Replicated(int64_t leader_term) {
   Status complete_status = Status::OK();
-  RETURN_NOT_OK(DoReplicated(leader_term, &complete_status));
+  if (tablet() && tablet()->is_witness() && IsDataOperation(operation_type())) {
+    VLOG_WITH_PREFIX(4) << "Witness does not apply " << ToString();
+  } else {
+    RETURN_NOT_OK(DoReplicated(leader_term, &complete_status));
+  }
   Replicated();
   Release();
   CompleteWithStatus(complete_status);
@@ -69,6 +69,8 @@
 
 using namespace std::literals;
 
+DECLARE_bool(enable_adaptive_group_replicate_batching);
+
 DEFINE_test_flag(int32, delay_execute_async_ms, 0,
                  "Delay execution of ExecuteAsync for specified amount of milliseconds during "
                      "tests");
@@ -350,6 +352,10 @@ void OperationDriver::ReplicationFinished(
   }
 
   if (status.ok()) {
+    if (preparer_ && is_leader_side() &&
+        GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+      preparer_->OperationReplicated(MonoTime::Now() - start_time_);
+    }
     TRACE_EVENT_FLOW_BEGIN0("operation", "ApplyTask", this);
     ApplyTask(leader_term, applied_op_ids);
   } else {
@@ -27,8 +27,10 @@
 
 #include "yb/gutil/macros.h"
 
+#include "yb/tablet/adaptive_batch_controller.h"
 #include "yb/tablet/operations/operation_driver.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/lockfree.h"
 #include "yb/util/logging.h"
@@ -54,7 +56,8 @@ namespace tablet {
 
 class PreparerImpl {
  public:
-  explicit PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+               const scoped_refptr<MetricEntity>& metric_entity);
   ~PreparerImpl();
   CHECKED_STATUS Start();
   void Stop();
@@ -65,6 +68,10 @@ class PreparerImpl {
     return tablet_prepare_pool_token_.get();
   }
 
+  void OperationReplicated(MonoDelta latency) {
+    batch_controller_.OperationReplicated(latency);
+  }
+
  private:
   using OperationDrivers = std::vector<OperationDriver*>;
 
@@ -109,9 +116,29 @@ class PreparerImpl {
   // A temporary buffer of rounds to replicate, used to reduce reallocation.
   consensus::ConsensusRounds rounds_to_replicate_;
 
+  AdaptiveBatchController batch_controller_;
+
+  // When the preparer started to wait for more operations to join the current leader side batch.
+  // Default value if it did not wait.
+  CoarseTimePoint batch_wait_start_;
+
+  // Used to wake up the preparer task waiting for more operations, when an operation is submitted
+  // or stop is requested.
+  std::atomic<bool> waiting_for_operations_{false};
+  std::mutex batch_wait_mutex_;
+  std::condition_variable batch_wait_cond_;
+
+  void NotifyBatchWaiter();
+
   void Run();
   void ProcessItem(OperationDriver* item);
 
+  size_t BatchSizeLimit();
+
+  // Waits for more operations to join the current leader side batch, if adaptive batching decides
+  // that it is worth it. Returns true if there are new operations in the queue.
+  bool WaitForMoreOperations();
+
   void ProcessAndClearLeaderSideBatch();
 
   // A wrapper around ProcessAndClearLeaderSideBatch that assumes we are currently holding the
@@ -121,10 +148,12 @@ class PreparerImpl {
                          OperationDrivers::iterator end);
 };
 
-PreparerImpl::PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool)
+PreparerImpl::PreparerImpl(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+                           const scoped_refptr<MetricEntity>& metric_entity)
     : consensus_(consensus),
       tablet_prepare_pool_token_(tablet_prepare_pool
-                                     ->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+                                     ->NewToken(ThreadPool::ExecutionMode::SERIAL)),
+      batch_controller_(metric_entity) {
 }
 
 PreparerImpl::~PreparerImpl() {
@@ -140,6 +169,7 @@ void PreparerImpl::Stop() {
     return;
   }
   stop_requested_ = true;
+  NotifyBatchWaiter();
   {
     std::unique_lock<std::mutex> stop_lock(stop_mtx_);
     stop_cond_.wait(stop_lock, [this] {
@@ -165,8 +195,12 @@ Status PreparerImpl::Submit(OperationDriver* operation_driver) {
   if (leader_side) {
     // Prepare leader-side operations on the "preparer thread" so we can only acquire the
     // ReplicaState lock once and append multiple operations.
-    active_tasks_.fetch_add(1, std::memory_order_release);
+    if (GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+      batch_controller_.OperationSubmitted(CoarseMonoClock::now());
+    }
+    active_tasks_.fetch_add(1);
     queue_.Push(operation_driver);
+    NotifyBatchWaiter();
   } else {
     // For follower-side operations, there would be no benefit in preparing them on the preparer
     // thread.
@@ -191,6 +225,9 @@ void PreparerImpl::Run() {
       active_tasks_.fetch_sub(1, std::memory_order_release);
       ProcessItem(item);
     }
+    if (WaitForMoreOperations()) {
+      continue;
+    }
     ProcessAndClearLeaderSideBatch();
     std::unique_lock<std::mutex> stop_lock(stop_mtx_);
     running_.store(false, std::memory_order_release);
@@ -254,7 +291,7 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   // Don't add more than the max number of operations to a batch, and also don't add
   // operations bound to different terms, so as not to fail unrelated operations
   // unnecessarily in case of a bound term mismatch.
-  if (leader_side_batch_.size() >= FLAGS_max_group_replicate_batch_size ||
+  if (leader_side_batch_.size() >= BatchSizeLimit() ||
       (!leader_side_batch_.empty() &&
           bound_term != leader_side_batch_.back()->consensus_round()->bound_term())) {
     ProcessAndClearLeaderSideBatch();
@@ -265,11 +302,67 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
   }
 }
 
+size_t PreparerImpl::BatchSizeLimit() {
+  return GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)
+      ? batch_controller_.BatchSizeLimit() : FLAGS_max_group_replicate_batch_size;
+}
+
+bool PreparerImpl::WaitForMoreOperations() {
+  if (leader_side_batch_.empty() ||
+      !GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+    return false;
+  }
+  auto delay = batch_controller_.BatchDelay(leader_side_batch_.size());
+  if (!delay) {
+    return false;
+  }
+  auto now = CoarseMonoClock::now();
+  if (batch_wait_start_ == CoarseTimePoint()) {
+    batch_wait_start_ = now;
+  }
+  // The delay is bounded for the whole batch, not for each wait.
+  const auto deadline = batch_wait_start_ + delay;
+  if (now >= deadline) {
+    return active_tasks_.load(std::memory_order_acquire) != 0;
+  }
+  // Submit increments active_tasks_ before checking waiting_for_operations_, and we check
+  // active_tasks_ after setting waiting_for_operations_, so at least one side observes the other
+  // and the wake up is not lost.
+  waiting_for_operations_.store(true);
+  {
+    std::unique_lock<std::mutex> lock(batch_wait_mutex_);
+    batch_wait_cond_.wait_for(lock, deadline - now, [this] {
+      return active_tasks_.load() != 0 || stop_requested_.load(std::memory_order_acquire);
+    });
+  }
+  waiting_for_operations_.store(false, std::memory_order_release);
+  return active_tasks_.load(std::memory_order_acquire) != 0 &&
+         !stop_requested_.load(std::memory_order_acquire);
+}
+
+void PreparerImpl::NotifyBatchWaiter() {
+  if (!waiting_for_operations_.load()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(batch_wait_mutex_);
+  }
+  batch_wait_cond_.notify_one();
+}
+
 void PreparerImpl::ProcessAndClearLeaderSideBatch() {
   if (leader_side_batch_.empty()) {
     return;
   }
 
+  if (GetAtomicFlag(&FLAGS_enable_adaptive_group_replicate_batching)) {
+    batch_controller_.BatchReplicated(
+        leader_side_batch_.size(),
+        batch_wait_start_ == CoarseTimePoint()
+            ? MonoDelta::kZero : MonoDelta(CoarseMonoClock::now() - batch_wait_start_));
+  }
+  batch_wait_start_ = CoarseTimePoint();
+
   VLOG(2) << "Preparing a batch of " << leader_side_batch_.size() << " leader-side operations";
 
   auto iter = leader_side_batch_.begin();
@@ -345,8 +438,9 @@ void PreparerImpl::ReplicateSubBatch(
 // ------------------------------------------------------------------------------------------------
 // Preparer
 
-Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread)
-    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread)) {
+Preparer::Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_thread,
+                   const scoped_refptr<MetricEntity>& metric_entity)
+    : impl_(std::make_unique<PreparerImpl>(consensus, tablet_prepare_thread, metric_entity)) {
 }
 
 Preparer::~Preparer() = default;
@@ -370,5 +464,9 @@ ThreadPoolToken* Preparer::PoolToken() {
   return impl_->PoolToken();
 }
 
+void Preparer::OperationReplicated(MonoDelta latency) {
+  impl_->OperationReplicated(latency);
+}
+
 }  // namespace tablet
 }  // namespace yb
@@ -16,6 +16,8 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/util/metrics_fwd.h"
+#include "yb/util/monotime.h"
 #include "yb/util/status_fwd.h"
 #include "yb/util/threadpool.h"
 
@@ -40,7 +42,9 @@ class PreparerImpl;
 // Preparer does not manage a thread but only submits to a token in a thread pool.
 class Preparer {
  public:
-  explicit Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool);
+  // metric_entity could be null, in this case adaptive batching metrics are not collected.
+  Preparer(consensus::Consensus* consensus, ThreadPool* tablet_prepare_pool,
+           const scoped_refptr<MetricEntity>& metric_entity);
   ~Preparer();
 
   CHECKED_STATUS Start();
@@ -49,6 +53,10 @@ class Preparer {
   CHECKED_STATUS Submit(OperationDriver* txn_driver);
   ThreadPoolToken* PoolToken();
 
+  // Invoked when a leader-side operation submitted to this preparer has been replicated, with the
+  // time passed since the operation was created. Used by adaptive batching.
+  void OperationReplicated(MonoDelta latency);
+
  private:
   std::unique_ptr<PreparerImpl> impl_;
 };
@@ -54,7 +54,6 @@ RunningTransaction::RunningTransaction(TransactionMetadata metadata,
       context_(*context),
       remove_intents_task_(&context->applier_, &context->participant_context_, context,
                            metadata_.transaction_id),
-      get_status_handle_(context->rpcs_.InvalidHandle()),
       abort_handle_(context->rpcs_.InvalidHandle()),
       apply_intents_task_(&context->applier_, context, &apply_data_),
       abort_check_ht_(base_time_for_abort_check_ht_calculation.AddDelta(
@@ -62,7 +61,7 @@ RunningTransaction::RunningTransaction(TransactionMetadata metadata,
 }
 
 RunningTransaction::~RunningTransaction() {
-  context_.rpcs_.Abort({&get_status_handle_, &abort_handle_});
+  context_.rpcs_.Abort({&abort_handle_});
 }
 
 void RunningTransaction::AddReplicatedBatch(
@@ -214,19 +213,9 @@ void RunningTransaction::SendStatusRequest(
     int64_t serial_no, const RunningTransactionPtr& shared_self) {
   TRACE_FUNC();
   VTRACE(1, yb::ToString(metadata_.transaction_id));
-  tserver::GetTransactionStatusRequestPB req;
-  req.set_tablet_id(metadata_.status_tablet);
-  req.add_transaction_id()->assign(
-      pointer_cast<const char*>(metadata_.transaction_id.data()), metadata_.transaction_id.size());
-  req.set_propagated_hybrid_time(context_.participant_context_.Now().ToUint64());
-  context_.rpcs_.RegisterAndStart(
-      client::GetTransactionStatus(
-          TransactionRpcDeadline(),
-          nullptr /* tablet */,
-          context_.participant_context_.client_future().get(),
-          &req,
-          std::bind(&RunningTransaction::StatusReceived, this, _1, _2, serial_no, shared_self)),
-      &get_status_handle_);
+  context_.status_batcher_.RequestStatus(
+      metadata_.status_tablet, metadata_.transaction_id,
+      std::bind(&RunningTransaction::StatusReceived, this, _1, _2, serial_no, shared_self));
 }
 
 void RunningTransaction::StatusReceived(
@@ -284,7 +273,6 @@ void RunningTransaction::DoStatusReceived(const Status& status,
     context_.participant_context_.UpdateClock(HybridTime(response.propagated_hybrid_time()));
   }
 
-  context_.rpcs_.Unregister(&get_status_handle_);
   decltype(status_waiters_) status_waiters;
   HybridTime time_of_status = HybridTime::kMin;
   TransactionStatus transaction_status = TransactionStatus::PENDING;
@@ -162,7 +162,6 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
   TransactionStatus last_known_status_ = TransactionStatus::CREATED;
   HybridTime last_known_status_hybrid_time_ = HybridTime::kMin;
   std::vector<StatusRequest> status_waiters_;
-  rpc::Rpcs::Handle get_status_handle_;
   rpc::Rpcs::Handle abort_handle_;
   std::vector<TransactionStatusCallback> abort_waiters_;
 
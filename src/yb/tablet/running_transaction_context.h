@@ -29,6 +29,7 @@
 
 #include "yb/tablet/transaction_intent_applier.h"
 #include "yb/tablet/transaction_participant.h"
+#include "yb/tablet/transaction_status_batcher.h"
 
 #include "yb/util/delayer.h"
 #include "yb/util/math_util.h"
@@ -66,8 +67,10 @@ YB_DEFINE_ENUM(RemoveReason,
 class RunningTransactionContext {
  public:
   RunningTransactionContext(TransactionParticipantContext* participant_context,
-                            TransactionIntentApplier* applier)
-      : participant_context_(*participant_context), applier_(*applier) {
+                            TransactionIntentApplier* applier,
+                            const scoped_refptr<MetricEntity>& entity)
+      : participant_context_(*participant_context), applier_(*applier),
+        status_batcher_(participant_context, &rpcs_, entity) {
   }
 
   virtual ~RunningTransactionContext() {}
@@ -96,6 +99,7 @@ class RunningTransactionContext {
   rpc::Rpcs rpcs_;
   TransactionParticipantContext& participant_context_;
   TransactionIntentApplier& applier_;
+  TransactionStatusBatcher status_batcher_;
   int64_t request_serial_ = 0;
   std::mutex mutex_;
 
@@ -0,0 +1,81 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+class SharedTransactionStatusCacheTest : public YBTest {
+ protected:
+  TransactionStatusInfo MakeInfo(TransactionStatus status, uint64_t time = 1000) {
+    return TransactionStatusInfo {
+      .transaction_id = TransactionId::GenerateRandom(),
+      .status = status,
+      .aborted_subtxn_set = AbortedSubTransactionSet(),
+      .status_ht = HybridTime(time),
+      .coordinator_safe_time = HybridTime(),
+    };
+  }
+};
+
+TEST_F(SharedTransactionStatusCacheTest, FinalStatusesOnly) {
+  SharedTransactionStatusCache cache(10, scoped_refptr<MetricEntity>());
+
+  auto committed = MakeInfo(TransactionStatus::COMMITTED, 2000);
+  auto aborted = MakeInfo(TransactionStatus::ABORTED);
+  auto pending = MakeInfo(TransactionStatus::PENDING);
+  cache.Put(committed);
+  cache.Put(aborted);
+  cache.Put(pending);
+  ASSERT_EQ(cache.size(), 2U);
+
+  auto info = cache.Get(committed.transaction_id);
+  ASSERT_TRUE(info);
+  ASSERT_EQ(info->status, TransactionStatus::COMMITTED);
+  ASSERT_EQ(info->status_ht, HybridTime(2000));
+
+  info = cache.Get(aborted.transaction_id);
+  ASSERT_TRUE(info);
+  ASSERT_EQ(info->status, TransactionStatus::ABORTED);
+
+  ASSERT_FALSE(cache.Get(pending.transaction_id));
+}
+
+TEST_F(SharedTransactionStatusCacheTest, EvictLeastRecentlyUsed) {
+  constexpr size_t kCapacity = 4;
+  SharedTransactionStatusCache cache(kCapacity, scoped_refptr<MetricEntity>());
+
+  std::vector<TransactionStatusInfo> infos;
+  for (size_t i = 0; i != kCapacity; ++i) {
+    infos.push_back(MakeInfo(TransactionStatus::COMMITTED));
+    cache.Put(infos.back());
+  }
+
+  // Touch the oldest entry, so the second one becomes least recently used.
+  ASSERT_TRUE(cache.Get(infos[0].transaction_id));
+  infos.push_back(MakeInfo(TransactionStatus::ABORTED));
+  cache.Put(infos.back());
+
+  ASSERT_EQ(cache.size(), kCapacity);
+  ASSERT_FALSE(cache.Get(infos[1].transaction_id));
+  for (size_t i : {0, 2, 3, 4}) {
+    ASSERT_TRUE(cache.Get(infos[i].transaction_id)) << i;
+  }
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,94 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+
+DEFINE_int64(transaction_status_cache_size, 100000,
+             "Max number of final transaction statuses cached by a tablet server, and shared by "
+             "transaction participants of all its tablets. 0 disables the cache.");
+TAG_FLAG(transaction_status_cache_size, advanced);
+
+METRIC_DEFINE_counter(
+    server, transaction_status_cache_hits, "Transaction Status Cache Hits",
+    yb::MetricUnit::kCacheHits,
+    "Number of transaction status requests served from the shared transaction status cache.");
+
+METRIC_DEFINE_counter(
+    server, transaction_status_cache_misses, "Transaction Status Cache Misses",
+    yb::MetricUnit::kCacheQueries,
+    "Number of transaction status requests that were not found in the shared transaction status "
+    "cache.");
+
+namespace yb {
+namespace tablet {
+
+SharedTransactionStatusCache::SharedTransactionStatusCache(
+    size_t capacity, const scoped_refptr<MetricEntity>& metric_entity)
+    : capacity_(capacity) {
+  if (metric_entity) {
+    hits_ = METRIC_transaction_status_cache_hits.Instantiate(metric_entity);
+    misses_ = METRIC_transaction_status_cache_misses.Instantiate(metric_entity);
+  }
+}
+
+SharedTransactionStatusCache::~SharedTransactionStatusCache() = default;
+
+boost::optional<TransactionStatusInfo> SharedTransactionStatusCache::Get(
+    const TransactionId& id) {
+  boost::optional<TransactionStatusInfo> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& index = entries_.get<IdTag>();
+    auto it = index.find(id);
+    if (it != index.end()) {
+      entries_.relocate(entries_.begin(), entries_.project<0>(it));
+      result = *it;
+    }
+  }
+  auto* counter = result ? hits_.get() : misses_.get();
+  if (counter) {
+    counter->Increment();
+  }
+  return result;
+}
+
+void SharedTransactionStatusCache::Put(const TransactionStatusInfo& info) {
+  if (info.status != TransactionStatus::COMMITTED && info.status != TransactionStatus::ABORTED) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& index = entries_.get<IdTag>();
+  auto it = index.find(info.transaction_id);
+  if (it != index.end()) {
+    // Status is final, so it cannot change. But we still mark it as recently used.
+    entries_.relocate(entries_.begin(), entries_.project<0>(it));
+    return;
+  }
+  entries_.push_front(info);
+  while (entries_.size() > capacity_) {
+    entries_.pop_back();
+  }
+}
+
+size_t SharedTransactionStatusCache::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+} // namespace tablet
+} // namespace yb
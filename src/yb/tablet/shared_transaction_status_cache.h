@@ -0,0 +1,87 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_SHARED_TRANSACTION_STATUS_CACHE_H
+#define YB_TABLET_SHARED_TRANSACTION_STATUS_CACHE_H
+
+#include <mutex>
+
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+#include <boost/multi_index_container.hpp>
+#include <boost/optional/optional.hpp>
+
+#include <gflags/gflags_declare.h>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/tablet/transaction_status_resolver.h"
+
+#include "yb/util/metrics_fwd.h"
+
+DECLARE_int64(transaction_status_cache_size);
+
+namespace yb {
+namespace tablet {
+
+// Final statuses of transactions, i.e. COMMITTED with commit time or ABORTED, shared by
+// transaction participants of all tablets of a tablet server.
+//
+// Final status of a transaction never changes at its coordinator, so once any tablet of the
+// server has learned it, other tablets could use it instead of sending a status RPC.
+// The number of entries is limited, least recently used entries are evicted first.
+class SharedTransactionStatusCache {
+ public:
+  SharedTransactionStatusCache(
+      size_t capacity, const scoped_refptr<MetricEntity>& metric_entity);
+  ~SharedTransactionStatusCache();
+
+  // Returns cached status of the specified transaction, if present.
+  boost::optional<TransactionStatusInfo> Get(const TransactionId& id);
+
+  // Remembers status of a transaction, status that is not final is ignored.
+  void Put(const TransactionStatusInfo& info);
+
+  size_t size() const;
+
+ private:
+  class IdTag;
+
+  typedef boost::multi_index_container<TransactionStatusInfo,
+      boost::multi_index::indexed_by <
+          boost::multi_index::sequenced<>,
+          boost::multi_index::hashed_unique <
+              boost::multi_index::tag<IdTag>,
+              boost::multi_index::member <
+                  TransactionStatusInfo, TransactionId, &TransactionStatusInfo::transaction_id>,
+              TransactionIdHash
+          >
+      >
+  > Entries;
+
+  const size_t capacity_;
+
+  mutable std::mutex mutex_;
+  // Most recently used entries are at the front.
+  Entries entries_ GUARDED_BY(mutex_);
+
+  scoped_refptr<Counter> hits_;
+  scoped_refptr<Counter> misses_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_SHARED_TRANSACTION_STATUS_CACHE_H
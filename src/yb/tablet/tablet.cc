@@ -98,6 +98,7 @@
 
 #include "yb/tserver/tserver.pb.h"
 
+#include "yb/util/countdown_latch.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
@@ -111,6 +112,7 @@
 #include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/yb_pg_errcodes.h"
 
@@ -250,6 +252,19 @@ DEFINE_test_flag(bool, disable_getting_user_frontier_from_mem_table, false,
                  "Prevents checking the MemTable for a UserFrontier for test cases where we are "
                  "generating SST files without UserFrontiers.");
 
+DEFINE_int32(txn_apply_intents_parallelism, 4,
+             "Max number of key range chunks of a large transaction's intents that are applied "
+             "in parallel. 1 to apply intents sequentially.");
+TAG_FLAG(txn_apply_intents_parallelism, advanced);
+TAG_FLAG(txn_apply_intents_parallelism, runtime);
+
+DEFINE_int32(txn_apply_intents_chunk_records, 100000,
+             "Number of transaction reverse index records in a chunk that is applied in parallel "
+             "with other chunks, using its own RocksDB write batch. Transactions with fewer "
+             "records in a tablet are applied sequentially.");
+TAG_FLAG(txn_apply_intents_chunk_records, advanced);
+TAG_FLAG(txn_apply_intents_chunk_records, runtime);
+
 DECLARE_int32(client_read_write_timeout_ms);
 DECLARE_bool(consistent_restore);
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
@@ -257,6 +272,7 @@ DECLARE_int32(rocksdb_level0_stop_writes_trigger);
 DECLARE_uint64(rocksdb_max_file_size_for_compaction);
 DECLARE_int64(apply_intents_task_injected_delay_ms);
 DECLARE_string(regular_tablets_data_block_key_value_encoding);
+DECLARE_int32(txn_max_apply_batch_records);
 
 using namespace std::placeholders;
 
@@ -340,6 +356,37 @@ rocksdb::UserFrontierPtr MemTableFrontierFromDb(
   return db->GetMutableMemTableFrontier(type);
 }
 
+// Chunk of transaction intents that is prepared for apply, see Tablet::ApplyIntentChunks.
+struct ApplyIntentsChunk {
+  rocksdb::WriteBatch batch;
+  Result<IntraTxnWriteId> write_id = IntraTxnWriteId(0);
+  bool prepared = false;
+};
+
+// Task that prepares a chunk on the apply intents pool. The latch is counted down when the task is
+// destroyed, so the waiting thread is released even when the pool discards queued tasks on
+// shutdown. Such chunks are not marked as prepared, and are prepared by the waiting thread.
+class ApplyIntentsChunkTask {
+ public:
+  ApplyIntentsChunkTask(std::function<void()> prepare, CountDownLatch* latch)
+      : prepare_(std::move(prepare)), latch_(latch) {}
+
+  ApplyIntentsChunkTask(const ApplyIntentsChunkTask&) = delete;
+  void operator=(const ApplyIntentsChunkTask&) = delete;
+
+  ~ApplyIntentsChunkTask() {
+    latch_->CountDown();
+  }
+
+  void Run() {
+    prepare_();
+  }
+
+ private:
+  std::function<void()> prepare_;
+  CountDownLatch* latch_;
+};
+
 } // namespace
 
 class Tablet::RegularRocksDbListener : public rocksdb::EventListener {
@@ -384,6 +431,7 @@ Tablet::Tablet(const TabletInitData& data)
       log_prefix_suffix_(data.log_prefix_suffix),
       is_sys_catalog_(data.is_sys_catalog),
       txns_enabled_(data.txns_enabled),
+      apply_intents_pool_(data.apply_intents_pool),
       retention_policy_(std::make_shared<TabletRetentionPolicy>(
           clock_, data.allowed_history_cutoff_provider, metadata_.get())) {
   CHECK(schema()->has_column_ids());
@@ -423,7 +471,7 @@ Tablet::Tablet(const TabletInitData& data)
       data.transaction_participant_context &&
       (is_sys_catalog_ || transactional)) {
     transaction_participant_ = std::make_unique<TransactionParticipant>(
-        data.transaction_participant_context, this, tablet_metrics_entity_);
+        data.transaction_participant_context, this, tablet_metrics_entity_, data.wait_queue_pool);
     // Create transaction manager for secondary index update.
     if (has_index) {
       transaction_manager_ = std::make_unique<client::TransactionManager>(
@@ -712,6 +760,8 @@ Status Tablet::OpenKeyValueTablet() {
     LOG_WITH_PREFIX(INFO) << "Opening intents DB at: " << db_dir + kIntentsDBSuffix;
     rocksdb::Options intents_rocksdb_options(rocksdb_options);
     docdb::SetLogPrefix(&intents_rocksdb_options, LogPrefix(docdb::StorageDbType::kIntents));
+    // Applied intents are erased from the memtable in place, that requires a single writer.
+    docdb::DisableConcurrentMemTableWrites(&intents_rocksdb_options);
 
     intents_rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
@@ -1664,9 +1714,16 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
+// Large transactions are split into key range chunks of reverse index, that are applied in
+// parallel, see ApplyIntentChunks.
 Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApplyData& data) {
   VLOG_WITH_PREFIX(4) << __func__ << ": " << data.transaction_id;
 
+  auto chunks_apply_state = VERIFY_RESULT(ApplyIntentChunks(data));
+  if (chunks_apply_state) {
+    return std::move(*chunks_apply_state);
+  }
+
   rocksdb::WriteBatch regular_write_batch;
   auto new_apply_state = VERIFY_RESULT(docdb::PrepareApplyIntentsBatch(
       tablet_id(), data.transaction_id, data.aborted, data.commit_ht, &key_bounds_,
@@ -1681,6 +1738,85 @@ Result<docdb::ApplyTransactionState> Tablet::ApplyIntents(const TransactionApply
   return new_apply_state;
 }
 
+// Applies a single round of at most txn_apply_intents_parallelism chunks, so each step of apply
+// is limited as in PrepareApplyIntentsBatch. The last chunk batch also stores apply state and
+// frontiers, and the transaction participant schedules the next step while apply state is active.
+// Other chunks are written without them, so if tablet is restarted before the last batch is
+// written, then apply is repeated from the previous position. It is safe, because the same intents
+// are applied with the same keys and values.
+Result<boost::optional<docdb::ApplyTransactionState>> Tablet::ApplyIntentChunks(
+    const TransactionApplyData& data) {
+  const size_t parallelism = std::max(GetAtomicFlag(&FLAGS_txn_apply_intents_parallelism), 1);
+  const size_t chunk_records = std::max(GetAtomicFlag(&FLAGS_txn_apply_intents_chunk_records), 0);
+  if (!apply_intents_pool_ || parallelism == 1 || chunk_records == 0) {
+    return boost::none;
+  }
+
+  // Number of records that could be applied in this step, the rest is applied by the following
+  // steps.
+  const size_t max_records = std::max(FLAGS_txn_max_apply_batch_records, 0);
+  const auto max_chunks = std::min(parallelism, max_records / chunk_records);
+  if (max_chunks == 0) {
+    return boost::none;
+  }
+  const auto& aborted = data.apply_state ? data.apply_state->aborted : data.aborted;
+  auto bounds = VERIFY_RESULT(docdb::SplitApplyIntents(
+      data.transaction_id, data.apply_state ? data.apply_state->key : std::string(),
+      chunk_records, max_chunks, intents_db_.get()));
+  if (bounds.size() <= 1) {
+    return boost::none;
+  }
+
+  const size_t num_chunks = bounds.size() - 1;
+  VLOG_WITH_PREFIX(2) << "Apply " << num_chunks << " chunks of " << data.transaction_id;
+  std::vector<ApplyIntentsChunk> chunks(num_chunks);
+  auto prepare = [this, &data, &aborted, &bounds, &chunks](size_t i) {
+    chunks[i].write_id = docdb::PrepareApplyIntentsChunk(
+        data.transaction_id, aborted, data.commit_ht, &key_bounds_, bounds[i], bounds[i + 1],
+        intents_db_.get(), &chunks[i].batch);
+    chunks[i].prepared = true;
+  };
+  // The last chunk is prepared by the current thread.
+  CountDownLatch latch(num_chunks - 1);
+  for (size_t i = 0; i + 1 < num_chunks; ++i) {
+    auto task = std::make_shared<ApplyIntentsChunkTask>([&prepare, i] { prepare(i); }, &latch);
+    WARN_NOT_OK(apply_intents_pool_->SubmitFunc([task] { task->Run(); }),
+                "Failed to submit apply intents chunk");
+  }
+  prepare(num_chunks - 1);
+  latch.Wait();
+
+  // Write id is taken from applied intents, so the previous one is a valid lower bound.
+  IntraTxnWriteId write_id = data.apply_state ? data.apply_state->write_id : 0;
+  for (size_t i = 0; i != num_chunks; ++i) {
+    if (!chunks[i].prepared) {
+      prepare(i);
+    }
+    write_id = std::max(write_id, VERIFY_RESULT(std::move(chunks[i].write_id)));
+  }
+
+  auto& last_batch = chunks.back().batch;
+  const auto transaction_id_slice = data.transaction_id.AsSlice();
+  docdb::ApplyTransactionState result;
+  if (bounds.back().empty()) {
+    // Transaction is fully applied.
+    if (data.apply_state) {
+      docdb::RemoveApplyState(transaction_id_slice, data.commit_ht, write_id, &last_batch);
+    }
+  } else {
+    result = docdb::StoreApplyState(
+        transaction_id_slice, bounds.back(), write_id, aborted, data.commit_ht, &last_batch);
+  }
+
+  for (size_t i = 0; i + 1 < num_chunks; ++i) {
+    WriteToRocksDB(nullptr /* frontiers */, &chunks[i].batch, StorageDbType::kRegular);
+  }
+  docdb::ConsensusFrontiers frontiers;
+  auto frontiers_ptr = data.op_id.empty() ? nullptr : InitFrontiers(data, &frontiers);
+  WriteToRocksDB(frontiers_ptr, &last_batch, StorageDbType::kRegular);
+  return result;
+}
+
 template <class Ids>
 CHECKED_STATUS Tablet::RemoveIntentsImpl(const RemoveIntentsData& data, const Ids& ids) {
   auto scoped_read_operation = CreateNonAbortableScopedRWOperation();
@@ -687,6 +687,16 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
     return txns_enabled_;
   }
 
+  // Whether this tablet is hosted by a witness replica, i.e. only keeps the Raft log and does not
+  // apply data operations to RocksDB.
+  bool is_witness() const {
+    return is_witness_.load(std::memory_order_acquire);
+  }
+
+  void SetWitness(bool value) {
+    is_witness_.store(value, std::memory_order_release);
+  }
+
   client::YBClient& client() {
     return *client_future_.get();
   }
@@ -857,6 +867,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   std::unique_ptr<rocksdb::DB> intents_db_;
   std::atomic<bool> rocksdb_shutdown_requested_{false};
 
+  std::atomic<bool> is_witness_{false};
+
   // Optional key bounds (see docdb::KeyBounds) served by this tablet.
   docdb::KeyBounds key_bounds_;
 
@@ -928,6 +940,12 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   template <class Ids>
   CHECKED_STATUS RemoveIntentsImpl(const RemoveIntentsData& data, const Ids& ids);
 
+  // Applies one round of full chunks of transaction reverse index in parallel, each chunk is
+  // written with its own RocksDB batch. Returns apply state after this round, or none if the
+  // transaction should be applied sequentially.
+  Result<boost::optional<docdb::ApplyTransactionState>> ApplyIntentChunks(
+      const TransactionApplyData& data);
+
   // Tries to find intent .SST files that could be deleted and remove them.
   void CleanupIntentFiles();
   void DoCleanupIntentFiles();
@@ -955,6 +973,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<ThreadPoolToken> cleanup_intent_files_token_;
 
+  ThreadPool* const apply_intents_pool_;
+
   std::unique_ptr<TabletSnapshots> snapshots_;
 
   SnapshotCoordinator* snapshot_coordinator_ = nullptr;
@@ -57,6 +57,7 @@
 
 DECLARE_bool(skip_flushed_entries);
 DECLARE_int32(retryable_request_timeout_secs);
+DECLARE_bool(tablet_bootstrap_prefetch_log_segments);
 
 using std::shared_ptr;
 using std::string;
@@ -511,6 +512,43 @@ TEST_F(BootstrapTest, TestBootstrapHighOpIdIndex) {
   ASSERT_OPID_EQ(last_opid, boot_info.last_committed_id);
 }
 
+// Replays a log of many segments with and without prefetching of the next segment, and reports
+// bootstrap time.
+TEST_F(BootstrapTest, PrefetchLogSegments) {
+  constexpr int kNumSegments = 20;
+  constexpr int kBatchesPerSegment = NonTsanVsTsan(200, 20);
+
+  for (bool prefetch : {false, true}) {
+    FLAGS_tablet_bootstrap_prefetch_log_segments = prefetch;
+    CleanTablet();
+    test_hooks_->Clear();
+    BuildLog();
+    const auto first_index = current_index_;
+    for (int segment = 0; segment != kNumSegments; ++segment) {
+      if (segment != 0) {
+        ASSERT_OK(RollLog());
+      }
+      for (int i = 0; i != kBatchesPerSegment; ++i) {
+        OpIdPB opid = MakeOpId(1, current_index_);
+        AppendReplicateBatch(
+            opid, opid, {TupleForAppend(narrow_cast<int32_t>(current_index_), i, "row")});
+        ++current_index_;
+      }
+    }
+
+    TabletPtr tablet;
+    ConsensusBootstrapInfo boot_info;
+    auto start = MonoTime::Now();
+    ASSERT_OK(BootstrapTestTablet(&tablet, &boot_info));
+    LOG(INFO) << "Bootstrap with prefetch " << prefetch << " of " << kNumSegments
+              << " segments took " << MonoTime::Now() - start;
+
+    ASSERT_EQ(current_index_ - first_index,
+              static_cast<int64_t>(test_hooks_->actual_report.replayed.size()));
+    ASSERT_EQ(current_index_ - 1, boot_info.last_id.index());
+  }
+}
+
 struct BootstrapInputEntry {
   const OpId& op_id() const { return batch_data.op_id; }
 
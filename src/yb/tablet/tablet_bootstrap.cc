@@ -32,6 +32,7 @@
 
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
 #include <map>
 #include <set>
 
@@ -52,6 +53,7 @@
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/consensus/retryable_requests.h"
 
 #include "yb/docdb/consensus_frontier.h"
@@ -97,6 +99,7 @@
 #include "yb/util/status.h"
 #include "yb/util/status_format.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 
 DEFINE_bool(skip_remove_old_recovery_dir, false,
             "Skip removing WAL recovery dir after startup. (useful for debugging)");
@@ -130,6 +133,12 @@ DEFINE_uint64(transaction_status_tablet_log_segment_size_bytes, 4_MB,
 DEFINE_test_flag(int32, tablet_bootstrap_delay_ms, 0,
                  "Time (in ms) to delay tablet bootstrap by.");
 
+DEFINE_bool(tablet_bootstrap_prefetch_log_segments, true,
+            "Read and decode the next log segment in background, while entries of the current "
+            "segment are replayed during tablet bootstrap.");
+TAG_FLAG(tablet_bootstrap_prefetch_log_segments, advanced);
+TAG_FLAG(tablet_bootstrap_prefetch_log_segments, runtime);
+
 namespace yb {
 namespace tablet {
 
@@ -176,6 +185,47 @@ static string DebugInfo(const string& tablet_id,
                     segment_path, debug_str);
 }
 
+// ================================================================================================
+// Class SegmentPrefetcher.
+// ================================================================================================
+
+// Reads entries of a log segment in the thread pool, so reading, CRC checking and decoding of the
+// next segment overlaps with the replay of the current one. When pool is null, entries are read
+// synchronously by Get.
+class SegmentPrefetcher {
+ public:
+  explicit SegmentPrefetcher(ThreadPool* pool) : pool_(pool) {}
+
+  void Start(const scoped_refptr<ReadableLogSegment>& segment) {
+    segment_ = segment;
+    if (!pool_) {
+      return;
+    }
+    auto promise = std::make_shared<std::promise<log::ReadEntriesResult>>();
+    future_ = promise->get_future();
+    auto status = pool_->SubmitFunc([segment, promise] {
+      promise->set_value(segment->ReadEntries());
+    });
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to submit prefetch of " << segment->path() << ": " << status;
+      future_ = std::future<log::ReadEntriesResult>();
+    }
+  }
+
+  // Returns entries of the segment passed to the last Start.
+  log::ReadEntriesResult Get() {
+    if (future_.valid()) {
+      return future_.get();
+    }
+    return segment_->ReadEntries();
+  }
+
+ private:
+  ThreadPool* const pool_;
+  scoped_refptr<ReadableLogSegment> segment_;
+  std::future<log::ReadEntriesResult> future_;
+};
+
 // ================================================================================================
 // Class ReplayState.
 // ================================================================================================
@@ -486,6 +536,7 @@ class TabletBootstrap {
         listener_(data.listener),
         append_pool_(data.append_pool),
         allocation_pool_(data.allocation_pool),
+        log_sync_group_(data.log_sync_group),
       skip_wal_rewrite_(FLAGS_skip_wal_rewrite) ,
         test_hooks_(data.test_hooks) {
   }
@@ -523,6 +574,8 @@ class TabletBootstrap {
     }
 
     const bool has_blocks = VERIFY_RESULT(OpenTablet());
+    tablet_->SetWitness(consensus::IsRaftConfigWitness(
+        meta_->fs_manager()->uuid(), cmeta_->committed_config()));
 
     const auto needs_recovery = VERIFY_RESULT(PrepareToReplay());
     if (needs_recovery && !skip_wal_rewrite_) {
@@ -774,6 +827,7 @@ class TabletBootstrap {
     const auto& metadata = *tablet_->metadata();
     log_options.retention_secs = metadata.wal_retention_secs();
     log_options.env = GetEnv();
+    log_options.sync_group = log_sync_group_;
     if (tablet_->metadata()->table_type() == TableType::TRANSACTION_STATUS_TABLE_TYPE) {
       auto log_segment_size = FLAGS_transaction_status_tablet_log_segment_size_bytes;
       if (log_segment_size) {
@@ -900,6 +954,19 @@ class TabletBootstrap {
     if (test_hooks_) {
       test_hooks_->Replayed(yb::OpId::FromPB(replicate->id()), already_applied_to_regular_db);
     }
+    if (tablet_->is_witness()) {
+      switch (op_type) {
+        case consensus::WRITE_OP: FALLTHROUGH_INTENDED;
+        case consensus::TRUNCATE_OP: FALLTHROUGH_INTENDED;
+        case consensus::UPDATE_TRANSACTION_OP: FALLTHROUGH_INTENDED;
+        case consensus::SNAPSHOT_OP: FALLTHROUGH_INTENDED;
+        case consensus::HISTORY_CUTOFF_OP:
+          // Witness replicas do not apply data operations.
+          return Status::OK();
+        default:
+          break;
+      }
+    }
     switch (op_type) {
       case consensus::WRITE_OP:
         return PlayWriteRequest(replicate, already_applied_to_regular_db);
@@ -1247,10 +1314,18 @@ class TabletBootstrap {
     yb::OpId last_committed_op_id;
     yb::OpId last_read_entry_op_id;
     RestartSafeCoarseTimePoint last_entry_time;
+    SegmentPrefetcher prefetcher(
+        GetAtomicFlag(&FLAGS_tablet_bootstrap_prefetch_log_segments) ? allocation_pool_ : nullptr);
+    if (iter != segments.end()) {
+      prefetcher.Start(*iter);
+    }
     for (; iter != segments.end(); ++iter) {
       const scoped_refptr<ReadableLogSegment>& segment = *iter;
 
-      auto read_result = segment->ReadEntries();
+      auto read_result = prefetcher.Get();
+      if (iter + 1 != segments.end()) {
+        prefetcher.Start(*(iter + 1));
+      }
       last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
       if (!read_result.entries.empty()) {
         last_read_entry_op_id = yb::OpId::FromPB(read_result.entries.back()->replicate().id());
@@ -1618,6 +1693,8 @@ class TabletBootstrap {
 
   ThreadPool* allocation_pool_;
 
+  log::LogSyncGroup* log_sync_group_;
+
   // Statistics on the replay of entries in the log.
   struct Stats {
     std::string ToString() const;
@@ -161,6 +161,7 @@ struct BootstrapTabletData {
   TabletStatusListener* listener = nullptr;
   ThreadPool* append_pool = nullptr;
   ThreadPool* allocation_pool = nullptr;
+  log::LogSyncGroup* log_sync_group = nullptr;
   consensus::RetryableRequests* retryable_requests = nullptr;
 
   std::shared_ptr<TabletBootstrapTestHooksIf> test_hooks = nullptr;
@@ -47,6 +47,7 @@ class ChangeMetadataOperation;
 class Operation;
 class OperationFilter;
 class SnapshotCoordinator;
+class SharedTransactionStatusCache;
 class SnapshotOperation;
 class SplitOperation;
 class TabletSnapshots;
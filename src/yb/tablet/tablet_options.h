@@ -33,6 +33,7 @@ class Cache;
 class EventListener;
 class MemoryMonitor;
 class Env;
+class PersistentCache;
 }
 
 namespace yb {
@@ -40,6 +41,7 @@ namespace yb {
 class Env;
 class MemTracker;
 class MetricRegistry;
+class ThreadPool;
 
 namespace tablet {
 
@@ -48,6 +50,7 @@ YB_STRONGLY_TYPED_BOOL(IsDropTable);
 // Common for all tablets within TabletManager.
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  std::shared_ptr<rocksdb::PersistentCache> persistent_cache;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
   yb::Env* env = Env::Default();
@@ -73,6 +76,11 @@ struct TabletInitData {
   SnapshotCoordinator* snapshot_coordinator = nullptr;
   TabletSplitter* tablet_splitter = nullptr;
   std::function<HybridTime(RaftGroupMetadata*)> allowed_history_cutoff_provider;
+  // Pool used to apply chunks of large transactions in parallel, null to apply sequentially.
+  ThreadPool* apply_intents_pool = nullptr;
+  // Pool used to resume operations waiting in the wait queue of transaction participant, null to
+  // resume them in the thread that resolves the transaction they wait for.
+  ThreadPool* wait_queue_pool = nullptr;
 };
 
 } // namespace tablet
@@ -47,6 +47,7 @@
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/multi_raft_batcher.h"
+#include "yb/consensus/raft_consensus.h"
 #include "yb/consensus/state_change_context.h"
 
 #include "yb/gutil/bind.h"
@@ -148,7 +149,8 @@ class TabletPeerTest : public YBTabletTest {
             tablet()->tablet_id()),
         &metric_registry_,
         nullptr, // tablet_splitter
-        std::shared_future<client::YBClient*>()));
+        std::shared_future<client::YBClient*>(),
+        nullptr)); // transaction_status_cache
 
     // Make TabletPeer use the same LogAnchorRegistry as the Tablet created by the harness.
     // TODO: Refactor TabletHarness to allow taking a LogAnchorRegistry, while also providing
@@ -435,6 +437,58 @@ TEST_F(TabletPeerTest, TestActiveOperationPreventsLogGC) {
   ASSERT_EQ(5, segments.size());
 }
 
+// Witness replica keeps data operations in the log, but does not apply them to RocksDB.
+TEST_F(TabletPeerTest, WitnessDoesNotApplyWrites) {
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  tablet()->SetWitness(true);
+  ASSERT_OK(ExecuteInsertsAndRollLogs(2));
+  auto last_log_opid = tablet_peer_->log_->GetLatestEntryOpId();
+  ASSERT_GE(last_log_opid.index, 2);
+
+  std::vector<std::string> rows;
+  ASSERT_OK(DumpTablet(*tablet(), client_schema_, &rows));
+  ASSERT_EQ(rows.size(), 0U) << yb::ToString(rows);
+
+  tablet()->SetWitness(false);
+  ASSERT_OK(ExecuteInsertsAndRollLogs(1));
+  ASSERT_OK(DumpTablet(*tablet(), client_schema_, &rows));
+  ASSERT_EQ(rows.size(), 1U) << yb::ToString(rows);
+}
+
+// Witness replica could not rebuild operations from its regular DB, so it keeps the log until
+// the operations are applied by a majority, instead of using flushed op ids.
+TEST_F(TabletPeerTest, WitnessLogGCUsesMajorityAppliedIndex) {
+  FLAGS_log_min_seconds_to_retain = 0;
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  tablet()->SetWitness(true);
+  Log* log = tablet_peer_->log();
+  ASSERT_OK(ExecuteInsertsAndRollLogs(3));
+  ASSERT_OK(tablet_peer_->tablet()->Flush(tablet::FlushMode::kSync));
+
+  log::SegmentSequence segments;
+  ASSERT_OK(log->GetLogReader()->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(4, segments.size());
+
+  // Nothing was reported as applied by a majority yet, so the whole log is retained.
+  int32_t num_gced = 0;
+  int64_t min_log_index = ASSERT_RESULT(tablet_peer_->GetEarliestNeededLogIndex());
+  ASSERT_EQ(min_log_index, 0);
+  ASSERT_OK(log->GC(min_log_index, &num_gced));
+  ASSERT_EQ(0, num_gced);
+
+  auto last_log_opid = log->GetLatestEntryOpId();
+  tablet_peer_->raft_consensus()->TEST_SetMajorityAppliedOpIndex(last_log_opid.index);
+  min_log_index = ASSERT_RESULT(tablet_peer_->GetEarliestNeededLogIndex());
+  ASSERT_GT(min_log_index, 0);
+  ASSERT_LE(min_log_index, last_log_opid.index);
+  ASSERT_OK(log->GC(min_log_index, &num_gced));
+  ASSERT_GT(num_gced, 0) << "Earliest needed: " << min_log_index;
+}
+
 TEST_F(TabletPeerTest, TestGCEmptyLog) {
   ConsensusBootstrapInfo info;
   ASSERT_OK(tablet_peer_->Start(info));
@@ -47,6 +47,7 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
+#include "yb/consensus/quorum_util.h"
 #include "yb/consensus/raft_consensus.h"
 #include "yb/consensus/retryable_requests.h"
 #include "yb/consensus/state_change_context.h"
@@ -159,7 +160,8 @@ TabletPeer::TabletPeer(
     Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
     MetricRegistry* metric_registry,
     TabletSplitter* tablet_splitter,
-    const std::shared_future<client::YBClient*>& client_future)
+    const std::shared_future<client::YBClient*>& client_future,
+    SharedTransactionStatusCache* transaction_status_cache)
     : meta_(meta),
       tablet_id_(meta->raft_group_id()),
       local_peer_pb_(local_peer_pb),
@@ -173,7 +175,8 @@ TabletPeer::TabletPeer(
       preparing_operations_counter_(operation_tracker_.LogPrefix()),
       metric_registry_(metric_registry),
       tablet_splitter_(tablet_splitter),
-      client_future_(client_future) {}
+      client_future_(client_future),
+      transaction_status_cache_(transaction_status_cache) {}
 
 TabletPeer::~TabletPeer() {
   std::lock_guard<simple_spinlock> lock(lock_);
@@ -290,7 +293,8 @@ Status TabletPeer::InitTabletPeer(
     operation_tracker_.SetPostTracker(
         std::bind(&RaftConsensus::TrackOperationMemory, consensus_.get(), _1));
 
-    prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    prepare_thread_ = std::make_unique<Preparer>(
+        consensus_.get(), tablet_prepare_pool, tablet_metric_entity);
 
     ChangeConfigReplicated(RaftConfig()); // Set initial flag value.
   }
@@ -355,6 +359,10 @@ Result<HybridTime> TabletPeer::PreparePeerRequest() {
     }
   }
 
+  return LeaderClosedTimestamp();
+}
+
+Result<HybridTime> TabletPeer::LeaderClosedTimestamp() {
   if (!FLAGS_propagate_safe_time) {
     return HybridTime::kInvalid;
   }
@@ -378,6 +386,7 @@ void TabletPeer::MajorityReplicated() {
 
 void TabletPeer::ChangeConfigReplicated(const RaftConfigPB& config) {
   tablet_->mvcc_manager()->SetLeaderOnlyMode(config.peers_size() == 1);
+  tablet_->SetWitness(consensus::IsRaftConfigWitness(permanent_uuid(), config));
 }
 
 uint64_t TabletPeer::NumSSTFiles() {
@@ -912,7 +921,15 @@ Result<int64_t> TabletPeer::GetEarliestNeededLogIndex(std::string* details) cons
     *details += Format("Last committed op id: $0\n", last_committed_op_id);
   }
 
-  if (tablet_->table_type() != TableType::TRANSACTION_STATUS_TABLE_TYPE) {
+  if (tablet_->is_witness()) {
+    // Witness does not apply operations, so instead of the flushed op ids it keeps the log until
+    // the operations are applied by a majority of the regular voters.
+    auto majority_applied_op_index = consensus_->MajorityAppliedOpIndex();
+    min_index = std::min(min_index, majority_applied_op_index);
+    if (details) {
+      *details += Format("Majority applied op index: $0\n", majority_applied_op_index);
+    }
+  } else if (tablet_->table_type() != TableType::TRANSACTION_STATUS_TABLE_TYPE) {
     tablet_->FlushIntentsDbIfNecessary(latest_log_entry_op_id);
     auto max_persistent_op_id = VERIFY_RESULT(
         tablet_->MaxPersistentOpId(true /* invalid_if_no_new_data */));
@@ -143,7 +143,8 @@ class TabletPeer : public consensus::ConsensusContext,
       Callback<void(std::shared_ptr<StateChangeContext> context)> mark_dirty_clbk,
       MetricRegistry* metric_registry,
       TabletSplitter* tablet_splitter,
-      const std::shared_future<client::YBClient*>& client_future);
+      const std::shared_future<client::YBClient*>& client_future,
+      SharedTransactionStatusCache* transaction_status_cache);
 
   ~TabletPeer();
 
@@ -320,13 +321,17 @@ class TabletPeer : public consensus::ConsensusContext,
     return clock_;
   }
 
-  void Enqueue(rpc::ThreadPoolTask* task);
+  void Enqueue(rpc::ThreadPoolTask* task) override;
   void StrandEnqueue(rpc::StrandTask* task) override;
 
   const std::shared_future<client::YBClient*>& client_future() const override {
     return client_future_;
   }
 
+  SharedTransactionStatusCache* transaction_status_cache() const override {
+    return transaction_status_cache_;
+  }
+
   int64_t LeaderTerm() const override;
   consensus::LeaderStatus LeaderStatus(bool allow_stale = false) const;
   Result<HybridTime> LeaderSafeTime() const override;
@@ -479,6 +484,7 @@ class TabletPeer : public consensus::ConsensusContext,
 
   Result<FixedHybridTimeLease> HybridTimeLease(HybridTime min_allowed, CoarseTimePoint deadline);
   Result<HybridTime> PreparePeerRequest() override;
+  Result<HybridTime> LeaderClosedTimestamp() override;
   void MajorityReplicated() override;
   void ChangeConfigReplicated(const consensus::RaftConfigPB& config) override;
   uint64_t NumSSTFiles() override;
@@ -500,6 +506,8 @@ class TabletPeer : public consensus::ConsensusContext,
 
   std::shared_future<client::YBClient*> client_future_;
 
+  SharedTransactionStatusCache* const transaction_status_cache_;
+
   rpc::Messenger* messenger_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletPeer);
@@ -29,8 +29,10 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/transaction_dump.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/rpc/poller.h"
+#include "yb/rpc/thread_pool.h"
 
 #include "yb/server/clock.h"
 
@@ -40,6 +42,7 @@
 #include "yb/tablet/remove_intents_task.h"
 #include "yb/tablet/running_transaction.h"
 #include "yb/tablet/running_transaction_context.h"
+#include "yb/tablet/shared_transaction_status_cache.h"
 #include "yb/tablet/transaction_loader.h"
 #include "yb/tablet/transaction_participant_context.h"
 #include "yb/tablet/transaction_status_resolver.h"
@@ -90,6 +93,7 @@ DEFINE_uint64(transactions_status_poll_interval_ms, 500 * yb::kTimeMultiplier,
 DEFINE_bool(transactions_poll_check_aborted, true, "Check aborted transactions during poll.");
 
 DECLARE_int64(transaction_abort_check_timeout_ms);
+DECLARE_int32(wait_queue_poll_interval_ms);
 
 METRIC_DEFINE_simple_counter(
     tablet, transaction_not_found, "Total number of missing transactions during load",
@@ -119,11 +123,13 @@ class TransactionParticipant::Impl
     : public RunningTransactionContext, public TransactionLoaderContext {
  public:
   Impl(TransactionParticipantContext* context, TransactionIntentApplier* applier,
-       const scoped_refptr<MetricEntity>& entity)
-      : RunningTransactionContext(context, applier),
+       const scoped_refptr<MetricEntity>& entity, ThreadPool* wait_queue_pool)
+      : RunningTransactionContext(context, applier, entity),
         log_prefix_(context->LogPrefix()),
         loader_(this, entity),
-        poller_(log_prefix_, std::bind(&Impl::Poll, this)) {
+        poller_(log_prefix_, std::bind(&Impl::Poll, this)),
+        wait_queue_(std::make_shared<docdb::WaitQueue>(log_prefix_, entity, wait_queue_pool)),
+        wait_queue_poller_(log_prefix_, std::bind(&Impl::PollWaitQueue, this)) {
     LOG_WITH_PREFIX(INFO) << "Create";
     metric_transactions_running_ = METRIC_transactions_running.Instantiate(entity, 0);
     metric_transaction_not_found_ = METRIC_transaction_not_found.Instantiate(entity);
@@ -145,6 +151,8 @@ class TransactionParticipant::Impl
     }
 
     poller_.Shutdown();
+    wait_queue_poller_.Shutdown();
+    wait_queue_->Shutdown();
 
     if (start_latch_.count()) {
       start_latch_.CountDown();
@@ -166,6 +174,7 @@ class TransactionParticipant::Impl
       status_resolvers.swap(status_resolvers_);
     }
 
+    status_batcher_.Shutdown();
     rpcs_.Shutdown();
     loader_.Shutdown();
     for (auto& resolver : status_resolvers) {
@@ -533,6 +542,18 @@ class TransactionParticipant::Impl
         transactions_.modify(lock_and_iterator.iterator, [&data](auto& txn) {
           txn->SetLocalCommitData(data.commit_ht, data.aborted);
         });
+        // Other tablets of this server could have intents of the same transaction, so they
+        // could use commit time without asking the coordinator.
+        auto* status_cache = participant_context_.transaction_status_cache();
+        if (status_cache) {
+          status_cache->Put(TransactionStatusInfo {
+            .transaction_id = data.transaction_id,
+            .status = TransactionStatus::COMMITTED,
+            .aborted_subtxn_set = data.aborted,
+            .status_ht = data.commit_ht,
+            .coordinator_safe_time = HybridTime(),
+          });
+        }
 
         LOG_IF_WITH_PREFIX(DFATAL, data.log_ht < last_safe_time_)
             << "Apply transaction before last safe time " << data.transaction_id
@@ -1019,6 +1040,8 @@ class TransactionParticipant::Impl
 
     poller_.Start(
         &participant_context_.scheduler(), 1ms * FLAGS_transactions_status_poll_interval_ms);
+    wait_queue_poller_.Start(
+        &participant_context_.scheduler(), 1ms * FLAGS_wait_queue_poll_interval_ms);
   }
 
   void TransactionsModifiedUnlocked(MinRunningNotifier* min_running_notifier) REQUIRES(mutex_) {
@@ -1246,6 +1269,10 @@ class TransactionParticipant::Impl
     return result;
   }
 
+  docdb::WaitQueue* wait_queue() const {
+    return wait_queue_.get();
+  }
+
   const std::string& LogPrefix() const override {
     return log_prefix_;
   }
@@ -1263,10 +1290,26 @@ class TransactionParticipant::Impl
     LOG_IF_WITH_PREFIX(DFATAL, !recently_removed_transactions_.insert(transaction.id()).second)
         << "Transaction removed twice: " << transaction.id();
     VLOG_WITH_PREFIX(4) << "Remove transaction: " << transaction.id();
+    if (wait_queue_->HasWaiters()) {
+      // Waiters are resumed in the thread pool, since they resolve conflicts again.
+      participant_context_.Enqueue(rpc::MakeFunctorThreadPoolTask(
+          [wait_queue = wait_queue_, id = transaction.id()] {
+        wait_queue->SignalResolved(id);
+      }));
+    }
     transactions_.erase(it);
     TransactionsModifiedUnlocked(min_running_notifier);
   }
 
+  void PollWaitQueue() {
+    if (!wait_queue_->HasWaiters()) {
+      return;
+    }
+    participant_context_.Enqueue(rpc::MakeFunctorThreadPoolTask([wait_queue = wait_queue_] {
+      wait_queue->Poll(CoarseMonoClock::now());
+    }));
+  }
+
   void CleanupRecentlyRemovedTransactions(CoarseTimePoint now) {
     while (!recently_removed_transactions_cleanup_queue_.empty() &&
            recently_removed_transactions_cleanup_queue_.front().time <= now) {
@@ -1553,12 +1596,15 @@ class TransactionParticipant::Impl
   LRUCache<TransactionId> cleanup_cache_{FLAGS_transactions_cleanup_cache_size};
 
   rpc::Poller poller_;
+
+  std::shared_ptr<docdb::WaitQueue> wait_queue_;
+  rpc::Poller wait_queue_poller_;
 };
 
 TransactionParticipant::TransactionParticipant(
     TransactionParticipantContext* context, TransactionIntentApplier* applier,
-    const scoped_refptr<MetricEntity>& entity)
-    : impl_(new Impl(context, applier, entity)) {
+    const scoped_refptr<MetricEntity>& entity, ThreadPool* wait_queue_pool)
+    : impl_(new Impl(context, applier, entity, wait_queue_pool)) {
 }
 
 TransactionParticipant::~TransactionParticipant() {
@@ -1660,6 +1706,10 @@ TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
 
+docdb::WaitQueue* TransactionParticipant::wait_queue() const {
+  return impl_->wait_queue();
+}
+
 HybridTime TransactionParticipant::MinRunningHybridTime() const {
   return impl_->MinRunningHybridTime();
 }
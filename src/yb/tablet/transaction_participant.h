@@ -54,6 +54,7 @@ class MetricEntity;
 class HybridTime;
 class OneWayBitmap;
 class RWOperationCounter;
+class ThreadPool;
 class TransactionMetadataPB;
 
 namespace tserver {
@@ -104,7 +105,7 @@ class TransactionParticipant : public TransactionStatusManager {
  public:
   TransactionParticipant(
       TransactionParticipantContext* context, TransactionIntentApplier* applier,
-      const scoped_refptr<MetricEntity>& entity);
+      const scoped_refptr<MetricEntity>& entity, ThreadPool* wait_queue_pool = nullptr);
   virtual ~TransactionParticipant();
 
   // Notify participant that this context is ready and it could start performing its requests.
@@ -171,6 +172,9 @@ class TransactionParticipant : public TransactionStatusManager {
 
   TransactionParticipantContext* context() const;
 
+  // Queue of transactional writes waiting for conflicting transactions at this tablet.
+  docdb::WaitQueue* wait_queue() const;
+
   HybridTime MinRunningHybridTime() const override;
 
   Result<HybridTime> WaitForSafeTime(HybridTime safe_time, CoarseTimePoint deadline) override;
@@ -35,11 +35,18 @@ class TransactionParticipantContext {
   virtual const server::ClockPtr& clock_ptr() const = 0;
   virtual rpc::Scheduler& scheduler() const = 0;
 
+  // Cache of final transaction statuses shared by all tablets of the server, could be null.
+  virtual SharedTransactionStatusCache* transaction_status_cache() const = 0;
+
   // Fills RemoveIntentsData with information about replicated state.
   virtual void GetLastReplicatedData(RemoveIntentsData* data) = 0;
 
   // Enqueue task to participant context strand.
   virtual void StrandEnqueue(rpc::StrandTask* task) = 0;
+
+  // Enqueue task to participant context thread pool.
+  virtual void Enqueue(rpc::ThreadPoolTask* task) = 0;
+
   virtual void UpdateClock(HybridTime hybrid_time) = 0;
   virtual bool IsLeader() = 0;
   virtual void SubmitUpdateTransaction(
@@ -0,0 +1,436 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/transaction_status_batcher.h"
+
+#include <deque>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/optional.hpp>
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/rpc/scheduler.h"
+
+#include "yb/server/logical_clock.h"
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+#include "yb/tablet/transaction_participant_context.h"
+#include "yb/tablet/transaction_status_resolver.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/metrics.h"
+#include "yb/util/result.h"
+#include "yb/util/status_log.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int32(max_transactions_in_status_request);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+const TabletId kStatusTablet = "status_tablet";
+const TabletId kOtherStatusTablet = "other_status_tablet";
+
+class TestParticipantContext : public TransactionParticipantContext {
+ public:
+  explicit TestParticipantContext(SharedTransactionStatusCache* cache)
+      : clock_(server::LogicalClock::CreateStartingAt(HybridTime::kInitial)),
+        scheduler_(&io_service_),
+        cache_(cache) {
+  }
+
+  ~TestParticipantContext() {
+    scheduler_.Shutdown();
+  }
+
+  const std::string& permanent_uuid() const override {
+    return permanent_uuid_;
+  }
+
+  const std::string& tablet_id() const override {
+    return tablet_id_;
+  }
+
+  const std::shared_future<client::YBClient*>& client_future() const override {
+    return client_future_;
+  }
+
+  const server::ClockPtr& clock_ptr() const override {
+    return clock_;
+  }
+
+  rpc::Scheduler& scheduler() const override {
+    return scheduler_;
+  }
+
+  SharedTransactionStatusCache* transaction_status_cache() const override {
+    return cache_;
+  }
+
+  void GetLastReplicatedData(RemoveIntentsData* data) override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  void StrandEnqueue(rpc::StrandTask* task) override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  void Enqueue(rpc::ThreadPoolTask* task) override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  void UpdateClock(HybridTime hybrid_time) override {
+    clock_->Update(hybrid_time);
+  }
+
+  bool IsLeader() override {
+    return true;
+  }
+
+  void SubmitUpdateTransaction(std::unique_ptr<UpdateTxnOperation> state, int64_t term) override {
+    LOG(FATAL) << "Not supported";
+  }
+
+  HybridTime SafeTimeForTransactionParticipant() override {
+    return clock_->Now();
+  }
+
+  Result<HybridTime> WaitForSafeTime(HybridTime safe_time, CoarseTimePoint deadline) override {
+    return STATUS(NotSupported, "WaitForSafeTime is not supported");
+  }
+
+ private:
+  const std::string permanent_uuid_ = "test_peer";
+  const std::string tablet_id_ = "test_tablet";
+  std::shared_future<client::YBClient*> client_future_;
+  server::ClockPtr clock_;
+  boost::asio::io_service io_service_;
+  mutable rpc::Scheduler scheduler_;
+  SharedTransactionStatusCache* cache_;
+};
+
+// Batcher that remembers sent requests instead of sending RPCs, so test could respond to them.
+class TestTransactionStatusBatcher : public TransactionStatusBatcher {
+ public:
+  struct SentRequest {
+    TabletId status_tablet;
+    std::vector<TransactionId> ids;
+    client::GetTransactionStatusCallback callback;
+  };
+
+  using TransactionStatusBatcher::TransactionStatusBatcher;
+
+  size_t num_sent() const {
+    return sent_.size();
+  }
+
+  // Removes the oldest sent request, so its callback could be invoked by test.
+  SentRequest PopSent() {
+    CHECK(!sent_.empty());
+    auto result = std::move(sent_.front());
+    sent_.erase(sent_.begin());
+    return result;
+  }
+
+ protected:
+  bool SendRpc(
+      tserver::GetTransactionStatusRequestPB* req, rpc::Rpcs::Handle* handle,
+      client::GetTransactionStatusCallback callback) override {
+    SentRequest sent {
+      .status_tablet = req->tablet_id(),
+      .ids = {},
+      .callback = std::move(callback),
+    };
+    for (const auto& id : req->transaction_id()) {
+      sent.ids.push_back(CHECK_RESULT(FullyDecodeTransactionId(id)));
+    }
+    sent_.push_back(std::move(sent));
+    return true;
+  }
+
+ private:
+  std::vector<SentRequest> sent_;
+};
+
+struct ReceivedStatus {
+  Status status;
+  tserver::GetTransactionStatusResponsePB response;
+};
+
+// Status time reported by the status tablet for the transaction with the specified index.
+HybridTime StatusTime(size_t idx) {
+  return HybridTime(1000 + idx);
+}
+
+tserver::GetTransactionStatusResponsePB MakeResponse(
+    const std::vector<TransactionId>& ids, TransactionStatus status) {
+  tserver::GetTransactionStatusResponsePB response;
+  for (size_t i = 0; i != ids.size(); ++i) {
+    response.add_status(status);
+    response.add_status_hybrid_time(StatusTime(i).ToUint64());
+    response.add_aborted_subtxn_set();
+  }
+  return response;
+}
+
+} // namespace
+
+class TransactionStatusBatcherTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    FLAGS_max_transactions_in_status_request = 128;
+  }
+
+  void TearDown() override {
+    batcher_->Shutdown();
+    YBTest::TearDown();
+  }
+
+  void Init(SharedTransactionStatusCache* cache = nullptr) {
+    context_.emplace(cache);
+    batcher_.emplace(&*context_, &rpcs_, scoped_refptr<MetricEntity>());
+  }
+
+  // Requests status of a new transaction, received status is stored to the returned index in
+  // received_.
+  size_t Request(const TabletId& status_tablet = kStatusTablet) {
+    return Request(TransactionId::GenerateRandom(), status_tablet);
+  }
+
+  size_t Request(const TransactionId& id, const TabletId& status_tablet = kStatusTablet) {
+    auto idx = received_.size();
+    received_.emplace_back();
+    batcher_->RequestStatus(
+        status_tablet, id,
+        [this, idx](const Status& status, const tserver::GetTransactionStatusResponsePB& resp) {
+      auto& received = received_[idx];
+      ASSERT_FALSE(received) << "Callback invoked twice for request " << idx;
+      received = ReceivedStatus {
+        .status = status,
+        .response = resp,
+      };
+    });
+    return idx;
+  }
+
+  // Responds to the oldest sent request, marking all its transactions as pending.
+  std::vector<TransactionId> RespondPending() {
+    auto sent = batcher_->PopSent();
+    sent.callback(Status::OK(), MakeResponse(sent.ids, TransactionStatus::PENDING));
+    return sent.ids;
+  }
+
+  rpc::Rpcs rpcs_;
+  boost::optional<TestParticipantContext> context_;
+  boost::optional<TestTransactionStatusBatcher> batcher_;
+  std::deque<boost::optional<ReceivedStatus>> received_;
+};
+
+// Requests that arrive while RPC to their status tablet is in flight, are sent together in the
+// next RPC, and each of them receives its own part of the response.
+TEST_F(TransactionStatusBatcherTest, Coalescing) {
+  Init();
+
+  auto first = Request();
+  ASSERT_EQ(batcher_->num_sent(), 1U);
+
+  constexpr size_t kQueued = 5;
+  std::vector<size_t> queued;
+  for (size_t i = 0; i != kQueued; ++i) {
+    queued.push_back(Request());
+  }
+  // Status tablet has RPC in flight, so queued requests are not sent yet.
+  ASSERT_EQ(batcher_->num_sent(), 1U);
+
+  // Other status tablet does not wait for RPC to the first one.
+  auto other = Request(kOtherStatusTablet);
+  ASSERT_EQ(batcher_->num_sent(), 2U);
+
+  ASSERT_EQ(RespondPending().size(), 1U);
+  ASSERT_TRUE(received_[first]);
+  ASSERT_OK(received_[first]->status);
+
+  // All queued requests are sent in one RPC after the response is received.
+  ASSERT_EQ(batcher_->num_sent(), 2U);
+  auto sent = batcher_->PopSent();
+  ASSERT_EQ(sent.status_tablet, kOtherStatusTablet);
+  ASSERT_EQ(sent.ids.size(), 1U);
+  sent.callback(Status::OK(), MakeResponse(sent.ids, TransactionStatus::PENDING));
+  ASSERT_TRUE(received_[other]);
+
+  sent = batcher_->PopSent();
+  ASSERT_EQ(sent.status_tablet, kStatusTablet);
+  ASSERT_EQ(sent.ids.size(), kQueued);
+  for (auto idx : queued) {
+    ASSERT_FALSE(received_[idx]);
+  }
+
+  // Every transaction gets different status time, so the response could be checked to be split
+  // correctly.
+  auto response = MakeResponse(sent.ids, TransactionStatus::PENDING);
+  response.set_propagated_hybrid_time(StatusTime(kQueued).ToUint64());
+  sent.callback(Status::OK(), response);
+
+  for (size_t i = 0; i != kQueued; ++i) {
+    const auto& received = received_[queued[i]];
+    ASSERT_TRUE(received);
+    ASSERT_OK(received->status);
+    const auto& resp = received->response;
+    ASSERT_EQ(resp.status().size(), 1);
+    ASSERT_EQ(resp.status(0), TransactionStatus::PENDING);
+    ASSERT_EQ(resp.status_hybrid_time().size(), 1);
+    ASSERT_EQ(HybridTime(resp.status_hybrid_time(0)), StatusTime(i));
+    ASSERT_EQ(resp.aborted_subtxn_set().size(), 1);
+    ASSERT_EQ(resp.propagated_hybrid_time(), StatusTime(kQueued).ToUint64());
+  }
+
+  // There is nothing to send after the last response.
+  ASSERT_EQ(batcher_->num_sent(), 0U);
+}
+
+// Queued requests are split to RPCs with at most --max_transactions_in_status_request
+// transactions.
+TEST_F(TransactionStatusBatcherTest, BatchSizeLimit) {
+  constexpr size_t kMaxBatchSize = 2;
+  constexpr size_t kQueued = 5;
+  FLAGS_max_transactions_in_status_request = kMaxBatchSize;
+  Init();
+
+  Request();
+  for (size_t i = 0; i != kQueued; ++i) {
+    Request();
+  }
+  ASSERT_EQ(batcher_->num_sent(), 1U);
+
+  std::vector<size_t> batch_sizes;
+  while (batcher_->num_sent()) {
+    batch_sizes.push_back(RespondPending().size());
+    // Batches are sent one after another, so at most one RPC is in flight.
+    ASSERT_LE(batcher_->num_sent(), 1U);
+  }
+  ASSERT_EQ(batch_sizes, std::vector<size_t>({1, 2, 2, 1}));
+
+  for (const auto& received : received_) {
+    ASSERT_TRUE(received);
+    ASSERT_OK(received->status);
+  }
+}
+
+// Failure of RPC, or error in its response, is delivered to every transaction in the batch.
+TEST_F(TransactionStatusBatcherTest, ErrorFanOut) {
+  Init();
+
+  Request();
+  std::vector<size_t> failed;
+  for (int i = 0; i != 3; ++i) {
+    failed.push_back(Request());
+  }
+  RespondPending();
+
+  auto sent = batcher_->PopSent();
+  ASSERT_EQ(sent.ids.size(), failed.size());
+  sent.callback(STATUS(TimedOut, "Status RPC timed out"),
+                tserver::GetTransactionStatusResponsePB());
+  for (auto idx : failed) {
+    ASSERT_TRUE(received_[idx]);
+    ASSERT_TRUE(received_[idx]->status.IsTimedOut()) << received_[idx]->status;
+  }
+
+  // Batcher keeps working after failure.
+  failed.clear();
+  for (int i = 0; i != 2; ++i) {
+    failed.push_back(Request());
+  }
+  sent = batcher_->PopSent();
+  ASSERT_EQ(sent.ids.size(), 1U);
+  tserver::GetTransactionStatusResponsePB response;
+  StatusToPB(STATUS(NotFound, "Status tablet not found"),
+             response.mutable_error()->mutable_status());
+  sent.callback(Status::OK(), response);
+  ASSERT_TRUE(received_[failed[0]]);
+  ASSERT_TRUE(received_[failed[0]]->status.IsNotFound()) << received_[failed[0]]->status;
+
+  sent = batcher_->PopSent();
+  ASSERT_EQ(sent.ids.size(), 1U);
+  sent.callback(STATUS(NetworkError, "Status tablet unreachable"),
+                tserver::GetTransactionStatusResponsePB());
+  ASSERT_TRUE(received_[failed[1]]);
+  ASSERT_TRUE(received_[failed[1]]->status.IsNetworkError()) << received_[failed[1]]->status;
+
+  ASSERT_EQ(batcher_->num_sent(), 0U);
+}
+
+// Shutdown fails queued requests immediately, while RPC in flight still delivers its response.
+TEST_F(TransactionStatusBatcherTest, ShutdownWithPendingRequests) {
+  Init();
+
+  auto in_flight = Request();
+  std::vector<size_t> queued;
+  for (int i = 0; i != 3; ++i) {
+    queued.push_back(Request());
+  }
+  ASSERT_EQ(batcher_->num_sent(), 1U);
+
+  batcher_->Shutdown();
+  for (auto idx : queued) {
+    ASSERT_TRUE(received_[idx]);
+    ASSERT_TRUE(received_[idx]->status.IsAborted()) << received_[idx]->status;
+  }
+  ASSERT_FALSE(received_[in_flight]);
+
+  // Requests after shutdown fail without sending RPC.
+  auto after_shutdown = Request();
+  ASSERT_TRUE(received_[after_shutdown]);
+  ASSERT_TRUE(received_[after_shutdown]->status.IsAborted()) << received_[after_shutdown]->status;
+
+  RespondPending();
+  ASSERT_TRUE(received_[in_flight]);
+  ASSERT_OK(received_[in_flight]->status);
+  ASSERT_EQ(batcher_->num_sent(), 0U);
+
+  // Batcher is destroyed after TearDown, and checks that there are no active queues.
+}
+
+// Final status received from the status tablet is taken from shared cache by subsequent
+// requests, without sending RPC.
+TEST_F(TransactionStatusBatcherTest, SharedCache) {
+  SharedTransactionStatusCache cache(16, scoped_refptr<MetricEntity>());
+  Init(&cache);
+
+  auto id = TransactionId::GenerateRandom();
+  Request(id);
+  auto sent = batcher_->PopSent();
+  sent.callback(Status::OK(), MakeResponse(sent.ids, TransactionStatus::COMMITTED));
+  ASSERT_EQ(cache.size(), 1U);
+
+  auto idx = Request(id);
+  ASSERT_EQ(batcher_->num_sent(), 0U);
+  ASSERT_TRUE(received_[idx]);
+  ASSERT_OK(received_[idx]->status);
+  ASSERT_EQ(received_[idx]->response.status(0), TransactionStatus::COMMITTED);
+  ASSERT_EQ(HybridTime(received_[idx]->response.status_hybrid_time(0)), StatusTime(0));
+
+  // Pending status is not cached.
+  auto pending = Request();
+  RespondPending();
+  ASSERT_TRUE(received_[pending]);
+  ASSERT_EQ(cache.size(), 1U);
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,289 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/transaction_status_batcher.h"
+
+#include <gflags/gflags.h>
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/tablet/shared_transaction_status_cache.h"
+#include "yb/tablet/transaction_participant_context.h"
+
+#include "yb/tserver/tserver_service.pb.h"
+
+#include "yb/util/logging.h"
+#include "yb/util/metrics.h"
+#include "yb/util/status_format.h"
+
+using namespace std::placeholders;
+
+DECLARE_int32(max_transactions_in_status_request);
+
+METRIC_DEFINE_counter(
+    tablet, transaction_status_rpcs, "Transaction Status RPCs", yb::MetricUnit::kRequests,
+    "Number of GetTransactionStatus RPCs sent to resolve status of running transactions.");
+
+METRIC_DEFINE_counter(
+    tablet, transaction_status_rpc_transactions, "Transactions In Status RPCs",
+    yb::MetricUnit::kTransactions,
+    "Number of transactions whose status was requested by GetTransactionStatus RPCs sent to "
+    "resolve status of running transactions.");
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+tserver::GetTransactionStatusResponsePB MakeResponse(const TransactionStatusInfo& info) {
+  tserver::GetTransactionStatusResponsePB response;
+  response.add_status(info.status);
+  response.add_status_hybrid_time(info.status_ht.ToUint64());
+  if (info.coordinator_safe_time) {
+    response.add_coordinator_safe_time(info.coordinator_safe_time.ToUint64());
+  }
+  info.aborted_subtxn_set.ToPB(response.add_aborted_subtxn_set()->mutable_set());
+  return response;
+}
+
+// Extracts response for the transaction at the specified index of a batched response.
+// Also fills info, when response contains all required fields.
+tserver::GetTransactionStatusResponsePB ExtractResponse(
+    const tserver::GetTransactionStatusResponsePB& response, int idx,
+    TransactionStatusInfo* info) {
+  tserver::GetTransactionStatusResponsePB result;
+  if (response.has_propagated_hybrid_time()) {
+    result.set_propagated_hybrid_time(response.propagated_hybrid_time());
+  }
+  result.add_status(response.status(idx));
+  *result.add_aborted_subtxn_set() = response.aborted_subtxn_set(idx);
+  if (idx < response.coordinator_safe_time().size()) {
+    result.add_coordinator_safe_time(response.coordinator_safe_time(idx));
+    info->coordinator_safe_time = HybridTime(response.coordinator_safe_time(idx));
+  }
+  if (idx < response.status_hybrid_time().size()) {
+    result.add_status_hybrid_time(response.status_hybrid_time(idx));
+    auto aborted_subtxn_set = AbortedSubTransactionSet::FromPB(
+        response.aborted_subtxn_set(idx).set());
+    if (aborted_subtxn_set.ok()) {
+      info->status = response.status(idx);
+      info->status_ht = HybridTime(response.status_hybrid_time(idx));
+      info->aborted_subtxn_set = std::move(*aborted_subtxn_set);
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+TransactionStatusBatcher::TransactionStatusBatcher(
+    TransactionParticipantContext* participant_context, rpc::Rpcs* rpcs,
+    const scoped_refptr<MetricEntity>& entity)
+    : participant_context_(*participant_context),
+      rpcs_(*rpcs),
+      cache_(participant_context->transaction_status_cache()) {
+  if (entity) {
+    rpcs_counter_ = METRIC_transaction_status_rpcs.Instantiate(entity);
+    requested_transactions_counter_ =
+        METRIC_transaction_status_rpc_transactions.Instantiate(entity);
+  }
+}
+
+TransactionStatusBatcher::~TransactionStatusBatcher() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LOG_IF(DFATAL, !queues_.empty())
+      << participant_context_.LogPrefix() << "Destroying transaction status batcher with "
+      << queues_.size() << " active queues";
+}
+
+void TransactionStatusBatcher::RequestStatus(
+    const TabletId& status_tablet, const TransactionId& id,
+    client::GetTransactionStatusCallback callback) {
+  if (cache_) {
+    auto info = cache_->Get(id);
+    if (info) {
+      callback(Status::OK(), MakeResponse(*info));
+      return;
+    }
+  }
+
+  BatchPtr batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!closing_) {
+      auto it = queues_.find(status_tablet);
+      if (it == queues_.end()) {
+        it = queues_.emplace(status_tablet, StatusTabletQueue()).first;
+        it->second.handle = rpcs_.InvalidHandle();
+      }
+      auto& queue = it->second;
+      queue.requests.push_back(Request {
+        .id = id,
+        .callback = std::move(callback),
+      });
+      if (queue.in_flight) {
+        return;
+      }
+      batch = NextBatchUnlocked(status_tablet);
+    }
+  }
+  if (!batch) {
+    callback(STATUS(Aborted, "Transaction participant is shutting down"),
+             tserver::GetTransactionStatusResponsePB());
+    return;
+  }
+  Send(status_tablet, batch);
+}
+
+TransactionStatusBatcher::BatchPtr TransactionStatusBatcher::NextBatchUnlocked(
+    const TabletId& status_tablet) {
+  auto it = queues_.find(status_tablet);
+  auto& queue = it->second;
+  if (queue.requests.empty()) {
+    queues_.erase(it);
+    return nullptr;
+  }
+  auto batch_size = std::min<size_t>(
+      std::max(FLAGS_max_transactions_in_status_request, 1), queue.requests.size());
+  auto batch = std::make_shared<Batch>(
+      std::make_move_iterator(queue.requests.begin()),
+      std::make_move_iterator(queue.requests.begin() + batch_size));
+  queue.requests.erase(queue.requests.begin(), queue.requests.begin() + batch_size);
+  queue.in_flight = true;
+  return batch;
+}
+
+void TransactionStatusBatcher::Send(const TabletId& status_tablet, const BatchPtr& batch) {
+  tserver::GetTransactionStatusRequestPB req;
+  req.set_tablet_id(status_tablet);
+  for (const auto& request : *batch) {
+    req.add_transaction_id()->assign(
+        pointer_cast<const char*>(request.id.data()), request.id.size());
+  }
+  req.set_propagated_hybrid_time(participant_context_.Now().ToUint64());
+
+  rpc::Rpcs::Handle* handle;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    handle = &queues_[status_tablet].handle;
+  }
+  if (rpcs_counter_) {
+    rpcs_counter_->Increment();
+    requested_transactions_counter_->IncrementBy(batch->size());
+  }
+  if (!SendRpc(&req, handle, std::bind(&TransactionStatusBatcher::StatusReceived, this, _1, _2,
+                                      status_tablet, batch))) {
+    StatusReceived(STATUS(Aborted, "Aborted because cannot start RPC"),
+                   tserver::GetTransactionStatusResponsePB(), status_tablet, batch);
+  }
+}
+
+bool TransactionStatusBatcher::SendRpc(
+    tserver::GetTransactionStatusRequestPB* req, rpc::Rpcs::Handle* handle,
+    client::GetTransactionStatusCallback callback) {
+  auto client = participant_context_.client_future().get();
+  return client && rpcs_.RegisterAndStart(
+      client::GetTransactionStatus(
+          TransactionRpcDeadline(),
+          nullptr /* tablet */,
+          client,
+          req,
+          std::move(callback)),
+      handle);
+}
+
+void TransactionStatusBatcher::StatusReceived(
+    Status status, const tserver::GetTransactionStatusResponsePB& response,
+    const TabletId& status_tablet, const BatchPtr& batch) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rpcs_.Unregister(&queues_[status_tablet].handle);
+  }
+
+  if (status.ok() && response.has_error()) {
+    status = StatusFromPB(response.error().status());
+  }
+  const auto request_size = static_cast<int>(batch->size());
+  if (status.ok() && (response.status().size() != request_size ||
+                      response.aborted_subtxn_set().size() != request_size)) {
+    LOG(DFATAL) << participant_context_.LogPrefix() << "Bad response size, expected "
+                << request_size << " entries, but found: " << response.ShortDebugString();
+    status = STATUS_FORMAT(
+        IllegalState, "Bad transaction status response size, expected $0 entries",
+        request_size);
+  }
+
+  for (int i = 0; i != request_size; ++i) {
+    auto& request = (*batch)[i];
+    if (!status.ok()) {
+      request.callback(status, response);
+      continue;
+    }
+    TransactionStatusInfo info;
+    info.transaction_id = request.id;
+    info.status = TransactionStatus::PENDING;
+    auto single_response = ExtractResponse(response, i, &info);
+    if (cache_) {
+      cache_->Put(info);
+    }
+    request.callback(status, single_response);
+  }
+
+  // Requests that arrived while RPC was in flight, including the ones issued by the callbacks
+  // above, are sent in the next RPC.
+  BatchPtr next_batch;
+  Batch failed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closing_) {
+      auto it = queues_.find(status_tablet);
+      failed.swap(it->second.requests);
+      queues_.erase(it);
+    } else {
+      next_batch = NextBatchUnlocked(status_tablet);
+    }
+  }
+  for (auto& request : failed) {
+    request.callback(STATUS(Aborted, "Transaction participant is shutting down"),
+                     tserver::GetTransactionStatusResponsePB());
+  }
+  if (next_batch) {
+    Send(status_tablet, next_batch);
+  }
+}
+
+void TransactionStatusBatcher::Shutdown() {
+  Batch failed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+    for (auto it = queues_.begin(); it != queues_.end();) {
+      auto& requests = it->second.requests;
+      std::move(requests.begin(), requests.end(), std::back_inserter(failed));
+      if (it->second.in_flight) {
+        // Queue is erased when the RPC in flight completes.
+        requests.clear();
+        ++it;
+      } else {
+        it = queues_.erase(it);
+      }
+    }
+  }
+  for (auto& request : failed) {
+    request.callback(STATUS(Aborted, "Transaction participant is shutting down"),
+                     tserver::GetTransactionStatusResponsePB());
+  }
+}
+
+} // namespace tablet
+} // namespace yb
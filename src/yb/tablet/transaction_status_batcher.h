@@ -0,0 +1,109 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_TRANSACTION_STATUS_BATCHER_H
+#define YB_TABLET_TRANSACTION_STATUS_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/client/transaction_rpc.h"
+
+#include "yb/common/transaction.h"
+
+#include "yb/gutil/thread_annotations.h"
+
+#include "yb/rpc/rpc.h"
+
+#include "yb/tablet/tablet_fwd.h"
+
+#include "yb/util/metrics_fwd.h"
+
+namespace yb {
+namespace tablet {
+
+class SharedTransactionStatusCache;
+
+// Sends status requests of running transactions to their status tablets.
+//
+// Final statuses are taken from the shared transaction status cache of the tablet server, when
+// present, without sending RPC. Otherwise at most one RPC per status tablet is in flight, and
+// requests that arrive meanwhile are sent together in the next RPC, up to
+// --max_transactions_in_status_request transactions per RPC.
+//
+// Callback receives response in the same format as GetTransactionStatus RPC for a single
+// transaction.
+class TransactionStatusBatcher {
+ public:
+  TransactionStatusBatcher(
+      TransactionParticipantContext* participant_context, rpc::Rpcs* rpcs,
+      const scoped_refptr<MetricEntity>& entity);
+  virtual ~TransactionStatusBatcher();
+
+  void RequestStatus(
+      const TabletId& status_tablet, const TransactionId& id,
+      client::GetTransactionStatusCallback callback);
+
+  // Fails queued requests, requests that arrive after shutdown are failed immediately.
+  // RPCs in flight should be aborted via rpcs.
+  void Shutdown();
+
+ protected:
+  // Sends GetTransactionStatus RPC, returns false if RPC could not be started.
+  // Overridden in tests.
+  virtual bool SendRpc(
+      tserver::GetTransactionStatusRequestPB* req, rpc::Rpcs::Handle* handle,
+      client::GetTransactionStatusCallback callback);
+
+ private:
+  struct Request {
+    TransactionId id;
+    client::GetTransactionStatusCallback callback;
+  };
+
+  using Batch = std::vector<Request>;
+  using BatchPtr = std::shared_ptr<Batch>;
+
+  struct StatusTabletQueue {
+    std::vector<Request> requests;
+    bool in_flight = false;
+    rpc::Rpcs::Handle handle;
+  };
+
+  // Extracts next batch from queue, or returns nullptr and erases queue if it is empty.
+  BatchPtr NextBatchUnlocked(const TabletId& status_tablet) REQUIRES(mutex_);
+
+  void Send(const TabletId& status_tablet, const BatchPtr& batch);
+
+  void StatusReceived(
+      Status status, const tserver::GetTransactionStatusResponsePB& response,
+      const TabletId& status_tablet, const BatchPtr& batch);
+
+  TransactionParticipantContext& participant_context_;
+  rpc::Rpcs& rpcs_;
+  SharedTransactionStatusCache* const cache_;
+
+  std::mutex mutex_;
+  std::unordered_map<TabletId, StatusTabletQueue> queues_ GUARDED_BY(mutex_);
+  bool closing_ GUARDED_BY(mutex_) = false;
+
+  scoped_refptr<Counter> rpcs_counter_;
+  scoped_refptr<Counter> requested_transactions_counter_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_TRANSACTION_STATUS_BATCHER_H
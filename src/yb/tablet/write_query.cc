@@ -30,6 +30,7 @@
 #include "yb/docdb/doc_write_batch.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/redis_operation.h"
+#include "yb/docdb/wait_queue.h"
 
 #include "yb/tablet/tablet_metadata.h"
 #include "yb/tablet/operations/write_operation.h"
@@ -40,6 +41,7 @@
 
 #include "yb/tserver/tserver.pb.h"
 
+#include "yb/util/atomic.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
@@ -461,11 +463,14 @@ CHECKED_STATUS WriteQuery::DoExecute() {
     }
   }
 
+  auto* wait_queue = transaction_participant && GetAtomicFlag(&FLAGS_enable_wait_queues)
+      ? transaction_participant->wait_queue() : nullptr;
   docdb::ResolveTransactionConflicts(
       doc_ops_, write_batch, tablet().clock()->Now(),
       read_time_ ? read_time_.read : HybridTime::kMax,
       tablet().doc_db(), partial_range_key_intents,
       transaction_participant, tablet().metrics()->transaction_conflicts.get(),
+      wait_queue, &prepare_result_.lock_batch, deadline(),
       [this](const Result<HybridTime>& result) {
         if (!result.ok()) {
           ExecuteDone(result.status());
@@ -781,6 +786,19 @@ void WriteQuery::PgsqlExecuteDone(const Status& status) {
     return;
   }
 
+  // Non-transactional batch of multiple operations is applied atomically, so transaction committed
+  // as a single-shard write (see YBTransaction::RequestSingleShardFlush) does not write a part of
+  // its operations when some of them fail.
+  if (isolation_level_ == IsolationLevel::NON_TRANSACTIONAL && !tablet().is_sys_catalog() &&
+      response_->pgsql_response_batch_size() > 1) {
+    for (const auto& resp : response_->pgsql_response_batch()) {
+      if (resp.status() != PgsqlResponsePB::PGSQL_STATUS_OK) {
+        request().mutable_write_batch()->clear_write_pairs();
+        break;
+      }
+    }
+  }
+
   for (auto& doc_op : doc_ops_) {
     // We'll need to return the number of rows inserted, updated, or deleted by each operation.
     std::unique_ptr<docdb::PgsqlWriteOperation> pgsql_write_op(
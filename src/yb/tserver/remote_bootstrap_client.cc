@@ -467,7 +467,8 @@ Status RemoteBootstrapClient::VerifyChangeRoleSucceeded(
       }
 
       if (peer.member_type() == PeerMemberType::VOTER ||
-          peer.member_type() == PeerMemberType::OBSERVER) {
+          peer.member_type() == PeerMemberType::OBSERVER ||
+          peer.member_type() == PeerMemberType::WITNESS) {
         return Status::OK();
       } else {
         SleepFor(MonoDelta::FromMilliseconds(backoff_ms));
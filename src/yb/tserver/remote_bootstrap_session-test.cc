@@ -86,7 +86,8 @@ void RemoteBootstrapSessionTest::SetUpTabletPeer() {
           tablet()->tablet_id()),
       &metric_registry_,
       nullptr /* tablet_splitter */,
-      std::shared_future<client::YBClient*>()));
+      std::shared_future<client::YBClient*>(),
+      nullptr /* transaction_status_cache */));
 
   // TODO similar to code in tablet_peer-test, consider refactor.
   RaftConfigPB config;
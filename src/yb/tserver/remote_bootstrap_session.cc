@@ -134,6 +134,7 @@ Status RemoteBootstrapSession::ChangeRole() {
 
     switch(peer_pb.member_type()) {
       case PeerMemberType::OBSERVER: FALLTHROUGH_INTENDED;
+      case PeerMemberType::WITNESS: FALLTHROUGH_INTENDED;
       case PeerMemberType::VOTER:
         LOG(ERROR) << "Peer " << peer_pb.permanent_uuid() << " is a "
                    << PeerMemberType_Name(peer_pb.member_type())
@@ -144,6 +145,7 @@ Status RemoteBootstrapSession::ChangeRole() {
         return Status::OK();
 
       case PeerMemberType::PRE_OBSERVER: FALLTHROUGH_INTENDED;
+      case PeerMemberType::PRE_WITNESS: FALLTHROUGH_INTENDED;
       case PeerMemberType::PRE_VOTER: {
         consensus::ChangeConfigRequestPB req;
         consensus::ChangeConfigResponsePB resp;
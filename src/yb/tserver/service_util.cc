@@ -297,6 +297,12 @@ Result<std::shared_ptr<tablet::AbstractTablet>> GetTablet(
     // Peer is not the leader, so check that the time since it last heard from the leader is less
     // than FLAGS_max_stale_read_bound_time_ms.
     if (PREDICT_FALSE(!s.ok())) {
+      // Witness replicas do not apply data operations, so they have nothing to read from.
+      if (tablet_ptr->is_witness()) {
+        return STATUS(
+            IllegalState, "Witness replica cannot serve reads",
+            TabletServerError(TabletServerErrorPB::NOT_THE_LEADER));
+      }
       if (FLAGS_max_stale_read_bound_time_ms > 0) {
         auto consensus = tablet_peer->shared_consensus();
         // TODO(hector): This safe time could be reused by the read operation.
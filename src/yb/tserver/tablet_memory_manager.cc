@@ -21,6 +21,7 @@
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/persistent_cache.h"
 
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_options.h"
@@ -76,6 +77,22 @@ DEFINE_int32(db_block_cache_num_shard_bits, 4,
              "Number of bits to use for sharding the block cache (defaults to 4 bits)");
 TAG_FLAG(db_block_cache_num_shard_bits, advanced);
 
+DEFINE_bool(db_block_cache_tinylfu_admission, false,
+            "Add a new block to the block cache only if it was accessed more frequently than the "
+            "block it would evict, as estimated by a sketch of recent accesses (TinyLFU). Keeps "
+            "frequently accessed blocks in the cache during large scans.");
+TAG_FLAG(db_block_cache_tinylfu_admission, advanced);
+
+DEFINE_string(db_block_cache_persistent_path, "",
+              "Directory on a fast local device used to keep SST data blocks in addition to the "
+              "block cache. The blocks are kept across restarts. Empty disables the persistent "
+              "block cache.");
+TAG_FLAG(db_block_cache_persistent_path, advanced);
+
+DEFINE_int64(db_block_cache_persistent_size_bytes, 16LL * 1024 * 1024 * 1024,
+             "Maximum size of the persistent block cache, see db_block_cache_persistent_path.");
+TAG_FLAG(db_block_cache_persistent_size_bytes, advanced);
+
 DEFINE_test_flag(bool, pretend_memory_exceeded_enforce_flush, false,
                   "Always pretend memory has been exceeded to enforce background flush.");
 
@@ -196,12 +213,34 @@ void TabletMemoryManager::InitBlockCache(
       server_mem_tracker_);
 
   if (block_cache_size_bytes != kDbCacheSizeCacheDisabled) {
-    options->block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
-                                                FLAGS_db_block_cache_num_shard_bits);
+    options->block_cache = rocksdb::NewLRUCache(
+        block_cache_size_bytes, FLAGS_db_block_cache_num_shard_bits,
+        /* strict_capacity_limit= */ false,
+        FLAGS_db_block_cache_tinylfu_admission ? rocksdb::CacheAdmissionPolicy::kTinyLFU
+                                               : rocksdb::CacheAdmissionPolicy::kAdmitAll);
     options->block_cache->SetMetrics(metrics);
     block_based_table_gc_ = std::make_shared<LRUCacheGC>(options->block_cache);
     block_based_table_mem_tracker_->AddGarbageCollector(block_based_table_gc_);
   }
+
+  if (!FLAGS_db_block_cache_persistent_path.empty() &&
+      FLAGS_db_block_cache_persistent_size_bytes > 0) {
+    rocksdb::LogStructuredPersistentCacheOptions persistent_cache_options;
+    // Cache files keep decrypted SST blocks, so they are written through the same environment as
+    // SST files, that encrypts them when encryption at rest is enabled.
+    persistent_cache_options.env = options->rocksdb_env;
+    persistent_cache_options.path = FLAGS_db_block_cache_persistent_path;
+    persistent_cache_options.capacity = FLAGS_db_block_cache_persistent_size_bytes;
+    auto status = rocksdb::NewLogStructuredPersistentCache(
+        persistent_cache_options, &options->persistent_cache);
+    if (status.ok()) {
+      options->persistent_cache->SetMetrics(metrics);
+    } else {
+      LOG(WARNING) << "Failed to open persistent block cache at "
+                   << FLAGS_db_block_cache_persistent_path << ": " << status;
+      options->persistent_cache = nullptr;
+    }
+  }
 }
 
 void TabletMemoryManager::InitLogCacheGC() {
@@ -105,6 +105,7 @@
 #include "yb/util/status_format.h"
 #include "yb/util/status_log.h"
 #include "yb/util/string_util.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 
 #include "yb/yql/pgwrapper/ysql_upgrade.h"
@@ -172,6 +173,11 @@ DEFINE_int32(index_backfill_wait_for_old_txns_ms, 0,
 TAG_FLAG(index_backfill_wait_for_old_txns_ms, evolving);
 TAG_FLAG(index_backfill_wait_for_old_txns_ms, runtime);
 
+DEFINE_int32(multi_raft_update_consensus_max_threads, 16,
+             "Maximum number of threads applying requests of a multi-raft UpdateConsensus batch "
+             "to their tablets in parallel. 0 applies them sequentially in the RPC thread.");
+TAG_FLAG(multi_raft_update_consensus_max_threads, advanced);
+
 DEFINE_test_flag(double, respond_write_failed_probability, 0.0,
                  "Probability to respond that write request is failed");
 
@@ -1620,6 +1626,11 @@ ConsensusServiceImpl::ConsensusServiceImpl(const scoped_refptr<MetricEntity>& me
                                            TabletPeerLookupIf* tablet_manager)
     : ConsensusServiceIf(metric_entity),
       tablet_manager_(tablet_manager) {
+  if (FLAGS_multi_raft_update_consensus_max_threads > 0) {
+    CHECK_OK(ThreadPoolBuilder("multi_raft_update")
+                 .set_max_threads(FLAGS_multi_raft_update_consensus_max_threads)
+                 .Build(&multi_raft_update_pool_));
+  }
 }
 
 ConsensusServiceImpl::~ConsensusServiceImpl() {
@@ -1639,53 +1650,112 @@ void ConsensusServiceImpl::MultiRaftUpdateConsensus(
       const consensus::MultiRaftConsensusRequestPB *req,
       consensus::MultiRaftConsensusResponsePB *resp,
       rpc::RpcContext context) {
-    DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
-    // Effectively performs ConsensusServiceImpl::UpdateConsensus for
-    // each ConsensusRequestPB in the batch but does not fail the entire
-    // batch if a single request fails.
-    for (int i = 0; i < req->consensus_request_size(); i++) {
-      // Unfortunately, we have to use const_cast here,
-      // because the protobuf-generated interface only gives us a const request
-      // but we need to be able to move messages out of the request for efficiency.
-      auto consensus_req = const_cast<ConsensusRequestPB*>(&req->consensus_request(i));
-      auto consensus_resp = resp->add_consensus_response();;
-
-      auto uuid_match_res = CheckUuidMatch(tablet_manager_, "UpdateConsensus", consensus_req,
-                                           context.requestor_string());
-      if (!uuid_match_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), uuid_match_res.status());
-        continue;
-      }
+  DVLOG(3) << "Received Batch Consensus Update RPC: " << req->ShortDebugString();
+  // Effectively performs ConsensusServiceImpl::UpdateConsensus for
+  // each ConsensusRequestPB in the batch but does not fail the entire
+  // batch if a single request fails.
+  // Requests to different tablets are independent, so they are applied in parallel, and the
+  // batch is responded when the last one is complete.
+  const int num_requests = req->consensus_request_size();
+  if (num_requests == 0) {
+    context.RespondSuccess();
+    return;
+  }
+  for (int i = 0; i < num_requests; i++) {
+    resp->add_consensus_response();
+  }
+  auto context_ptr = std::make_shared<rpc::RpcContext>(std::move(context));
+  auto pending = std::make_shared<std::atomic<int>>(num_requests);
+  auto update = [this, req, resp, context_ptr, pending](int i) {
+    // Unfortunately, we have to use const_cast here,
+    // because the protobuf-generated interface only gives us a const request
+    // but we need to be able to move messages out of the request for efficiency.
+    UpdateConsensusInBatch(
+        const_cast<ConsensusRequestPB*>(&req->consensus_request(i)),
+        resp->mutable_consensus_response(i), *context_ptr);
+    if (pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      context_ptr->RespondSuccess();
+    }
+  };
+  // The first request is applied by the RPC thread.
+  for (int i = 1; i < num_requests; i++) {
+    if (!multi_raft_update_pool_ ||
+        !multi_raft_update_pool_->SubmitFunc(std::bind(update, i)).ok()) {
+      update(i);
+    }
+  }
+  update(0);
+}
 
-      auto peer_tablet_res = LookupTabletPeer(tablet_manager_, consensus_req->tablet_id());
-      if (!peer_tablet_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), peer_tablet_res.status());
-        continue;
-      }
-      auto tablet_peer = peer_tablet_res.get().tablet_peer;
+void ConsensusServiceImpl::UpdateConsensusInBatch(
+    ConsensusRequestPB* req, ConsensusResponsePB* resp, const rpc::RpcContext& context) {
+  auto uuid_match_res = CheckUuidMatch(tablet_manager_, "UpdateConsensus", req,
+                                       context.requestor_string());
+  if (!uuid_match_res.ok()) {
+    SetupError(resp->mutable_error(), uuid_match_res.status());
+    return;
+  }
 
-      // Submit the update directly to the TabletPeer's Consensus instance.
-      auto consensus_res = GetConsensus(tablet_peer);
-      if (!consensus_res.ok()) {
-        SetupError(consensus_resp->mutable_error(), consensus_res.status());
-        continue;
-      }
-      auto consensus = *consensus_res;
-
-      Status s = consensus->Update(
-        consensus_req, consensus_resp, context.GetClientDeadline());
-      if (PREDICT_FALSE(!s.ok())) {
-        // Clear the response first, since a partially-filled response could
-        // result in confusing a caller, or in having missing required fields
-        // in embedded optional messages.
-        consensus_resp->Clear();
-        SetupError(consensus_resp->mutable_error(), s);
-        continue;
-      }
+  auto peer_tablet_res = LookupTabletPeer(tablet_manager_, req->tablet_id());
+  if (!peer_tablet_res.ok()) {
+    SetupError(resp->mutable_error(), peer_tablet_res.status());
+    return;
+  }
+  auto tablet_peer = peer_tablet_res.get().tablet_peer;
 
-      CompleteUpdateConsensusResponse(tablet_peer, consensus_resp);
+  // Submit the update directly to the TabletPeer's Consensus instance.
+  auto consensus_res = GetConsensus(tablet_peer);
+  if (!consensus_res.ok()) {
+    SetupError(resp->mutable_error(), consensus_res.status());
+    return;
+  }
+  auto consensus = *consensus_res;
+
+  Status s = consensus->Update(req, resp, context.GetClientDeadline());
+  if (PREDICT_FALSE(!s.ok())) {
+    // Clear the response first, since a partially-filled response could
+    // result in confusing a caller, or in having missing required fields
+    // in embedded optional messages.
+    resp->Clear();
+    SetupError(resp->mutable_error(), s);
+    return;
+  }
+
+  CompleteUpdateConsensusResponse(tablet_peer, resp);
+}
+
+void ConsensusServiceImpl::UpdateClosedTimestamps(
+    const consensus::UpdateClosedTimestampsRequestPB* req,
+    consensus::UpdateClosedTimestampsResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received UpdateClosedTimestamps RPC: " << req->ShortDebugString();
+  if (!CheckUuidMatchOrRespond(tablet_manager_, "UpdateClosedTimestamps", req, resp, &context)) {
+    return;
+  }
+  // Closed timestamps are published periodically, so ones that could not be applied are just
+  // skipped, the next publication will contain newer values.
+  int num_applied = 0;
+  for (const auto& closed_timestamp : req->closed_timestamps()) {
+    auto peer_tablet = LookupTabletPeer(tablet_manager_, closed_timestamp.tablet_id());
+    if (!peer_tablet.ok()) {
+      VLOG(2) << "Skipped closed timestamp: " << peer_tablet.status();
+      continue;
     }
-    context.RespondSuccess();
+    auto consensus = GetConsensus(peer_tablet->tablet_peer);
+    if (!consensus.ok()) {
+      VLOG(2) << "Skipped closed timestamp: " << consensus.status();
+      continue;
+    }
+    auto applied = (**consensus).ApplyClosedTimestamp(closed_timestamp);
+    if (!applied.ok()) {
+      VLOG(2) << "Failed to apply closed timestamp for " << closed_timestamp.tablet_id() << ": "
+              << applied.status();
+    } else if (*applied) {
+      ++num_applied;
+    }
+  }
+  resp->set_num_applied(num_applied);
+  context.RespondSuccess();
 }
 
 void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
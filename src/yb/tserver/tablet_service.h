@@ -63,6 +63,7 @@ namespace yb {
 class Schema;
 class Status;
 class HybridTime;
+class ThreadPool;
 
 namespace tserver {
 
@@ -266,6 +267,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                         consensus::MultiRaftConsensusResponsePB *resp,
                                         rpc::RpcContext context) override;
 
+  virtual void UpdateClosedTimestamps(const consensus::UpdateClosedTimestampsRequestPB* req,
+                                      consensus::UpdateClosedTimestampsResponsePB* resp,
+                                      rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -305,7 +310,16 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
  private:
   void CompleteUpdateConsensusResponse(std::shared_ptr<tablet::TabletPeer> tablet_peer,
                                        consensus::ConsensusResponsePB* resp);
+
+  // Applies a single request of the MultiRaftUpdateConsensus batch, errors are reported in resp.
+  void UpdateConsensusInBatch(consensus::ConsensusRequestPB* req,
+                              consensus::ConsensusResponsePB* resp,
+                              const rpc::RpcContext& context);
+
   TabletPeerLookupIf* tablet_manager_;
+
+  // Applies requests of MultiRaftUpdateConsensus batches in parallel, null if disabled.
+  std::unique_ptr<ThreadPool> multi_raft_update_pool_;
 };
 
 class TabletServerForwardServiceImpl : public TabletServerForwardServiceIf {
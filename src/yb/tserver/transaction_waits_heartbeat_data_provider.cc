@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tserver/transaction_waits_heartbeat_data_provider.h"
+
+#include "yb/docdb/wait_queue.h"
+
+#include "yb/master/master_heartbeat.pb.h"
+
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_peer.h"
+#include "yb/tablet/transaction_participant.h"
+
+#include "yb/tserver/tablet_server.h"
+#include "yb/tserver/ts_tablet_manager.h"
+
+#include "yb/util/logging.h"
+
+namespace yb {
+namespace tserver {
+
+TransactionWaitsHeartbeatDataProvider::TransactionWaitsHeartbeatDataProvider(
+    TabletServer* server) : HeartbeatDataProvider(server) {}
+
+void TransactionWaitsHeartbeatDataProvider::AddData(
+    const master::TSHeartbeatResponsePB& last_resp, master::TSHeartbeatRequestPB* req) {
+  std::vector<docdb::WaitQueue*> wait_queues;
+  for (const auto& tablet_peer : server().tablet_manager()->GetTabletPeers()) {
+    auto tablet = tablet_peer ? tablet_peer->shared_tablet() : nullptr;
+    auto* participant = tablet ? tablet->transaction_participant() : nullptr;
+    if (participant) {
+      wait_queues.push_back(participant->wait_queue());
+    }
+  }
+
+  for (const auto& id_bytes : last_resp.deadlocked_transactions()) {
+    auto id = FullyDecodeTransactionId(id_bytes);
+    if (!id.ok()) {
+      LOG_WITH_PREFIX(DFATAL) << "Bad deadlocked transaction: " << id.status();
+      continue;
+    }
+    for (auto* wait_queue : wait_queues) {
+      wait_queue->FailDeadlocked(*id);
+    }
+  }
+
+  // Report all waits, even when there are none, so the master drops waits reported before.
+  std::vector<docdb::WaitingTransactionData> waits;
+  for (auto* wait_queue : wait_queues) {
+    wait_queue->GetWaitingTransactions(&waits);
+  }
+  for (const auto& wait : waits) {
+    auto* wait_pb = req->add_transaction_waits();
+    wait_pb->set_transaction_id(wait.id.data(), wait.id.size());
+    wait_pb->set_priority(wait.priority);
+    for (const auto& blocker : wait.blockers) {
+      wait_pb->add_blockers(blocker.data(), blocker.size());
+    }
+  }
+}
+
+} // namespace tserver
+} // namespace yb
@@ -0,0 +1,35 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TSERVER_TRANSACTION_WAITS_HEARTBEAT_DATA_PROVIDER_H
+#define YB_TSERVER_TRANSACTION_WAITS_HEARTBEAT_DATA_PROVIDER_H
+
+#include "yb/tserver/heartbeater.h"
+
+namespace yb {
+namespace tserver {
+
+// Reports transactions waiting in wait queues of tablets to the master, which detects deadlocks
+// among them. Fails waits of transactions that the master chose as deadlock victims.
+class TransactionWaitsHeartbeatDataProvider : public HeartbeatDataProvider {
+ public:
+  explicit TransactionWaitsHeartbeatDataProvider(TabletServer* server);
+
+  void AddData(
+      const master::TSHeartbeatResponsePB& last_resp, master::TSHeartbeatRequestPB* req) override;
+};
+
+} // namespace tserver
+} // namespace yb
+
+#endif // YB_TSERVER_TRANSACTION_WAITS_HEARTBEAT_DATA_PROVIDER_H
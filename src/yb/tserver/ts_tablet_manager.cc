@@ -49,10 +49,12 @@
 #include "yb/common/wire_protocol.h"
 
 #include "yb/consensus/consensus.h"
+#include "yb/consensus/consensus.proxy.h"
 #include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_anchor_registry.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/metadata.pb.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/quorum_util.h"
@@ -72,11 +74,15 @@
 #include "yb/master/master_heartbeat.pb.h"
 #include "yb/master/sys_catalog.h"
 
+#include "yb/rocksdb/persistent_cache.h"
+
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/poller.h"
+#include "yb/rpc/rpc_controller.h"
 
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/operations/split_operation.h"
+#include "yb/tablet/shared_transaction_status_cache.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet.pb.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
@@ -187,6 +193,13 @@ DEFINE_int32(verify_tablet_data_interval_sec, 0,
 DEFINE_bool(skip_tablet_data_verification, false,
             "Skip checking tablet data for corruption.");
 
+DEFINE_int32(closed_timestamp_publish_interval_ms, 0,
+             "Interval for publishing closed timestamps of tablets led by this tablet server to "
+             "their followers, batched per follower tablet server. It allows followers to serve "
+             "reads at recent hybrid time without waiting for Raft heartbeats of each tablet. "
+             "0 to disable.");
+TAG_FLAG(closed_timestamp_publish_interval_ms, advanced);
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -206,6 +219,15 @@ DEFINE_int32(post_split_trigger_compaction_pool_max_queue_size, 16,
              "after they have been split and still contain irrelevant data from the tablet they "
              "were sourced from.");
 
+DEFINE_int32(apply_intents_pool_max_threads, 8,
+             "The maximum number of threads allowed for apply_intents_pool_. This pool is used "
+             "to apply key range chunks of large transactions in parallel.");
+
+DEFINE_int32(wait_queue_pool_max_threads, 64,
+             "The maximum number of threads allowed for wait_queue_pool_. This pool is used "
+             "to resume transactional writes waiting for conflicting transactions, that could "
+             "block while reacquiring their locks.");
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -218,6 +240,14 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
 DEFINE_bool(enable_restart_transaction_status_tablets_first, true,
             "Set to true to prioritize bootstrapping transaction status tablets first.");
 
+DEFINE_bool(log_group_sync_across_tablets, false,
+            "Combine WAL syncs of all tablets on the node into groups, waited for with a single "
+            "syncfs call per file system instead of a separate fsync per log segment. syncfs "
+            "flushes all dirty data of the file system, so it should be enabled only when WAL "
+            "directories are placed on dedicated devices. Ignored before Linux 5.8, where syncfs "
+            "does not report writeback errors.");
+TAG_FLAG(log_group_sync_across_tablets, advanced);
+
 DECLARE_string(rocksdb_compact_flush_rate_limit_sharing_mode);
 
 namespace yb {
@@ -321,6 +351,71 @@ void TSTabletManager::VerifyTabletData() {
   }
 }
 
+namespace {
+
+constexpr auto kPublishClosedTimestampsTimeout = 1s;
+
+// Closed timestamps to be sent to a single follower tablet server.
+struct PublishClosedTimestampsCall {
+  HostPort hostport;
+  consensus::UpdateClosedTimestampsRequestPB req;
+  consensus::UpdateClosedTimestampsResponsePB resp;
+  rpc::RpcController controller;
+};
+
+} // namespace
+
+void TSTabletManager::PublishClosedTimestamps() {
+  const auto& local_uuid = local_peer_pb_.permanent_uuid();
+  std::unordered_map<std::string, std::shared_ptr<PublishClosedTimestampsCall>> calls;
+  for (const TabletPeerPtr& peer : GetTabletPeers()) {
+    if (peer->state() != RUNNING) {
+      continue;
+    }
+    auto consensus = peer->shared_raft_consensus();
+    if (!consensus) {
+      continue;
+    }
+    consensus::ClosedTimestampPB closed_timestamp;
+    auto filled = consensus->GetClosedTimestamp(&closed_timestamp);
+    if (!filled.ok()) {
+      VLOG_WITH_PREFIX(2) << "Failed to get closed timestamp of " << peer->tablet_id() << ": "
+                          << filled.status();
+      continue;
+    }
+    if (!*filled) {
+      continue;
+    }
+    for (const auto& raft_peer : consensus->CommittedConfig().peers()) {
+      if (raft_peer.permanent_uuid() == local_uuid) {
+        continue;
+      }
+      auto& call = calls[raft_peer.permanent_uuid()];
+      if (!call) {
+        call = std::make_shared<PublishClosedTimestampsCall>();
+        call->hostport = HostPortFromPB(DesiredHostPort(raft_peer, local_peer_pb_.cloud_info()));
+        call->req.set_dest_uuid(raft_peer.permanent_uuid());
+        call->req.set_caller_uuid(local_uuid);
+      }
+      *call->req.add_closed_timestamps() = closed_timestamp;
+    }
+  }
+
+  for (auto& uuid_and_call : calls) {
+    auto call = std::move(uuid_and_call.second);
+    auto proxy = std::make_shared<consensus::ConsensusServiceProxy>(
+        &server_->proxy_cache(), call->hostport);
+    call->controller.set_timeout(kPublishClosedTimestampsTimeout);
+    proxy->UpdateClosedTimestampsAsync(
+        call->req, &call->resp, &call->controller, [call, proxy] {
+      if (!call->controller.status().ok()) {
+        VLOG(2) << "Failed to publish closed timestamps to " << call->req.dest_uuid() << ": "
+                << call->controller.status();
+      }
+    });
+  }
+}
+
 TSTabletManager::TSTabletManager(FsManager* fs_manager,
                                  TabletServer* server,
                                  MetricRegistry* metric_registry)
@@ -361,6 +456,18 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_min_threads(1)
                .unlimited_threads()
                .Build(&allocation_pool_));
+  if (FLAGS_log_group_sync_across_tablets) {
+    if (log::LogSyncGroup::IsSupported()) {
+      log_sync_group_ = std::make_unique<log::LogSyncGroup>();
+    } else {
+      LOG(WARNING) << "syncfs does not report writeback errors on this system, WAL syncs are not "
+                   << "grouped across tablets";
+    }
+  }
+  if (FLAGS_transaction_status_cache_size > 0) {
+    transaction_status_cache_ = std::make_unique<tablet::SharedTransactionStatusCache>(
+        FLAGS_transaction_status_cache_size, server_->metric_entity());
+  }
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
       METRIC_op_read_queue_time.Instantiate(server_->metric_entity()),
@@ -377,12 +484,22 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
               .set_metrics(THREAD_POOL_METRICS_INSTANCE(
                   server_->metric_entity(), post_split_trigger_compaction_pool))
               .Build(&post_split_trigger_compaction_pool_));
+  CHECK_OK(ThreadPoolBuilder("apply-intents")
+              .set_max_threads(FLAGS_apply_intents_pool_max_threads)
+              .Build(&apply_intents_pool_));
+  CHECK_OK(ThreadPoolBuilder("wait-queue")
+              .set_max_threads(FLAGS_wait_queue_pool_max_threads)
+              .Build(&wait_queue_pool_));
   CHECK_OK(ThreadPoolBuilder("admin-compaction")
               .set_max_threads(std::max(docdb::GetGlobalRocksDBPriorityThreadPoolSize(), 0))
               .set_metrics(THREAD_POOL_METRICS_INSTANCE(
                   server_->metric_entity(), admin_triggered_compaction_pool))
               .Build(&admin_triggered_compaction_pool_));
 
+  // Environments should be set before the memory manager, that creates persistent block cache
+  // files through the RocksDB environment.
+  tablet_options_.env = server_->GetEnv();
+  tablet_options_.rocksdb_env = server_->GetRocksDBEnv();
   mem_manager_ = std::make_shared<TabletMemoryManager>(
       &tablet_options_,
       server_->mem_tracker(),
@@ -410,8 +527,6 @@ Status TSTabletManager::Init() {
     }
   });
 
-  tablet_options_.env = server_->GetEnv();
-  tablet_options_.rocksdb_env = server_->GetRocksDBEnv();
   tablet_options_.listeners = server_->options().listeners;
   if (docdb::GetRocksDBRateLimiterSharingMode() == docdb::RateLimiterSharingMode::TSERVER) {
     tablet_options_.rate_limiter = docdb::CreateRocksDBRateLimiter();
@@ -510,6 +625,9 @@ Status TSTabletManager::Init() {
   verify_tablet_data_poller_ = std::make_unique<rpc::Poller>(
       LogPrefix(), std::bind(&TSTabletManager::VerifyTabletData, this));
 
+  closed_timestamps_publisher_ = std::make_unique<rpc::Poller>(
+      LogPrefix(), std::bind(&TSTabletManager::PublishClosedTimestamps, this));
+
   return Status::OK();
 }
 
@@ -561,6 +679,11 @@ Status TSTabletManager::Start() {
     LOG(INFO)
         << "Tablet data verification is disabled by verify_tablet_data_interval_sec flag set to 0";
   }
+  if (FLAGS_closed_timestamp_publish_interval_ms > 0) {
+    closed_timestamps_publisher_->Start(
+        &server_->messenger()->scheduler(), FLAGS_closed_timestamp_publish_interval_ms * 1ms);
+    LOG(INFO) << "Closed timestamps publisher started...";
+  }
 
   return Status::OK();
 }
@@ -1152,7 +1275,8 @@ Result<TabletPeerPtr> TSTabletManager::CreateAndRegisterTabletPeer(
       Bind(&TSTabletManager::ApplyChange, Unretained(this), meta->raft_group_id()),
       metric_registry_,
       this,
-      async_client_init_->get_client_future()));
+      async_client_init_->get_client_future(),
+      transaction_status_cache_.get()));
   RETURN_NOT_OK(RegisterTablet(meta->raft_group_id(), tablet_peer, mode));
   return tablet_peer;
 }
@@ -1299,6 +1423,15 @@ Status TSTabletManager::StartTabletStateTransition(
   return Status::OK();
 }
 
+void TSTabletManager::ErasePersistentCacheBlocks(const tablet::RaftGroupMetadata& meta) {
+  const auto& persistent_cache = tablet_options_.persistent_cache;
+  if (!persistent_cache) {
+    return;
+  }
+  persistent_cache->EraseDirectory(meta.rocksdb_dir());
+  persistent_cache->EraseDirectory(meta.intents_rocksdb_dir());
+}
+
 bool TSTabletManager::IsTabletInTransition(const TabletId& tablet_id) const {
   std::unique_lock<std::mutex> lock(transition_in_progress_mutex_);
   return ContainsKey(transition_in_progress_, tablet_id);
@@ -1377,12 +1510,15 @@ void TSTabletManager::OpenTablet(const RaftGroupMetadataPtr& meta,
       .tablet_splitter = this,
       .allowed_history_cutoff_provider = std::bind(
           &TSTabletManager::AllowedHistoryCutoff, this, _1),
+      .apply_intents_pool = apply_intents_pool_.get(),
+      .wait_queue_pool = wait_queue_pool_.get(),
     };
     tablet::BootstrapTabletData data = {
       .tablet_init_data = tablet_init_data,
       .listener = tablet_peer->status_listener(),
       .append_pool = append_pool(),
       .allocation_pool = allocation_pool_.get(),
+      .log_sync_group = log_sync_group_.get(),
       .retryable_requests = &retryable_requests,
     };
     s = BootstrapTablet(data, &tablet, &log, &bootstrap_info);
@@ -1496,6 +1632,8 @@ void TSTabletManager::StartShutdown() {
 
   verify_tablet_data_poller_->Shutdown();
 
+  closed_timestamps_publisher_->Shutdown();
+
   async_client_init_->Shutdown();
 
   mem_manager_->Shutdown();
@@ -1569,6 +1707,12 @@ void TSTabletManager::CompleteShutdown() {
   if (admin_triggered_compaction_pool_) {
     admin_triggered_compaction_pool_->Shutdown();
   }
+  if (apply_intents_pool_) {
+    apply_intents_pool_->Shutdown();
+  }
+  if (wait_queue_pool_) {
+    wait_queue_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(mutex_);
@@ -2046,7 +2190,7 @@ Status TSTabletManager::HandleNonReadyTabletOnStartup(
 
   if (!skip_deletion) {
     // Passing no OpId will retain the last_logged_opid that was previously in the metadata.
-    RETURN_NOT_OK(DeleteTabletData(meta, data_state, fs_manager_->uuid(), yb::OpId()));
+    RETURN_NOT_OK(DeleteTabletData(meta, data_state, fs_manager_->uuid(), yb::OpId(), this));
   }
 
   // We only delete the actual superblock of a TABLET_DATA_DELETED tablet on startup.
@@ -2446,6 +2590,9 @@ Status DeleteTabletData(const RaftGroupMetadataPtr& meta,
   RETURN_NOT_OK(meta->DeleteTabletData(data_state, last_logged_opid));
   LOG(INFO) << kLogPrefix << "Tablet deleted. Last logged OpId: "
             << meta->tombstone_last_logged_opid();
+  if (ts_manager) {
+    ts_manager->ErasePersistentCacheBlocks(*meta);
+  }
   MAYBE_FAULT(FLAGS_TEST_fault_crash_after_blocks_deleted);
 
   RETURN_NOT_OK(Log::DeleteOnDiskData(
@@ -48,6 +48,7 @@
 #include "yb/common/snapshot.h"
 
 #include "yb/consensus/consensus_fwd.h"
+#include "yb/consensus/log_fwd.h"
 #include "yb/consensus/metadata.pb.h"
 
 #include "yb/gutil/macros.h"
@@ -313,6 +314,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
                             const std::string& data_root_dir,
                             const std::string& wal_root_dir);
 
+  // Erases blocks of the tablet files from the persistent block cache. Should be called when
+  // RocksDB directories of the tablet are deleted, since no per file notifications are sent then.
+  void ErasePersistentCacheBlocks(const tablet::RaftGroupMetadata& meta);
+
   bool IsTabletInTransition(const TabletId& tablet_id) const;
 
   TabletServer* server() { return server_; }
@@ -326,6 +331,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Background task that verifies the data on each tablet for consistency.
   void VerifyTabletData();
 
+  // Background task that publishes closed timestamps of tablets led by this server to their
+  // followers, using a single RPC per follower tablet server.
+  void PublishClosedTimestamps();
+
   client::YBClient& client();
 
   const std::shared_future<client::YBClient*>& client_future();
@@ -559,6 +568,12 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Thread pool for log allocation threads, shared between all tablets.
   std::unique_ptr<ThreadPool> allocation_pool_;
 
+  // Combines WAL syncs of all tablets, if enabled.
+  std::unique_ptr<log::LogSyncGroup> log_sync_group_;
+
+  // Final transaction statuses shared by transaction participants of all tablets, if enabled.
+  std::unique_ptr<tablet::SharedTransactionStatusCache> transaction_status_cache_;
+
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
@@ -568,11 +583,20 @@ class TSTabletManager : public tserver::TabletPeerLookupIf, public tablet::Table
   // Thread pool for admin triggered compactions for tablets.
   std::unique_ptr<ThreadPool> admin_triggered_compaction_pool_;
 
+  // Thread pool for applying key range chunks of large transactions in parallel, shared between
+  // all tablets.
+  std::unique_ptr<ThreadPool> apply_intents_pool_;
+
+  // Thread pool for resuming transactional writes parked in wait queues of tablets.
+  std::unique_ptr<ThreadPool> wait_queue_pool_;
+
   std::unique_ptr<rpc::Poller> tablets_cleaner_;
 
   // Used for verifying tablet data integrity.
   std::unique_ptr<rpc::Poller> verify_tablet_data_poller_;
 
+  std::unique_ptr<rpc::Poller> closed_timestamps_publisher_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
@@ -59,6 +59,17 @@ METRIC_DEFINE_counter(server, block_cache_hits_caching,
                       "Number of lookups that were expecting a block that found one."
                       "Use this number instead of cache_hits when trying to determine how "
                       "efficient the cache is");
+METRIC_DEFINE_counter(server, block_cache_single_touch_hits,
+                      "Block Cache Single Touch Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the single touch cache");
+METRIC_DEFINE_counter(server, block_cache_multi_touch_hits,
+                      "Block Cache Multi Touch Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the multi touch cache");
+METRIC_DEFINE_counter(server, block_cache_admission_rejections,
+                      "Block Cache Admission Rejections", yb::MetricUnit::kBlocks,
+                      "Number of blocks that were not added to the cache by the admission policy, "
+                      "because they were accessed less frequently than the blocks they would "
+                      "evict");
 
 METRIC_DEFINE_gauge_uint64(server, block_cache_usage, "Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
@@ -71,6 +82,23 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_hits,
+                      "Persistent Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of blocks read from the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_misses,
+                      "Persistent Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups that didn't find a block in the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_inserts,
+                      "Persistent Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks written to the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_insert_drops,
+                      "Persistent Block Cache Insert Drops", yb::MetricUnit::kBlocks,
+                      "Number of blocks that were not written to the persistent block cache, "
+                      "because too many blocks were waiting to be written");
+METRIC_DEFINE_gauge_uint64(server, persistent_block_cache_usage,
+                           "Persistent Block Cache Usage", yb::MetricUnit::kBytes,
+                           "Size of persistent block cache files");
+
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -83,10 +111,21 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(cache_hits_caching, block_cache_hits_caching),
     MINIT(cache_misses, block_cache_misses),
     MINIT(cache_misses_caching, block_cache_misses_caching),
+    MINIT(single_touch_cache_hits, block_cache_single_touch_hits),
+    MINIT(multi_touch_cache_hits, block_cache_multi_touch_hits),
+    MINIT(admission_rejections, block_cache_admission_rejections),
     GINIT(cache_usage, block_cache_usage),
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
     GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
 }
+
+PersistentCacheMetrics::PersistentCacheMetrics(const scoped_refptr<MetricEntity>& entity)
+  : MINIT(hits, persistent_block_cache_hits),
+    MINIT(misses, persistent_block_cache_misses),
+    MINIT(inserts, persistent_block_cache_inserts),
+    MINIT(insert_drops, persistent_block_cache_insert_drops),
+    GINIT(usage, persistent_block_cache_usage) {
+}
 #undef MINIT
 #undef GINIT
 
@@ -54,11 +54,26 @@ struct CacheMetrics {
   scoped_refptr<Counter> cache_hits_caching;
   scoped_refptr<Counter> cache_misses;
   scoped_refptr<Counter> cache_misses_caching;
+  scoped_refptr<Counter> single_touch_cache_hits;
+  scoped_refptr<Counter> multi_touch_cache_hits;
+  scoped_refptr<Counter> admission_rejections;
 
   scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > single_touch_cache_usage;
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
 };
 
+// Metrics of the persistent secondary tier of the block cache.
+struct PersistentCacheMetrics {
+  explicit PersistentCacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+
+  scoped_refptr<Counter> hits;
+  scoped_refptr<Counter> misses;
+  scoped_refptr<Counter> inserts;
+  scoped_refptr<Counter> insert_drops;
+
+  scoped_refptr<AtomicGauge<uint64_t> > usage;
+};
+
 } // namespace yb
 #endif /* YB_UTIL_CACHE_METRICS_H */
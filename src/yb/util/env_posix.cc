@@ -31,6 +31,7 @@
 #include <sys/uio.h>
 #include <time.h>
 
+#include <atomic>
 #include <set>
 #include <vector>
 
@@ -420,8 +421,7 @@ class PosixWritableFile : public WritableFile {
     TRACE_EVENT1("io", "PosixWritableFile::Sync", "path", filename_);
     ThreadRestrictions::AssertIOAllowed();
     LOG_SLOW_EXECUTION(WARNING, 1000, Substitute("sync call for $0", filename_)) {
-      if (pending_sync_) {
-        pending_sync_ = false;
+      if (pending_sync_.exchange(false)) {
         RETURN_NOT_OK(DoSync(fd_, filename_));
       }
     }
@@ -440,7 +440,8 @@ class PosixWritableFile : public WritableFile {
     bool sync_on_close_;
     uint64_t filesize_;
     uint64_t pre_allocated_size_;
-    bool pending_sync_;
+    // Atomic, so Sync could be called concurrently with appends.
+    std::atomic<bool> pending_sync_;
 
  private:
   Status DoWritev(const Slice* slices, size_t n) {
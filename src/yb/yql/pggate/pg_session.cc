@@ -851,6 +851,13 @@ Status PgSession::FlushBufferedOperations() {
       [this](auto ops, auto txn) { return this->FlushOperations(std::move(ops), txn); });
 }
 
+Status PgSession::FlushBufferedOperationsBeforeCommit() {
+  return FlushBufferedOperationsImpl(
+      [this](auto ops, auto txn) {
+        return this->FlushOperations(std::move(ops), txn, IsCommitFlush(txn));
+      });
+}
+
 void PgSession::DropBufferedOperations() {
   VLOG_IF(1, !buffered_keys_.empty())
           << "Dropping " << buffered_keys_.size() << " pending operations";
@@ -938,7 +945,9 @@ Status PgSession::ApplyOperation(client::YBSession *session,
   return Status::OK();
 }
 
-Status PgSession::FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession transactional) {
+Status PgSession::FlushOperations(PgsqlOpBuffer ops,
+                                  IsTransactionalSession transactional,
+                                  IsCommitFlush commit_flush) {
   DCHECK(ops.size() > 0 && ops.size() <= FLAGS_ysql_session_max_batch_size);
   auto session = VERIFY_RESULT(GetSession(transactional, IsReadOnlyOperation::kFalse));
   if (session != session_.get()) {
@@ -953,6 +962,9 @@ Status PgSession::FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession tran
   for (const auto& buffered_op : ops) {
     RETURN_NOT_OK(ApplyOperation(session, transactional, buffered_op));
   }
+  if (commit_flush) {
+    pg_txn_manager_->RequestSingleShardFlush();
+  }
   const auto flush_status = session->FlushFuture().get();
   RETURN_NOT_OK(CombineErrorsToStatus(flush_status.errors, flush_status.status));
   for (const auto& buffered_op : ops) {
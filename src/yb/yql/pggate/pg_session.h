@@ -107,6 +107,7 @@ YB_STRONGLY_TYPED_BOOL(IsTransactionalSession);
 YB_STRONGLY_TYPED_BOOL(IsPessimisticLockRequired);
 YB_STRONGLY_TYPED_BOOL(IsReadOnlyOperation);
 YB_STRONGLY_TYPED_BOOL(IsCatalogOperation);
+YB_STRONGLY_TYPED_BOOL(IsCommitFlush);
 
 // This class is not thread-safe as it is mostly used by a single-threaded PostgreSQL backend
 // process.
@@ -210,6 +211,10 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   // Flush all pending buffered operations. Buffering mode remain unchanged.
   CHECKED_STATUS FlushBufferedOperations();
+  // Flush all pending buffered operations right before commit of the current transaction.
+  // Transactional operations could be written as a single-shard operation in this case,
+  // see PgTxnManager::RequestSingleShardFlush.
+  CHECKED_STATUS FlushBufferedOperationsBeforeCommit();
   // Drop all pending buffered operations. Buffering mode remain unchanged.
   void DropBufferedOperations();
 
@@ -336,7 +341,9 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   using Flusher = std::function<Status(PgsqlOpBuffer, IsTransactionalSession)>;
 
   CHECKED_STATUS FlushBufferedOperationsImpl(const Flusher& flusher);
-  CHECKED_STATUS FlushOperations(PgsqlOpBuffer ops, IsTransactionalSession transactional);
+  CHECKED_STATUS FlushOperations(PgsqlOpBuffer ops,
+                                 IsTransactionalSession transactional,
+                                 IsCommitFlush commit_flush = IsCommitFlush::kFalse);
   CHECKED_STATUS ApplyOperation(client::YBSession* session,
                                 bool transactional,
                                 const BufferableOperation& bop);
@@ -267,6 +267,10 @@ Status PgTxnManager::BeginWriteTransactionIfNecessary(bool read_only_op,
     return Status::OK();
   }
 
+  if (read_only_op) {
+    has_read_ops_ = true;
+  }
+
   // Using pg_isolation_level_, read_only_, and deferrable_, determine the effective isolation level
   // to use at the DocDB layer, and the "deferrable" flag.
   //
@@ -350,6 +354,14 @@ Status PgTxnManager::BeginWriteTransactionIfNecessary(bool read_only_op,
   return Status::OK();
 }
 
+void PgTxnManager::RequestSingleShardFlush() {
+  if (!txn_ || ddl_session_ || has_read_ops_) {
+    return;
+  }
+  VLOG_TXN_STATE(2);
+  txn_->RequestSingleShardFlush();
+}
+
 Status PgTxnManager::SetActiveSubTransaction(SubTransactionId id) {
   RETURN_NOT_OK(BeginWriteTransactionIfNecessary(
       false /* read_only_op */, false /* needs_pessimistic_locking */));
@@ -481,6 +493,7 @@ std::shared_future<Result<TransactionMetadata>> PgTxnManager::GetDdlTxnMetadata(
 
 void PgTxnManager::ResetTxnAndSession() {
   txn_in_progress_ = false;
+  has_read_ops_ = false;
   session_ = nullptr;
   txn_ = nullptr;
   can_restart_.store(true, std::memory_order_release);
@@ -82,6 +82,11 @@ class PgTxnManager : public RefCountedThreadSafe<PgTxnManager> {
   CHECKED_STATUS BeginWriteTransactionIfNecessary(bool read_only_op,
                                                   bool needs_pessimistic_locking = false);
 
+  // Requests the next flush of the transactional session to be written as a single-shard
+  // operation, when transaction did not read anything. Transaction should be committed right
+  // after this flush. See YBTransaction::RequestSingleShardFlush.
+  void RequestSingleShardFlush();
+
   CHECKED_STATUS SetActiveSubTransaction(SubTransactionId id);
 
   CHECKED_STATUS RollbackSubTransaction(SubTransactionId id);
@@ -113,6 +118,8 @@ class PgTxnManager : public RefCountedThreadSafe<PgTxnManager> {
   const tserver::TServerSharedObject* const tserver_shared_object_;
 
   bool txn_in_progress_ = false;
+  // Read operations were performed in context of the current transaction.
+  bool has_read_ops_ = false;
   client::YBTransactionPtr txn_;
   client::YBSessionPtr session_;
 
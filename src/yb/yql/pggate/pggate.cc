@@ -1405,7 +1405,7 @@ Status PgApiImpl::MaybeResetTransactionReadPoint() {
 
 Status PgApiImpl::CommitTransaction() {
   pg_session_->InvalidateForeignKeyReferenceCache();
-  RETURN_NOT_OK(pg_session_->FlushBufferedOperations());
+  RETURN_NOT_OK(pg_session_->FlushBufferedOperationsBeforeCommit());
   return pg_txn_manager_->CommitTransaction();
 }
 